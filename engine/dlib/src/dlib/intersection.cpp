@@ -14,6 +14,7 @@
 
 #include <dmsdk/dlib/intersection.h>
 #include <stdint.h>
+#include "simd.h"
 
 namespace dmIntersection
 {
@@ -98,4 +99,53 @@ bool TestFrustumSphere(const Frustum& frustum, const dmVMath::Vector4& pos, floa
     return true;
 }
 
+#if defined(DM_SIMD)
+
+// Returns a bit mask with the spheres that are completely behind any of the planes
+static inline uint32_t TestFrustumSpheres4(const Frustum& frustum, const dmVMath::Vector4* spheres, uint32_t num_planes)
+{
+    dmSimd::Float4 x = dmSimd::Load((const float*)&spheres[0]);
+    dmSimd::Float4 y = dmSimd::Load((const float*)&spheres[1]);
+    dmSimd::Float4 z = dmSimd::Load((const float*)&spheres[2]);
+    dmSimd::Float4 r = dmSimd::Load((const float*)&spheres[3]);
+    dmSimd::Transpose(x, y, z, r);
+
+    dmSimd::Float4 neg_r = dmSimd::Sub(dmSimd::Splat(0.0f), r);
+    dmSimd::Float4 outside = dmSimd::Splat(0.0f);
+    for (uint32_t i = 0; i < num_planes; ++i)
+    {
+        const float* plane = (const float*)&frustum.m_Planes[i];
+        // Same operation order as DistanceToPlane
+        dmSimd::Float4 d = dmSimd::Mul(dmSimd::Splat(plane[0]), x);
+        d = dmSimd::Add(d, dmSimd::Mul(dmSimd::Splat(plane[1]), y));
+        d = dmSimd::Add(d, dmSimd::Mul(dmSimd::Splat(plane[2]), z));
+        d = dmSimd::Add(d, dmSimd::Splat(plane[3]));
+        outside = dmSimd::Or(outside, dmSimd::CmpLt(d, neg_r));
+    }
+    return dmSimd::MoveMask(outside);
+}
+
+#endif
+
+void TestFrustumSpheres(const Frustum& frustum, const dmVMath::Vector4* spheres, uint32_t count, bool skip_near_far, bool* results)
+{
+    uint32_t num_planes = skip_near_far ? 4 : 6;
+    uint32_t i = 0;
+#if defined(DM_SIMD)
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32_t outside = TestFrustumSpheres4(frustum, &spheres[i], num_planes);
+        results[i + 0] = (outside & 1) == 0;
+        results[i + 1] = (outside & 2) == 0;
+        results[i + 2] = (outside & 4) == 0;
+        results[i + 3] = (outside & 8) == 0;
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const dmVMath::Vector4& sphere = spheres[i];
+        results[i] = TestFrustumSphere(frustum, dmVMath::Vector4(sphere.getXYZ(), 1.0f), sphere.getW(), skip_near_far);
+    }
+}
+
 } // dmIntersection
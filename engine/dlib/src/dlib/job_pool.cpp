@@ -0,0 +1,224 @@
+// Copyright 2020-2022 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "job_pool.h"
+#include "array.h"
+#include "log.h"
+#include "mutex.h"
+#include "condition_variable.h"
+#include "thread.h"
+
+namespace dmJobPool
+{
+    // Jobs of a Run call, living on the stack of the calling thread
+    struct Batch
+    {
+        JobFunction m_Function;
+        void*       m_Context;
+        uint32_t    m_Count;
+        uint32_t    m_Next;
+        uint32_t    m_Done;
+        Batch*      m_NextBatch;
+    };
+
+    struct Job
+    {
+        JobFunction m_Function;
+        void*       m_Context;
+        uint32_t    m_Index;
+    };
+
+    struct JobPool
+    {
+        dmMutex::HMutex                         m_Mutex;
+        /// Signalled when jobs are posted, or on shutdown
+        dmConditionVariable::HConditionVariable m_WakeupCond;
+        /// Signalled when the last job of a batch is done
+        dmConditionVariable::HConditionVariable m_DoneCond;
+        dmThread::Thread                        m_Threads[MAX_THREAD_COUNT];
+        uint32_t                                m_ThreadCount;
+        /// Batches of the pending Run calls, all guarded by the mutex
+        Batch*                                  m_Batches;
+        /// Jobs posted with Push, run in order from m_NextJob
+        dmArray<Job>                            m_Jobs;
+        uint32_t                                m_NextJob;
+        uint32_t                                m_Shutdown : 1;
+    };
+
+    static Batch* GetPendingBatch(JobPool* pool)
+    {
+        Batch* batch = pool->m_Batches;
+        while (batch != 0x0 && batch->m_Next == batch->m_Count)
+            batch = batch->m_NextBatch;
+        return batch;
+    }
+
+    // Runs one job from the batch. Called with the mutex held.
+    static void RunBatchJob(JobPool* pool, Batch* batch)
+    {
+        uint32_t index = batch->m_Next++;
+        dmMutex::Unlock(pool->m_Mutex);
+
+        batch->m_Function(batch->m_Context, index);
+
+        dmMutex::Lock(pool->m_Mutex);
+        if (++batch->m_Done == batch->m_Count)
+            dmConditionVariable::Broadcast(pool->m_DoneCond);
+    }
+
+    static void WorkerThread(void* arg)
+    {
+        JobPool* pool = (JobPool*)arg;
+        dmMutex::Lock(pool->m_Mutex);
+        while (!pool->m_Shutdown)
+        {
+            // Batches first, since there is a thread waiting for each of them
+            Batch* batch = GetPendingBatch(pool);
+            if (batch != 0x0)
+            {
+                RunBatchJob(pool, batch);
+            }
+            else if (pool->m_NextJob < pool->m_Jobs.Size())
+            {
+                Job job = pool->m_Jobs[pool->m_NextJob++];
+                if (pool->m_NextJob == pool->m_Jobs.Size())
+                {
+                    pool->m_Jobs.SetSize(0);
+                    pool->m_NextJob = 0;
+                }
+                dmMutex::Unlock(pool->m_Mutex);
+
+                job.m_Function(job.m_Context, job.m_Index);
+
+                dmMutex::Lock(pool->m_Mutex);
+            }
+            else
+            {
+                dmConditionVariable::Wait(pool->m_WakeupCond, pool->m_Mutex);
+            }
+        }
+        dmMutex::Unlock(pool->m_Mutex);
+    }
+
+    HJobPool New(uint32_t thread_count)
+    {
+        if (thread_count == 0)
+            return 0x0;
+        if (thread_count > MAX_THREAD_COUNT)
+        {
+            dmLogWarning("The number of job threads (%d) is limited to %d", thread_count, MAX_THREAD_COUNT);
+            thread_count = MAX_THREAD_COUNT;
+        }
+
+        JobPool* pool = new JobPool;
+        pool->m_Mutex = dmMutex::New();
+        pool->m_WakeupCond = dmConditionVariable::New();
+        pool->m_DoneCond = dmConditionVariable::New();
+        pool->m_ThreadCount = thread_count;
+        pool->m_Batches = 0x0;
+        pool->m_Jobs.SetCapacity(32);
+        pool->m_NextJob = 0;
+        pool->m_Shutdown = 0;
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            pool->m_Threads[i] = dmThread::New(&WorkerThread, 0x80000, pool, "job_pool");
+        }
+        return pool;
+    }
+
+    void Delete(HJobPool pool)
+    {
+        if (pool == 0x0)
+            return;
+        {
+            DM_MUTEX_SCOPED_LOCK(pool->m_Mutex);
+            pool->m_Shutdown = 1;
+            dmConditionVariable::Broadcast(pool->m_WakeupCond);
+        }
+        for (uint32_t i = 0; i < pool->m_ThreadCount; ++i)
+        {
+            dmThread::Join(pool->m_Threads[i]);
+        }
+        dmConditionVariable::Delete(pool->m_DoneCond);
+        dmConditionVariable::Delete(pool->m_WakeupCond);
+        dmMutex::Delete(pool->m_Mutex);
+        delete pool;
+    }
+
+    uint32_t GetThreadCount(HJobPool pool)
+    {
+        return pool != 0x0 ? pool->m_ThreadCount : 0;
+    }
+
+    void Run(HJobPool pool, JobFunction function, void* context, uint32_t count)
+    {
+        if (pool == 0x0 || count < 2)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                function(context, i);
+            }
+            return;
+        }
+
+        Batch batch;
+        batch.m_Function = function;
+        batch.m_Context = context;
+        batch.m_Count = count;
+        batch.m_Next = 0;
+        batch.m_Done = 0;
+        batch.m_NextBatch = 0x0;
+
+        dmMutex::Lock(pool->m_Mutex);
+        Batch** last = &pool->m_Batches;
+        while (*last != 0x0)
+            last = &(*last)->m_NextBatch;
+        *last = &batch;
+        dmConditionVariable::Broadcast(pool->m_WakeupCond);
+
+        // The calling thread only runs its own jobs, so it never waits behind a posted job
+        while (batch.m_Next < count)
+        {
+            RunBatchJob(pool, &batch);
+        }
+        while (batch.m_Done < count)
+        {
+            dmConditionVariable::Wait(pool->m_DoneCond, pool->m_Mutex);
+        }
+
+        Batch** link = &pool->m_Batches;
+        while (*link != &batch)
+            link = &(*link)->m_NextBatch;
+        *link = batch.m_NextBatch;
+        dmMutex::Unlock(pool->m_Mutex);
+    }
+
+    bool Push(HJobPool pool, JobFunction function, void* context, uint32_t index)
+    {
+        if (pool == 0x0)
+            return false;
+
+        Job job;
+        job.m_Function = function;
+        job.m_Context = context;
+        job.m_Index = index;
+
+        DM_MUTEX_SCOPED_LOCK(pool->m_Mutex);
+        if (pool->m_Jobs.Full())
+            pool->m_Jobs.OffsetCapacity(32);
+        pool->m_Jobs.Push(job);
+        dmConditionVariable::Signal(pool->m_WakeupCond);
+        return true;
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright 2020-2022 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_JOB_POOL_H
+#define DM_JOB_POOL_H
+
+#include <stdint.h>
+
+/**
+ * Pool of worker threads shared by the engine systems
+ *
+ * Jobs are either run in parallel with Run, where the calling thread takes part and the call returns
+ * when all of them are done, or posted with Push and run later by one of the threads.
+ * A job may call Run, but must never wait for another job posted to the same pool.
+ */
+namespace dmJobPool
+{
+    typedef struct JobPool* HJobPool;
+
+    /// Max number of threads in a pool
+    const uint32_t MAX_THREAD_COUNT = 16;
+
+    /**
+     * Job function
+     * @param context Context passed to Run or Push
+     * @param index Index of the job, in [0, count) for Run and the index passed to Push
+     */
+    typedef void (*JobFunction)(void* context, uint32_t index);
+
+    /**
+     * Create a new job pool
+     * @param thread_count Number of worker threads, limited to MAX_THREAD_COUNT
+     * @return Pool handle, 0x0 if thread_count is 0
+     */
+    HJobPool New(uint32_t thread_count);
+
+    /**
+     * Delete a job pool. Jobs posted with Push that haven't been started are discarded.
+     * @param pool Pool handle, may be 0x0
+     */
+    void Delete(HJobPool pool);
+
+    /**
+     * Get the number of worker threads
+     * @param pool Pool handle, may be 0x0
+     * @return Number of worker threads, 0 for a 0x0 pool
+     */
+    uint32_t GetThreadCount(HJobPool pool);
+
+    /**
+     * Run the jobs [0, count) in parallel and return when all of them are done.
+     * The calling thread runs jobs too, and runs all of them if the pool is 0x0.
+     * @param pool Pool handle, may be 0x0
+     * @param function Job function
+     * @param context Context passed to the job function
+     * @param count Number of jobs
+     */
+    void Run(HJobPool pool, JobFunction function, void* context, uint32_t count);
+
+    /**
+     * Post a job to be run by one of the worker threads. The caller is responsible for
+     * waiting for the job to finish before the context is deleted.
+     * @param pool Pool handle
+     * @param function Job function
+     * @param context Context passed to the job function
+     * @param index Index passed to the job function
+     * @return true if the job was posted, false if the pool is 0x0
+     */
+    bool Push(HJobPool pool, JobFunction function, void* context, uint32_t index);
+}
+
+#endif // DM_JOB_POOL_H
@@ -24,6 +24,7 @@
 #include <dlib/mutex.h>
 #include <dlib/static_assert.h>
 #include <dlib/spinlock.h>
+#include <dlib/thread.h>
 #include <dlib/profile/profile.h>
 
 DM_PROPERTY_GROUP(rmtp_Message, "dmMessage");
@@ -34,24 +35,40 @@ namespace dmMessage
     // Alignment of allocations
     const uint32_t DM_MESSAGE_ALIGNMENT = 16U;
 
+    // Each message is prefixed with a pointer to the page it was allocated from.
+    // The header is a full alignment unit, so that the message itself stays aligned.
+    const uint32_t DM_MESSAGE_HEADER_SIZE = DM_MESSAGE_ALIGNMENT;
+
+    /*
+     * Messages are allocated from pages owned by the posting thread, so that posting never
+     * contends with other threads over allocation.
+     * A page is reference counted: one reference for each message allocated from it that
+     * hasn't been dispatched yet, and one reference held by the owning thread while the page
+     * is its current page. When the count reaches zero, the page is returned to the free list
+     * of the context and can be picked up by any thread.
+     */
     struct MemoryPage
     {
-        uint8_t     m_Memory[DM_MESSAGE_PAGE_SIZE];
-        uint32_t    m_Current;
-        MemoryPage* m_NextPage;
+        uint8_t         m_Memory[DM_MESSAGE_HEADER_SIZE + DM_MESSAGE_PAGE_SIZE];
+        uint32_t        m_Current;
+        int32_atomic_t  m_RefCount;
+        MemoryPage*     m_NextPage;      // Next page in the free list
+        MemoryPage*     m_NextAllocated; // Next page in the list of all pages, for cleanup
     };
 
+    struct MessageContext;
+
     struct MemoryAllocator
     {
-        MemoryAllocator()
+        MemoryAllocator(MessageContext* ctx)
         {
+            m_Context = ctx;
             m_CurrentPage = 0;
-            m_FreePages = 0;
-            m_FullPages = 0;
+            m_Next = 0;
         }
-        MemoryPage* m_CurrentPage;
-        MemoryPage* m_FreePages;
-        MemoryPage* m_FullPages;
+        MessageContext*  m_Context;
+        MemoryPage*      m_CurrentPage;
+        MemoryAllocator* m_Next;
     };
 
     struct GlobalInit
@@ -63,64 +80,21 @@ namespace dmMessage
 
     } g_MessageInit;
 
-    static void AllocateNewPage(MemoryAllocator* allocator)
-    {
-        if (allocator->m_CurrentPage)
-        {
-            // Link current page to full pages
-            allocator->m_CurrentPage->m_NextPage = allocator->m_FullPages;
-            allocator->m_FullPages = allocator->m_CurrentPage;
-        }
-
-        MemoryPage* new_page = 0;
-
-        if (allocator->m_FreePages)
-        {
-            // Free page to use
-            new_page = allocator->m_FreePages;
-            allocator->m_FreePages = new_page->m_NextPage;
-        }
-        else
-        {
-            // Allocate new page
-            new_page = new MemoryPage;
-        }
-
-        new_page->m_Current = 0;
-        new_page->m_NextPage = 0;
-
-        allocator->m_CurrentPage = new_page;
-    }
-
-    static void* AllocateMessage(MemoryAllocator* allocator, uint32_t size)
-    {
-        // At least ALIGNMENT bytes alignment of size in order to ensure that the next allocation is aligned
-        size += DM_MESSAGE_ALIGNMENT-1;
-        size &= ~(DM_MESSAGE_ALIGNMENT-1);
-        assert(size <= DM_MESSAGE_PAGE_SIZE);
-
-        if (allocator->m_CurrentPage == 0 || (DM_MESSAGE_PAGE_SIZE-allocator->m_CurrentPage->m_Current) < size)
-        {
-            // No current page or allocation didn't fit.
-            AllocateNewPage(allocator);
-        }
-
-        MemoryPage* page = allocator->m_CurrentPage;
-        void* ret = (void*) ((uintptr_t) &page->m_Memory[0] + page->m_Current);
-        page->m_Current += size;
-        return ret;
-    }
-
+    /*
+     * The message queue of a socket is a lock free multiple producer stack. Producers push
+     * messages with a compare-and-swap on m_Head, and a dispatch takes the entire stack with
+     * a single exchange and reverses it into posting order.
+     * The mutex and condition variable are only used to wake up a blocking dispatch.
+     */
     struct MessageSocket
     {
-        uint32_t        m_RefCount; // Is protected by "g_MessageContext->m_Spinlock"
+        int32_atomic_t  m_RefCount; // Is incremented under "g_MessageContext->m_Spinlock"
         dmhash_t        m_NameHash;
-        Message*        m_Header;
-        Message*        m_Tail;
+        Message* volatile m_Head;
+        int32_atomic_t  m_Waiters;
         const char*     m_Name;
         dmMutex::HMutex m_Mutex;
         dmConditionVariable::HConditionVariable m_Condition;
-        MemoryAllocator m_Allocator;
     };
 
     const uint32_t MAX_SOCKETS = 256;
@@ -129,18 +103,54 @@ namespace dmMessage
     {
         dmHashTable64<MessageSocket> m_Sockets;
         dmSpinlock::Spinlock m_Spinlock;
+        // Page allocation state, protected by m_PageSpinlock
+        dmSpinlock::Spinlock m_PageSpinlock;
+        MemoryPage*          m_FreePages;
+        MemoryPage*          m_AllPages;
+        MemoryAllocator*     m_Allocators;
+        dmThread::TlsKey     m_AllocatorKey;
     };
 
     MessageContext* g_MessageContext = 0;
 
+    static void DeleteThreadAllocator(void* value);
+
     static MessageContext* Create(uint32_t max_sockets)
     {
         MessageContext* ctx = new MessageContext;
         ctx->m_Sockets.SetCapacity(max_sockets, max_sockets);
         dmSpinlock::Init(&ctx->m_Spinlock);
+        dmSpinlock::Init(&ctx->m_PageSpinlock);
+        ctx->m_FreePages = 0;
+        ctx->m_AllPages = 0;
+        ctx->m_Allocators = 0;
+        ctx->m_AllocatorKey = dmThread::AllocTls(DeleteThreadAllocator);
         return ctx;
     }
 
+    static void Destroy(MessageContext* ctx)
+    {
+        // Other threads are expected to have exited, and released their allocators
+        dmThread::SetTlsValue(ctx->m_AllocatorKey, 0);
+        dmThread::FreeTls(ctx->m_AllocatorKey);
+
+        MemoryPage* p = ctx->m_AllPages;
+        while (p)
+        {
+            MemoryPage* next = p->m_NextAllocated;
+            delete p;
+            p = next;
+        }
+        MemoryAllocator* a = ctx->m_Allocators;
+        while (a)
+        {
+            MemoryAllocator* next = a->m_Next;
+            delete a;
+            a = next;
+        }
+        delete ctx;
+    }
+
     // Until the Create/Destroy functions are exposed:
     // The context is created on demand, and we also need to destroy it automatically
     struct ContextDestroyer
@@ -149,12 +159,139 @@ namespace dmMessage
         {
             if (g_MessageContext)
             {
-                delete g_MessageContext;
+                Destroy(g_MessageContext);
                 g_MessageContext = 0;
             }
         }
     } g_ContextDestroyer;
 
+    static MemoryAllocator* GetThreadAllocator(MessageContext* ctx)
+    {
+        MemoryAllocator* allocator = (MemoryAllocator*) dmThread::GetTlsValue(ctx->m_AllocatorKey);
+        if (allocator == 0)
+        {
+            allocator = new MemoryAllocator(ctx);
+            dmThread::SetTlsValue(ctx->m_AllocatorKey, allocator);
+
+            DM_SPINLOCK_SCOPED_LOCK(ctx->m_PageSpinlock);
+            allocator->m_Next = ctx->m_Allocators;
+            ctx->m_Allocators = allocator;
+        }
+        return allocator;
+    }
+
+    static void ReleasePage(MessageContext* ctx, MemoryPage* page)
+    {
+        if (dmAtomicDecrement32(&page->m_RefCount) == 1)
+        {
+            DM_SPINLOCK_SCOPED_LOCK(ctx->m_PageSpinlock);
+            page->m_NextPage = ctx->m_FreePages;
+            ctx->m_FreePages = page;
+        }
+    }
+
+    // Called when a thread that has posted messages exits
+    static void DeleteThreadAllocator(void* value)
+    {
+        MemoryAllocator* allocator = (MemoryAllocator*) value;
+        MessageContext* ctx = allocator->m_Context;
+        if (allocator->m_CurrentPage)
+        {
+            // Drop the reference held by the thread, the page is freed with its last message
+            ReleasePage(ctx, allocator->m_CurrentPage);
+        }
+
+        {
+            DM_SPINLOCK_SCOPED_LOCK(ctx->m_PageSpinlock);
+            MemoryAllocator** link = &ctx->m_Allocators;
+            while (*link != allocator)
+                link = &(*link)->m_Next;
+            *link = allocator->m_Next;
+        }
+        delete allocator;
+    }
+
+    static void AllocateNewPage(MessageContext* ctx, MemoryAllocator* allocator)
+    {
+        if (allocator->m_CurrentPage)
+        {
+            // Drop the reference held by this thread, the page is freed with its last message
+            ReleasePage(ctx, allocator->m_CurrentPage);
+        }
+
+        MemoryPage* new_page = 0;
+        {
+            DM_SPINLOCK_SCOPED_LOCK(ctx->m_PageSpinlock);
+            if (ctx->m_FreePages)
+            {
+                // Free page to use
+                new_page = ctx->m_FreePages;
+                ctx->m_FreePages = new_page->m_NextPage;
+            }
+        }
+
+        if (new_page == 0)
+        {
+            // Allocate new page
+            new_page = new MemoryPage;
+            DM_SPINLOCK_SCOPED_LOCK(ctx->m_PageSpinlock);
+            new_page->m_NextAllocated = ctx->m_AllPages;
+            ctx->m_AllPages = new_page;
+        }
+
+        new_page->m_Current = 0;
+        new_page->m_RefCount = 1;
+        new_page->m_NextPage = 0;
+
+        allocator->m_CurrentPage = new_page;
+    }
+
+    static Message* AllocateMessage(MessageContext* ctx, uint32_t size)
+    {
+        MemoryAllocator* allocator = GetThreadAllocator(ctx);
+
+        // At least ALIGNMENT bytes alignment of size in order to ensure that the next allocation is aligned
+        size += DM_MESSAGE_HEADER_SIZE;
+        size += DM_MESSAGE_ALIGNMENT-1;
+        size &= ~(DM_MESSAGE_ALIGNMENT-1);
+        assert(size <= DM_MESSAGE_HEADER_SIZE + DM_MESSAGE_PAGE_SIZE);
+
+        if (allocator->m_CurrentPage == 0 || (DM_MESSAGE_HEADER_SIZE + DM_MESSAGE_PAGE_SIZE - allocator->m_CurrentPage->m_Current) < size)
+        {
+            // No current page or allocation didn't fit.
+            AllocateNewPage(ctx, allocator);
+        }
+
+        MemoryPage* page = allocator->m_CurrentPage;
+        uint8_t* memory = &page->m_Memory[page->m_Current];
+        page->m_Current += size;
+        dmAtomicIncrement32(&page->m_RefCount);
+
+        *(MemoryPage**) memory = page;
+        return (Message*) (memory + DM_MESSAGE_HEADER_SIZE);
+    }
+
+    static void FreeMessage(MessageContext* ctx, Message* message)
+    {
+        MemoryPage* page = *(MemoryPage**) ((uint8_t*) message - DM_MESSAGE_HEADER_SIZE);
+        ReleasePage(ctx, page);
+    }
+
+    // Takes all messages currently queued on the socket, in the order they were posted
+    static Message* TakeMessages(MessageSocket* s)
+    {
+        Message* message = (Message*) dmAtomicStorePtr((void* volatile*) &s->m_Head, 0);
+        Message* ordered = 0;
+        while (message)
+        {
+            Message* next = message->m_Next;
+            message->m_Next = ordered;
+            ordered = message;
+            message = next;
+        }
+        return ordered;
+    }
+
     Result NewSocket(const char* name, HSocket* socket)
     {
         if (g_MessageContext == 0)
@@ -183,8 +320,8 @@ namespace dmMessage
 
         MessageSocket s;
         s.m_RefCount = 1;
-        s.m_Header = 0;
-        s.m_Tail = 0;
+        s.m_Head = 0;
+        s.m_Waiters = 0;
         s.m_NameHash = name_hash;
         s.m_Name = strdup(name);
         s.m_Mutex = dmMutex::New();
@@ -198,56 +335,35 @@ namespace dmMessage
 
     static void DisposeSocket(MessageSocket* s)
     {
-        Message *message_object = s->m_Header;
+        Message *message_object = TakeMessages(s);
         while (message_object)
         {
             if (message_object->m_DestroyCallback)
             {
                 message_object->m_DestroyCallback(message_object);
             }
-            message_object = message_object->m_Next;
+            Message* next = message_object->m_Next;
+            FreeMessage(g_MessageContext, message_object);
+            message_object = next;
         }
 
         free((void*) s->m_Name);
 
-        MemoryPage* p = s->m_Allocator.m_FreePages;
-        while (p)
-        {
-            MemoryPage* next = p->m_NextPage;
-            delete p;
-            p = next;
-        }
-        p = s->m_Allocator.m_FullPages;
-        while (p)
-        {
-            MemoryPage* next = p->m_NextPage;
-            delete p;
-            p = next;
-        }
-        if (s->m_Allocator.m_CurrentPage)
-        {
-            delete s->m_Allocator.m_CurrentPage;
-        }
-
         dmConditionVariable::Delete(s->m_Condition);
 
         dmMutex::Delete(s->m_Mutex);
 
-        memset(s, 0, sizeof(*s));
+        memset((void*)s, 0, sizeof(*s));
     }
 
     static void ReleaseSocket(MessageSocket* s)
     {
+        // The socket table holds a reference until the socket is deleted, so the
+        // count can only reach zero after the socket has been removed from the table.
+        if (dmAtomicDecrement32(&s->m_RefCount) == 1)
         {
-            DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_Spinlock);
-            --s->m_RefCount;
-
-            if (s->m_RefCount > 0)
-            {
-                return;
-            }
+            DisposeSocket(s);
         }
-        DisposeSocket(s);
     }
 
     static MessageSocket* AcquireSocket(HSocket socket)
@@ -263,7 +379,7 @@ namespace dmMessage
 
         assert(s->m_RefCount >= 1);
 
-        ++s->m_RefCount;
+        dmAtomicIncrement32(&s->m_RefCount);
 
         return s;
     }
@@ -280,15 +396,8 @@ namespace dmMessage
             }
 
             g_MessageContext->m_Sockets.Erase(s->m_NameHash);
-            --s->m_RefCount;
-
-            if(s->m_RefCount > 0)
-            {
-                // Defer deletion
-                return RESULT_OK;
-            }
         }
-        DisposeSocket(s);
+        ReleaseSocket(s);
         return RESULT_OK;
     }
 
@@ -348,11 +457,7 @@ namespace dmMessage
         MessageSocket* s = AcquireSocket(socket);
         if (s != 0)
         {
-            bool has_messages;
-            {
-                DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
-                has_messages = s->m_Header != 0;
-            }
+            bool has_messages = s->m_Head != 0;
             ReleaseSocket(s);
             return has_messages;
         }
@@ -416,11 +521,8 @@ namespace dmMessage
             return RESULT_SOCKET_NOT_FOUND;
         }
 
-        dmMutex::Lock(s->m_Mutex);
-
-        MemoryAllocator* allocator = &s->m_Allocator;
         uint32_t data_size = sizeof(Message) + message_data_size;
-        Message *new_message = (Message *) AllocateMessage(allocator, data_size);
+        Message *new_message = AllocateMessage(g_MessageContext, data_size);
         if (sender != 0x0)
         {
             new_message->m_Sender = *sender;
@@ -435,28 +537,23 @@ namespace dmMessage
         new_message->m_UserData2 = user_data2;
         new_message->m_Descriptor = descriptor;
         new_message->m_DataSize = message_data_size;
-        new_message->m_Next = 0;
         new_message->m_DestroyCallback = destroy_callback;
         memcpy(&new_message->m_Data[0], message_data, message_data_size);
 
-        bool is_first_message = !s->m_Header;
-
-        if (!s->m_Header)
+        Message* head;
+        do
         {
-            s->m_Header = new_message;
-            s->m_Tail = new_message;
-        }
-        else
-        {
-            s->m_Tail->m_Next = new_message;
-            s->m_Tail = new_message;
-        }
+            head = s->m_Head;
+            new_message->m_Next = head;
+        } while (dmAtomicCompareStorePtr((void* volatile*) &s->m_Head, new_message, head) != head);
 
-        if (is_first_message)
+        // The compare-and-swap above is a full barrier, so a blocking dispatch either sees the
+        // message or has registered itself as a waiter before we read the count
+        if (head == 0 && s->m_Waiters > 0)
         {
+            DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
             dmConditionVariable::Signal(s->m_Condition);
         }
-        dmMutex::Unlock(s->m_Mutex);
 
         ReleaseSocket(s);
 
@@ -504,21 +601,23 @@ namespace dmMessage
             return 0;
         }
 
-        dmMutex::Lock(s->m_Mutex);
-
-        MemoryAllocator* allocator = &s->m_Allocator;
-
-        if (!s->m_Header)
+        if (blocking)
         {
-            if (blocking) {
+            DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
+            dmAtomicIncrement32(&s->m_Waiters);
+            while (s->m_Head == 0)
+            {
                 dmConditionVariable::Wait(s->m_Condition, s->m_Mutex);
-            } else {
-                dmMutex::Unlock(s->m_Mutex);
-                ReleaseSocket(s);
-                return 0;
             }
+            dmAtomicDecrement32(&s->m_Waiters);
         }
 
+        Message *message_object = TakeMessages(s);
+        if (!message_object)
+        {
+            ReleaseSocket(s);
+            return 0;
+        }
 
         char buffer[128];
         const char* profiler_string = GetProfilerString(s->m_Name, buffer, sizeof(buffer));
@@ -526,38 +625,18 @@ namespace dmMessage
 
         uint32_t dispatch_count = 0;
 
-        Message *message_object = s->m_Header;
-        s->m_Header = 0;
-        s->m_Tail = 0;
-
-        // Unlink full pages
-        MemoryPage* full_pages = allocator->m_FullPages;
-        allocator->m_FullPages = 0;
-
-        dmMutex::Unlock(s->m_Mutex);
-
         while (message_object)
         {
             dispatch_callback(message_object, user_ptr);
             if (message_object->m_DestroyCallback) {
                 message_object->m_DestroyCallback(message_object);
             }
-            message_object = message_object->m_Next;
+            Message* next = message_object->m_Next;
+            FreeMessage(g_MessageContext, message_object);
+            message_object = next;
             dispatch_count++;
         }
 
-        // Reclaim all full pages active when dispatch started
-        dmMutex::Lock(s->m_Mutex);
-        MemoryPage* p = full_pages;
-        while (p)
-        {
-            MemoryPage* next = p->m_NextPage;
-            p->m_NextPage = allocator->m_FreePages;
-            allocator->m_FreePages = p;
-            p = next;
-        }
-        dmMutex::Unlock(s->m_Mutex);
-
         ReleaseSocket(s);
 
         return dispatch_count;
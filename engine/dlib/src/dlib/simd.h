@@ -0,0 +1,167 @@
+// Copyright 2020-2022 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_SIMD_H
+#define DM_SIMD_H
+
+/*
+ * Minimal 4-wide float abstraction over SSE2 and NEON, used by the batch kernels in the engine.
+ *
+ * DM_SIMD is defined when one of the backends is available. Code using this header must always
+ * provide a scalar fallback for when it isn't (e.g. html5).
+ *
+ * All loads and stores are unaligned, since dmArray storage is not guaranteed to be 16 byte aligned
+ * on all platforms.
+ *
+ * The operations map one-to-one to IEEE single precision operations (no fused multiply-add),
+ * so a kernel written with the same operation order as the scalar code gives bit exact results.
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DM_SIMD_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define DM_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined(DM_SIMD_SSE2) || defined(DM_SIMD_NEON)
+    #define DM_SIMD
+#endif
+
+#if defined(DM_SIMD)
+
+namespace dmSimd
+{
+#if defined(DM_SIMD_SSE2)
+
+    typedef __m128 Float4;
+
+    static inline Float4 Load(const float* p)                   { return _mm_loadu_ps(p); }
+    static inline void   Store(float* p, Float4 v)              { _mm_storeu_ps(p, v); }
+    static inline Float4 Splat(float v)                         { return _mm_set1_ps(v); }
+    static inline Float4 Set(float x, float y, float z, float w){ return _mm_setr_ps(x, y, z, w); }
+    static inline Float4 Add(Float4 a, Float4 b)                { return _mm_add_ps(a, b); }
+    static inline Float4 Sub(Float4 a, Float4 b)                { return _mm_sub_ps(a, b); }
+    static inline Float4 Mul(Float4 a, Float4 b)                { return _mm_mul_ps(a, b); }
+    static inline Float4 Min(Float4 a, Float4 b)                { return _mm_min_ps(a, b); }
+    static inline Float4 Max(Float4 a, Float4 b)                { return _mm_max_ps(a, b); }
+    static inline Float4 Sqrt(Float4 v)                         { return _mm_sqrt_ps(v); }
+
+    // Comparisons return a mask with all bits set in the lanes where the comparison is true
+    static inline Float4 CmpLt(Float4 a, Float4 b)              { return _mm_cmplt_ps(a, b); }
+    static inline Float4 Or(Float4 a, Float4 b)                 { return _mm_or_ps(a, b); }
+    static inline Float4 And(Float4 a, Float4 b)                { return _mm_and_ps(a, b); }
+    // Returns the top bit of each lane in the lower four bits
+    static inline uint32_t MoveMask(Float4 v)                   { return (uint32_t)_mm_movemask_ps(v); }
+
+    // Broadcast lane i of v to all lanes
+    template <int i>
+    static inline Float4 SplatLane(Float4 v)                    { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i)); }
+
+    static inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+    // Truncates eight floats towards zero and stores them as int16, saturating
+    static inline void StoreS16(int16_t* p, Float4 lo, Float4 hi)
+    {
+        _mm_storeu_si128((__m128i*)p, _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi)));
+    }
+
+    // Loads four int16 and converts them to float
+    static inline Float4 LoadS16(const int16_t* p)
+    {
+        __m128i v = _mm_loadl_epi64((const __m128i*)p);
+        return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+    }
+
+    // Interleaves the lanes of a and b: (a0, b0, a1, b1) and (a2, b2, a3, b3)
+    static inline Float4 ZipLo(Float4 a, Float4 b)              { return _mm_unpacklo_ps(a, b); }
+    static inline Float4 ZipHi(Float4 a, Float4 b)              { return _mm_unpackhi_ps(a, b); }
+
+#elif defined(DM_SIMD_NEON)
+
+    typedef float32x4_t Float4;
+
+    static inline Float4 Load(const float* p)                   { return vld1q_f32(p); }
+    static inline void   Store(float* p, Float4 v)              { vst1q_f32(p, v); }
+    static inline Float4 Splat(float v)                         { return vdupq_n_f32(v); }
+    static inline Float4 Set(float x, float y, float z, float w){ float v[4] = {x, y, z, w}; return vld1q_f32(v); }
+    static inline Float4 Add(Float4 a, Float4 b)                { return vaddq_f32(a, b); }
+    static inline Float4 Sub(Float4 a, Float4 b)                { return vsubq_f32(a, b); }
+    static inline Float4 Mul(Float4 a, Float4 b)                { return vmulq_f32(a, b); }
+    static inline Float4 Min(Float4 a, Float4 b)                { return vminq_f32(a, b); }
+    static inline Float4 Max(Float4 a, Float4 b)                { return vmaxq_f32(a, b); }
+#if defined(__aarch64__) || defined(_M_ARM64)
+    static inline Float4 Sqrt(Float4 v)                         { return vsqrtq_f32(v); }
+#else
+    // ARMv7 NEON has no exact square root
+    static inline Float4 Sqrt(Float4 v)
+    {
+        float t[4];
+        vst1q_f32(t, v);
+        t[0] = sqrtf(t[0]); t[1] = sqrtf(t[1]); t[2] = sqrtf(t[2]); t[3] = sqrtf(t[3]);
+        return vld1q_f32(t);
+    }
+#endif
+
+    // Comparisons return a mask with all bits set in the lanes where the comparison is true
+    static inline Float4 CmpLt(Float4 a, Float4 b)              { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    static inline Float4 Or(Float4 a, Float4 b)                 { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    static inline Float4 And(Float4 a, Float4 b)                { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    // Returns the top bit of each lane in the lower four bits
+    static inline uint32_t MoveMask(Float4 v)
+    {
+        uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(v), 31);
+        return vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1) | (vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3);
+    }
+
+    // Broadcast lane i of v to all lanes
+    template <int i>
+    static inline Float4 SplatLane(Float4 v)                    { return vdupq_n_f32(vgetq_lane_f32(v, i)); }
+
+    static inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+    {
+        float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    // Truncates eight floats towards zero and stores them as int16, saturating
+    static inline void StoreS16(int16_t* p, Float4 lo, Float4 hi)
+    {
+        vst1q_s16(p, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+    }
+
+    // Loads four int16 and converts them to float
+    static inline Float4 LoadS16(const int16_t* p)              { return vcvtq_f32_s32(vmovl_s16(vld1_s16(p))); }
+
+    // Interleaves the lanes of a and b: (a0, b0, a1, b1) and (a2, b2, a3, b3)
+    static inline Float4 ZipLo(Float4 a, Float4 b)              { return vzipq_f32(a, b).val[0]; }
+    static inline Float4 ZipHi(Float4 a, Float4 b)              { return vzipq_f32(a, b).val[1]; }
+
+#endif
+}
+
+#endif // DM_SIMD
+
+#endif // DM_SIMD_H
@@ -14,7 +14,7 @@
 
 #include <assert.h>
 #include <dlib/profile/profile.h>
-#include <dmsdk/dlib/thread.h>
+#include <dlib/thread.h>
 
 #if defined(_WIN32)
 #include <stdlib.h>
@@ -102,9 +102,14 @@ namespace dmThread
     }
 
     TlsKey AllocTls()
+    {
+        return AllocTls(0);
+    }
+
+    TlsKey AllocTls(TlsDestructor destructor)
     {
         pthread_key_t key;
-        int ret = pthread_key_create(&key, 0);
+        int ret = pthread_key_create(&key, destructor);
         assert(ret == 0);
         return key;
     }
@@ -194,25 +199,96 @@ namespace dmThread
         CloseHandle(thread);
     }
 
+    // TlsAlloc doesn't support destructors, so keys with a destructor use fiber local storage instead
+    // (equivalent to thread local storage without fibers), and are tagged with FLS_KEY_BIT.
+    // The FLS callback has a different calling convention than TlsDestructor, and only gets the value,
+    // so the value is stored in a record with the destructor and FlsDestructorTrampoline calls it.
+    static const DWORD FLS_KEY_BIT = 0x80000000;
+
+    struct FlsValue
+    {
+        TlsDestructor m_Destructor;
+        void*         m_Value;
+    };
+
+    static TlsDestructor g_FlsDestructors[FLS_MAXIMUM_AVAILABLE];
+
+    static void NTAPI FlsDestructorTrampoline(void* data)
+    {
+        FlsValue* fls_value = (FlsValue*) data;
+        if (fls_value)
+        {
+            fls_value->m_Destructor(fls_value->m_Value);
+            delete fls_value;
+        }
+    }
+
     TlsKey AllocTls()
     {
         return TlsAlloc();
     }
 
+    TlsKey AllocTls(TlsDestructor destructor)
+    {
+        if (!destructor)
+            return TlsAlloc();
+
+        DWORD index = FlsAlloc(FlsDestructorTrampoline);
+        assert(index != FLS_OUT_OF_INDEXES);
+        assert(index < FLS_MAXIMUM_AVAILABLE);
+        g_FlsDestructors[index] = destructor;
+        return index | FLS_KEY_BIT;
+    }
+
     void FreeTls(TlsKey key)
     {
-        BOOL ret = TlsFree(key);
+        BOOL ret;
+        if (key & FLS_KEY_BIT)
+            ret = FlsFree(key & ~FLS_KEY_BIT);
+        else
+            ret = TlsFree(key);
         assert(ret);
     }
 
     void SetTlsValue(TlsKey key, void* value)
     {
-        BOOL ret = TlsSetValue(key, value);
+        BOOL ret;
+        if (key & FLS_KEY_BIT)
+        {
+            DWORD index = key & ~FLS_KEY_BIT;
+            FlsValue* fls_value = (FlsValue*) FlsGetValue(index);
+            if (value == 0)
+            {
+                ret = FlsSetValue(index, 0);
+                delete fls_value;
+            }
+            else if (fls_value == 0)
+            {
+                fls_value = new FlsValue;
+                fls_value->m_Destructor = g_FlsDestructors[index];
+                fls_value->m_Value = value;
+                ret = FlsSetValue(index, fls_value);
+            }
+            else
+            {
+                fls_value->m_Value = value;
+                ret = TRUE;
+            }
+        }
+        else
+        {
+            ret = TlsSetValue(key, value);
+        }
         assert(ret);
     }
 
     void* GetTlsValue(TlsKey key)
     {
+        if (key & FLS_KEY_BIT)
+        {
+            FlsValue* fls_value = (FlsValue*) FlsGetValue(key & ~FLS_KEY_BIT);
+            return fls_value ? fls_value->m_Value : 0;
+        }
         return TlsGetValue(key);
     }
 
@@ -17,4 +17,21 @@
 
 #include <dmsdk/dlib/thread.h>
 
+namespace dmThread
+{
+    /**
+     * Function called with the value of a thread local storage key when a thread exits
+     * @param value Value of the exiting thread, never 0
+     */
+    typedef void (*TlsDestructor)(void* value);
+
+    /**
+     * Allocate thread local storage key, with a destructor called when a thread with a value set exits.
+     * Whether the destructor is called for the values left when the key is freed differs between platforms.
+     * @param destructor Destructor
+     * @return Key
+     */
+    TlsKey AllocTls(TlsDestructor destructor);
+}
+
 #endif // DM_THREAD_H
@@ -0,0 +1,197 @@
+// Copyright 2020-2022 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <math.h>
+#include "transform.h"
+#include "simd.h"
+
+namespace dmTransform
+{
+    using namespace dmVMath;
+
+    static inline Matrix4 ToMatrix4(const Vector3& translation, const Quat& rotation, const Vector3& scale)
+    {
+        Matrix4 res(rotation, translation);
+        return appendScale(res, scale);
+    }
+
+#if defined(DM_SIMD)
+
+    using dmSimd::Float4;
+
+    // The batch kernels below mirror the operation order of the scalar vectormath code,
+    // to produce the same results as ToMatrix4 and Matrix4::operator*
+
+    // Calculates the local matrices of four transforms, as columns: cols[matrix*4 + column]
+    static inline void ToMatrix4x4(const Vector3* translations, const Quat* rotations, const Vector3* scales, const uint32_t* indices, Float4* cols)
+    {
+        Float4 qx = dmSimd::Load((const float*)&rotations[indices[0]]);
+        Float4 qy = dmSimd::Load((const float*)&rotations[indices[1]]);
+        Float4 qz = dmSimd::Load((const float*)&rotations[indices[2]]);
+        Float4 qw = dmSimd::Load((const float*)&rotations[indices[3]]);
+        dmSimd::Transpose(qx, qy, qz, qw);
+
+        Float4 sx = dmSimd::Load((const float*)&scales[indices[0]]);
+        Float4 sy = dmSimd::Load((const float*)&scales[indices[1]]);
+        Float4 sz = dmSimd::Load((const float*)&scales[indices[2]]);
+        Float4 sw = dmSimd::Load((const float*)&scales[indices[3]]);
+        dmSimd::Transpose(sx, sy, sz, sw);
+
+        Float4 tx = dmSimd::Load((const float*)&translations[indices[0]]);
+        Float4 ty = dmSimd::Load((const float*)&translations[indices[1]]);
+        Float4 tz = dmSimd::Load((const float*)&translations[indices[2]]);
+        Float4 tw = dmSimd::Load((const float*)&translations[indices[3]]);
+        dmSimd::Transpose(tx, ty, tz, tw);
+
+        const Float4 one = dmSimd::Splat(1.0f);
+        const Float4 zero = dmSimd::Splat(0.0f);
+
+        Float4 qx2 = dmSimd::Add(qx, qx);
+        Float4 qy2 = dmSimd::Add(qy, qy);
+        Float4 qz2 = dmSimd::Add(qz, qz);
+        Float4 qxqx2 = dmSimd::Mul(qx, qx2);
+        Float4 qxqy2 = dmSimd::Mul(qx, qy2);
+        Float4 qxqz2 = dmSimd::Mul(qx, qz2);
+        Float4 qxqw2 = dmSimd::Mul(qw, qx2);
+        Float4 qyqy2 = dmSimd::Mul(qy, qy2);
+        Float4 qyqz2 = dmSimd::Mul(qy, qz2);
+        Float4 qyqw2 = dmSimd::Mul(qw, qy2);
+        Float4 qzqz2 = dmSimd::Mul(qz, qz2);
+        Float4 qzqw2 = dmSimd::Mul(qw, qz2);
+
+        Float4 c0x = dmSimd::Mul(dmSimd::Sub(dmSimd::Sub(one, qyqy2), qzqz2), sx);
+        Float4 c0y = dmSimd::Mul(dmSimd::Add(qxqy2, qzqw2), sx);
+        Float4 c0z = dmSimd::Mul(dmSimd::Sub(qxqz2, qyqw2), sx);
+        Float4 c0w = dmSimd::Mul(zero, sx);
+        Float4 c1x = dmSimd::Mul(dmSimd::Sub(qxqy2, qzqw2), sy);
+        Float4 c1y = dmSimd::Mul(dmSimd::Sub(dmSimd::Sub(one, qxqx2), qzqz2), sy);
+        Float4 c1z = dmSimd::Mul(dmSimd::Add(qyqz2, qxqw2), sy);
+        Float4 c1w = dmSimd::Mul(zero, sy);
+        Float4 c2x = dmSimd::Mul(dmSimd::Add(qxqz2, qyqw2), sz);
+        Float4 c2y = dmSimd::Mul(dmSimd::Sub(qyqz2, qxqw2), sz);
+        Float4 c2z = dmSimd::Mul(dmSimd::Sub(dmSimd::Sub(one, qxqx2), qyqy2), sz);
+        Float4 c2w = dmSimd::Mul(zero, sz);
+        tw = one;
+
+        dmSimd::Transpose(c0x, c0y, c0z, c0w);
+        dmSimd::Transpose(c1x, c1y, c1z, c1w);
+        dmSimd::Transpose(c2x, c2y, c2z, c2w);
+        dmSimd::Transpose(tx, ty, tz, tw);
+
+        cols[0] = c0x; cols[1] = c1x; cols[2] = c2x; cols[3] = tx;
+        cols[4] = c0y; cols[5] = c1y; cols[6] = c2y; cols[7] = ty;
+        cols[8] = c0z; cols[9] = c1z; cols[10] = c2z; cols[11] = tz;
+        cols[12] = c0w; cols[13] = c1w; cols[14] = c2w; cols[15] = tw;
+    }
+
+    static inline void StoreMatrix(Matrix4* out, const Float4* cols)
+    {
+        float* m = (float*)out;
+        dmSimd::Store(m + 0, cols[0]);
+        dmSimd::Store(m + 4, cols[1]);
+        dmSimd::Store(m + 8, cols[2]);
+        dmSimd::Store(m + 12, cols[3]);
+    }
+
+    // m * v, where the matrix columns are p0..p3
+    static inline Float4 MulColumn(Float4 p0, Float4 p1, Float4 p2, Float4 p3, Float4 v)
+    {
+        Float4 r = dmSimd::Mul(p0, dmSimd::SplatLane<0>(v));
+        r = dmSimd::Add(r, dmSimd::Mul(p1, dmSimd::SplatLane<1>(v)));
+        r = dmSimd::Add(r, dmSimd::Mul(p2, dmSimd::SplatLane<2>(v)));
+        return dmSimd::Add(r, dmSimd::Mul(p3, dmSimd::SplatLane<3>(v)));
+    }
+
+    static inline void MulParent(const Matrix4& parent, const Float4* local, bool scale_along_z, Matrix4* out)
+    {
+        const float* p = (const float*)&parent;
+        Float4 p0 = dmSimd::Load(p + 0);
+        Float4 p1 = dmSimd::Load(p + 4);
+        Float4 p2 = dmSimd::Load(p + 8);
+        Float4 p3 = dmSimd::Load(p + 12);
+
+        Float4 res[4];
+        res[0] = MulColumn(p0, p1, p2, p3, local[0]);
+        res[1] = MulColumn(p0, p1, p2, p3, local[1]);
+        res[2] = MulColumn(p0, p1, p2, p3, local[2]);
+        if (!scale_along_z)
+        {
+            // See NormalizeZScale
+            float z_mag_sqr = p[8] * p[8] + p[9] * p[9] + p[10] * p[10] + p[11] * p[11];
+            if (z_mag_sqr > 0.0f)
+            {
+                p2 = dmSimd::Mul(p2, dmSimd::Splat(1.0f / sqrtf(z_mag_sqr)));
+            }
+        }
+        res[3] = MulColumn(p0, p1, p2, p3, local[3]);
+        StoreMatrix(out, res);
+    }
+
+#endif
+
+    void ToMatrix4Batch(const Vector3* translations, const Quat* rotations, const Vector3* scales,
+                        const uint32_t* indices, uint32_t count, Matrix4* out)
+    {
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        Float4 cols[16];
+        for (; i + 4 <= count; i += 4)
+        {
+            const uint32_t* batch = indices + i;
+            ToMatrix4x4(translations, rotations, scales, batch, cols);
+            StoreMatrix(&out[batch[0]], &cols[0]);
+            StoreMatrix(&out[batch[1]], &cols[4]);
+            StoreMatrix(&out[batch[2]], &cols[8]);
+            StoreMatrix(&out[batch[3]], &cols[12]);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            uint32_t index = indices[i];
+            out[index] = ToMatrix4(translations[index], rotations[index], scales[index]);
+        }
+    }
+
+    void MulParentBatch(const Vector3* translations, const Quat* rotations, const Vector3* scales,
+                        const uint32_t* indices, const uint32_t* parent_indices, uint32_t count, bool scale_along_z, Matrix4* out)
+    {
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        Float4 cols[16];
+        for (; i + 4 <= count; i += 4)
+        {
+            const uint32_t* batch = indices + i;
+            const uint32_t* parents = parent_indices + i;
+            ToMatrix4x4(translations, rotations, scales, batch, cols);
+            MulParent(out[parents[0]], &cols[0], scale_along_z, &out[batch[0]]);
+            MulParent(out[parents[1]], &cols[4], scale_along_z, &out[batch[1]]);
+            MulParent(out[parents[2]], &cols[8], scale_along_z, &out[batch[2]]);
+            MulParent(out[parents[3]], &cols[12], scale_along_z, &out[batch[3]]);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            uint32_t index = indices[i];
+            Matrix4 local = ToMatrix4(translations[index], rotations[index], scales[index]);
+            if (scale_along_z)
+            {
+                out[index] = out[parent_indices[i]] * local;
+            }
+            else
+            {
+                out[index] = MulNoScaleZ(out[parent_indices[i]], local);
+            }
+        }
+    }
+}
@@ -16,6 +16,7 @@
 #define DM_TRANSFORM_H
 
 #include <assert.h>
+#include <stdint.h>
 #include <dmsdk/dlib/transform.h>
 #include <dmsdk/dlib/vmath.h>
 
@@ -179,6 +180,36 @@ namespace dmTransform
         res = appendScale(res, dmVMath::Vector3(t.GetScale()));
         return res;
     }
+
+    /**
+     * Convert a batch of transforms, stored as separate translation, rotation and scale arrays, into 4-dim matrices.
+     * For each index in indices: out[index] = ToMatrix4(Transform(translations[index], rotations[index], scales[index]))
+     * The result is bit exact with ToMatrix4.
+     * @param translations Translations
+     * @param rotations Rotations
+     * @param scales Scales
+     * @param indices Indices of the transforms to convert
+     * @param count Number of indices
+     * @param out Output matrices, indexed the same way as the input arrays
+     */
+    void ToMatrix4Batch(const dmVMath::Vector3* translations, const dmVMath::Quat* rotations, const dmVMath::Vector3* scales,
+                        const uint32_t* indices, uint32_t count, dmVMath::Matrix4* out);
+
+    /**
+     * Same as ToMatrix4Batch, but each result is also transformed by the matrix of its parent, read from the output array:
+     * out[index] = out[parent] * local, or MulNoScaleZ(out[parent], local) when scale_along_z is false.
+     * A parent must not be part of the same batch.
+     * @param translations Translations
+     * @param rotations Rotations
+     * @param scales Scales
+     * @param indices Indices of the transforms to convert
+     * @param parent_indices Index of the parent of each entry in indices
+     * @param count Number of indices
+     * @param scale_along_z If the translation should be affected by the z-scale of the parent
+     * @param out Output matrices, indexed the same way as the input arrays
+     */
+    void MulParentBatch(const dmVMath::Vector3* translations, const dmVMath::Quat* rotations, const dmVMath::Vector3* scales,
+                        const uint32_t* indices, const uint32_t* parent_indices, uint32_t count, bool scale_along_z, dmVMath::Matrix4* out);
 }
 
 #endif // DM_TRANSFORM_H
@@ -15,6 +15,7 @@
 #ifndef DMSDK_INTERSECTION_H
 #define DMSDK_INTERSECTION_H
 
+#include <stdint.h>
 #include <dmsdk/dlib/vmath.h>
 
 /*# Intersection math structs and functions
@@ -44,6 +45,10 @@ namespace dmIntersection
     bool TestFrustumSphere(const Frustum& frustum, const dmVMath::Point3& pos, float radius, bool skip_near_far);
     bool TestFrustumSphere(const Frustum& frustum, const dmVMath::Vector4& pos, float radius, bool skip_near_far);
 
+    // Tests a batch of spheres, given as (x, y, z, radius), and writes the result of each test to `results`.
+    // Gives the same results as TestFrustumSphere, but tests four spheres at a time where SIMD is available.
+    void TestFrustumSpheres(const Frustum& frustum, const dmVMath::Vector4* spheres, uint32_t count, bool skip_near_far, bool* results);
+
 } // dmIntersection
 
 #endif // DMSDK_INTERSECTION_H
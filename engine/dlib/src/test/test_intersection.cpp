@@ -105,6 +105,47 @@ TEST(dmVMath, TestFrustumSphere)
 
 }
 
+TEST(dmVMath, TestFrustumSpheres)
+{
+    dmVMath::Matrix4 proj = dmVMath::Matrix4::orthographic(0.0f, FRUSTUM_WIDTH, 0.0f, FRUSTUM_HEIGHT, FRUSTUM_NEAR, FRUSTUM_FAR);
+
+    dmIntersection::Frustum frustum;
+    dmIntersection::CreateFrustumFromMatrix(proj, true, frustum);
+
+    // A grid of spheres of varying size, both inside, outside and on the edges of the frustum
+    const uint32_t count = 7 * 7 * 7;
+    dmVMath::Vector4 spheres[count];
+    bool results[count];
+    uint32_t n = 0;
+    for (int z = 0; z < 7; ++z)
+    {
+        for (int y = 0; y < 7; ++y)
+        {
+            for (int x = 0; x < 7; ++x)
+            {
+                float radius = (float)((x + y + z) % 4) * 5.0f;
+                spheres[n++] = dmVMath::Vector4(-20.0f + x * 25.0f, -20.0f + y * 20.0f, 10.0f - z * 25.0f, radius);
+            }
+        }
+    }
+
+    for (uint32_t skip_near_far = 0; skip_near_far < 2; ++skip_near_far)
+    {
+        // Odd count, to also test the remainder
+        dmIntersection::TestFrustumSpheres(frustum, spheres, count, skip_near_far != 0, results);
+
+        uint32_t num_inside = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            bool expected = dmIntersection::TestFrustumSphere(frustum, dmVMath::Point3(spheres[i].getXYZ()), spheres[i].getW(), skip_near_far != 0);
+            ASSERT_EQ(expected, results[i]);
+            num_inside += results[i] ? 1 : 0;
+        }
+        ASSERT_LT(0U, num_inside);
+        ASSERT_GT(count, num_inside);
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
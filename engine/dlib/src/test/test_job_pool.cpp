@@ -0,0 +1,161 @@
+// Copyright 2020-2022 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#include <string.h>
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+#include <dlib/atomic.h>
+#include <dlib/job_pool.h>
+#include <dlib/mutex.h>
+#include <dlib/condition_variable.h>
+#include <dlib/time.h>
+
+static const uint32_t JOB_COUNT = 1000;
+
+struct RunContext
+{
+    uint32_t        m_Counts[JOB_COUNT];
+    int32_atomic_t  m_Total;
+};
+
+static void CountJob(void* context, uint32_t index)
+{
+    RunContext* ctx = (RunContext*)context;
+    ctx->m_Counts[index]++;
+    dmAtomicIncrement32(&ctx->m_Total);
+}
+
+static void RunAndCheck(dmJobPool::HJobPool pool)
+{
+    RunContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    dmJobPool::Run(pool, CountJob, &ctx, JOB_COUNT);
+    ASSERT_EQ((int32_t)JOB_COUNT, dmAtomicAdd32(&ctx.m_Total, 0));
+    for (uint32_t i = 0; i < JOB_COUNT; ++i)
+    {
+        ASSERT_EQ(1U, ctx.m_Counts[i]);
+    }
+}
+
+TEST(JobPool, NoThreads)
+{
+    dmJobPool::HJobPool pool = dmJobPool::New(0);
+    ASSERT_EQ((dmJobPool::HJobPool)0x0, pool);
+    ASSERT_EQ(0U, dmJobPool::GetThreadCount(pool));
+    RunAndCheck(pool);
+    ASSERT_FALSE(dmJobPool::Push(pool, CountJob, 0x0, 0));
+    dmJobPool::Delete(pool);
+}
+
+TEST(JobPool, Run)
+{
+    dmJobPool::HJobPool pool = dmJobPool::New(4);
+    ASSERT_EQ(4U, dmJobPool::GetThreadCount(pool));
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        RunAndCheck(pool);
+    }
+    dmJobPool::Delete(pool);
+}
+
+TEST(JobPool, MaxThreads)
+{
+    dmJobPool::HJobPool pool = dmJobPool::New(dmJobPool::MAX_THREAD_COUNT + 1);
+    ASSERT_EQ(dmJobPool::MAX_THREAD_COUNT, dmJobPool::GetThreadCount(pool));
+    dmJobPool::Delete(pool);
+}
+
+struct NestedContext
+{
+    dmJobPool::HJobPool m_Pool;
+    RunContext          m_Inner[4];
+};
+
+static void NestedJob(void* context, uint32_t index)
+{
+    NestedContext* ctx = (NestedContext*)context;
+    dmJobPool::Run(ctx->m_Pool, CountJob, &ctx->m_Inner[index], JOB_COUNT);
+}
+
+// Jobs may run jobs of their own, the calling thread always takes part
+TEST(JobPool, RunNested)
+{
+    NestedContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.m_Pool = dmJobPool::New(2);
+    dmJobPool::Run(ctx.m_Pool, NestedJob, &ctx, 4);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQ((int32_t)JOB_COUNT, dmAtomicAdd32(&ctx.m_Inner[i].m_Total, 0));
+    }
+    dmJobPool::Delete(ctx.m_Pool);
+}
+
+struct PushContext
+{
+    dmMutex::HMutex                         m_Mutex;
+    dmConditionVariable::HConditionVariable m_DoneCond;
+    uint32_t                                m_Done;
+    uint32_t                                m_IndexSum;
+};
+
+static void PushJob(void* context, uint32_t index)
+{
+    PushContext* ctx = (PushContext*)context;
+    DM_MUTEX_SCOPED_LOCK(ctx->m_Mutex);
+    ctx->m_Done++;
+    ctx->m_IndexSum += index;
+    dmConditionVariable::Broadcast(ctx->m_DoneCond);
+}
+
+TEST(JobPool, Push)
+{
+    dmJobPool::HJobPool pool = dmJobPool::New(2);
+    PushContext ctx;
+    ctx.m_Mutex = dmMutex::New();
+    ctx.m_DoneCond = dmConditionVariable::New();
+    ctx.m_Done = 0;
+    ctx.m_IndexSum = 0;
+
+    // More than the initial capacity of the queue
+    const uint32_t count = 100;
+    uint32_t index_sum = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_TRUE(dmJobPool::Push(pool, PushJob, &ctx, i));
+        index_sum += i;
+    }
+    // Runs alongside the posted jobs
+    RunAndCheck(pool);
+
+    {
+        DM_MUTEX_SCOPED_LOCK(ctx.m_Mutex);
+        while (ctx.m_Done < count)
+        {
+            dmConditionVariable::Wait(ctx.m_DoneCond, ctx.m_Mutex);
+        }
+    }
+    ASSERT_EQ(index_sum, ctx.m_IndexSum);
+
+    dmJobPool::Delete(pool);
+    dmConditionVariable::Delete(ctx.m_DoneCond);
+    dmMutex::Delete(ctx.m_Mutex);
+}
+
+int main(int argc, char **argv)
+{
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
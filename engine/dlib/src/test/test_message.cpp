@@ -357,6 +357,97 @@ TEST(dmMessage, ThreadTest2)
     ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
 }
 
+struct BenchProducer
+{
+    dmMessage::URL  m_Receiver;
+    uint32_t        m_Count;
+};
+
+static void BenchPostThread(void* arg)
+{
+    BenchProducer* producer = (BenchProducer*) arg;
+    CustomMessageData1 message_data1;
+    for (uint32_t i = 0; i < producer->m_Count; ++i)
+    {
+        message_data1.m_MyValue = i;
+        dmMessage::Post(0x0, &producer->m_Receiver, m_HashMessage1, 0, 0x0, &message_data1, sizeof(CustomMessageData1), 0);
+    }
+}
+
+TEST(dmMessage, BenchThreads)
+{
+    const uint32_t message_count = 1024 * 64;
+    const uint32_t PRODUCER_COUNTS[] = {1, 4, 16};
+    const uint32_t MAX_PRODUCERS = 16;
+
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(&receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket));
+
+    for (uint32_t n = 0; n < sizeof(PRODUCER_COUNTS) / sizeof(PRODUCER_COUNTS[0]); ++n)
+    {
+        uint32_t producer_count = PRODUCER_COUNTS[n];
+        BenchProducer producer;
+        producer.m_Receiver = receiver;
+        producer.m_Count = message_count / producer_count;
+
+        uint64_t start = dmTime::GetTime();
+        dmThread::Thread threads[MAX_PRODUCERS];
+        for (uint32_t i = 0; i < producer_count; ++i)
+        {
+            threads[i] = dmThread::New(&BenchPostThread, 0x80000, (void*) &producer, "bench_post");
+        }
+
+        uint32_t count = 0;
+        while (count < message_count)
+        {
+            count += dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0);
+        }
+
+        for (uint32_t i = 0; i < producer_count; ++i)
+        {
+            dmThread::Join(threads[i]);
+        }
+        uint64_t end = dmTime::GetTime();
+        ASSERT_EQ(message_count, count);
+        ASSERT_EQ(0u, dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0));
+
+        double seconds = (end - start) / 1000000.0;
+        printf("BenchThreads %2u producers: %f ms (%.0f messages/s)\n", producer_count, (end - start) / 1000.0, message_count / (seconds > 0.0 ? seconds : 0.000001));
+    }
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
+static void PostAndExitThread(void* arg)
+{
+    dmMessage::URL* receiver = (dmMessage::URL*) arg;
+    CustomMessageData1 message_data1;
+    message_data1.m_MyValue = 1;
+    dmMessage::Post(0x0, receiver, m_HashMessage1, 0, 0x0, &message_data1, sizeof(CustomMessageData1), 0);
+}
+
+// The allocator of a thread is released when it exits, while its messages are still queued
+TEST(dmMessage, ThreadExit)
+{
+    const uint32_t thread_count = 64;
+
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(&receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket));
+
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        dmThread::Thread thread = dmThread::New(&PostAndExitThread, 0x80000, (void*) &receiver, "post_exit");
+        dmThread::Join(thread);
+    }
+
+    ASSERT_EQ(thread_count, dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0));
+    ASSERT_EQ(0u, dmMessage::Dispatch(receiver.m_Socket, HandleMessage, 0));
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
 void HandleIntegrityMessage(dmMessage::Message *message_object, void *user_ptr)
 {
     dmhash_t hash = dmHashBuffer64(message_object->m_Data, message_object->m_DataSize);
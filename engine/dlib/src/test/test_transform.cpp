@@ -14,6 +14,7 @@
 
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
+#include <string.h>
 #include "dlib/transform.h"
 #include "dlib/math.h"
 
@@ -211,6 +212,89 @@ TEST(dmTransform, Inverse)
     ASSERT_TRANSFORM_NEAR(i, Mul(Inv(t0), t0));
 }
 
+static void MakeTransforms(uint32_t count, Vector3* translations, Quat* rotations, Vector3* scales)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float f = (float)i;
+        translations[i] = Vector3(f, -2.0f * f, 0.5f * f + 1.0f);
+        rotations[i] = normalize(Quat(0.1f * f, 0.3f, -0.2f * f, 1.0f));
+        scales[i] = Vector3(1.0f + f, 0.5f, (i % 3) == 0 ? -2.0f : 3.0f);
+    }
+}
+
+static bool MatrixEquals(const Matrix4& a, const Matrix4& b)
+{
+    return memcmp(&a, &b, sizeof(Matrix4)) == 0;
+}
+
+TEST(dmTransform, ToMatrix4Batch)
+{
+    const uint32_t count = 11;
+    Vector3 translations[count];
+    Quat rotations[count];
+    Vector3 scales[count];
+    MakeTransforms(count, translations, rotations, scales);
+
+    // Every other transform, in reverse order
+    uint32_t indices[count];
+    uint32_t index_count = 0;
+    for (int32_t i = count - 1; i >= 0; i -= 2)
+        indices[index_count++] = i;
+
+    Matrix4 out[count];
+    for (uint32_t i = 0; i < count; ++i)
+        out[i] = Matrix4(Vector4(0.0f), Vector4(0.0f), Vector4(0.0f), Vector4(0.0f));
+    ToMatrix4Batch(translations, rotations, scales, indices, index_count, out);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            Matrix4 expected = ToMatrix4(Transform(translations[i], rotations[i], scales[i]));
+            ASSERT_TRUE(MatrixEquals(expected, out[i]));
+        }
+        else
+        {
+            ASSERT_TRUE(MatrixEquals(Matrix4(Vector4(0.0f), Vector4(0.0f), Vector4(0.0f), Vector4(0.0f)), out[i]));
+        }
+    }
+}
+
+TEST(dmTransform, MulParentBatch)
+{
+    const uint32_t count = 14;
+    Vector3 translations[count];
+    Quat rotations[count];
+    Vector3 scales[count];
+    MakeTransforms(count, translations, rotations, scales);
+
+    // The first 4 are parents, the remaining 10 children
+    const uint32_t parent_count = 4;
+    uint32_t indices[count];
+    uint32_t parent_indices[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        indices[i] = i;
+        parent_indices[i] = i % parent_count;
+    }
+
+    for (uint32_t scale_along_z = 0; scale_along_z < 2; ++scale_along_z)
+    {
+        Matrix4 out[count];
+        ToMatrix4Batch(translations, rotations, scales, indices, parent_count, out);
+        MulParentBatch(translations, rotations, scales, indices + parent_count, parent_indices + parent_count, count - parent_count, scale_along_z != 0, out);
+
+        for (uint32_t i = parent_count; i < count; ++i)
+        {
+            Matrix4 parent = ToMatrix4(Transform(translations[parent_indices[i]], rotations[parent_indices[i]], scales[parent_indices[i]]));
+            Matrix4 local = ToMatrix4(Transform(translations[i], rotations[i], scales[i]));
+            Matrix4 expected = scale_along_z ? parent * local : MulNoScaleZ(parent, local);
+            ASSERT_TRUE(MatrixEquals(expected, out[i]));
+        }
+    }
+}
+
 #undef EPSILON
 #undef ASSERT_V3_NEAR
 #undef ASSERT_V4_NEAR
@@ -221,6 +221,7 @@ namespace dmEngine
     Engine::Engine(dmEngineService::HEngineService engine_service)
     : m_Config(0)
     , m_Alive(true)
+    , m_JobPool(0x0)
     , m_MainCollection(0)
     , m_LastReloadMTime(0)
     , m_MouseSensitivity(1.0f)
@@ -367,6 +368,8 @@ namespace dmEngine
                 dmPhysics::DeleteContext2D(engine->m_PhysicsContext.m_Context2D);
         }
 
+        dmJobPool::Delete(engine->m_JobPool);
+
         dmEngine::ExtensionAppParams app_params;
         app_params.m_ConfigFile = engine->m_Config;
         app_params.m_WebServer = dmEngineService::GetWebServer(engine->m_EngineService);
@@ -875,6 +878,7 @@ namespace dmEngine
         const uint32_t max_resources = dmConfigFile::GetInt(engine->m_Config, dmResource::MAX_RESOURCES_KEY, 1024);
         dmResource::NewFactoryParams params;
         params.m_MaxResources = max_resources;
+        params.m_LoaderThreadCount = dmConfigFile::GetInt(engine->m_Config, dmResource::LOADER_THREADS_KEY, 2);
         params.m_Flags = 0;
 
         dmResourceArchive::ClearArchiveLoaders(); // in case we've rebooted
@@ -949,6 +953,11 @@ namespace dmEngine
 
         dmHID::Init(engine->m_HidContext);
 
+#if !defined(__EMSCRIPTEN__)
+        engine->m_JobPool = dmJobPool::New(dmConfigFile::GetInt(engine->m_Config, "engine.job_thread_count", 0));
+#endif
+        dmGameObject::SetJobPool(engine->m_Register, engine->m_JobPool);
+
         dmSound::InitializeParams sound_params;
         sound_params.m_OutputDevice = "default";
 #if defined(__EMSCRIPTEN__)
@@ -956,6 +965,7 @@ namespace dmEngine
 #else
         sound_params.m_UseThread = dmConfigFile::GetInt(engine->m_Config, "sound.use_thread", 1) != 0;
 #endif
+        sound_params.m_JobPool = engine->m_JobPool;
         dmSound::Result soundInit = dmSound::Initialize(engine->m_Config, &sound_params);
         if (dmSound::RESULT_OK == soundInit) {
             dmLogInfo("Initialised sound device '%s'", sound_params.m_OutputDevice);
@@ -983,6 +993,7 @@ namespace dmEngine
         render_params.m_CommandBufferSize = 1024;
         render_params.m_ScriptContext = engine->m_RenderScriptContext;
         render_params.m_MaxDebugVertexCount = (uint32_t) dmConfigFile::GetInt(engine->m_Config, "graphics.max_debug_vertices", 10000);
+        render_params.m_JobPool = engine->m_JobPool;
         engine->m_RenderContext = dmRender::NewRenderContext(engine->m_GraphicsContext, render_params);
 
         dmGameObject::Initialize(engine->m_Register, engine->m_GOScriptContext);
@@ -992,6 +1003,7 @@ namespace dmEngine
         engine->m_ParticleFXContext.m_MaxParticleFXCount = dmConfigFile::GetInt(engine->m_Config, dmParticle::MAX_INSTANCE_COUNT_KEY, 64);
         engine->m_ParticleFXContext.m_MaxEmitterCount = dmConfigFile::GetInt(engine->m_Config, dmParticle::MAX_EMITTER_COUNT_KEY, 64);
         engine->m_ParticleFXContext.m_MaxParticleCount = dmConfigFile::GetInt(engine->m_Config, dmParticle::MAX_PARTICLE_COUNT_KEY, 1024);
+        engine->m_ParticleFXContext.m_JobPool = engine->m_JobPool;
         engine->m_ParticleFXContext.m_Debug = false;
 
         dmInput::NewContextParams input_params;
@@ -1041,6 +1053,7 @@ namespace dmEngine
         physics_params.m_Scale = dmConfigFile::GetFloat(engine->m_Config, "physics.scale", 1.0f);
         physics_params.m_RayCastLimit2D = dmConfigFile::GetInt(engine->m_Config, "physics.ray_cast_limit_2d", 64);
         physics_params.m_RayCastLimit3D = dmConfigFile::GetInt(engine->m_Config, "physics.ray_cast_limit_3d", 128);
+        physics_params.m_JobPool = engine->m_JobPool;
         physics_params.m_TriggerOverlapCapacity = dmConfigFile::GetInt(engine->m_Config, "physics.trigger_overlap_capacity", 16);
         physics_params.m_VelocityThreshold = dmConfigFile::GetFloat(engine->m_Config, "physics.velocity_threshold", 1.0f);
         if (physics_params.m_Scale < dmPhysics::MIN_SCALE || physics_params.m_Scale > dmPhysics::MAX_SCALE)
@@ -19,6 +19,7 @@
 
 #include <dlib/configfile.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_pool.h>
 #include <dlib/message.h>
 
 #include <resource/resource.h>
@@ -110,6 +111,8 @@ namespace dmEngine
         RunResult                                   m_RunResult;
         bool                                        m_Alive;
 
+        /// Worker threads shared by the engine systems, 0x0 if engine.job_thread_count is 0
+        dmJobPool::HJobPool                         m_JobPool;
         dmGameObject::HRegister                     m_Register;
         dmGameObject::HCollection                   m_MainCollection;
         dmArray<dmGameObject::InputAction>          m_InputBuffer;
@@ -650,6 +650,15 @@ namespace dmGameObject
      */
     const dmVMath::Matrix4& GetWorldMatrix(HInstance instance);
 
+    /*# get world transform version
+     * Get a counter that changes each time the world transform of the game object instance is recalculated.
+     * Components can use it to detect that their cached world data is out of date.
+     * @name GetWorldTransformVersion
+     * @param instance [type:dmGameObject::HInstance] Gameobject instance
+     * @return [type:uint32_t] World transform version
+     */
+    uint32_t GetWorldTransformVersion(HInstance instance);
+
     /*# get world transform
      * Get game object instance world transform
      * @name GetWorldTransform
@@ -21,6 +21,7 @@
 #include <script/script.h>
 
 #include "component.h"
+#include "gameobject_private.h"
 #include "gameobject_script.h"
 #include "gameobject_props_lua.h"
 
@@ -314,6 +315,9 @@ namespace dmGameObject
                 if (anim.m_Value != 0x0)
                 {
                     *anim.m_Value = v;
+                    // The value points directly into the instance transform
+                    if (anim.m_ComponentId == 0)
+                        SetTransformDirty(anim.m_Instance);
                 }
                 else
                 {
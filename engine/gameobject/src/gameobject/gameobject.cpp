@@ -40,6 +40,7 @@ DM_PROPERTY_GROUP(rmtp_GameObject, "Gameobjects");
 
 DM_PROPERTY_U32(rmtp_GOInstances, 0, FrameReset, "# alive go instances / frame", &rmtp_GameObject);
 DM_PROPERTY_U32(rmtp_GODeleted, 0, FrameReset, "# deleted instances / frame", &rmtp_GameObject);
+DM_PROPERTY_U32(rmtp_GOTransforms, 0, FrameReset, "# world transforms calculated / frame", &rmtp_GameObject);
 
 namespace dmGameObject
 {
@@ -164,6 +165,7 @@ namespace dmGameObject
         m_ComponentTypeCount = 0;
         m_DefaultCollectionCapacity = DEFAULT_MAX_COLLECTION_CAPACITY;
         m_DefaultInputStackCapacity = DEFAULT_MAX_INPUT_STACK_CAPACITY;
+        m_JobPool = 0x0;
         m_Mutex = dmMutex::New();
     }
 
@@ -197,6 +199,18 @@ namespace dmGameObject
         m_InstanceIndices.SetCapacity(max_instances);
         m_WorldTransforms.SetCapacity(max_instances);
         m_WorldTransforms.SetSize(max_instances);
+        m_WorldTransformVersions.SetCapacity(max_instances);
+        m_WorldTransformVersions.SetSize(max_instances);
+        m_Positions.SetCapacity(max_instances);
+        m_Positions.SetSize(max_instances);
+        m_Rotations.SetCapacity(max_instances);
+        m_Rotations.SetSize(max_instances);
+        m_Scales.SetCapacity(max_instances);
+        m_Scales.SetSize(max_instances);
+        m_TransformBatch.SetCapacity(max_instances);
+        m_TransformBatch.SetSize(max_instances);
+        m_TransformBatchParents.SetCapacity(max_instances);
+        m_TransformBatchParents.SetSize(max_instances);
         m_IDToInstance.SetCapacity(dmMath::Max(1U, max_instances/3), max_instances);
         m_InputFocusStack.SetCapacity(max_input_stack_entries);
         m_NameHash = 0;
@@ -224,6 +238,7 @@ namespace dmGameObject
 
         memset(&m_Instances[0], 0, sizeof(Instance*) * max_instances);
         memset(&m_WorldTransforms[0], 0xcc, sizeof(dmTransform::Transform) * max_instances);
+        memset(&m_WorldTransformVersions[0], 0, sizeof(uint32_t) * max_instances);
         memset(&m_LevelIndices[0], 0, sizeof(m_LevelIndices));
         memset(&m_ComponentInstanceCount[0], 0, sizeof(uint32_t) * MAX_COMPONENT_TYPES);
     }
@@ -249,6 +264,12 @@ namespace dmGameObject
         regist->m_DefaultInputStackCapacity = capacity;
     }
 
+    void SetJobPool(HRegister regist, dmJobPool::HJobPool pool)
+    {
+        assert(regist != 0x0);
+        regist->m_JobPool = pool;
+    }
+
     static uint32_t GetInputStackDefaultCapacity(HRegister regist)
     {
         assert(regist != 0x0);
@@ -617,12 +638,12 @@ namespace dmGameObject
          * Remove instance from m_LevelIndices using an erase-swap operation
          */
 
-        dmArray<uint16_t>& level = collection->m_LevelIndices[instance->m_Depth];
+        dmArray<uint32_t>& level = collection->m_LevelIndices[instance->m_Depth];
         assert(level.Size() > 0);
         assert(instance->m_LevelIndex < level.Size());
 
-        uint16_t level_index = instance->m_LevelIndex;
-        uint16_t swap_in_index = level.EraseSwap(level_index);
+        uint32_t level_index = instance->m_LevelIndex;
+        uint32_t swap_in_index = level.EraseSwap(level_index);
         HInstance swap_in_instance = collection->m_Instances[swap_in_index];
         assert(swap_in_instance->m_Index == swap_in_index);
         swap_in_instance->m_LevelIndex = level_index;
@@ -634,7 +655,7 @@ namespace dmGameObject
      * ** 10 elements as min
      * ** Up to max_instances as max
      */
-    static void ExpandLevel(dmArray<uint16_t>& level, uint32_t max_instances)
+    static void ExpandLevel(dmArray<uint32_t>& level, uint32_t max_instances)
     {
         const uint32_t min_offset = 10;
         const uint32_t max_offset = max_instances - level.Capacity();
@@ -647,12 +668,12 @@ namespace dmGameObject
         /*
          * Insert instance in m_LevelIndices at level set in instance->m_Depth
          */
-        dmArray<uint16_t>& level = collection->m_LevelIndices[instance->m_Depth];
+        dmArray<uint32_t>& level = collection->m_LevelIndices[instance->m_Depth];
         if (level.Full())
             ExpandLevel(level, collection->m_MaxInstances);
         assert(!level.Full());
 
-        uint16_t level_index = (uint16_t)level.Size();
+        uint32_t level_index = (uint32_t)level.Size();
         level.SetSize(level_index + 1);
         level[level_index] = instance->m_Index;
         instance->m_LevelIndex = level_index;
@@ -702,11 +723,15 @@ namespace dmGameObject
         HInstance instance = AllocInstance(proto, prototype_name);
         instance->m_Collection = collection;
         instance->m_ScaleAlongZ = collection->m_ScaleAlongZ;
-        uint16_t instance_index = collection->m_InstanceIndices.Pop();
+        uint32_t instance_index = collection->m_InstanceIndices.Pop();
         instance->m_Index = instance_index;
         assert(collection->m_Instances[instance_index] == 0);
         collection->m_Instances[instance_index] = instance;
 
+        dmTransform::Transform transform;
+        transform.SetIdentity();
+        SetLocalTransform(instance, transform);
+
         InsertInstanceInLevelIndex(collection, instance);
 
         return instance;
@@ -727,7 +752,7 @@ namespace dmGameObject
             Unlink(collection, instance);
         }
 
-        uint16_t instance_index = instance->m_Index;
+        uint32_t instance_index = instance->m_Index;
         operator delete ((void*)instance);
         collection->m_Instances[instance_index] = 0x0;
         collection->m_InstanceIndices.Push(instance_index);
@@ -976,8 +1001,8 @@ namespace dmGameObject
             return;
         }
         instance->m_ToBeAdded = 1;
-        uint16_t index = instance->m_Index;
-        uint16_t tail = collection->m_InstancesToAddTail;
+        uint32_t index = instance->m_Index;
+        uint32_t tail = collection->m_InstancesToAddTail;
         if (tail != INVALID_INSTANCE_INDEX) {
             HInstance tail_instance = collection->m_Instances[tail];
             tail_instance->m_NextToAdd = index;
@@ -1036,7 +1061,7 @@ namespace dmGameObject
             dmLogError("Instances can not be added to update during the update.");
             return false;
         }
-        uint16_t index = collection->m_InstancesToAddHead;
+        uint32_t index = collection->m_InstancesToAddHead;
         bool result = true;
         while (index != INVALID_INSTANCE_INDEX) {
             HInstance instance = collection->m_Instances[index];
@@ -1108,7 +1133,8 @@ namespace dmGameObject
         SetPosition(instance, position);
         SetRotation(instance, rotation);
         SetScale(instance, scale);
-        collection->m_WorldTransforms[instance->m_Index] = dmTransform::ToMatrix4(instance->m_Transform);
+        collection->m_WorldTransforms[instance->m_Index] = dmTransform::ToMatrix4(GetLocalTransform(instance));
+        collection->m_WorldTransformVersions[instance->m_Index]++;
 
         dmHashInit64(&instance->m_CollectionPathHashState, true);
         dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, ID_SEPARATOR, strlen(ID_SEPARATOR));
@@ -1195,7 +1221,7 @@ namespace dmGameObject
             if (scale.getX() == 0 && scale.getY() == 0 && scale.getZ() == 0)
                     scale = Vector3(instance_desc.m_Scale, instance_desc.m_Scale, instance_desc.m_Scale);
 
-            instance->m_Transform = dmTransform::Transform(Vector3(instance_desc.m_Position), instance_desc.m_Rotation, scale);
+            SetLocalTransform(instance, dmTransform::Transform(Vector3(instance_desc.m_Position), instance_desc.m_Rotation, scale));
             dmHashClone64(&instance->m_CollectionPathHashState, &prefixHashState, true);
 
             const char* path_end = strrchr(instance_desc.m_Id, *ID_SEPARATOR);
@@ -1285,11 +1311,12 @@ namespace dmGameObject
         {
             if (!GetParent(new_instances[i]))
             {
-                new_instances[i]->m_Transform = dmTransform::Mul(transform, new_instances[i]->m_Transform);
+                SetLocalTransform(new_instances[i], dmTransform::Mul(transform, GetLocalTransform(new_instances[i])));
             }
 
             // world transforms need to be up to date in time for the script init calls
-            collection->m_WorldTransforms[new_instances[i]->m_Index] = dmTransform::ToMatrix4(new_instances[i]->m_Transform);
+            collection->m_WorldTransforms[new_instances[i]->m_Index] = dmTransform::ToMatrix4(GetLocalTransform(new_instances[i]));
+            collection->m_WorldTransformVersions[new_instances[i]->m_Index]++;
         }
 
         // Create components and set properties
@@ -1627,22 +1654,24 @@ namespace dmGameObject
 
             // Update world transforms since some components might need them in their init-callback
             Matrix4* trans = &collection->m_WorldTransforms[instance->m_Index];
+            Matrix4 local = dmTransform::ToMatrix4(GetLocalTransform(instance));
             if (instance->m_Parent == INVALID_INSTANCE_INDEX)
             {
-                *trans = dmTransform::ToMatrix4(instance->m_Transform);
+                *trans = local;
             }
             else
             {
                 const Matrix4* parent_trans = &collection->m_WorldTransforms[instance->m_Parent];
                 if (instance->m_ScaleAlongZ)
                 {
-                    *trans = (*parent_trans) * dmTransform::ToMatrix4(instance->m_Transform);
+                    *trans = (*parent_trans) * local;
                 }
                 else
                 {
-                    *trans = dmTransform::MulNoScaleZ(*parent_trans, dmTransform::ToMatrix4(instance->m_Transform));
+                    *trans = dmTransform::MulNoScaleZ(*parent_trans, local);
                 }
             }
+            collection->m_WorldTransformVersions[instance->m_Index]++;
             return InitComponents(collection, instance);
         }
 
@@ -1799,8 +1828,8 @@ namespace dmGameObject
         // Delete instance
         instance->m_ToBeDeleted = 1;
 
-        uint16_t index = instance->m_Index;
-        uint16_t tail = collection->m_InstancesToDeleteTail;
+        uint32_t index = instance->m_Index;
+        uint32_t tail = collection->m_InstancesToDeleteTail;
         if (tail != INVALID_INSTANCE_INDEX) {
             HInstance tail_instance = collection->m_Instances[tail];
             tail_instance->m_NextToDelete = index;
@@ -1817,10 +1846,10 @@ namespace dmGameObject
 
     static void RemoveFromAddToUpdate(Collection* collection, HInstance instance)
     {
-        uint16_t index = instance->m_Index;
+        uint32_t index = instance->m_Index;
         assert(collection->m_InstancesToAddTail == index || instance->m_NextToAdd != INVALID_INSTANCE_INDEX);
-        uint16_t* prev_index_ptr = &collection->m_InstancesToAddHead;
-        uint16_t prev_index = *prev_index_ptr;
+        uint32_t* prev_index_ptr = &collection->m_InstancesToAddHead;
+        uint32_t prev_index = *prev_index_ptr;
         while (prev_index != index) {
             prev_index_ptr = &collection->m_Instances[prev_index]->m_NextToAdd;
             if (collection->m_InstancesToAddTail == *prev_index_ptr) {
@@ -1871,6 +1900,7 @@ namespace dmGameObject
             Instance* child = collection->m_Instances[index];
             assert(child->m_Parent == instance->m_Index);
             child->m_Parent = instance->m_Parent;
+            child->m_TransformDirty = 1;
             index = collection->m_Instances[index]->m_SiblingIndex;
         }
 
@@ -2041,11 +2071,11 @@ namespace dmGameObject
         return instance->m_Bone;
     }
 
-    static uint32_t DoSetBoneTransforms(HCollection hcollection, dmTransform::Transform* component_transform, uint16_t first_index, dmTransform::Transform* transforms, uint32_t transform_count)
+    static uint32_t DoSetBoneTransforms(HCollection hcollection, dmTransform::Transform* component_transform, uint32_t first_index, dmTransform::Transform* transforms, uint32_t transform_count)
     {
         if (transform_count == 0)
             return 0;
-        uint16_t current_index = first_index;
+        uint32_t current_index = first_index;
         uint32_t count = 0;
         Collection* collection = hcollection->m_Collection;
         while (current_index != INVALID_INSTANCE_INDEX)
@@ -2053,10 +2083,11 @@ namespace dmGameObject
             HInstance instance = collection->m_Instances[current_index];
             if (instance->m_Bone)
             {
-                instance->m_Transform = transforms[count++];
+                dmTransform::Transform transform = transforms[count++];
                 if (component_transform && count == 1) {
-                    instance->m_Transform = dmTransform::Mul(*component_transform, instance->m_Transform);
+                    transform = dmTransform::Mul(*component_transform, transform);
                 }
+                SetLocalTransform(instance, transform);
                 if (count < transform_count)
                 {
                     count += DoSetBoneTransforms(hcollection, 0x0, instance->m_FirstChildIndex, &transforms[count], transform_count - count);
@@ -2076,8 +2107,8 @@ namespace dmGameObject
         return DoSetBoneTransforms(instance->m_Collection->m_HCollection, &component_transform, instance->m_Index, transforms, transform_count);
     }
 
-    static void DeleteBones(Collection* collection, uint16_t first_index) {
-        uint16_t current_index = first_index;
+    static void DeleteBones(Collection* collection, uint32_t first_index) {
+        uint32_t current_index = first_index;
         while (current_index != INVALID_INSTANCE_INDEX) {
             HInstance instance = collection->m_Instances[current_index];
             if (instance->m_Bone && instance->m_ToBeDeleted == 0) {
@@ -2196,23 +2227,24 @@ namespace dmGameObject
                     Matrix4& world = collection->m_WorldTransforms[instance->m_Index];
                     if (instance->m_ScaleAlongZ)
                     {
-                        world = parent_t * dmTransform::ToMatrix4(instance->m_Transform);
+                        world = parent_t * dmTransform::ToMatrix4(GetLocalTransform(instance));
                     }
                     else
                     {
-                        world = dmTransform::MulNoScaleZ(parent_t, dmTransform::ToMatrix4(instance->m_Transform));
+                        world = dmTransform::MulNoScaleZ(parent_t, dmTransform::ToMatrix4(GetLocalTransform(instance)));
                     }
+                    collection->m_WorldTransformVersions[instance->m_Index]++;
                 }
                 else
                 {
                     if (instance->m_ScaleAlongZ)
                     {
-                        instance->m_Transform = dmTransform::ToTransform(inverse(parent_t) * collection->m_WorldTransforms[instance->m_Index]);
+                        SetLocalTransform(instance, dmTransform::ToTransform(inverse(parent_t) * collection->m_WorldTransforms[instance->m_Index]));
                     }
                     else
                     {
                         Matrix4 tmp = dmTransform::MulNoScaleZ(inverse(parent_t), collection->m_WorldTransforms[instance->m_Index]);
-                        instance->m_Transform = dmTransform::ToTransform(tmp);
+                        SetLocalTransform(instance, dmTransform::ToTransform(tmp));
                     }
                 }
 
@@ -2387,67 +2419,117 @@ namespace dmGameObject
         }
     }
 
-    void UpdateTransforms(Collection* collection)
+    // Flag the direct children of an instance, so that they are recalculated when their level is processed
+    static inline void SetChildrenTransformDirty(Collection* collection, Instance* instance)
     {
-        DM_PROFILE("UpdateTransforms");
+        uint32_t index = instance->m_FirstChildIndex;
+        while (index != INVALID_INSTANCE_INDEX)
+        {
+            Instance* child = collection->m_Instances[index];
+            child->m_TransformDirty = 1;
+            index = child->m_SiblingIndex;
+        }
+    }
 
-        // Calculate world transforms
-        // First root-level instances
-        dmArray<uint16_t>& root_level = collection->m_LevelIndices[0];
-        uint32_t root_count = root_level.Size();
-        for (uint32_t i = 0; i < root_count; ++i)
+    void SetTransformDirty(HInstance instance)
+    {
+        instance->m_TransformDirty = 1;
+    }
+
+    // Gathers the dirty instances of a level into the transform batch, and flags their children
+    static uint32_t GatherDirtyTransforms(Collection* collection, const dmArray<uint32_t>& level)
+    {
+        uint32_t* batch = collection->m_TransformBatch.Begin();
+        uint32_t* batch_parents = collection->m_TransformBatchParents.Begin();
+        uint32_t batch_count = 0;
+        uint32_t instance_count = level.Size();
+        for (uint32_t i = 0; i < instance_count; ++i)
         {
-            uint16_t index = root_level[i];
+            uint32_t index = level[i];
             Instance* instance = collection->m_Instances[index];
             CheckEuler(instance);
-            collection->m_WorldTransforms[index] = dmTransform::ToMatrix4(instance->m_Transform);
-            uint16_t parent_index = instance->m_Parent;
-            assert(parent_index == INVALID_INSTANCE_INDEX);
+            if (!instance->m_TransformDirty)
+                continue;
+
+            instance->m_TransformDirty = 0;
+            SetChildrenTransformDirty(collection, instance);
+            collection->m_WorldTransformVersions[index]++;
+            batch[batch_count] = index;
+            batch_parents[batch_count] = instance->m_Parent;
+            ++batch_count;
         }
+        return batch_count;
+    }
 
+    // Number of dirty instances of a level calculated by each transform job
+    static const uint32_t TRANSFORM_JOB_SIZE = 256;
 
-        if (collection->m_ScaleAlongZ) {
-            for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
-            {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
-                uint32_t instance_count = level.Size();
-                for (uint32_t i = 0; i < instance_count; ++i)
-                {
-                    uint16_t index = level[i];
-                    Instance* instance = collection->m_Instances[index];
-                    CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
+    struct TransformJobs
+    {
+        Collection* m_Collection;
+        uint32_t    m_BatchCount;
+        bool        m_Root;
+    };
+
+    static void TransformJob(void* context, uint32_t job_index)
+    {
+        TransformJobs* jobs = (TransformJobs*)context;
+        Collection* collection = jobs->m_Collection;
+        uint32_t start = job_index * TRANSFORM_JOB_SIZE;
+        uint32_t count = dmMath::Min(TRANSFORM_JOB_SIZE, jobs->m_BatchCount - start);
+        const uint32_t* batch = collection->m_TransformBatch.Begin() + start;
+        if (jobs->m_Root)
+        {
+            dmTransform::ToMatrix4Batch(collection->m_Positions.Begin(), collection->m_Rotations.Begin(), collection->m_Scales.Begin(),
+                                        batch, count, collection->m_WorldTransforms.Begin());
+        }
+        else
+        {
+            dmTransform::MulParentBatch(collection->m_Positions.Begin(), collection->m_Rotations.Begin(), collection->m_Scales.Begin(),
+                                        batch, collection->m_TransformBatchParents.Begin() + start, count,
+                                        collection->m_ScaleAlongZ != 0, collection->m_WorldTransforms.Begin());
+        }
+    }
 
-                    uint16_t parent_index = instance->m_Parent;
-                    assert(parent_index != INVALID_INSTANCE_INDEX);
+    // Calculates the gathered transform batch of a level. The parents belong to the previous levels,
+    // so the batch is split into jobs run on the job pool of the register.
+    static void CalculateTransformBatch(Collection* collection, uint32_t batch_count, bool root)
+    {
+        TransformJobs jobs;
+        jobs.m_Collection = collection;
+        jobs.m_BatchCount = batch_count;
+        jobs.m_Root = root;
+        uint32_t job_count = (batch_count + TRANSFORM_JOB_SIZE - 1) / TRANSFORM_JOB_SIZE;
+        dmJobPool::Run(collection->m_Register->m_JobPool, TransformJob, &jobs, job_count);
+    }
 
-                    Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
-                    Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = *parent_trans * own;
-                }
-            }
-        } else {
-            for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
-            {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
-                uint32_t instance_count = level.Size();
-                for (uint32_t i = 0; i < instance_count; ++i)
-                {
-                    uint16_t index = level[i];
-                    Instance* instance = collection->m_Instances[index];
-                    CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
+    void UpdateTransforms(Collection* collection)
+    {
+        DM_PROFILE("UpdateTransforms");
 
-                    uint16_t parent_index = instance->m_Parent;
-                    assert(parent_index != INVALID_INSTANCE_INDEX);
+        // Calculate world transforms
+        // Only instances flagged as dirty are recalculated. The flag is propagated to the children of each
+        // recalculated instance, and since the levels are processed top-down the whole subtree is updated in this pass.
+        // The dirty instances of each level are computed in one batch, straight from the local transform arrays
 
-                    Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
-                    Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = dmTransform::MulNoScaleZ(*parent_trans, own);
-                }
-            }
+        // First root-level instances
+        uint32_t batch_count = GatherDirtyTransforms(collection, collection->m_LevelIndices[0]);
+        CalculateTransformBatch(collection, batch_count, true);
+        uint32_t updated_count = batch_count;
+
+        for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
+        {
+            // A level is only populated if the previous one is
+            dmArray<uint32_t>& level = collection->m_LevelIndices[level_i];
+            if (level.Empty())
+                break;
+
+            batch_count = GatherDirtyTransforms(collection, level);
+            CalculateTransformBatch(collection, batch_count, false);
+            updated_count += batch_count;
         }
 
+        DM_PROPERTY_ADD_U32(rmtp_GOTransforms, updated_count);
         collection->m_DirtyTransforms = false;
     }
 
@@ -2681,11 +2763,11 @@ namespace dmGameObject
             while (collection->m_InstancesToDeleteHead != INVALID_INSTANCE_INDEX && pass_count < max_pass_count) {
                 ++pass_count;
                 // Save the list and clear the head and tail
-                uint16_t head = collection->m_InstancesToDeleteHead;
+                uint32_t head = collection->m_InstancesToDeleteHead;
                 collection->m_InstancesToDeleteHead = INVALID_INSTANCE_INDEX;
                 collection->m_InstancesToDeleteTail = INVALID_INSTANCE_INDEX;
 
-                uint16_t index = head;
+                uint32_t index = head;
                 while (index != INVALID_INSTANCE_INDEX) {
                     Instance* instance = collection->m_Instances[index];
 
@@ -2927,42 +3009,61 @@ namespace dmGameObject
 
     void SetPosition(HInstance instance, Point3 position)
     {
-        instance->m_Transform.SetTranslation(Vector3(position));
+        instance->m_Collection->m_Positions[instance->m_Index] = Vector3(position);
+        instance->m_TransformDirty = 1;
     }
 
     Point3 GetPosition(HInstance instance)
     {
-        return Point3(instance->m_Transform.GetTranslation());
+        return Point3(instance->m_Collection->m_Positions[instance->m_Index]);
     }
 
     void SetRotation(HInstance instance, Quat rotation)
     {
-        instance->m_Transform.SetRotation(rotation);
+        instance->m_Collection->m_Rotations[instance->m_Index] = rotation;
+        instance->m_TransformDirty = 1;
     }
 
     Quat GetRotation(HInstance instance)
     {
-        return instance->m_Transform.GetRotation();
+        return instance->m_Collection->m_Rotations[instance->m_Index];
+    }
+
+    void SetTransforms2D(const InstanceTransform2D* transforms, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const InstanceTransform2D& transform = transforms[i];
+            HInstance instance = transform.m_Instance;
+            Collection* collection = instance->m_Collection;
+            Vector3& position = collection->m_Positions[instance->m_Index];
+            position.setX(transform.m_X);
+            position.setY(transform.m_Y);
+            collection->m_Rotations[instance->m_Index] = Quat::rotationZ(transform.m_Angle);
+            instance->m_TransformDirty = 1;
+        }
     }
 
     void SetScale(HInstance instance, float scale)
     {
-        instance->m_Transform.SetUniformScale(scale);
+        instance->m_Collection->m_Scales[instance->m_Index] = Vector3(scale);
+        instance->m_TransformDirty = 1;
     }
 
     void SetScale(HInstance instance, Vector3 scale)
     {
-        instance->m_Transform.SetScale(scale);
+        instance->m_Collection->m_Scales[instance->m_Index] = scale;
+        instance->m_TransformDirty = 1;
     }
 
     float GetUniformScale(HInstance instance)
     {
-        return instance->m_Transform.GetUniformScale();
+        return minElem(instance->m_Collection->m_Scales[instance->m_Index]);
     }
 
     Vector3 GetScale(HInstance instance)
     {
-        return instance->m_Transform.GetScale();
+        return instance->m_Collection->m_Scales[instance->m_Index];
     }
 
     Point3 GetWorldPosition(HInstance instance)
@@ -3004,6 +3105,11 @@ namespace dmGameObject
         return instance->m_Collection->m_WorldTransforms[instance->m_Index];
     }
 
+    uint32_t GetWorldTransformVersion(HInstance instance)
+    {
+        return instance->m_Collection->m_WorldTransformVersions[instance->m_Index];
+    }
+
     Result SetParent(HInstance child, HInstance parent)
     {
         if (parent == 0 && child->m_Parent == INVALID_INSTANCE_INDEX)
@@ -3075,6 +3181,7 @@ namespace dmGameObject
             child->m_Parent = INVALID_INSTANCE_INDEX;
             child->m_Depth = 0;
         }
+        child->m_TransformDirty = 1;
         InsertInstanceInLevelIndex(collection, child);
 
         int32_t n_steps =  (int32_t) original_child_depth - (int32_t) child->m_Depth;
@@ -3144,7 +3251,7 @@ namespace dmGameObject
 
     static void UpdateRotationToEuler(HInstance instance)
     {
-        Quat q = instance->m_Transform.GetRotation();
+        Quat q = instance->m_Collection->m_Rotations[instance->m_Index];
         instance->m_EulerRotation = dmVMath::QuatToEuler(q.getX(), q.getY(), q.getZ(), q.getW());
         instance->m_PrevEulerRotation = instance->m_EulerRotation;
     }
@@ -3152,7 +3259,8 @@ namespace dmGameObject
     static void UpdateEulerToRotation(HInstance instance)
     {
         instance->m_PrevEulerRotation = instance->m_EulerRotation;
-        instance->m_Transform.SetRotation(dmVMath::EulerToQuat(instance->m_EulerRotation));
+        instance->m_Collection->m_Rotations[instance->m_Index] = dmVMath::EulerToQuat(instance->m_EulerRotation);
+        instance->m_TransformDirty = 1;
     }
 
     PropertyResult GetProperty(HInstance instance, dmhash_t component_id, dmhash_t property_id, PropertyOptions options, PropertyDesc& out_value)
@@ -3169,89 +3277,89 @@ namespace dmGameObject
             // Scale used to be a uniform scalar, but is now a non-uniform 3-component scale
             if (property_id == PROP_SCALE)
             {
-                float* scale = instance->m_Transform.GetScalePtr();
+                float* scale = GetScalePtr(instance);
                 out_value.m_ValuePtr = scale;
                 out_value.m_ElementIds[0] = PROP_SCALE_X;
                 out_value.m_ElementIds[1] = PROP_SCALE_Y;
                 out_value.m_ElementIds[2] = PROP_SCALE_Z;
-                out_value.m_Variant = PropertyVar(instance->m_Transform.GetScale());
+                out_value.m_Variant = PropertyVar(instance->m_Collection->m_Scales[instance->m_Index]);
             }
             else if (property_id == PROP_SCALE_X)
             {
-                float* scale = instance->m_Transform.GetScalePtr();
+                float* scale = GetScalePtr(instance);
                 out_value.m_ValuePtr = scale;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_SCALE_Y)
             {
-                float* scale = instance->m_Transform.GetScalePtr();
+                float* scale = GetScalePtr(instance);
                 out_value.m_ValuePtr = scale + 1;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_SCALE_Z)
             {
-                float* scale = instance->m_Transform.GetScalePtr();
+                float* scale = GetScalePtr(instance);
                 out_value.m_ValuePtr = scale + 2;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_POSITION)
             {
-                float* position = instance->m_Transform.GetPositionPtr();
+                float* position = GetPositionPtr(instance);
                 out_value.m_ValuePtr = position;
                 out_value.m_ElementIds[0] = PROP_POSITION_X;
                 out_value.m_ElementIds[1] = PROP_POSITION_Y;
                 out_value.m_ElementIds[2] = PROP_POSITION_Z;
-                out_value.m_Variant = PropertyVar(instance->m_Transform.GetTranslation());
+                out_value.m_Variant = PropertyVar(instance->m_Collection->m_Positions[instance->m_Index]);
             }
             else if (property_id == PROP_POSITION_X)
             {
-                float* position = instance->m_Transform.GetPositionPtr();
+                float* position = GetPositionPtr(instance);
                 out_value.m_ValuePtr = position;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_POSITION_Y)
             {
-                float* position = instance->m_Transform.GetPositionPtr();
+                float* position = GetPositionPtr(instance);
                 out_value.m_ValuePtr = position + 1;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_POSITION_Z)
             {
-                float* position = instance->m_Transform.GetPositionPtr();
+                float* position = GetPositionPtr(instance);
                 out_value.m_ValuePtr = position + 2;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_ROTATION)
             {
-                float* rotation = instance->m_Transform.GetRotationPtr();
+                float* rotation = GetRotationPtr(instance);
                 out_value.m_ValuePtr = rotation;
                 out_value.m_ElementIds[0] = PROP_ROTATION_X;
                 out_value.m_ElementIds[1] = PROP_ROTATION_Y;
                 out_value.m_ElementIds[2] = PROP_ROTATION_Z;
                 out_value.m_ElementIds[3] = PROP_ROTATION_W;
-                out_value.m_Variant = PropertyVar(instance->m_Transform.GetRotation());
+                out_value.m_Variant = PropertyVar(instance->m_Collection->m_Rotations[instance->m_Index]);
             }
             else if (property_id == PROP_ROTATION_X)
             {
-                float* rotation = instance->m_Transform.GetRotationPtr();
+                float* rotation = GetRotationPtr(instance);
                 out_value.m_ValuePtr = rotation;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_ROTATION_Y)
             {
-                float* rotation = instance->m_Transform.GetRotationPtr();
+                float* rotation = GetRotationPtr(instance);
                 out_value.m_ValuePtr = rotation + 1;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_ROTATION_Z)
             {
-                float* rotation = instance->m_Transform.GetRotationPtr();
+                float* rotation = GetRotationPtr(instance);
                 out_value.m_ValuePtr = rotation + 2;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
             else if (property_id == PROP_ROTATION_W)
             {
-                float* rotation = instance->m_Transform.GetRotationPtr();
+                float* rotation = GetRotationPtr(instance);
                 out_value.m_ValuePtr = rotation + 3;
                 out_value.m_Variant = PropertyVar(*out_value.m_ValuePtr);
             }
@@ -3345,9 +3453,11 @@ namespace dmGameObject
             return PROPERTY_RESULT_INVALID_INSTANCE;
         if (component_id == 0)
         {
-            float* position = instance->m_Transform.GetPositionPtr();
-            float* rotation = instance->m_Transform.GetRotationPtr();
-            float* scale = instance->m_Transform.GetScalePtr();
+            float* position = GetPositionPtr(instance);
+            float* rotation = GetRotationPtr(instance);
+            float* scale = GetScalePtr(instance);
+            // All game object properties are transform properties
+            instance->m_TransformDirty = 1;
             if (property_id == PROP_POSITION)
             {
                 if (value.m_Type != PROPERTY_TYPE_VECTOR3)
@@ -3542,7 +3652,7 @@ namespace dmGameObject
     //  - patch data structures for identification and input stack
     //  - copy the rest of the fields
     // The old instance is destroyed.
-    static void RecreateInstance(Collection* collection, uint16_t index, Prototype* old_proto, Prototype* new_proto, const char* new_proto_name) {
+    static void RecreateInstance(Collection* collection, uint32_t index, Prototype* old_proto, Prototype* new_proto, const char* new_proto_name) {
         HInstance instance = collection->m_Instances[index];
         // We don't support recreating instances that are 'transitioning'
         assert(instance->m_ToBeAdded == 0);
@@ -3561,10 +3671,10 @@ namespace dmGameObject
         new_instance->m_FirstChildIndex = instance->m_FirstChildIndex;
         new_instance->m_SiblingIndex = instance->m_SiblingIndex;
         // transform-related
-        new_instance->m_Transform = instance->m_Transform;
         new_instance->m_EulerRotation = instance->m_EulerRotation;
         new_instance->m_PrevEulerRotation = instance->m_PrevEulerRotation;
         new_instance->m_ScaleAlongZ = instance->m_ScaleAlongZ;
+        new_instance->m_TransformDirty = 1;
         // id-related
         new_instance->m_Identifier = instance->m_Identifier;
         new_instance->m_IdentifierIndex = instance->m_IdentifierIndex;
@@ -3609,11 +3719,11 @@ namespace dmGameObject
         Collection* collection = (Collection*) params.m_UserData;
         for (uint32_t level_i = 0; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
         {
-            dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
+            dmArray<uint32_t>& level = collection->m_LevelIndices[level_i];
             uint32_t instance_count = level.Size();
             for (uint32_t i = 0; i < instance_count; ++i)
             {
-                uint16_t index = level[i];
+                uint32_t index = level[i];
                 Instance* instance = collection->m_Instances[index];
                 if (instance->m_Prototype == params.m_Resource->m_Resource) {
                     RecreateInstance(collection, index, (Prototype*)params.m_Resource->m_PrevResource, (Prototype*)params.m_Resource->m_Resource, params.m_Name);
@@ -3656,7 +3766,7 @@ namespace dmGameObject
     {
         Collection* collection = hcollection->m_Collection;
         uint32_t count = 0;
-        uint16_t index = collection->m_InstancesToAddHead;
+        uint32_t index = collection->m_InstancesToAddHead;
         while (index != INVALID_INSTANCE_INDEX) {
             index = collection->m_Instances[index]->m_NextToAdd;
             ++count;
@@ -3668,7 +3778,7 @@ namespace dmGameObject
     {
         Collection* collection = hcollection->m_Collection;
         uint32_t count = 0;
-        uint16_t index = collection->m_InstancesToDeleteHead;
+        uint32_t index = collection->m_InstancesToDeleteHead;
         while (index != INVALID_INSTANCE_INDEX) {
             index = collection->m_Instances[index]->m_NextToDelete;
             ++count;
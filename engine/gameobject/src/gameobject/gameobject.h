@@ -21,6 +21,7 @@
 
 #include <dlib/easing.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_pool.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
 
@@ -77,7 +78,7 @@ namespace dmGameObject
     /**
      * Set default capacity of collections in this register. This does not affect existing collections.
      * @param regist Register
-     * @param capacity Default capacity of collections in this register (0-32766).
+     * @param capacity Default capacity of collections in this register (0-2147483645).
      * @return RESULT_OK on success or RESULT_INVALID_OPERATION if max_count is not within range
      */
     Result SetCollectionDefaultCapacity(HRegister regist, uint32_t capacity);
@@ -96,6 +97,13 @@ namespace dmGameObject
      */
     void SetInputStackDefaultCapacity(HRegister regist, uint32_t capacity);
 
+    /**
+     * Set the job pool used to calculate world transforms in parallel
+     * @param regist Register
+     * @param pool Job pool, 0x0 to calculate them on the calling thread
+     */
+    void SetJobPool(HRegister regist, dmJobPool::HJobPool pool);
+
     /**
      * Creates a new gameobject collection
      * @param name Collection name, which must be unique and follow the same naming as for sockets
@@ -348,6 +356,26 @@ namespace dmGameObject
      */
     bool IsChildOf(HInstance child, HInstance parent);
 
+    /**
+     * Transform of an instance in the xy-plane
+     */
+    struct InstanceTransform2D
+    {
+        HInstance   m_Instance;
+        float       m_X;
+        float       m_Y;
+        /// Rotation around the z-axis, in radians
+        float       m_Angle;
+    };
+
+    /**
+     * Set the x and y position and the rotation around the z-axis of a number of instances.
+     * The z position of each instance is kept. Used to write back the bodies moved by 2D physics.
+     * @param transforms Transforms to set
+     * @param count Number of transforms
+     */
+    void SetTransforms2D(const InstanceTransform2D* transforms, uint32_t count);
+
     /**
      * Retrieve a property from a component.
      * @param instance Instance of the game object
@@ -85,8 +85,8 @@ namespace dmGameObject
         dmArray<void*> m_PropertyResources;
     };
 
-    // Invalid instance index. Implies that maximum number of instances is 32766 (ie 0x7fff - 1)
-    const uint32_t INVALID_INSTANCE_INDEX = 0x7fff;
+    // Invalid instance index. Implies that maximum number of instances is 0x7fffffff - 1
+    const uint32_t INVALID_INSTANCE_INDEX = 0x7fffffff;
 
     // NOTE: Actual size of Instance is sizeof(Instance) + sizeof(uintptr_t) * m_UserDataCount
     struct Instance
@@ -94,7 +94,6 @@ namespace dmGameObject
         Instance(Prototype* prototype)
         {
             m_Collection = 0;
-            m_Transform.SetIdentity();
             m_EulerRotation = Vector3(0.0f, 0.0f, 0.0f);
             m_PrevEulerRotation = Vector3(0.0f, 0.0f, 0.0f);
             m_Prototype = prototype;
@@ -106,6 +105,7 @@ namespace dmGameObject
             m_ScaleAlongZ = 0;
             m_Bone = 0;
             m_Generated = 0;
+            m_TransformDirty = 1;
             m_Parent = INVALID_INSTANCE_INDEX;
             m_Index = INVALID_INSTANCE_INDEX;
             m_LevelIndex = INVALID_INSTANCE_INDEX;
@@ -121,7 +121,7 @@ namespace dmGameObject
         {
         }
 
-        dmTransform::Transform m_Transform;
+        // NOTE: The local transform is stored in the collection, see Collection::m_Positions
 
         // Shadowed rotation expressed in euler coordinates
         Vector3 m_EulerRotation;
@@ -149,36 +149,40 @@ namespace dmGameObject
         uint16_t        m_Bone : 1;
         // If this is a generated instance, i.e. if the instance id is uniquely generated
         uint16_t        m_Generated : 1;
+        // If the local transform (or the hierarchy above) changed since the world transform was last calculated
+        uint16_t        m_TransformDirty : 1;
         // Padding
-        uint16_t        m_Pad : 4;
+        uint16_t        m_Pad : 3;
 
         // Index to parent
-        uint16_t        m_Parent : 16;
+        uint32_t        m_Parent : 31;
+        uint32_t        m_Pad1 : 1;
 
         // Index to Collection::m_Instances
-        uint16_t        m_Index : 15;
+        uint32_t        m_Index : 31;
         // Used for deferred deletion
-        uint16_t        m_ToBeDeleted : 1;
+        uint32_t        m_ToBeDeleted : 1;
 
         // Index to Collection::m_LevelIndex. Index is relative to current level (m_Depth), eg first object in level L always has level-index 0
         // Level-index is used to reorder Collection::m_LevelIndex entries in O(1). Given an instance we need to find where the
         // instance index is located in Collection::m_LevelIndex
-        uint16_t        m_LevelIndex : 15;
-        uint16_t        m_Pad2 : 1;
+        uint32_t        m_LevelIndex : 31;
+        uint32_t        m_Pad2 : 1;
 
         // Index to next instance to delete or INVALID_INSTANCE_INDEX
-        uint16_t        m_NextToDelete : 16;
+        uint32_t        m_NextToDelete : 31;
+        uint32_t        m_Pad3 : 1;
 
         // Index to next instance to add-to-update or INVALID_INSTANCE_INDEX
-        uint16_t        m_NextToAdd;
+        uint32_t        m_NextToAdd;
 
         // Next sibling index. Index to Collection::m_Instances
-        uint16_t        m_SiblingIndex : 15;
-        uint16_t        m_ToBeAdded : 1;
+        uint32_t        m_SiblingIndex : 31;
+        uint32_t        m_ToBeAdded : 1;
 
         // First child index. Index to Collection::m_Instances
-        uint16_t        m_FirstChildIndex : 15;
-        uint16_t        m_Pad4 : 1;
+        uint32_t        m_FirstChildIndex : 31;
+        uint32_t        m_Pad4 : 1;
 
         uint32_t        m_ComponentInstanceUserDataCount;
         uintptr_t       m_ComponentInstanceUserData[0];
@@ -202,6 +206,8 @@ namespace dmGameObject
         // Default capacity of collections
         uint32_t                    m_DefaultCollectionCapacity;
         uint32_t                    m_DefaultInputStackCapacity;
+        // Pool used by UpdateTransforms, may be 0x0
+        dmJobPool::HJobPool         m_JobPool;
 
         Register();
         ~Register();
@@ -238,7 +244,7 @@ namespace dmGameObject
         dmArray<Instance*>       m_Instances;
 
         // Index pool for mapping Instance::m_Index to m_Instances
-        dmIndexPool16            m_InstanceIndices;
+        dmIndexPool32            m_InstanceIndices;
 
         // Resources referenced through property overrides inside the collection
         dmArray<void*>           m_PropertyResources;
@@ -248,10 +254,22 @@ namespace dmGameObject
         // Two dimensional table of indices with stride "max_instances"
         // Level 0 contains root-nodes in [0..m_LevelIndices[0].Size()-1]
         // Level 1 contains level 1 indices in [0..m_LevelIndices[1].Size()-1]
-        dmArray<uint16_t>        m_LevelIndices[MAX_HIERARCHICAL_DEPTH];
+        dmArray<uint32_t>        m_LevelIndices[MAX_HIERARCHICAL_DEPTH];
+
+        // Local transforms, as separate arrays of positions, rotations and scales indexed by Instance::m_Index
+        // Size is always = max_instances
+        dmArray<Vector3>         m_Positions;
+        dmArray<Quat>            m_Rotations;
+        dmArray<Vector3>         m_Scales;
 
         // Array of world transforms. Calculated using m_LevelIndices above
         dmArray<Matrix4>         m_WorldTransforms;
+        // Incremented each time the corresponding world transform is written, see GetWorldTransformVersion
+        dmArray<uint32_t>        m_WorldTransformVersions;
+
+        // Scratch arrays for the dirty instances (and their parents) of the level currently calculated in UpdateTransforms
+        dmArray<uint32_t>        m_TransformBatch;
+        dmArray<uint32_t>        m_TransformBatchParents;
 
         // Identifier to Instance mapping
         dmHashTable64<Instance*> m_IDToInstance;
@@ -275,14 +293,14 @@ namespace dmGameObject
         dmIndexPool32            m_InstanceIdPool;
 
         // Head of linked list of instances scheduled for deferred deletion
-        uint16_t                 m_InstancesToDeleteHead;
+        uint32_t                 m_InstancesToDeleteHead;
         // Tail of the same list, for O(1) appending
-        uint16_t                 m_InstancesToDeleteTail;
+        uint32_t                 m_InstancesToDeleteTail;
 
         // Head of linked list of instances scheduled to be added to update
-        uint16_t                 m_InstancesToAddHead;
+        uint32_t                 m_InstancesToAddHead;
         // Tail of the same list, for O(1) appending
-        uint16_t                 m_InstancesToAddTail;
+        uint32_t                 m_InstancesToAddTail;
 
         float                    m_FixedAccumTime;  // Accumulated time between fixed updates. Scaled time.
 
@@ -302,6 +320,38 @@ namespace dmGameObject
         Collection* m_Collection;
     };
 
+    inline dmTransform::Transform GetLocalTransform(const Instance* instance)
+    {
+        const Collection* collection = instance->m_Collection;
+        uint32_t index = instance->m_Index;
+        return dmTransform::Transform(collection->m_Positions[index], collection->m_Rotations[index], collection->m_Scales[index]);
+    }
+
+    inline void SetLocalTransform(Instance* instance, const dmTransform::Transform& transform)
+    {
+        Collection* collection = instance->m_Collection;
+        uint32_t index = instance->m_Index;
+        collection->m_Positions[index] = transform.GetTranslation();
+        collection->m_Rotations[index] = transform.GetRotation();
+        collection->m_Scales[index] = transform.GetScale();
+        instance->m_TransformDirty = 1;
+    }
+
+    inline float* GetPositionPtr(Instance* instance)
+    {
+        return (float*)&instance->m_Collection->m_Positions[instance->m_Index];
+    }
+
+    inline float* GetRotationPtr(Instance* instance)
+    {
+        return (float*)&instance->m_Collection->m_Rotations[instance->m_Index];
+    }
+
+    inline float* GetScalePtr(Instance* instance)
+    {
+        return (float*)&instance->m_Collection->m_Scales[instance->m_Index];
+    }
+
     ComponentType* FindComponentType(Register* regist, uint32_t resource_type, uint32_t* index);
 
     // Used by res_collection.cpp
@@ -314,6 +364,7 @@ namespace dmGameObject
     bool CreateComponents(Collection* collection, HInstance instance);
     void Delete(Collection* collection, HInstance instance, bool recursive);
     void UpdateTransforms(Collection* collection);
+    void SetTransformDirty(HInstance instance);
     void DeleteCollection(Collection* collection);
     bool IsCollectionInitialized(Collection* collection);
     Result AttachCollection(Collection* collection, const char* name, dmResource::HFactory factory, HRegister regist, HCollection hcollection);
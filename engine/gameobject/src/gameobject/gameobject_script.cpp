@@ -147,9 +147,11 @@ namespace dmGameObject
 
 #define SCRIPTINSTANCE "GOScriptInstance"
 #define SCRIPT "GOScript"
+#define INSTANCELIST "GOInstanceList"
 
     static uint32_t SCRIPT_TYPE_HASH = 0;
     static uint32_t SCRIPTINSTANCE_TYPE_HASH = 0;
+    static uint32_t INSTANCELIST_TYPE_HASH = 0;
 
     using namespace dmPropertiesDDF;
 
@@ -368,6 +370,43 @@ namespace dmGameObject
         {0, 0}
     };
 
+    /**
+     * Resolves the instance id at index (string, hash or url) to an instance in the
+     * same collection as the script instance. Otherwise a lua-error will be raised.
+     * @param L lua state
+     * @param script_instance the calling script instance
+     * @param index lua-arg
+     * @return instance handler
+     */
+    static Instance* ResolveInstanceId(lua_State* L, ScriptInstance* script_instance, int index)
+    {
+        HCollection collection = script_instance->m_Instance->m_Collection->m_HCollection;
+        dmhash_t id;
+        if (dmScript::IsHash(L, index))
+        {
+            // A hash is always an id in the same collection, no need to resolve it as an url
+            id = dmScript::CheckHash(L, index);
+        }
+        else
+        {
+            dmMessage::URL receiver;
+            dmScript::ResolveURL(L, index, &receiver, 0x0);
+            if (receiver.m_Socket != dmGameObject::GetMessageSocket(collection))
+            {
+                luaL_error(L, "function called can only access instances within the same collection.");
+            }
+            id = receiver.m_Path;
+        }
+
+        Instance* instance = GetInstanceFromIdentifier(collection, id);
+        if (!instance)
+        {
+            luaL_error(L, "Instance %s not found", lua_tostring(L, index));
+            return 0; // Actually never reached
+        }
+        return instance;
+    }
+
     /**
      * Get instance utility function helper.
      * The function will use the default "this" instance by default
@@ -383,19 +422,7 @@ namespace dmGameObject
         ScriptInstance* i = ScriptInstance_Check(L);
         Instance* instance = i->m_Instance;
         if (lua_gettop(L) == instance_arg && !lua_isnil(L, instance_arg)) {
-            dmMessage::URL receiver;
-            dmScript::ResolveURL(L, instance_arg, &receiver, 0x0);
-            if (receiver.m_Socket != dmGameObject::GetMessageSocket(i->m_Instance->m_Collection->m_HCollection))
-            {
-                luaL_error(L, "function called can only access instances within the same collection.");
-            }
-
-            instance = GetInstanceFromIdentifier(instance->m_Collection->m_HCollection, receiver.m_Path);
-            if (!instance)
-            {
-                luaL_error(L, "Instance %s not found", lua_tostring(L, instance_arg));
-                return 0; // Actually never reached
-            }
+            instance = ResolveInstanceId(L, i, instance_arg);
         }
         return instance;
     }
@@ -1170,6 +1197,351 @@ namespace dmGameObject
         return 0;
     }
 
+    enum TransformProperty
+    {
+        TRANSFORM_PROPERTY_POSITION,
+        TRANSFORM_PROPERTY_ROTATION,
+        TRANSFORM_PROPERTY_SCALE,
+    };
+
+    // Instance ids resolved once by go.prepare_ids, to be reused by the bulk transform functions
+    struct InstanceList
+    {
+        struct Entry
+        {
+            dmhash_t    m_Id;
+            // Index of the instance in the collection when it was last looked up
+            uint32_t    m_Index;
+        };
+
+        HCollection     m_Collection;
+        uint32_t        m_Count;
+        Entry           m_Entries[1]; // m_Count entries
+    };
+
+    static const luaL_reg InstanceList_methods[] =
+    {
+        {0,0}
+    };
+
+    static int InstanceList_len(lua_State* L)
+    {
+        InstanceList* list = (InstanceList*)lua_touserdata(L, 1);
+        lua_pushinteger(L, list->m_Count);
+        return 1;
+    }
+
+    static const luaL_reg InstanceList_meta[] =
+    {
+        {"__len", InstanceList_len},
+        {0, 0}
+    };
+
+    static Instance* GetInstanceFromList(lua_State* L, InstanceList* list, uint32_t n)
+    {
+        InstanceList::Entry& entry = list->m_Entries[n];
+        Collection* collection = list->m_Collection->m_Collection;
+        Instance* instance = collection->m_Instances[entry.m_Index];
+        if (instance == 0x0 || instance->m_Identifier != entry.m_Id)
+        {
+            // The instance has been deleted, or spawned again with the same id
+            instance = GetInstanceFromIdentifier(collection, entry.m_Id);
+            if (!instance)
+            {
+                luaL_error(L, "Instance %s not found", dmHashReverseSafe64(entry.m_Id));
+                return 0; // Actually never reached
+            }
+            entry.m_Index = instance->m_Index;
+        }
+        return instance;
+    }
+
+    // The ids at index 1 are either a table of ids or an instance list
+    static InstanceList* CheckInstanceIds(lua_State* L, ScriptInstance* i, const char* function_name, uint32_t* count)
+    {
+        InstanceList* list = (InstanceList*)dmScript::ToUserType(L, 1, INSTANCELIST_TYPE_HASH);
+        if (list)
+        {
+            if (list->m_Collection != i->m_Instance->m_Collection->m_HCollection)
+            {
+                luaL_error(L, "go.%s can only access instances within the same collection.", function_name);
+            }
+            *count = list->m_Count;
+            return list;
+        }
+        luaL_checktype(L, 1, LUA_TTABLE);
+        *count = (uint32_t)lua_objlen(L, 1);
+        return 0;
+    }
+
+    static Instance* GetInstanceFromIds(lua_State* L, ScriptInstance* i, InstanceList* list, uint32_t n)
+    {
+        if (list)
+        {
+            return GetInstanceFromList(L, list, n - 1);
+        }
+        lua_rawgeti(L, 1, n);
+        Instance* instance = ResolveInstanceId(L, i, lua_gettop(L));
+        lua_pop(L, 1);
+        return instance;
+    }
+
+    static int SetTransforms(lua_State* L, TransformProperty property, const char* function_name)
+    {
+        int top = lua_gettop(L);
+        (void)top;
+
+        ScriptInstance* i = ScriptInstance_Check(L);
+        uint32_t count;
+        InstanceList* list = CheckInstanceIds(L, i, function_name, &count);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        if ((uint32_t)lua_objlen(L, 2) != count)
+        {
+            return luaL_error(L, "go.%s expects the same number of ids (%d) and values (%d)", function_name, count, (int)lua_objlen(L, 2));
+        }
+
+        for (uint32_t n = 1; n <= count; ++n)
+        {
+            Instance* instance = GetInstanceFromIds(L, i, list, n);
+            lua_rawgeti(L, 2, n);
+            int value_index = lua_gettop(L);
+            switch (property)
+            {
+            case TRANSFORM_PROPERTY_POSITION:
+                dmGameObject::SetPosition(instance, dmVMath::Point3(*dmScript::CheckVector3(L, value_index)));
+                break;
+            case TRANSFORM_PROPERTY_ROTATION:
+                dmGameObject::SetRotation(instance, *dmScript::CheckQuat(L, value_index));
+                break;
+            case TRANSFORM_PROPERTY_SCALE:
+                {
+                    Vector3* v = dmScript::ToVector3(L, value_index);
+                    Vector3 scale = v ? *v : Vector3((float)luaL_checknumber(L, value_index));
+                    if (scale.getX() <= 0.0f || scale.getY() <= 0.0f || scale.getZ() <= 0.0f)
+                    {
+                        return luaL_error(L, "The scale supplied to go.%s must be greater than 0.", function_name);
+                    }
+                    dmGameObject::SetScale(instance, scale);
+                }
+                break;
+            }
+            lua_pop(L, 1);
+        }
+
+        assert(top == lua_gettop(L));
+        return 0;
+    }
+
+    static int GetTransforms(lua_State* L, TransformProperty property, const char* function_name)
+    {
+        int top = lua_gettop(L);
+        (void)top;
+
+        ScriptInstance* i = ScriptInstance_Check(L);
+        uint32_t count;
+        InstanceList* list = CheckInstanceIds(L, i, function_name, &count);
+        if (!lua_isnoneornil(L, 2))
+        {
+            luaL_checktype(L, 2, LUA_TTABLE);
+            lua_pushvalue(L, 2);
+        }
+        else
+        {
+            lua_createtable(L, count, 0);
+        }
+        int out_index = lua_gettop(L);
+
+        for (uint32_t n = 1; n <= count; ++n)
+        {
+            Instance* instance = GetInstanceFromIds(L, i, list, n);
+
+            // Values already in the result table are updated in place, to not create garbage
+            lua_rawgeti(L, out_index, n);
+            if (property == TRANSFORM_PROPERTY_ROTATION)
+            {
+                Quat* q = dmScript::ToQuat(L, -1);
+                lua_pop(L, 1);
+                if (q)
+                {
+                    *q = dmGameObject::GetRotation(instance);
+                    continue;
+                }
+                dmScript::PushQuat(L, dmGameObject::GetRotation(instance));
+            }
+            else
+            {
+                Vector3 value = property == TRANSFORM_PROPERTY_POSITION ? Vector3(dmGameObject::GetPosition(instance)) : dmGameObject::GetScale(instance);
+                Vector3* v = dmScript::ToVector3(L, -1);
+                lua_pop(L, 1);
+                if (v)
+                {
+                    *v = value;
+                    continue;
+                }
+                dmScript::PushVector3(L, value);
+            }
+            lua_rawseti(L, out_index, n);
+        }
+
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
+    /*# resolves a list of game object instance ids for the bulk transform functions
+     * Resolves a list of game object instance ids once, for use with [ref:go.set_positions],
+     * [ref:go.get_positions] and the other bulk transform functions. Passing the prepared list instead of
+     * a table of ids skips the id and url resolving on every call.
+     *
+     * The list stays valid when instances are deleted. An instance that has been deleted raises an error
+     * when the list is used, unless an instance with the same id has been spawned since.
+     *
+     * @name go.prepare_ids
+     * @param ids [type:table] ids of the game object instances, as string, hash or url
+     * @return list [type:userdata] the resolved instances, in the same order as the ids
+     * @examples
+     *
+     * ```lua
+     * function init(self)
+     *     self.ids = go.prepare_ids({"boid1", "boid2", "boid3"})
+     * end
+     *
+     * function update(self, dt)
+     *     go.set_positions(self.ids, self.positions)
+     * end
+     * ```
+     */
+    static int Script_PrepareIds(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        ScriptInstance* i = ScriptInstance_Check(L);
+        luaL_checktype(L, 1, LUA_TTABLE);
+        uint32_t count = (uint32_t)lua_objlen(L, 1);
+
+        uint32_t size = sizeof(InstanceList) + (count > 0 ? count - 1 : 0) * sizeof(InstanceList::Entry);
+        InstanceList* list = (InstanceList*)lua_newuserdata(L, size);
+        list->m_Collection = i->m_Instance->m_Collection->m_HCollection;
+        list->m_Count = 0;
+        luaL_getmetatable(L, INSTANCELIST);
+        lua_setmetatable(L, -2);
+
+        for (uint32_t n = 1; n <= count; ++n)
+        {
+            lua_rawgeti(L, 1, n);
+            Instance* instance = ResolveInstanceId(L, i, lua_gettop(L));
+            lua_pop(L, 1);
+            InstanceList::Entry& entry = list->m_Entries[list->m_Count++];
+            entry.m_Id = instance->m_Identifier;
+            entry.m_Index = instance->m_Index;
+        }
+        return 1;
+    }
+
+    /*# sets the positions of several game object instances
+     * Sets the positions of a list of game object instances in one call, which is faster
+     * than calling [ref:go.set_position] for each instance. The positions are relative to the parents (if any).
+     *
+     * @name go.set_positions
+     * @param ids [type:table] ids of the game object instances, as string, hash or url, or a list from [ref:go.prepare_ids]
+     * @param positions [type:table] positions to set, as vector3, in the same order as the ids
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     for i, pos in ipairs(self.positions) do
+     *         vmath.add_to(pos, pos, self.velocities[i] * dt)
+     *     end
+     *     go.set_positions(self.ids, self.positions)
+     * end
+     * ```
+     */
+    static int Script_SetPositions(lua_State* L)
+    {
+        return SetTransforms(L, TRANSFORM_PROPERTY_POSITION, "set_positions");
+    }
+
+    /*# sets the rotations of several game object instances
+     * Sets the rotations of a list of game object instances in one call, which is faster
+     * than calling [ref:go.set_rotation] for each instance. The rotations are relative to the parents (if any).
+     *
+     * @name go.set_rotations
+     * @param ids [type:table] ids of the game object instances, as string, hash or url, or a list from [ref:go.prepare_ids]
+     * @param rotations [type:table] rotations to set, as quaternion, in the same order as the ids
+     */
+    static int Script_SetRotations(lua_State* L)
+    {
+        return SetTransforms(L, TRANSFORM_PROPERTY_ROTATION, "set_rotations");
+    }
+
+    /*# sets the scale factors of several game object instances
+     * Sets the scale factors of a list of game object instances in one call, which is faster
+     * than calling [ref:go.set_scale] for each instance. The scale factors are relative to the parents (if any).
+     *
+     * @name go.set_scales
+     * @param ids [type:table] ids of the game object instances, as string, hash or url, or a list from [ref:go.prepare_ids]
+     * @param scales [type:table] vector or uniform scale factors to set, in the same order as the ids, must be greater than 0
+     */
+    static int Script_SetScales(lua_State* L)
+    {
+        return SetTransforms(L, TRANSFORM_PROPERTY_SCALE, "set_scales");
+    }
+
+    /*# gets the positions of several game object instances
+     * Gets the positions of a list of game object instances in one call. The positions are relative to the parents (if any).
+     *
+     * If a result table is supplied, the vector3 values already in it are updated in place instead of
+     * creating new ones.
+     *
+     * @name go.get_positions
+     * @param ids [type:table] ids of the game object instances, as string, hash or url, or a list from [ref:go.prepare_ids]
+     * @param [positions] [type:table] optional table to store the positions in
+     * @return positions [type:table] the positions, as vector3, in the same order as the ids
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     -- no new vectors are created after the first frame
+     *     self.positions = go.get_positions(self.ids, self.positions)
+     * end
+     * ```
+     */
+    static int Script_GetPositions(lua_State* L)
+    {
+        return GetTransforms(L, TRANSFORM_PROPERTY_POSITION, "get_positions");
+    }
+
+    /*# gets the rotations of several game object instances
+     * Gets the rotations of a list of game object instances in one call. The rotations are relative to the parents (if any).
+     *
+     * If a result table is supplied, the quaternion values already in it are updated in place instead of
+     * creating new ones.
+     *
+     * @name go.get_rotations
+     * @param ids [type:table] ids of the game object instances, as string, hash or url, or a list from [ref:go.prepare_ids]
+     * @param [rotations] [type:table] optional table to store the rotations in
+     * @return rotations [type:table] the rotations, as quaternion, in the same order as the ids
+     */
+    static int Script_GetRotations(lua_State* L)
+    {
+        return GetTransforms(L, TRANSFORM_PROPERTY_ROTATION, "get_rotations");
+    }
+
+    /*# gets the 3D scale factors of several game object instances
+     * Gets the scale factors of a list of game object instances in one call. The scale factors are relative to the parents (if any).
+     *
+     * If a result table is supplied, the vector3 values already in it are updated in place instead of
+     * creating new ones.
+     *
+     * @name go.get_scales
+     * @param ids [type:table] ids of the game object instances, as string, hash or url, or a list from [ref:go.prepare_ids]
+     * @param [scales] [type:table] optional table to store the scale factors in
+     * @return scales [type:table] the scale factors, as vector3, in the same order as the ids
+     */
+    static int Script_GetScales(lua_State* L)
+    {
+        return GetTransforms(L, TRANSFORM_PROPERTY_SCALE, "get_scales");
+    }
+
     /*# sets the parent for a specific game object instance
      * Sets the parent for a game object instance. This means that the instance will exist in the geometrical space of its parent,
      * like a basic transformation hierarchy or scene graph. If no parent is specified, the instance will be detached from any parent and exist in world
@@ -2145,6 +2517,13 @@ namespace dmGameObject
         {"set_rotation",            Script_SetRotation},
         {"set_scale",               Script_SetScale},
         {"set_parent",              Script_SetParent},
+        {"get_positions",           Script_GetPositions},
+        {"get_rotations",           Script_GetRotations},
+        {"get_scales",              Script_GetScales},
+        {"set_positions",           Script_SetPositions},
+        {"set_rotations",           Script_SetRotations},
+        {"set_scales",              Script_SetScales},
+        {"prepare_ids",             Script_PrepareIds},
         {"get_world_position",      Script_GetWorldPosition},
         {"get_world_rotation",      Script_GetWorldRotation},
         {"get_world_scale",         Script_GetWorldScale},
@@ -2173,6 +2552,8 @@ namespace dmGameObject
 
         SCRIPTINSTANCE_TYPE_HASH = dmScript::RegisterUserType(L, SCRIPTINSTANCE, ScriptInstance_methods, ScriptInstance_meta);
 
+        INSTANCELIST_TYPE_HASH = dmScript::RegisterUserType(L, INSTANCELIST, InstanceList_methods, InstanceList_meta);
+
         luaL_register(L, "go", GO_methods);
 
 #define SETPLAYBACK(name) \
@@ -524,6 +524,38 @@ TEST_F(CollectionTest, CollectionCapacity)
     }
 }
 
+TEST_F(CollectionTest, LargeCollection)
+{
+    // More instances than fit in 16 bit indices
+    const uint32_t instance_count = 100000;
+    dmGameObject::HCollection coll = dmGameObject::NewCollection("largecollection", m_Factory, m_Register, instance_count, 0x0);
+    ASSERT_NE((void*) 0, coll);
+
+    // Pairs of parent and child
+    dmGameObject::HInstance parent = 0;
+    dmGameObject::HInstance child = 0;
+    for (uint32_t i = 0; i < instance_count; i += 2)
+    {
+        parent = dmGameObject::New(coll, 0x0);
+        ASSERT_NE((void*) 0, parent);
+        child = dmGameObject::New(coll, 0x0);
+        ASSERT_NE((void*) 0, child);
+        dmGameObject::SetPosition(parent, dmVMath::Point3((float)i, 0.0f, 0.0f));
+        dmGameObject::SetPosition(child, dmVMath::Point3(0.0f, 1.0f, 0.0f));
+        ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetParent(child, parent));
+    }
+    ASSERT_EQ((void*) 0, dmGameObject::New(coll, 0x0));
+    ASSERT_EQ(instance_count / 2, coll->m_Collection->m_LevelIndices[0].Size());
+    ASSERT_EQ(instance_count / 2, coll->m_Collection->m_LevelIndices[1].Size());
+
+    dmGameObject::UpdateTransforms(coll);
+    dmVMath::Point3 p = dmGameObject::GetWorldPosition(child);
+    ASSERT_EQ((float)(instance_count - 2), p.getX());
+    ASSERT_EQ(1.0f, p.getY());
+
+    dmGameObject::DeleteCollection(coll);
+    dmGameObject::PostUpdate(m_Register);
+}
 
 TEST_F(CollectionTest, CreateCallback)
 {
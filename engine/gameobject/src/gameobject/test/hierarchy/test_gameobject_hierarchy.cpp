@@ -681,6 +681,149 @@ TEST_F(HierarchyTest, TestHierarchyInheritScale)
     dmGameObject::Delete(m_Collection, parent, false);
 }
 
+// Only the parent is moved, the child must still be recalculated
+TEST_F(HierarchyTest, TestHierarchyDirtyParent)
+{
+    dmGameObject::HInstance parent = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance child = dmGameObject::New(m_Collection, "/go.goc");
+
+    dmGameObject::SetPosition(child, Point3(1.0f, 0.0f, 0.0f));
+    dmGameObject::SetParent(child, parent);
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_NEAR(1.0f, dmGameObject::GetWorldPosition(child).getX(), EPSILON);
+
+    dmGameObject::SetPosition(parent, Point3(2.0f, 0.0f, 0.0f));
+    dmGameObject::UpdateTransforms(m_Collection);
+    ASSERT_NEAR(2.0f, dmGameObject::GetWorldPosition(parent).getX(), EPSILON);
+    ASSERT_NEAR(3.0f, dmGameObject::GetWorldPosition(child).getX(), EPSILON);
+
+    // Through the property system, as used by go.set and go.animate
+    dmGameObject::PropertyOptions opt;
+    opt.m_Index = 0;
+    opt.m_HasKey = 0;
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(parent, 0, dmHashString64("position.x"), opt, dmGameObject::PropertyVar(4.0f)));
+    dmGameObject::UpdateTransforms(m_Collection);
+    ASSERT_NEAR(5.0f, dmGameObject::GetWorldPosition(child).getX(), EPSILON);
+
+    // Unchanged instances keep their world transforms
+    dmGameObject::UpdateTransforms(m_Collection);
+    ASSERT_NEAR(4.0f, dmGameObject::GetWorldPosition(parent).getX(), EPSILON);
+    ASSERT_NEAR(5.0f, dmGameObject::GetWorldPosition(child).getX(), EPSILON);
+
+    dmGameObject::Delete(m_Collection, child, false);
+    dmGameObject::Delete(m_Collection, parent, false);
+}
+
+TEST_F(HierarchyTest, TestHierarchySetTransforms2D)
+{
+    dmGameObject::HInstance parent = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance child = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::SetPosition(parent, Point3(0.0f, 0.0f, 3.0f));
+    dmGameObject::SetPosition(child, Point3(1.0f, 0.0f, 0.0f));
+    dmGameObject::SetParent(child, parent);
+    dmGameObject::UpdateTransforms(m_Collection);
+
+    // The z position is kept
+    dmGameObject::InstanceTransform2D transforms[2];
+    transforms[0].m_Instance = parent;
+    transforms[0].m_X = 2.0f;
+    transforms[0].m_Y = 1.0f;
+    transforms[0].m_Angle = (float)M_PI / 2.0f;
+    transforms[1].m_Instance = child;
+    transforms[1].m_X = 1.0f;
+    transforms[1].m_Y = 0.0f;
+    transforms[1].m_Angle = 0.0f;
+    dmGameObject::SetTransforms2D(transforms, 2);
+    ASSERT_NEAR(3.0f, dmGameObject::GetPosition(parent).getZ(), EPSILON);
+    ASSERT_NEAR(0.0f, dmGameObject::GetPosition(child).getZ(), EPSILON);
+
+    dmGameObject::UpdateTransforms(m_Collection);
+    Point3 child_position = dmGameObject::GetWorldPosition(child);
+    ASSERT_NEAR(2.0f, child_position.getX(), EPSILON);
+    ASSERT_NEAR(2.0f, child_position.getY(), EPSILON);
+    ASSERT_NEAR(3.0f, child_position.getZ(), EPSILON);
+
+    dmGameObject::Delete(m_Collection, child, false);
+    dmGameObject::Delete(m_Collection, parent, false);
+}
+
+TEST_F(HierarchyTest, TestHierarchyWorldTransformVersion)
+{
+    dmGameObject::HInstance parent = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance child = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::SetParent(child, parent);
+    dmGameObject::UpdateTransforms(m_Collection);
+
+    uint32_t parent_version = dmGameObject::GetWorldTransformVersion(parent);
+    uint32_t child_version = dmGameObject::GetWorldTransformVersion(child);
+
+    // Nothing changed
+    dmGameObject::UpdateTransforms(m_Collection);
+    ASSERT_EQ(parent_version, dmGameObject::GetWorldTransformVersion(parent));
+    ASSERT_EQ(child_version, dmGameObject::GetWorldTransformVersion(child));
+
+    // Moving the child doesn't affect the parent
+    dmGameObject::SetPosition(child, Point3(1.0f, 0.0f, 0.0f));
+    dmGameObject::UpdateTransforms(m_Collection);
+    ASSERT_EQ(parent_version, dmGameObject::GetWorldTransformVersion(parent));
+    ASSERT_NE(child_version, dmGameObject::GetWorldTransformVersion(child));
+    child_version = dmGameObject::GetWorldTransformVersion(child);
+
+    // Moving the parent also updates the child
+    dmGameObject::SetPosition(parent, Point3(1.0f, 0.0f, 0.0f));
+    dmGameObject::UpdateTransforms(m_Collection);
+    ASSERT_NE(parent_version, dmGameObject::GetWorldTransformVersion(parent));
+    ASSERT_NE(child_version, dmGameObject::GetWorldTransformVersion(child));
+
+    dmGameObject::Delete(m_Collection, child, false);
+    dmGameObject::Delete(m_Collection, parent, false);
+}
+
+// The dirty instances of a level are split into several transform jobs
+TEST_F(HierarchyTest, TestHierarchyJobPool)
+{
+    const uint32_t count = 500;
+    dmJobPool::HJobPool pool = dmJobPool::New(2);
+    dmGameObject::SetJobPool(m_Register, pool);
+
+    dmGameObject::HInstance parents[count];
+    dmGameObject::HInstance children[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        parents[i] = dmGameObject::New(m_Collection, "/go.goc");
+        children[i] = dmGameObject::New(m_Collection, "/go.goc");
+        dmGameObject::SetPosition(parents[i], Point3((float)i, 0.0f, 0.0f));
+        dmGameObject::SetPosition(children[i], Point3(0.0f, 1.0f, 0.0f));
+        dmGameObject::SetParent(children[i], parents[i]);
+    }
+
+    dmGameObject::UpdateTransforms(m_Collection);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_NEAR((float)i, dmGameObject::GetWorldPosition(children[i]).getX(), EPSILON);
+        ASSERT_NEAR(1.0f, dmGameObject::GetWorldPosition(children[i]).getY(), EPSILON);
+    }
+
+    for (uint32_t i = 0; i < count; i += 2)
+    {
+        dmGameObject::SetPosition(parents[i], Point3((float)i, 2.0f, 0.0f));
+    }
+    dmGameObject::UpdateTransforms(m_Collection);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_NEAR(i % 2 == 0 ? 3.0f : 1.0f, dmGameObject::GetWorldPosition(children[i]).getY(), EPSILON);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmGameObject::Delete(m_Collection, children[i], false);
+        dmGameObject::Delete(m_Collection, parents[i], false);
+    }
+    dmGameObject::SetJobPool(m_Register, 0x0);
+    dmJobPool::Delete(pool);
+}
+
 // Test depth-first order
 TEST_F(HierarchyTest, TestHierarchyBonesOrder)
 {
@@ -116,6 +116,27 @@ namespace dmGameSystem
         uint8_t m_FlippedY : 1;
     };
 
+    // Events collected during a step while any listener is set, see SetCollisionEventsListener
+    struct CollisionEventBuffer
+    {
+        dmArray<CollisionEventPair> m_Collisions;
+        dmArray<CollisionEventPair> m_Contacts;
+        dmArray<dmVMath::Point3>    m_ContactPositions;
+        dmArray<dmVMath::Vector3>   m_ContactNormals;
+        dmArray<float>              m_ContactDistances;
+        dmArray<float>              m_ContactImpulses;
+        dmArray<CollisionEventPair> m_Triggers;
+        dmArray<uint8_t>            m_TriggerEnter;
+    };
+
+    struct CollisionEventsListener
+    {
+        dmhash_t                m_Owner;
+        CollisionEventsCallback m_Callback; // 0x0 if removed during the dispatch
+        void*                   m_UserData;
+        bool                    m_PostMessages;
+    };
+
     struct CollisionWorld
     {
         uint64_t m_Groups[16];
@@ -129,12 +150,17 @@ namespace dmGameSystem
         uint8_t     m_ComponentTypeIndex;
         uint8_t     m_3D : 1;
         uint8_t     m_FirstUpdate : 1;
+        uint8_t     m_DispatchingEvents : 1;
+        uint8_t     m_PostMessages : 1; // Cleared while a listener has opted out of the messages
         dmArray<CollisionComponent*> m_Components;
+        dmArray<CollisionEventsListener> m_EventsListeners;
+        CollisionEventBuffer    m_Events;
     };
 
     // Forward declarations
     static void DeleteJoint(CollisionWorld* world, dmPhysics::HJoint joint);
     static void DeleteJoint(CollisionWorld* world, JointEntry* joint_entry);
+    static void RemoveCollisionEventsListeners(CollisionWorld* world);
 
     static void GetWorldTransform(void* user_data, dmTransform::Transform& world_transform)
     {
@@ -170,6 +196,34 @@ namespace dmGameSystem
         ++g_NumPhysicsTransformsUpdated;
     }
 
+    static void SetWorldTransforms2D(const dmPhysics::BodyTransform2D* transforms, uint32_t count)
+    {
+        // The transforms are handed over to the game objects in batches, to avoid the per instance setters
+        const uint32_t batch_size = 256;
+        dmGameObject::InstanceTransform2D batch[batch_size];
+        uint32_t batch_count = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const dmPhysics::BodyTransform2D& transform = transforms[i];
+            CollisionComponent* component = (CollisionComponent*)transform.m_UserData;
+            if (!component)
+                continue;
+            dmGameObject::InstanceTransform2D& instance_transform = batch[batch_count++];
+            instance_transform.m_Instance = component->m_Instance;
+            instance_transform.m_X = transform.m_X;
+            instance_transform.m_Y = transform.m_Y;
+            instance_transform.m_Angle = transform.m_Angle;
+            if (batch_count == batch_size)
+            {
+                dmGameObject::SetTransforms2D(batch, batch_count);
+                g_NumPhysicsTransformsUpdated += batch_count;
+                batch_count = 0;
+            }
+        }
+        dmGameObject::SetTransforms2D(batch, batch_count);
+        g_NumPhysicsTransformsUpdated += batch_count;
+    }
+
     dmGameObject::CreateResult CompCollisionObjectNewWorld(const dmGameObject::ComponentNewWorldParams& params)
     {
         if (params.m_MaxComponentInstances == 0)
@@ -181,6 +235,7 @@ namespace dmGameSystem
         dmPhysics::NewWorldParams world_params;
         world_params.m_GetWorldTransformCallback = GetWorldTransform;
         world_params.m_SetWorldTransformCallback = SetWorldTransform;
+        world_params.m_SetWorldTransforms2DCallback = SetWorldTransforms2D;
 
         dmPhysics::HWorld2D world2D;
         dmPhysics::HWorld3D world3D;
@@ -216,6 +271,7 @@ namespace dmGameSystem
         world->m_ComponentTypeIndex = params.m_ComponentIndex;
         world->m_3D = physics_context->m_3D;
         world->m_FirstUpdate = 1;
+        world->m_PostMessages = 1;
         uint32_t comp_count = params.m_MaxComponentInstances;
         if (comp_count == 0xFFFFFFFF)
         {
@@ -234,6 +290,7 @@ namespace dmGameSystem
         {
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
+        RemoveCollisionEventsListeners(world);
         if (physics_context->m_3D)
             dmPhysics::DeleteWorld3D(physics_context->m_Context3D, world->m_World3D);
         else
@@ -570,9 +627,168 @@ namespace dmGameSystem
         }
     }
 
+    template <typename T>
+    static inline void PushEvent(dmArray<T>& array, const T& value)
+    {
+        if (array.Full())
+        {
+            array.OffsetCapacity(dmMath::Max(array.Capacity(), 32U));
+        }
+        array.Push(value);
+    }
+
+    static inline void PushEventPair(CollisionWorld* world, dmArray<CollisionEventPair>& pairs, void* user_data_a, uint16_t group_a, void* user_data_b, uint16_t group_b)
+    {
+        CollisionEventPair pair;
+        pair.m_IdA = dmGameObject::GetIdentifier(((CollisionComponent*)user_data_a)->m_Instance);
+        pair.m_IdB = dmGameObject::GetIdentifier(((CollisionComponent*)user_data_b)->m_Instance);
+        pair.m_GroupA = GetLSBGroupHash(world, group_a);
+        pair.m_GroupB = GetLSBGroupHash(world, group_b);
+        PushEvent(pairs, pair);
+    }
+
+    static void ClearCollisionEvents(CollisionEventBuffer& events)
+    {
+        events.m_Collisions.SetSize(0);
+        events.m_Contacts.SetSize(0);
+        events.m_ContactPositions.SetSize(0);
+        events.m_ContactNormals.SetSize(0);
+        events.m_ContactDistances.SetSize(0);
+        events.m_ContactImpulses.SetSize(0);
+        events.m_Triggers.SetSize(0);
+        events.m_TriggerEnter.SetSize(0);
+    }
+
+    // Removes the listeners that were removed during the dispatch, keeping the order of the others
+    static void CompactCollisionEventsListeners(CollisionWorld* world)
+    {
+        dmArray<CollisionEventsListener>& listeners = world->m_EventsListeners;
+        uint32_t size = 0;
+        bool post_messages = true;
+        for (uint32_t i = 0; i < listeners.Size(); ++i)
+        {
+            if (listeners[i].m_Callback)
+            {
+                post_messages &= listeners[i].m_PostMessages;
+                listeners[size++] = listeners[i];
+            }
+        }
+        listeners.SetSize(size);
+        world->m_PostMessages = post_messages;
+    }
+
+    static void RemoveCollisionEventsListener(CollisionWorld* world, uint32_t index)
+    {
+        CollisionEventsListener listener = world->m_EventsListeners[index];
+        world->m_EventsListeners[index].m_Callback = 0x0;
+        if (!world->m_DispatchingEvents)
+        {
+            CompactCollisionEventsListeners(world);
+        }
+        listener.m_Callback(0x0, listener.m_UserData);
+    }
+
+    static void RemoveCollisionEventsListeners(CollisionWorld* world)
+    {
+        dmArray<CollisionEventsListener>& listeners = world->m_EventsListeners;
+        while (!listeners.Empty())
+        {
+            CollisionEventsListener listener = listeners.Back();
+            listeners.Pop();
+            if (listener.m_Callback)
+            {
+                listener.m_Callback(0x0, listener.m_UserData);
+            }
+        }
+    }
+
+    void SetCollisionEventsListener(void* _world, dmhash_t owner, CollisionEventsCallback callback, void* user_data, bool post_messages)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        dmArray<CollisionEventsListener>& listeners = world->m_EventsListeners;
+        for (uint32_t i = 0; i < listeners.Size(); ++i)
+        {
+            if (listeners[i].m_Owner == owner && listeners[i].m_Callback)
+            {
+                RemoveCollisionEventsListener(world, i);
+                break;
+            }
+        }
+
+        if (callback)
+        {
+            CollisionEventsListener listener;
+            listener.m_Owner = owner;
+            listener.m_Callback = callback;
+            listener.m_UserData = user_data;
+            listener.m_PostMessages = post_messages;
+            PushEvent(listeners, listener);
+            world->m_PostMessages &= post_messages;
+        }
+    }
+
+    // Hands the events of the last step to each listener, in a single call per listener
+    static void DispatchCollisionEvents(CollisionWorld* world)
+    {
+        CollisionEventBuffer& buffer = world->m_Events;
+        if (world->m_EventsListeners.Empty() || (buffer.m_Collisions.Empty() && buffer.m_Contacts.Empty() && buffer.m_Triggers.Empty()))
+        {
+            // The last listener might have been removed after the events were collected
+            ClearCollisionEvents(buffer);
+            return;
+        }
+
+        DM_PROFILE("CollisionEvents");
+
+        CollisionEvents events;
+        events.m_Collisions = buffer.m_Collisions.Begin();
+        events.m_CollisionCount = buffer.m_Collisions.Size();
+        events.m_Contacts = buffer.m_Contacts.Begin();
+        events.m_ContactPositions = buffer.m_ContactPositions.Begin();
+        events.m_ContactNormals = buffer.m_ContactNormals.Begin();
+        events.m_ContactDistances = buffer.m_ContactDistances.Begin();
+        events.m_ContactImpulses = buffer.m_ContactImpulses.Begin();
+        events.m_ContactCount = buffer.m_Contacts.Size();
+        events.m_Triggers = buffer.m_Triggers.Begin();
+        events.m_TriggerEnter = buffer.m_TriggerEnter.Begin();
+        events.m_TriggerCount = buffer.m_Triggers.Size();
+
+        // Listeners can be added and removed from within the callbacks. Removed ones are only
+        // cleared until the dispatch is done, and added ones get the events of the next step.
+        world->m_DispatchingEvents = 1;
+        uint32_t listener_count = world->m_EventsListeners.Size();
+        for (uint32_t i = 0; i < listener_count; ++i)
+        {
+            CollisionEventsListener listener = world->m_EventsListeners[i];
+            if (listener.m_Callback == 0x0)
+            {
+                continue;
+            }
+
+            bool keep = listener.m_Callback(&events, listener.m_UserData);
+            if (!keep && world->m_EventsListeners[i].m_Callback)
+            {
+                RemoveCollisionEventsListener(world, i);
+            }
+        }
+        world->m_DispatchingEvents = 0;
+        CompactCollisionEventsListeners(world);
+
+        ClearCollisionEvents(buffer);
+    }
+
     bool CollisionCallback(void* user_data_a, uint16_t group_a, void* user_data_b, uint16_t group_b, void* user_data)
     {
         CollisionUserData* cud = (CollisionUserData*)user_data;
+        bool listening = !cud->m_World->m_EventsListeners.Empty();
+        if (listening)
+        {
+            PushEventPair(cud->m_World, cud->m_World->m_Events.m_Collisions, user_data_a, group_a, user_data_b, group_b);
+        }
+        if (!cud->m_World->m_PostMessages)
+        {
+            return true;
+        }
         if (cud->m_Count < cud->m_Context->m_MaxCollisionCount)
         {
             cud->m_Count += 1;
@@ -609,13 +825,28 @@ namespace dmGameSystem
         }
         else
         {
-            return false;
+            // The listeners get all events, only the messages are limited
+            return listening;
         }
     }
 
     bool ContactPointCallback(const dmPhysics::ContactPoint& contact_point, void* user_data)
     {
         CollisionUserData* cud = (CollisionUserData*)user_data;
+        bool listening = !cud->m_World->m_EventsListeners.Empty();
+        if (listening)
+        {
+            CollisionEventBuffer& events = cud->m_World->m_Events;
+            PushEventPair(cud->m_World, events.m_Contacts, contact_point.m_UserDataA, contact_point.m_GroupA, contact_point.m_UserDataB, contact_point.m_GroupB);
+            PushEvent(events.m_ContactPositions, contact_point.m_PositionA);
+            PushEvent(events.m_ContactNormals, contact_point.m_Normal);
+            PushEvent(events.m_ContactDistances, contact_point.m_Distance);
+            PushEvent(events.m_ContactImpulses, contact_point.m_AppliedImpulse);
+        }
+        if (!cud->m_World->m_PostMessages)
+        {
+            return true;
+        }
         if (cud->m_Count < cud->m_Context->m_MaxContactPointCount)
         {
             cud->m_Count += 1;
@@ -670,7 +901,8 @@ namespace dmGameSystem
         }
         else
         {
-            return false;
+            // The listeners get all events, only the messages are limited
+            return listening;
         }
     }
 
@@ -680,6 +912,15 @@ namespace dmGameSystem
     void TriggerEnteredCallback(const dmPhysics::TriggerEnter& trigger_enter, void* user_data)
     {
         CollisionWorld* world = (CollisionWorld*)user_data;
+        if (!world->m_EventsListeners.Empty())
+        {
+            PushEventPair(world, world->m_Events.m_Triggers, trigger_enter.m_UserDataA, trigger_enter.m_GroupA, trigger_enter.m_UserDataB, trigger_enter.m_GroupB);
+            PushEvent(world->m_Events.m_TriggerEnter, (uint8_t)1);
+        }
+        if (!world->m_PostMessages)
+        {
+            return;
+        }
         CollisionComponent* component_a = (CollisionComponent*)trigger_enter.m_UserDataA;
         CollisionComponent* component_b = (CollisionComponent*)trigger_enter.m_UserDataB;
         dmGameObject::HInstance instance_a = component_a->m_Instance;
@@ -711,6 +952,15 @@ namespace dmGameSystem
     void TriggerExitedCallback(const dmPhysics::TriggerExit& trigger_exit, void* user_data)
     {
         CollisionWorld* world = (CollisionWorld*)user_data;
+        if (!world->m_EventsListeners.Empty())
+        {
+            PushEventPair(world, world->m_Events.m_Triggers, trigger_exit.m_UserDataA, trigger_exit.m_GroupA, trigger_exit.m_UserDataB, trigger_exit.m_GroupB);
+            PushEvent(world->m_Events.m_TriggerEnter, (uint8_t)0);
+        }
+        if (!world->m_PostMessages)
+        {
+            return;
+        }
         CollisionComponent* component_a = (CollisionComponent*)trigger_exit.m_UserDataA;
         CollisionComponent* component_b = (CollisionComponent*)trigger_exit.m_UserDataB;
         dmGameObject::HInstance instance_a = component_a->m_Instance;
@@ -960,6 +1210,8 @@ namespace dmGameSystem
         {
             dmGameObject::UpdateTransforms(collection);
         }
+
+        DispatchCollisionEvents(world);
     }
 
     static dmGameObject::UpdateResult CompCollisionObjectUpdateInternal(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
@@ -1067,6 +1319,55 @@ namespace dmGameSystem
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
+    static bool CanSetGridShapeHulls(PhysicsContext* physics_context, CollisionComponent* component)
+    {
+        if (physics_context->m_3D)
+        {
+            dmLogError("Grid shape hulls can only be set for 2D physics.");
+            return false;
+        }
+        if (component->m_Resource->m_TileGrid == 0)
+        {
+            dmLogError("Hulls can only be set for collision objects with tile grids as shape.");
+            return false;
+        }
+        return true;
+    }
+
+    static bool SetGridShapeHull(CollisionWorld* world, CollisionComponent* component, uint32_t shape, uint32_t row, uint32_t column, uint32_t hull, dmPhysics::HullFlags flags)
+    {
+        TileGridResource* tile_grid_resource = component->m_Resource->m_TileGridResource;
+
+        if (row >= tile_grid_resource->m_RowCount || column >= tile_grid_resource->m_ColumnCount)
+        {
+            dmLogError("SetGridShapeHull: <row,column> out of bounds");
+            return false;
+        }
+        if (hull != ~0u && hull >= tile_grid_resource->m_TextureSet->m_HullCollisionGroups.Size())
+        {
+            dmLogError("SetGridShapHull: specified hull index is out of bounds.");
+            return false;
+        }
+
+        bool success = dmPhysics::SetGridShapeHull(component->m_Object2D, shape, row, column, hull, flags);
+        if (!success)
+        {
+            dmLogError("SetGridShapeHull: unable to set hull %d for shape %d", hull, shape);
+            return false;
+        }
+        uint16_t child = column + tile_grid_resource->m_ColumnCount * row;
+        uint16_t group = 0;
+        uint16_t mask = 0;
+        // Hull-index of 0xffffffff is empty cell
+        if (hull != ~0u)
+        {
+            group = GetGroupBitIndex(world, tile_grid_resource->m_TextureSet->m_HullCollisionGroups[hull], false);
+            mask = component->m_Mask;
+        }
+        dmPhysics::SetCollisionObjectFilter(component->m_Object2D, shape, child, group, mask);
+        return true;
+    }
+
     dmGameObject::UpdateResult CompCollisionObjectOnMessage(const dmGameObject::ComponentOnMessageParams& params)
     {
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
@@ -1137,54 +1438,38 @@ namespace dmGameSystem
         }
         else if (params.m_Message->m_Id == dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor->m_NameHash)
         {
-            if (physics_context->m_3D)
+            if (!CanSetGridShapeHulls(physics_context, component))
             {
-                dmLogError("Grid shape hulls can only be set for 2D physics.");
-                return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
-            }
-            if (component->m_Resource->m_TileGrid == 0)
-            {
-                dmLogError("Hulls can only be set for collision objects with tile grids as shape.");
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
             dmPhysicsDDF::SetGridShapeHull* ddf = (dmPhysicsDDF::SetGridShapeHull*) params.m_Message->m_Data;
-            uint32_t column = ddf->m_Column;
-            uint32_t row = ddf->m_Row;
-            uint32_t hull = ddf->m_Hull;
-
-            TileGridResource* tile_grid_resource = component->m_Resource->m_TileGridResource;
-
-            if (row >= tile_grid_resource->m_RowCount || column >= tile_grid_resource->m_ColumnCount)
+            dmPhysics::HullFlags flags;
+            flags.m_FlipHorizontal = ddf->m_FlipHorizontal;
+            flags.m_FlipVertical = ddf->m_FlipVertical;
+            flags.m_Rotate90 = ddf->m_Rotate90;
+            if (!SetGridShapeHull((CollisionWorld*)params.m_World, component, ddf->m_Shape, ddf->m_Row, ddf->m_Column, ddf->m_Hull, flags))
             {
-                dmLogError("SetGridShapeHull: <row,column> out of bounds");
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-            if (hull != ~0u && hull >= tile_grid_resource->m_TextureSet->m_HullCollisionGroups.Size())
+        }
+        else if (params.m_Message->m_Id == dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_NameHash)
+        {
+            if (!CanSetGridShapeHulls(physics_context, component))
             {
-                dmLogError("SetGridShapHull: specified hull index is out of bounds.");
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-
+            dmPhysicsDDF::SetGridShapeHulls* ddf = (dmPhysicsDDF::SetGridShapeHulls*) params.m_Message->m_Data;
+            const GridShapeHullCell* cells = (const GridShapeHullCell*) (uintptr_t) ddf->m_Cells;
             dmPhysics::HullFlags flags;
-            flags.m_FlipHorizontal = ddf->m_FlipHorizontal;
-            flags.m_FlipVertical = ddf->m_FlipVertical;
-            flags.m_Rotate90 = ddf->m_Rotate90;
-            bool success = dmPhysics::SetGridShapeHull(component->m_Object2D, ddf->m_Shape, row, column, hull, flags);
-            if (!success)
+            bool success = true;
+            for (uint32_t i = 0; i < ddf->m_Count; ++i)
             {
-                dmLogError("SetGridShapeHull: unable to set hull %d for shape %d", hull, ddf->m_Shape);
-                return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+                success &= SetGridShapeHull((CollisionWorld*)params.m_World, component, ddf->m_Shape, cells[i].m_Row, cells[i].m_Column, cells[i].m_Hull, flags);
             }
-            uint16_t child = column + tile_grid_resource->m_ColumnCount * row;
-            uint16_t group = 0;
-            uint16_t mask = 0;
-            // Hull-index of 0xffffffff is empty cell
-            if (hull != ~0u)
+            if (!success)
             {
-                group = GetGroupBitIndex((CollisionWorld*)params.m_World, tile_grid_resource->m_TextureSet->m_HullCollisionGroups[hull], false);
-                mask = component->m_Mask;
+                return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-            dmPhysics::SetCollisionObjectFilter(component->m_Object2D, ddf->m_Shape, child, group, mask);
         }
         else if(params.m_Message->m_Id == dmPhysicsDDF::EnableGridShapeLayer::m_DDFDescriptor->m_NameHash)
         {
@@ -1338,6 +1623,19 @@ namespace dmGameSystem
         }
     }
 
+    void RayCastBatch(void* _world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::RayCastBatch3D(world->m_World3D, requests, count, responses);
+        }
+        else
+        {
+            dmPhysics::RayCastBatch2D(world->m_World2D, requests, count, responses);
+        }
+    }
+
     // Find a JointEntry in the linked list of a collision component based on the joint id.
     static JointEntry* FindJointEntry(CollisionWorld* world, CollisionComponent* component, dmhash_t id)
     {
@@ -56,8 +56,58 @@ namespace dmGameSystem
 
     uint16_t CompCollisionGetGroupBitIndex(void* world, uint64_t group_hash);
 
+    // A pair of colliding objects, reported once per pair in CollisionEvents
+    struct CollisionEventPair
+    {
+        dmhash_t m_IdA;
+        dmhash_t m_IdB;
+        dmhash_t m_GroupA;
+        dmhash_t m_GroupB;
+    };
+
+    // The collision events of one physics update, stored as parallel arrays.
+    // The arrays are only valid during the CollisionEventsCallback call.
+    struct CollisionEvents
+    {
+        const CollisionEventPair*   m_Collisions;
+        uint32_t                    m_CollisionCount;
+
+        // Contact points. The position is on object a, and the normal points from a towards b
+        const CollisionEventPair*   m_Contacts;
+        const dmVMath::Point3*      m_ContactPositions;
+        const dmVMath::Vector3*     m_ContactNormals;
+        const float*                m_ContactDistances;
+        const float*                m_ContactImpulses;
+        uint32_t                    m_ContactCount;
+
+        const CollisionEventPair*   m_Triggers;
+        const uint8_t*              m_TriggerEnter; // 1 on enter, 0 on exit
+        uint32_t                    m_TriggerCount;
+    };
+
+    // Called once after each physics update that produced any events. Return false to remove the listener.
+    // Called with events set to 0x0 when the listener is removed, replaced or the world is deleted, so that user_data can be released.
+    typedef bool (*CollisionEventsCallback)(const CollisionEvents* events, void* user_data);
+
+    // Sets the listener of the owner, replacing any previous listener of the same owner. A world can have
+    // listeners of any number of owners. Pass a callback of 0x0 to remove the listener of the owner.
+    // While any listener is set, the events are also collected into the arrays, without the
+    // physics.max_collisions/max_contacts limits. The collision_response, contact_point_response and
+    // trigger_response messages are posted as usual, unless a listener of the world is set with
+    // post_messages false, in which case the world only collects the events.
+    void SetCollisionEventsListener(void* world, dmhash_t owner, CollisionEventsCallback callback, void* user_data, bool post_messages);
+
+    // A cell of a dmPhysicsDDF::SetGridShapeHulls message
+    struct GridShapeHullCell
+    {
+        uint32_t m_Row;
+        uint32_t m_Column;
+        uint32_t m_Hull;
+    };
+
     // For script_physics.cpp
     void RayCast(void* world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
+    void RayCastBatch(void* world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses);
     uint64_t GetLSBGroupHash(void* world, uint16_t mask);
     dmhash_t CompCollisionObjectGetIdentifier(void* component);
 
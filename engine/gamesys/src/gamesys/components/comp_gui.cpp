@@ -50,6 +50,8 @@
 DM_PROPERTY_EXTERN(rmtp_Components);
 DM_PROPERTY_GROUP(rmtp_ComponentsGui, "Gui component");
 DM_PROPERTY_U32(rmtp_GuiVertexCount, 0, FrameReset, "#", &rmtp_ComponentsGui);
+DM_PROPERTY_U32(rmtp_GuiReusedVertexCount, 0, FrameReset, "# vertices reused from the previous frame", &rmtp_ComponentsGui);
+DM_PROPERTY_U32(rmtp_GuiUploadedVertexCount, 0, FrameReset, "# vertices uploaded to the vertex buffer", &rmtp_ComponentsGui);
 
 namespace dmGameSystem
 {
@@ -127,6 +129,8 @@ namespace dmGameSystem
             {
                 dmGui::ReloadScene(component->m_Scene);
             }
+            // The cached vertices might refer to the texture set data that was reloaded
+            component->m_NodeVertexCache.SetSize(0);
         }
     }
 
@@ -158,7 +162,20 @@ namespace dmGameSystem
         gui_world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(dmRender::GetGraphicsContext(gui_context->m_RenderContext), ve, sizeof(ve) / sizeof(dmGraphics::VertexElement));
         // Grows automatically
         gui_world->m_ClientVertexBuffer.SetCapacity(512);
-        gui_world->m_VertexBuffer = dmGraphics::NewVertexBuffer(dmRender::GetGraphicsContext(gui_context->m_RenderContext), 0, 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        gui_world->m_PrevClientVertexBuffer.SetCapacity(512);
+        gui_world->m_DirtyVertexStart = 0xffffffff;
+        gui_world->m_DirtyVertexEnd = 0;
+        gui_world->m_FrameIndex = 0;
+        memset(&gui_world->m_Stats, 0, sizeof(gui_world->m_Stats));
+        for (uint32_t i = 0; i < GUI_VERTEX_BUFFER_COUNT; ++i)
+        {
+            GuiVertexBuffer& buffer = gui_world->m_VertexBuffers[i];
+            buffer.m_Buffer = dmGraphics::NewVertexBuffer(dmRender::GetGraphicsContext(gui_context->m_RenderContext), 0, 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+            buffer.m_Capacity = 0;
+            buffer.m_DirtyStart = 0xffffffff;
+            buffer.m_DirtyEnd = 0;
+        }
+        gui_world->m_VertexBuffer = gui_world->m_VertexBuffers[0].m_Buffer;
 
         uint8_t white_texture[] = { 0xff, 0xff, 0xff, 0xff,
                                     0xff, 0xff, 0xff, 0xff,
@@ -241,7 +258,10 @@ namespace dmGameSystem
         }
 
         dmGraphics::DeleteVertexDeclaration(gui_world->m_VertexDeclaration);
-        dmGraphics::DeleteVertexBuffer(gui_world->m_VertexBuffer);
+        for (uint32_t i = 0; i < GUI_VERTEX_BUFFER_COUNT; ++i)
+        {
+            dmGraphics::DeleteVertexBuffer(gui_world->m_VertexBuffers[i].m_Buffer);
+        }
         dmGraphics::DeleteTexture(gui_world->m_WhiteTexture);
 
         dmScript::DeleteScriptWorld(gui_world->m_ScriptWorld);
@@ -798,8 +818,20 @@ namespace dmGameSystem
 
         // true if the stencil is the first rendered (per scene)
         bool                        m_FirstStencil;
+
+        // The component being rendered, and the first render entry of its scene,
+        // used to look up the vertex cache of each node
+        GuiComponent*               m_Component;
+        const dmGui::RenderEntry*   m_FirstEntry;
     };
 
+    // Extends the range of vertices that changed since the previous frame
+    static inline void MarkVerticesDirty(GuiWorld* gui_world, uint32_t start, uint32_t end)
+    {
+        gui_world->m_DirtyVertexStart = dmMath::Min(gui_world->m_DirtyVertexStart, start);
+        gui_world->m_DirtyVertexEnd = dmMath::Max(gui_world->m_DirtyVertexEnd, end);
+    }
+
     inline uint32_t MakeFinalRenderOrder(uint32_t scene_order, uint32_t sub_order)
     {
         return (scene_order << 16) + sub_order;
@@ -1089,6 +1121,7 @@ namespace dmGameSystem
 
         ApplyStencilClipping(gui_context, stencil_scopes[0], ro);
         gui_world->m_ClientVertexBuffer.SetSize(vb_end - gui_world->m_ClientVertexBuffer.Begin());
+        MarkVerticesDirty(gui_world, ro.m_VertexStart, gui_world->m_ClientVertexBuffer.Size());
     }
 
     static GuiRenderObject* GetRenderObject(RenderGuiContext* gui_context)
@@ -1186,6 +1219,7 @@ namespace dmGameSystem
             uint32_t node_vertex_start = gui_world->m_ClientVertexBuffer.Size();
             gui_world->m_ClientVertexBuffer.SetSize(node_vertex_start + node_vertex_count);
             memcpy(gui_world->m_ClientVertexBuffer.Begin() + node_vertex_start, node_vertices.Begin(), node_vertex_count * sizeof(BoxVertex));
+            MarkVerticesDirty(gui_world, node_vertex_start, node_vertex_start + node_vertex_count);
         }
 
         ro.Init();
@@ -1211,6 +1245,260 @@ namespace dmGameSystem
         }
     }
 
+    static GuiNodeVertexCache* GetNodeVertexCache(RenderGuiContext* gui_context, const dmGui::RenderEntry* entry)
+    {
+        return &gui_context->m_Component->m_NodeVertexCache[entry - gui_context->m_FirstEntry];
+    }
+
+    // Copies the vertices the node generated in the previous frame, if nothing they depend on has changed.
+    // They only count as changed if they ended up at a different offset than in the previous frame.
+    static bool ReuseNodeVertices(GuiWorld* gui_world, const GuiNodeVertexCache* cache, dmGui::HNode node, const GuiNodeVertexKey& key)
+    {
+        if (cache->m_Node != node || cache->m_FrameIndex + 1 != gui_world->m_FrameIndex || memcmp(&cache->m_Key, &key, sizeof(key)) != 0)
+            return false;
+
+        dmArray<BoxVertex>& vertices = gui_world->m_ClientVertexBuffer;
+        uint32_t vertex_start = vertices.Size();
+        if (vertices.Remaining() < cache->m_VertexCount) {
+            vertices.OffsetCapacity(dmMath::Max(128U, cache->m_VertexCount));
+        }
+        vertices.SetSize(vertex_start + cache->m_VertexCount);
+        memcpy(vertices.Begin() + vertex_start, gui_world->m_PrevClientVertexBuffer.Begin() + cache->m_VertexStart, cache->m_VertexCount * sizeof(BoxVertex));
+
+        if (vertex_start != cache->m_VertexStart)
+        {
+            MarkVerticesDirty(gui_world, vertex_start, vertex_start + cache->m_VertexCount);
+        }
+        gui_world->m_Stats.m_ReusedVertexCount += cache->m_VertexCount;
+        DM_PROPERTY_ADD_U32(rmtp_GuiReusedVertexCount, cache->m_VertexCount);
+        return true;
+    }
+
+    static void StoreNodeVertices(GuiWorld* gui_world, GuiNodeVertexCache* cache, dmGui::HNode node, const GuiNodeVertexKey& key, uint32_t vertex_start)
+    {
+        cache->m_Key = key;
+        cache->m_Node = node;
+        cache->m_VertexStart = vertex_start;
+        cache->m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - vertex_start;
+        cache->m_FrameIndex = gui_world->m_FrameIndex;
+        gui_world->m_Stats.m_GeneratedVertexCount += cache->m_VertexCount;
+        MarkVerticesDirty(gui_world, vertex_start, gui_world->m_ClientVertexBuffer.Size());
+    }
+
+    // Generates the vertices of a box node. Everything the vertices depend on has to be in the key,
+    // since they are reused for as long as the key doesn't change, see ReuseNodeVertices
+    static void GenerateBoxNodeVertices(const GuiNodeVertexKey& key, dmArray<BoxVertex>& vertices)
+    {
+        const Vector4& pm_color = key.m_Color;
+
+        // default not uv_rotated texture coords
+        const float default_tc[6] = {0, 0, 0, 1, 1, 1};
+        const float* tc = key.m_TexCoords;
+
+        // tc equals 0 when texture is set from lua script directly with gui.set_texture(...) method
+        bool manually_set_texture = tc == 0;
+        if (manually_set_texture) {
+            tc = default_tc;
+        }
+
+        const Vector4& slice9 = key.m_Params;
+        bool use_slice_nine = sum(slice9) != 0;
+
+        // render simple quad ignoring 9-slicing
+        if ((!use_slice_nine && manually_set_texture) || !key.m_Texture)
+        {
+            BoxVertex v00;
+            v00.SetColor(pm_color);
+            v00.SetPosition(key.m_Transform * Point3(0, 0, 0));
+            v00.SetUV(0, 0);
+
+            BoxVertex v10;
+            v10.SetColor(pm_color);
+            v10.SetPosition(key.m_Transform * Point3(1, 0, 0));
+            v10.SetUV(1, 0);
+
+            BoxVertex v01;
+            v01.SetColor(pm_color);
+            v01.SetPosition(key.m_Transform * Point3(0, 1, 0));
+            v01.SetUV(0, 1);
+
+            BoxVertex v11;
+            v11.SetColor(pm_color);
+            v11.SetPosition(key.m_Transform * Point3(1, 1, 0));
+            v11.SetUV(1, 1);
+
+            vertices.Push(v00);
+            vertices.Push(v10);
+            vertices.Push(v11);
+            vertices.Push(v00);
+            vertices.Push(v11);
+            vertices.Push(v01);
+            return;
+        }
+
+        dmGameSystemDDF::TextureSet* texture_set_ddf = (dmGameSystemDDF::TextureSet*)key.m_TextureSet;
+        bool use_geometries = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
+
+        bool flip_u = key.m_FlipU;
+        bool flip_v = key.m_FlipV;
+
+        // render using geometries without 9-slicing
+        if (!use_slice_nine && use_geometries)
+        {
+            int32_t frame_index = texture_set_ddf->m_FrameIndices[key.m_AnimationFrame];
+
+            const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
+
+            const Matrix4& w = key.m_Transform;
+
+            // NOTE: The original rendering code is from the comp_sprite.cpp.
+            // Compare with that one if you do any changes to either.
+            uint32_t num_points = geometry->m_Vertices.m_Count / 2;
+
+            const float* points = geometry->m_Vertices.m_Data;
+            const float* uvs = geometry->m_Uvs.m_Data;
+
+            // Depending on the sprite is flipped or not, we loop the vertices forward or backward
+            // to respect face winding (and backface culling)
+            int reverse = (int)flip_u ^ (int)flip_v;
+
+            float scaleX = flip_u ? -1 : 1;
+            float scaleY = flip_v ? -1 : 1;
+
+            // Since we don't use an index buffer, we duplicate the vertices manually
+            uint32_t index_count = geometry->m_Indices.m_Count;
+            for (uint32_t index = 0; index < index_count; ++index)
+            {
+                uint32_t i = geometry->m_Indices.m_Data[index];
+                i = reverse ? (num_points - i - 1) : i;
+
+                const float* point = &points[i * 2];
+                const float* uv = &uvs[i * 2];
+                // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
+                float x = point[0] * scaleX + 0.5f;
+                float y = point[1] * scaleY + 0.5f;
+
+                Vector4 p = w * Point3(x, y, 0.0f);
+                BoxVertex v(p, uv[0], uv[1], pm_color);
+                vertices.Push(v);
+            }
+            return;
+        }
+
+        // render 9-sliced node
+
+        //   0 1     2 3
+        // 0 *-*-----*-*
+        //   | |  y  | |
+        // 1 *-*-----*-*
+        //   | |     | |
+        //   |x|     |z|
+        //   | |     | |
+        // 2 *-*-----*-*
+        //   | |  w  | |
+        // 3 *-*-----*-*
+        float us[4], vs[4], xs[4], ys[4];
+
+        // v are '1-v'
+        xs[0] = ys[0] = 0;
+        xs[3] = ys[3] = 1;
+
+        // disable slice9 computation below a certain dimension
+        // (avoid div by zero)
+        const float s9_min_dim = 0.001f;
+
+        const float su = 1.0f / (float)key.m_TextureWidth;
+        const float sv = 1.0f / (float)key.m_TextureHeight;
+
+        const Vector4& size = key.m_Size;
+        const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
+        const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
+
+        static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
+        bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+        if(uv_rotated)
+        {
+            const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getW());
+            us[uI[2]] = tc[2] - (su * slice9.getY());
+            us[uI[3]] = tc[2];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] - (sv * slice9.getX());
+            vs[vI[2]] = tc[5] + (sv * slice9.getZ());
+            vs[vI[3]] = tc[5];
+        }
+        else
+        {
+            const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getX());
+            us[uI[2]] = tc[4] - (su * slice9.getZ());
+            us[uI[3]] = tc[4];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] + (sv * slice9.getW());
+            vs[vI[2]] = tc[3] - (sv * slice9.getY());
+            vs[vI[3]] = tc[3];
+        }
+
+        xs[1] = sx * slice9.getX();
+        xs[2] = 1 - sx * slice9.getZ();
+        ys[1] = sy * slice9.getW();
+        ys[2] = 1 - sy * slice9.getY();
+
+        const Matrix4* transform = &key.m_Transform;
+        Vector4 pts[4][4];
+        for (int y=0;y<4;y++)
+        {
+            for (int x=0;x<4;x++)
+            {
+                pts[y][x] = (*transform * Point3(xs[x], ys[y], 0));
+            }
+        }
+
+        BoxVertex v00, v10, v01, v11;
+        v00.SetColor(pm_color);
+        v10.SetColor(pm_color);
+        v01.SetColor(pm_color);
+        v11.SetColor(pm_color);
+        for (int y=0;y<3;y++)
+        {
+            for (int x=0;x<3;x++)
+            {
+                const int x0 = x;
+                const int x1 = x+1;
+                const int y0 = y;
+                const int y1 = y+1;
+                v00.SetPosition(pts[y0][x0]);
+                v10.SetPosition(pts[y0][x1]);
+                v01.SetPosition(pts[y1][x0]);
+                v11.SetPosition(pts[y1][x1]);
+                if(uv_rotated)
+                {
+                    v00.SetUV(us[y0], vs[x0]);
+                    v10.SetUV(us[y0], vs[x1]);
+                    v01.SetUV(us[y1], vs[x0]);
+                    v11.SetUV(us[y1], vs[x1]);
+                }
+                else
+                {
+                    v00.SetUV(us[x0], vs[y0]);
+                    v10.SetUV(us[x1], vs[y0]);
+                    v01.SetUV(us[x0], vs[y1]);
+                    v11.SetUV(us[x1], vs[y1]);
+                }
+                vertices.Push(v00);
+                vertices.Push(v10);
+                vertices.Push(v11);
+                vertices.Push(v00);
+                vertices.Push(v11);
+                vertices.Push(v01);
+            }
+        }
+    }
+
     static void RenderBoxNodes(dmGui::HScene scene,
                         const dmGui::RenderEntry* entries,
                         const Matrix4* node_transforms,
@@ -1263,253 +1551,200 @@ namespace dmGameSystem
 
         // 9-slice values are specified with reference to the original graphics and not by
         // the possibly stretched texture.
-        float org_width = (float)dmGraphics::GetOriginalTextureWidth(ro.m_Textures[0]);
-        float org_height = (float)dmGraphics::GetOriginalTextureHeight(ro.m_Textures[0]);
+        uint32_t org_width = dmGraphics::GetOriginalTextureWidth(ro.m_Textures[0]);
+        uint32_t org_height = dmGraphics::GetOriginalTextureHeight(ro.m_Textures[0]);
         assert(org_width > 0 && org_height > 0);
 
-        int rendered_vert_count = 0;
         for (uint32_t i = 0; i < node_count; ++i)
         {
             const dmGui::HNode node = entries[i].m_Node;
 
             // pre-multiplied alpha
             const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
-            Vector4 pm_color(color.getXYZ(), node_opacities[i]);
-
-            // default not uv_rotated texture coords
-            const float default_tc[6] = {0, 0, 0, 1, 1, 1};
-            const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
-
-            // tc equals 0 when texture is set from lua script directly with gui.set_texture(...) method
-            bool manually_set_texture = tc == 0;
-            if (manually_set_texture) {
-                tc = default_tc;
-            }
-
-            Vector4 slice9 = dmGui::GetNodeSlice9(scene, node);
-            bool use_slice_nine = sum(slice9) != 0;
 
-            // render simple quad ignoring 9-slicing
-            if ((!use_slice_nine && manually_set_texture) || !texture)
+            GuiNodeVertexKey key;
+            memset(&key, 0, sizeof(key));
+            key.m_Transform = node_transforms[i];
+            key.m_Color = Vector4(color.getXYZ(), node_opacities[i]);
+            key.m_Size = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_SIZE);
+            key.m_Params = dmGui::GetNodeSlice9(scene, node);
+            key.m_TexCoords = dmGui::GetNodeFlipbookAnimUV(scene, node);
+            key.m_Texture = texture;
+            key.m_TextureWidth = org_width;
+            key.m_TextureHeight = org_height;
+            if (key.m_TexCoords)
             {
-                BoxVertex v00;
-                v00.SetColor(pm_color);
-                v00.SetPosition(node_transforms[i] * Point3(0, 0, 0));
-                v00.SetUV(0, 0);
-
-                BoxVertex v10;
-                v10.SetColor(pm_color);
-                v10.SetPosition(node_transforms[i] * Point3(1, 0, 0));
-                v10.SetUV(1, 0);
-
-                BoxVertex v01;
-                v01.SetColor(pm_color);
-                v01.SetPosition(node_transforms[i] * Point3(0, 1, 0));
-                v01.SetUV(0, 1);
-
-                BoxVertex v11;
-                v11.SetColor(pm_color);
-                v11.SetPosition(node_transforms[i] * Point3(1, 1, 0));
-                v11.SetUV(1, 1);
-
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v10);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v01);
-
-                rendered_vert_count += 6;
-                continue;
-            }
-
-            dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
-            dmGameSystemDDF::TextureSet* texture_set_ddf = anim_desc ? (dmGameSystemDDF::TextureSet*)anim_desc->m_TextureSet : 0;
-            bool use_geometries = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
-
-            bool flip_u = false;
-            bool flip_v = false;
-            if (!manually_set_texture)
+                // tc equals 0 when texture is set from lua script directly with gui.set_texture(...) method
+                dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
+                key.m_TextureSet = anim_desc ? anim_desc->m_TextureSet : 0;
+                key.m_AnimationFrame = dmGui::GetNodeAnimationFrame(scene, node);
+                bool flip_u, flip_v;
                 GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
+                key.m_FlipU = flip_u;
+                key.m_FlipV = flip_v;
+            }
 
-            // render using geometries without 9-slicing
-            if (!use_slice_nine && use_geometries)
+            GuiNodeVertexCache* cache = GetNodeVertexCache(gui_context, entries + i);
+            if (!ReuseNodeVertices(gui_world, cache, node, key))
             {
-                int32_t frame_index = dmGui::GetNodeAnimationFrame(scene, node);
-                frame_index = texture_set_ddf->m_FrameIndices[frame_index];
-
-                const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
-
-                const Matrix4& w = node_transforms[i];
-
-                // NOTE: The original rendering code is from the comp_sprite.cpp.
-                // Compare with that one if you do any changes to either.
-                uint32_t num_points = geometry->m_Vertices.m_Count / 2;
+                uint32_t vertex_start = gui_world->m_ClientVertexBuffer.Size();
+                GenerateBoxNodeVertices(key, gui_world->m_ClientVertexBuffer);
+                StoreNodeVertices(gui_world, cache, node, key, vertex_start);
+            }
+        }
 
-                const float* points = geometry->m_Vertices.m_Data;
-                const float* uvs = geometry->m_Uvs.m_Data;
+        ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
+    }
 
-                // Depending on the sprite is flipped or not, we loop the vertices forward or backward
-                // to respect face winding (and backface culling)
-                int reverse = (int)flip_u ^ (int)flip_v;
+    // Computes max vertices required in the vertex buffer to draw a pie node with a
+    // given number of perimeter vertices in its configuration.
+    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
+    {
+        // 1.  Minimum is capped to 4
+        // 2a. There will always be one extra needed to complete a full fill.
+        //     I.e. an 8-gon will need 9 vertices around, where the first and last
+        //     overlap. (+1)
+        // 2b. If the shape has rectangular bounds and pass through all four corners,
+        //     there will be 4 vertices inserted around the loop. (+4)
+        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
+        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
+        //     doubled vertices to tie it together (+2)
+        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+    }
 
-                float scaleX = flip_u ? -1 : 1;
-                float scaleY = flip_v ? -1 : 1;
+    // Generates the vertices of a pie node, from the key only (see GenerateBoxNodeVertices)
+    static void GeneratePieNodeVertices(const GuiNodeVertexKey& key, dmArray<BoxVertex>& vertices)
+    {
+        const Vector4& size = key.m_Size;
 
-                // Since we don't use an index buffer, we duplicate the vertices manually
-                uint32_t index_count = geometry->m_Indices.m_Count;
-                for (uint32_t index = 0; index < index_count; ++index)
-                {
-                    uint32_t i = geometry->m_Indices.m_Data[index];
-                    i = reverse ? (num_points - i - 1) : i;
-
-                    const float* point = &points[i * 2];
-                    const float* uv = &uvs[i * 2];
-                    // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
-                    float x = point[0] * scaleX + 0.5f;
-                    float y = point[1] * scaleY + 0.5f;
-
-                    Vector4 p = w * Point3(x, y, 0.0f);
-                    BoxVertex v(p, uv[0], uv[1], pm_color);
-                    gui_world->m_ClientVertexBuffer.Push(v);
-                }
+        if (dmMath::Abs(size.getX()) < 0.001f)
+            return;
 
-                rendered_vert_count += index_count;
-                continue;
-            }
+        const Vector4& pm_color = key.m_Color;
 
-            // render 9-sliced node
+        const uint32_t perimeterVertices = dmMath::Max<uint32_t>(4, (uint32_t)key.m_Params.getZ());
+        const float innerMultiplier = key.m_Params.getX() / size.getX();
+        const dmGui::PieBounds outerBounds = (dmGui::PieBounds)(uint32_t)key.m_Params.getW();
 
-            //   0 1     2 3
-            // 0 *-*-----*-*
-            //   | |  y  | |
-            // 1 *-*-----*-*
-            //   | |     | |
-            //   |x|     |z|
-            //   | |     | |
-            // 2 *-*-----*-*
-            //   | |  w  | |
-            // 3 *-*-----*-*
-            float us[4], vs[4], xs[4], ys[4];
+        const float PI = 3.1415926535f;
+        const float ad = PI * 2.0f / (float)perimeterVertices;
 
-            // v are '1-v'
-            xs[0] = ys[0] = 0;
-            xs[3] = ys[3] = 1;
+        float stopAngle = key.m_Params.getY();
+        bool backwards = false;
+        if (stopAngle < 0)
+        {
+            stopAngle = -stopAngle;
+            backwards = true;
+        }
 
-            // disable slice9 computation below a certain dimension
-            // (avoid div by zero)
-            const float s9_min_dim = 0.001f;
+        stopAngle = dmMath::Min(360.0f, stopAngle) * PI / 180.0f;
 
-            const float su = 1.0f / org_width;
-            const float sv = 1.0f / org_height;
+        // 1. Division computes number of cirlce segments needed, and we need 1 more
+        // vertex than that (1 lone segment = 2 perimeter vertices).
+        // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
+        // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
+        // floating point imprecision)
+        const uint32_t generate = floorf(stopAngle / ad + 0.999f) + 1;
 
-            Point3 size = dmGui::GetNodeSize(scene, node);
-            const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
-            const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
+        float lastAngle = 0;
+        float nextCorner = 0.25f * PI; // upper right rectangle corner at 45 deg
+        bool first = true;
 
-            static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
-            bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-            if(uv_rotated)
+        float u0,su,v0,sv;
+        bool uv_rotated;
+        const float* tc = key.m_TexCoords;
+        if(tc)
+        {
+            bool flip_u = key.m_FlipU;
+            bool flip_v = key.m_FlipV;
+            uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+            if(uv_rotated ? flip_v : flip_u)
             {
-                const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getW());
-                us[uI[2]] = tc[2] - (su * slice9.getY());
-                us[uI[3]] = tc[2];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] - (sv * slice9.getX());
-                vs[vI[2]] = tc[5] + (sv * slice9.getZ());
-                vs[vI[3]] = tc[5];
+                su = -(tc[4] - tc[0]);
+                u0 = tc[0] - su;
             }
             else
             {
-                const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getX());
-                us[uI[2]] = tc[4] - (su * slice9.getZ());
-                us[uI[3]] = tc[4];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] + (sv * slice9.getW());
-                vs[vI[2]] = tc[3] - (sv * slice9.getY());
-                vs[vI[3]] = tc[3];
-            }
-
-            xs[1] = sx * slice9.getX();
-            xs[2] = 1 - sx * slice9.getZ();
-            ys[1] = sy * slice9.getW();
-            ys[2] = 1 - sy * slice9.getY();
-
-            const Matrix4* transform = &node_transforms[i];
-            Vector4 pts[4][4];
-            for (int y=0;y<4;y++)
+                u0 = tc[0];
+                su = tc[4] - u0;
+            }
+            uint32_t v0i = uv_rotated ? 1 : 3;
+            uint32_t v1i = uv_rotated ? 5 : 1;
+            if(uv_rotated ? flip_u : flip_v)
             {
-                for (int x=0;x<4;x++)
-                {
-                    pts[y][x] = (*transform * Point3(xs[x], ys[y], 0));
-                }
+                sv = -(tc[v1i] - tc[v0i]);
+                v0 = tc[v0i] - sv;
             }
+            else
+            {
+                v0 = tc[v0i];
+                sv = tc[v1i] - v0;
+            }
+        }
+        else
+        {
+            uv_rotated = false;
+            u0 = 0.0f;
+            su = 1.0f;
+            v0 = 1.0f;
+            sv = -1.0f;
+        }
 
-            BoxVertex v00, v10, v01, v11;
-            v00.SetColor(pm_color);
-            v10.SetColor(pm_color);
-            v01.SetColor(pm_color);
-            v11.SetColor(pm_color);
-            for (int y=0;y<3;y++)
+        for (uint32_t j = 0; j != generate; j++)
+        {
+            float a;
+            if (j == (generate-1))
+                a = stopAngle;
+            else
+                a = ad * j;
+
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
             {
-                for (int x=0;x<3;x++)
+                // insert extra vertex (and ignore == case)
+                if (lastAngle < nextCorner && a >= nextCorner)
                 {
-                    const int x0 = x;
-                    const int x1 = x+1;
-                    const int y0 = y;
-                    const int y1 = y+1;
-                    v00.SetPosition(pts[y0][x0]);
-                    v10.SetPosition(pts[y0][x1]);
-                    v01.SetPosition(pts[y1][x0]);
-                    v11.SetPosition(pts[y1][x1]);
-                    if(uv_rotated)
-                    {
-                        v00.SetUV(us[y0], vs[x0]);
-                        v10.SetUV(us[y0], vs[x1]);
-                        v01.SetUV(us[y1], vs[x0]);
-                        v11.SetUV(us[y1], vs[x1]);
-                    }
-                    else
-                    {
-                        v00.SetUV(us[x0], vs[y0]);
-                        v10.SetUV(us[x1], vs[y0]);
-                        v01.SetUV(us[x0], vs[y1]);
-                        v11.SetUV(us[x1], vs[y1]);
-                    }
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v10);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v01);
+                    a = nextCorner;
+                    nextCorner += 0.50f * PI;
+                    --j;
                 }
+
+                lastAngle = a;
             }
-            rendered_vert_count += verts_per_node;
-        }
 
-        ro.m_VertexCount = rendered_vert_count;
-    }
+            const float s = dmTrigLookup::Sin(backwards ? -a : a);
+            const float c = dmTrigLookup::Cos(backwards ? -a : a);
 
-    // Computes max vertices required in the vertex buffer to draw a pie node with a
-    // given number of perimeter vertices in its configuration.
-    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
-    {
-        // 1.  Minimum is capped to 4
-        // 2a. There will always be one extra needed to complete a full fill.
-        //     I.e. an 8-gon will need 9 vertices around, where the first and last
-        //     overlap. (+1)
-        // 2b. If the shape has rectangular bounds and pass through all four corners,
-        //     there will be 4 vertices inserted around the loop. (+4)
-        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
-        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
-        //     doubled vertices to tie it together (+2)
-        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+            // make inner vertex
+            float u = 0.5f + innerMultiplier * c;
+            float v = 0.5f + innerMultiplier * s;
+            BoxVertex vInner(key.m_Transform * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
+
+            // make outer vertex
+            float d;
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
+                d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
+            else
+                d = 0.5f;
+
+            u = 0.5f + d * c;
+            v = 0.5f + d * s;
+            BoxVertex vOuter(key.m_Transform * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
+
+            // both inner & outer are doubled at first / last entry to generate degenerate triangles
+            // for the triangle strip, allowing more than one pie to be chained together in the same
+            // drawcall.
+            if (first)
+            {
+                vertices.Push(vInner);
+                first = false;
+            }
+
+            vertices.Push(vInner);
+            vertices.Push(vOuter);
+
+            if (j == generate-1)
+                vertices.Push(vOuter);
+        }
     }
 
     static void RenderPieNodes(dmGui::HScene scene,
@@ -1569,142 +1804,37 @@ namespace dmGameSystem
         for (uint32_t i = 0; i < node_count; ++i)
         {
             const dmGui::HNode node = entries[i].m_Node;
-            const Point3 size = dmGui::GetNodeSize(scene, node);
-
-            if (dmMath::Abs(size.getX()) < 0.001f)
-                continue;
-
-            const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
 
             // Pre-multiplied alpha
-            Vector4 pm_color(color.getXYZ(), node_opacities[i]);
-
-            const uint32_t perimeterVertices = dmMath::Max<uint32_t>(4, dmGui::GetNodePerimeterVertices(scene, node));
-            const float innerMultiplier = dmGui::GetNodeInnerRadius(scene, node) / size.getX();
-            const dmGui::PieBounds outerBounds = dmGui::GetNodeOuterBounds(scene, node);
-
-            const float PI = 3.1415926535f;
-            const float ad = PI * 2.0f / (float)perimeterVertices;
-
-            float stopAngle = dmGui::GetNodePieFillAngle(scene, node);
-            bool backwards = false;
-            if (stopAngle < 0)
-            {
-                stopAngle = -stopAngle;
-                backwards = true;
-            }
-
-            stopAngle = dmMath::Min(360.0f, stopAngle) * PI / 180.0f;
-
-            // 1. Division computes number of cirlce segments needed, and we need 1 more
-            // vertex than that (1 lone segment = 2 perimeter vertices).
-            // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
-            // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
-            // floating point imprecision)
-            const uint32_t generate = floorf(stopAngle / ad + 0.999f) + 1;
-
-            float lastAngle = 0;
-            float nextCorner = 0.25f * PI; // upper right rectangle corner at 45 deg
-            bool first = true;
+            const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
 
-            float u0,su,v0,sv;
-            bool uv_rotated;
-            const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
-            if(tc)
+            GuiNodeVertexKey key;
+            memset(&key, 0, sizeof(key));
+            key.m_Transform = node_transforms[i];
+            key.m_Color = Vector4(color.getXYZ(), node_opacities[i]);
+            key.m_Size = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_SIZE);
+            key.m_Params = Vector4(dmGui::GetNodeInnerRadius(scene, node),
+                                   dmGui::GetNodePieFillAngle(scene, node),
+                                   (float)dmGui::GetNodePerimeterVertices(scene, node),
+                                   (float)dmGui::GetNodeOuterBounds(scene, node));
+            key.m_TexCoords = dmGui::GetNodeFlipbookAnimUV(scene, node);
+            key.m_Texture = texture;
+            if (key.m_TexCoords)
             {
                 bool flip_u, flip_v;
                 GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
-                uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-                if(uv_rotated ? flip_v : flip_u)
-                {
-                    su = -(tc[4] - tc[0]);
-                    u0 = tc[0] - su;
-                }
-                else
-                {
-                    u0 = tc[0];
-                    su = tc[4] - u0;
-                }
-                uint32_t v0i = uv_rotated ? 1 : 3;
-                uint32_t v1i = uv_rotated ? 5 : 1;
-                if(uv_rotated ? flip_u : flip_v)
-                {
-                    sv = -(tc[v1i] - tc[v0i]);
-                    v0 = tc[v0i] - sv;
-                }
-                else
-                {
-                    v0 = tc[v0i];
-                    sv = tc[v1i] - v0;
-                }
-            }
-            else
-            {
-                uv_rotated = false;
-                u0 = 0.0f;
-                su = 1.0f;
-                v0 = 1.0f;
-                sv = -1.0f;
+                key.m_FlipU = flip_u;
+                key.m_FlipV = flip_v;
             }
 
-            uint32_t sizeBefore = gui_world->m_ClientVertexBuffer.Size();
-            for (uint32_t j = 0; j != generate; j++)
+            GuiNodeVertexCache* cache = GetNodeVertexCache(gui_context, entries + i);
+            if (!ReuseNodeVertices(gui_world, cache, node, key))
             {
-                float a;
-                if (j == (generate-1))
-                    a = stopAngle;
-                else
-                    a = ad * j;
-
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                {
-                    // insert extra vertex (and ignore == case)
-                    if (lastAngle < nextCorner && a >= nextCorner)
-                    {
-                        a = nextCorner;
-                        nextCorner += 0.50f * PI;
-                        --j;
-                    }
-
-                    lastAngle = a;
-                }
-
-                const float s = dmTrigLookup::Sin(backwards ? -a : a);
-                const float c = dmTrigLookup::Cos(backwards ? -a : a);
-
-                // make inner vertex
-                float u = 0.5f + innerMultiplier * c;
-                float v = 0.5f + innerMultiplier * s;
-                BoxVertex vInner(node_transforms[i] * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
-
-                // make outer vertex
-                float d;
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                    d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
-                else
-                    d = 0.5f;
-
-                u = 0.5f + d * c;
-                v = 0.5f + d * s;
-                BoxVertex vOuter(node_transforms[i] * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
-
-                // both inner & outer are doubled at first / last entry to generate degenerate triangles
-                // for the triangle strip, allowing more than one pie to be chained together in the same
-                // drawcall.
-                if (first)
-                {
-                    gui_world->m_ClientVertexBuffer.Push(vInner);
-                    first = false;
-                }
-
-                gui_world->m_ClientVertexBuffer.Push(vInner);
-                gui_world->m_ClientVertexBuffer.Push(vOuter);
-
-                if (j == generate-1)
-                    gui_world->m_ClientVertexBuffer.Push(vOuter);
+                uint32_t vertex_start = gui_world->m_ClientVertexBuffer.Size();
+                GeneratePieNodeVertices(key, gui_world->m_ClientVertexBuffer);
+                assert((gui_world->m_ClientVertexBuffer.Size() - vertex_start) <= ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, node)));
+                StoreNodeVertices(gui_world, cache, node, key, vertex_start);
             }
-
-            assert((gui_world->m_ClientVertexBuffer.Size() - sizeBefore) <= ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, entries[i].m_Node)));
         }
 
         ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
@@ -1751,6 +1881,17 @@ namespace dmGameSystem
         gui_world->m_RenderedParticlesSize = 0;
         gui_context->m_FirstStencil = true;
 
+        GuiComponent* component = (GuiComponent*)dmGui::GetSceneUserData(scene);
+        gui_context->m_Component = component;
+        gui_context->m_FirstEntry = entries;
+        uint32_t cache_size = component->m_NodeVertexCache.Size();
+        if (cache_size < node_count)
+        {
+            component->m_NodeVertexCache.SetCapacity(node_count);
+            component->m_NodeVertexCache.SetSize(node_count);
+            memset(component->m_NodeVertexCache.Begin() + cache_size, 0, (node_count - cache_size) * sizeof(GuiNodeVertexCache));
+        }
+
         dmGui::HNode first_node = entries[0].m_Node;
         dmGui::BlendMode prev_blend_mode = dmGui::GetNodeBlendMode(scene, first_node);
         dmGui::NodeType prev_node_type = dmGui::GetNodeType(scene, first_node);
@@ -1858,13 +1999,48 @@ namespace dmGameSystem
                     break;
             }
         }
+    }
+
+    // Uploads the vertices of all scenes in the world to the vertex buffer of the frame. The buffers are used
+    // in turn, and each one keeps the range of vertices that changed since it was last written. Only that range
+    // is uploaded, unless the buffer has to grow.
+    static void UploadVertices(GuiWorld* gui_world)
+    {
+        DM_PROFILE("UploadVertices");
+
+        dmArray<BoxVertex>& vertices = gui_world->m_ClientVertexBuffer;
+        uint32_t vertex_count = vertices.Size();
+        gui_world->m_Stats.m_VertexCount = vertex_count;
+        DM_PROPERTY_ADD_U32(rmtp_GuiVertexCount, vertex_count);
+
+        for (uint32_t i = 0; i < GUI_VERTEX_BUFFER_COUNT; ++i)
+        {
+            GuiVertexBuffer& buffer = gui_world->m_VertexBuffers[i];
+            buffer.m_DirtyStart = dmMath::Min(buffer.m_DirtyStart, gui_world->m_DirtyVertexStart);
+            buffer.m_DirtyEnd = dmMath::Max(buffer.m_DirtyEnd, gui_world->m_DirtyVertexEnd);
+        }
+        if (vertex_count == 0)
+            return;
 
-        dmGraphics::SetVertexBufferData(gui_world->m_VertexBuffer,
-                                        gui_world->m_ClientVertexBuffer.Size() * sizeof(BoxVertex),
-                                        gui_world->m_ClientVertexBuffer.Begin(),
-                                        dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        GuiVertexBuffer& buffer = gui_world->m_VertexBuffers[gui_world->m_FrameIndex % GUI_VERTEX_BUFFER_COUNT];
+        if (vertex_count > buffer.m_Capacity)
+        {
+            buffer.m_Capacity = vertices.Capacity();
+            dmGraphics::SetVertexBufferData(buffer.m_Buffer, buffer.m_Capacity * sizeof(BoxVertex), 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+            buffer.m_DirtyStart = 0;
+            buffer.m_DirtyEnd = vertex_count;
+        }
 
-        DM_PROPERTY_ADD_U32(rmtp_GuiVertexCount, gui_world->m_ClientVertexBuffer.Size());
+        uint32_t start = buffer.m_DirtyStart;
+        uint32_t end = dmMath::Min(buffer.m_DirtyEnd, vertex_count);
+        if (start < end)
+        {
+            dmGraphics::SetVertexBufferSubData(buffer.m_Buffer, start * sizeof(BoxVertex), (end - start) * sizeof(BoxVertex), vertices.Begin() + start);
+            gui_world->m_Stats.m_UploadedVertexCount = end - start;
+            DM_PROPERTY_ADD_U32(rmtp_GuiUploadedVertexCount, end - start);
+        }
+        buffer.m_DirtyStart = 0xffffffff;
+        buffer.m_DirtyEnd = 0;
     }
 
     static dmGraphics::TextureFormat ToGraphicsFormat(dmImage::Type type) {
@@ -2091,6 +2267,8 @@ namespace dmGameSystem
         render_gui_context.m_RenderContext = gui_context->m_RenderContext;
         render_gui_context.m_GuiWorld = gui_world;
         render_gui_context.m_NextSortOrder = 0;
+        render_gui_context.m_Component = 0;
+        render_gui_context.m_FirstEntry = 0;
 
         uint32_t total_node_count = 0;
         for (uint32_t i = 0; i < gui_world->m_Components.Size(); ++i)
@@ -2114,7 +2292,15 @@ namespace dmGameSystem
         }
 
         gui_world->m_GuiRenderObjects.SetSize(0);
+
+        // Keep the vertices of the previous frame around, for the nodes that haven't changed since
+        gui_world->m_ClientVertexBuffer.Swap(gui_world->m_PrevClientVertexBuffer);
         gui_world->m_ClientVertexBuffer.SetSize(0);
+        gui_world->m_DirtyVertexStart = 0xffffffff;
+        gui_world->m_DirtyVertexEnd = 0;
+        gui_world->m_FrameIndex++;
+        gui_world->m_VertexBuffer = gui_world->m_VertexBuffers[gui_world->m_FrameIndex % GUI_VERTEX_BUFFER_COUNT].m_Buffer;
+        memset(&gui_world->m_Stats, 0, sizeof(gui_world->m_Stats));
 
         uint32_t lastEnd = 0;
 
@@ -2151,6 +2337,8 @@ namespace dmGameSystem
             dmRender::RenderListSubmit(gui_context->m_RenderContext, render_list, write_ptr);
         }
 
+        UploadVertices(gui_world);
+
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
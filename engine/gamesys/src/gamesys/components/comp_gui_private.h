@@ -30,6 +30,33 @@ namespace dmGameSystem
     struct GuiSceneResource;
     struct CompGuiContext;
 
+    // Everything the vertices of a box or pie node are generated from
+    struct GuiNodeVertexKey
+    {
+        dmVMath::Matrix4        m_Transform;
+        dmVMath::Vector4        m_Color;
+        dmVMath::Vector4        m_Size;
+        dmVMath::Vector4        m_Params;       // Slice-9 for box nodes, inner radius, fill angle, perimeter vertices and outer bounds for pie nodes
+        const float*            m_TexCoords;
+        const void*             m_TextureSet;
+        dmGraphics::HTexture    m_Texture;
+        uint32_t                m_TextureWidth;
+        uint32_t                m_TextureHeight;
+        int32_t                 m_AnimationFrame;
+        uint32_t                m_FlipU : 1;
+        uint32_t                m_FlipV : 1;
+    };
+
+    // The vertices a box or pie node generated in the previous frame, see RenderBoxNodes
+    struct GuiNodeVertexCache
+    {
+        GuiNodeVertexKey        m_Key;
+        dmGui::HNode            m_Node;
+        uint32_t                m_VertexStart;  // Into GuiWorld::m_ClientVertexBuffer of m_FrameIndex
+        uint32_t                m_VertexCount;
+        uint32_t                m_FrameIndex;
+    };
+
     struct GuiComponent
     {
         struct GuiWorld*        m_World;
@@ -41,6 +68,7 @@ namespace dmGameSystem
         uint8_t                 m_Enabled : 1;
         uint8_t                 m_AddedToUpdate : 1;
         dmArray<void*>          m_ResourcePropertyPointers;
+        dmArray<GuiNodeVertexCache> m_NodeVertexCache; // Indexed by the render order of the nodes
     };
 
     struct BoxVertex
@@ -119,14 +147,40 @@ namespace dmGameSystem
     };
 
 
+    struct GuiRenderStats
+    {
+        uint32_t m_VertexCount;
+        uint32_t m_ReusedVertexCount;       // Copied from the previous frame
+        uint32_t m_GeneratedVertexCount;    // Generated by nodes not found in the vertex cache
+        uint32_t m_UploadedVertexCount;     // Written to the vertex buffer of the frame
+    };
+
+    /// Number of vertex buffers the gui world cycles through. A buffer is only written again
+    /// once the frames that were drawn from it are done, so it can be updated in place.
+    const static uint32_t GUI_VERTEX_BUFFER_COUNT = 3;
+
+    struct GuiVertexBuffer
+    {
+        dmGraphics::HVertexBuffer           m_Buffer;
+        uint32_t                            m_Capacity;     // In vertices
+        uint32_t                            m_DirtyStart;   // Range of vertices that changed since the buffer was last written
+        uint32_t                            m_DirtyEnd;
+    };
+
     struct GuiWorld
     {
         dmArray<GuiRenderObject>            m_GuiRenderObjects;
         dmArray<HComponentRenderConstants>  m_RenderConstants;
         dmArray<GuiComponent*>              m_Components;
         dmGraphics::HVertexDeclaration      m_VertexDeclaration;
-        dmGraphics::HVertexBuffer           m_VertexBuffer;
+        GuiVertexBuffer                     m_VertexBuffers[GUI_VERTEX_BUFFER_COUNT];
+        dmGraphics::HVertexBuffer           m_VertexBuffer;             // The buffer of the current frame, from m_VertexBuffers
         dmArray<BoxVertex>                  m_ClientVertexBuffer;
+        dmArray<BoxVertex>                  m_PrevClientVertexBuffer;   // The vertices uploaded in the previous frame
+        uint32_t                            m_DirtyVertexStart;         // Range of vertices that changed since the previous frame
+        uint32_t                            m_DirtyVertexEnd;
+        uint32_t                            m_FrameIndex;
+        GuiRenderStats                      m_Stats;                    // Of the last frame, used in unit tests
         dmGraphics::HTexture                m_WhiteTexture;
         dmParticle::HParticleContext        m_ParticleContext;
         uint32_t                            m_MaxParticleFXCount;
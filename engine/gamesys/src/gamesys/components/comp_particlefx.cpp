@@ -77,6 +77,7 @@ namespace dmGameSystem
         dmParticle::HParticleContext m_ParticleContext;
         dmGraphics::HVertexBuffer m_VertexBuffer;
         dmArray<dmParticle::Vertex> m_VertexBufferData;
+        dmArray<dmParticle::EmitterVertexRequest> m_VertexRequests;
         dmGraphics::HVertexDeclaration m_VertexDeclaration;
         uint32_t m_EmitterCount;
         float m_DT;
@@ -92,6 +93,7 @@ namespace dmGameSystem
         world->m_Context = ctx;
         uint32_t particle_fx_count = dmMath::Min(params.m_MaxComponentInstances, ctx->m_MaxParticleFXCount);
         world->m_ParticleContext = dmParticle::CreateContext(ctx->m_MaxParticleFXCount, ctx->m_MaxParticleCount);
+        dmParticle::SetContextJobPool(world->m_ParticleContext, ctx->m_JobPool);
         world->m_Components.SetCapacity(particle_fx_count);
         world->m_Prototypes.SetCapacity(particle_fx_count);
         world->m_Prototypes.SetSize(particle_fx_count);
@@ -262,11 +264,23 @@ namespace dmGameSystem
         uint32_t vb_size = vb_size_init;
         uint32_t vb_max_size =  dmParticle::GetVertexBufferSize(pfx_context->m_MaxParticleCount, dmParticle::PARTICLE_GO);
 
+        dmArray<dmParticle::EmitterVertexRequest>& requests = pfx_world->m_VertexRequests;
+        uint32_t request_count = end - begin;
+        requests.SetSize(0);
+        if (requests.Capacity() < request_count)
+        {
+            requests.SetCapacity(request_count);
+        }
         for (uint32_t *i = begin; i != end; ++i)
         {
             const dmParticle::EmitterRenderData* emitter_render_data = (dmParticle::EmitterRenderData*) buf[*i].m_UserData;
-            dmParticle::GenerateVertexData(particle_context, pfx_world->m_DT, emitter_render_data->m_Instance, emitter_render_data->m_EmitterIndex, Vector4(1,1,1,1), (void*)vertex_buffer.Begin(), vb_max_size, &vb_size, dmParticle::PARTICLE_GO);
+            dmParticle::EmitterVertexRequest request;
+            request.m_Color = Vector4(1,1,1,1);
+            request.m_Instance = emitter_render_data->m_Instance;
+            request.m_EmitterIndex = emitter_render_data->m_EmitterIndex;
+            requests.Push(request);
         }
+        dmParticle::GenerateVertexDataBatch(particle_context, pfx_world->m_DT, requests.Begin(), request_count, (void*)vertex_buffer.Begin(), vb_max_size, &vb_size, dmParticle::PARTICLE_GO);
 
         vb_end = (vb_begin + (vb_size - vb_size_init) / sizeof(dmParticle::Vertex));
 
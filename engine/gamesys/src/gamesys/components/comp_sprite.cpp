@@ -47,6 +47,9 @@ DM_PROPERTY_EXTERN(rmtp_Components);
 DM_PROPERTY_U32(rmtp_SpriteVertexCount, 0, FrameReset, "# vertices", &rmtp_Components);
 DM_PROPERTY_U32(rmtp_SpriteVertexSize, 0, FrameReset, "size of vertices in bytes", &rmtp_Components);
 DM_PROPERTY_U32(rmtp_SpriteIndexSize, 0, FrameReset, "size of indices in bytes", &rmtp_Components);
+DM_PROPERTY_U32(rmtp_SpriteInstanceCount, 0, FrameReset, "# instances", &rmtp_Components);
+DM_PROPERTY_U32(rmtp_SpriteInstanceSize, 0, FrameReset, "size of instances in bytes", &rmtp_Components);
+DM_PROPERTY_U32(rmtp_SpriteTransforms, 0, FrameReset, "# world transforms calculated", &rmtp_Components);
 
 namespace dmGameSystem
 {
@@ -60,6 +63,8 @@ namespace dmGameSystem
         Vector3                     m_Scale;
         Vector3                     m_Size;     // The current size of the animation frame (in texels)
         Matrix4                     m_World;
+        // The world transform version of the game object when m_World was calculated
+        uint32_t                    m_WorldTransformVersion;
         // Hash of the m_Resource-pointer. Hash is used to be compatible with 64-bit arch as a 32-bit value is used for sorting
         // See GenerateKeys
         uint32_t                    m_MixedHash;
@@ -88,7 +93,8 @@ namespace dmGameSystem
         uint16_t                    m_FlipVertical : 1;
         uint16_t                    m_AddedToUpdate : 1;
         uint16_t                    m_ReHash : 1;
-        uint16_t                    m_Padding : 7;
+        uint16_t                    m_TransformDirty : 1; // If the scale or size changed since m_World was calculated
+        uint16_t                    m_Padding : 6;
     };
 
     struct SpriteVertex
@@ -100,6 +106,25 @@ namespace dmGameSystem
         float v;
     };
 
+    // Per-instance record for sprites drawn with a material in local vertex space.
+    // The quad corner is expanded on the GPU: position = world_position + world_x * x + world_y * y,
+    // and texcoord = uv_origin + uv_axes.xy * (x + 0.5) + uv_axes.zw * (y + 0.5)
+    struct SpriteInstance
+    {
+        float m_WorldX[3];
+        float m_WorldY[3];
+        float m_WorldPosition[3];
+        float m_UVOrigin[2];
+        float m_UVAxes[4];
+    };
+
+    // Used when the graphics context can't draw instanced: the instance record is repeated for each quad corner
+    struct SpriteInstanceVertex
+    {
+        float           m_Position[3];
+        SpriteInstance  m_Instance;
+    };
+
     struct SpriteWorld
     {
         dmObjectPool<SpriteComponent>   m_Components;
@@ -113,9 +138,21 @@ namespace dmGameSystem
         dmGraphics::HIndexBuffer        m_IndexBuffer;
         uint8_t*                        m_IndexBufferData;
         uint8_t*                        m_IndexBufferWritePtr;
+        // Instanced path, used for materials in local vertex space. Allocated on first use.
+        dmGraphics::HVertexDeclaration  m_QuadVertexDeclaration;
+        dmGraphics::HVertexDeclaration  m_InstanceVertexDeclaration;
+        dmGraphics::HVertexDeclaration  m_InstanceExpandedVertexDeclaration;
+        dmGraphics::HVertexBuffer       m_QuadVertexBuffer;
+        dmGraphics::HIndexBuffer        m_QuadIndexBuffer;
+        dmGraphics::HVertexBuffer       m_InstanceBuffer;
+        SpriteInstance*                 m_InstanceData;
+        SpriteInstance*                 m_InstanceWritePtr;
+        SpriteInstanceVertex*           m_InstanceVertexData;
         uint8_t                         m_Is16BitIndex : 1;
         uint8_t                         m_UseGeometries : 1;
         uint8_t                         m_ReallocBuffers : 1;
+        uint8_t                         m_UseInstancing : 1;
+        uint8_t                         m_IsQuad16BitIndex : 1;
     };
 
     DM_GAMESYS_PROP_VECTOR3(SPRITE_PROP_SCALE, scale, false);
@@ -130,6 +167,13 @@ namespace dmGameSystem
     static float GetPlaybackRate(SpriteComponent* component);
     static void SetPlaybackRate(SpriteComponent* component, float playback_rate);
 
+    static const int TEX_COORD_ORDER[] = {
+        0,1,2,2,3,0,
+        3,2,1,1,0,3,    //h
+        1,0,3,3,2,1,    //v
+        2,3,0,0,1,2     //hv
+    };
+
     template<typename T>
     void fillIndices(T* index, uint32_t indices_count) {
         for(uint32_t i = 0, v = 0; i < indices_count; i += 6, v += 4)
@@ -186,6 +230,46 @@ namespace dmGameSystem
         sprite_world->m_ReallocBuffers = 0;
     }
 
+    static void AllocateInstanceBuffers(SpriteWorld* sprite_world, dmRender::HRenderContext render_context, uint32_t max_sprite_count)
+    {
+        dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(render_context);
+        sprite_world->m_UseInstancing = dmGraphics::IsInstancingSupported(graphics_context) ? 1 : 0;
+
+        sprite_world->m_InstanceData = (SpriteInstance*) malloc(sizeof(SpriteInstance) * max_sprite_count);
+        sprite_world->m_InstanceBuffer = dmGraphics::NewVertexBuffer(graphics_context, 0, 0x0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+
+        if (sprite_world->m_UseInstancing)
+        {
+            static const float quad[] = {
+                -0.5f, -0.5f, 0.0f,
+                -0.5f,  0.5f, 0.0f,
+                 0.5f,  0.5f, 0.0f,
+                 0.5f, -0.5f, 0.0f,
+            };
+            static const uint16_t quad_indices[] = { 0, 1, 2, 2, 3, 0 };
+            sprite_world->m_QuadVertexBuffer = dmGraphics::NewVertexBuffer(graphics_context, sizeof(quad), quad, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+            sprite_world->m_QuadIndexBuffer = dmGraphics::NewIndexBuffer(graphics_context, sizeof(quad_indices), quad_indices, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+            sprite_world->m_IsQuad16BitIndex = 1;
+        }
+        else
+        {
+            // Expand each instance into a quad, with the same attributes as the instanced draw
+            sprite_world->m_InstanceVertexData = (SpriteInstanceVertex*) malloc(sizeof(SpriteInstanceVertex) * 4 * max_sprite_count);
+
+            uint32_t indices_count = 6 * max_sprite_count;
+            uint32_t size_type = 4 * max_sprite_count <= 65536 ? sizeof(uint16_t) : sizeof(uint32_t);
+            sprite_world->m_IsQuad16BitIndex = size_type == sizeof(uint16_t) ? 1 : 0;
+            void* indices = malloc(indices_count * size_type);
+            if (sprite_world->m_IsQuad16BitIndex) {
+                fillIndices<uint16_t>((uint16_t*)indices, indices_count);
+            } else {
+                fillIndices<uint32_t>((uint32_t*)indices, indices_count);
+            }
+            sprite_world->m_QuadIndexBuffer = dmGraphics::NewIndexBuffer(graphics_context, indices_count * size_type, indices, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+            free(indices);
+        }
+    }
+
     dmGameObject::CreateResult CompSpriteNewWorld(const dmGameObject::ComponentNewWorldParams& params)
     {
         SpriteContext* sprite_context = (SpriteContext*)params.m_Context;
@@ -206,11 +290,44 @@ namespace dmGameSystem
 
         sprite_world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(dmRender::GetGraphicsContext(render_context), ve, sizeof(ve) / sizeof(dmGraphics::VertexElement));
 
+        dmGraphics::VertexElement quad_ve[] =
+        {
+                {"position", 0, 3, dmGraphics::TYPE_FLOAT, false},
+        };
+        dmGraphics::VertexElement instance_ve[] =
+        {
+                {"world_x", 0, 3, dmGraphics::TYPE_FLOAT, false},
+                {"world_y", 1, 3, dmGraphics::TYPE_FLOAT, false},
+                {"world_position", 2, 3, dmGraphics::TYPE_FLOAT, false},
+                {"uv_origin", 3, 2, dmGraphics::TYPE_FLOAT, false},
+                {"uv_axes", 4, 4, dmGraphics::TYPE_FLOAT, false},
+        };
+        dmGraphics::VertexElement instance_expanded_ve[] =
+        {
+                {"position", 0, 3, dmGraphics::TYPE_FLOAT, false},
+                {"world_x", 1, 3, dmGraphics::TYPE_FLOAT, false},
+                {"world_y", 2, 3, dmGraphics::TYPE_FLOAT, false},
+                {"world_position", 3, 3, dmGraphics::TYPE_FLOAT, false},
+                {"uv_origin", 4, 2, dmGraphics::TYPE_FLOAT, false},
+                {"uv_axes", 5, 4, dmGraphics::TYPE_FLOAT, false},
+        };
+
+        sprite_world->m_QuadVertexDeclaration = dmGraphics::NewVertexDeclaration(dmRender::GetGraphicsContext(render_context), quad_ve, sizeof(quad_ve) / sizeof(dmGraphics::VertexElement));
+        sprite_world->m_InstanceVertexDeclaration = dmGraphics::NewVertexDeclaration(dmRender::GetGraphicsContext(render_context), instance_ve, sizeof(instance_ve) / sizeof(dmGraphics::VertexElement));
+        sprite_world->m_InstanceExpandedVertexDeclaration = dmGraphics::NewVertexDeclaration(dmRender::GetGraphicsContext(render_context), instance_expanded_ve, sizeof(instance_expanded_ve) / sizeof(dmGraphics::VertexElement));
+
         sprite_world->m_VertexBuffer = 0;
         sprite_world->m_VertexBufferData = 0;
         sprite_world->m_IndexBuffer = 0;
         sprite_world->m_IndexBufferData = 0;
 
+        sprite_world->m_QuadVertexBuffer = 0;
+        sprite_world->m_QuadIndexBuffer = 0;
+        sprite_world->m_InstanceBuffer = 0;
+        sprite_world->m_InstanceData = 0;
+        sprite_world->m_InstanceWritePtr = 0;
+        sprite_world->m_InstanceVertexData = 0;
+
         sprite_world->m_UseGeometries = 0;
         sprite_world->m_ReallocBuffers = 1;
 
@@ -233,6 +350,19 @@ namespace dmGameSystem
         dmGraphics::DeleteIndexBuffer(sprite_world->m_IndexBuffer);
         free(sprite_world->m_IndexBufferData);
 
+        dmGraphics::DeleteVertexDeclaration(sprite_world->m_QuadVertexDeclaration);
+        dmGraphics::DeleteVertexDeclaration(sprite_world->m_InstanceVertexDeclaration);
+        dmGraphics::DeleteVertexDeclaration(sprite_world->m_InstanceExpandedVertexDeclaration);
+        if (sprite_world->m_InstanceData)
+        {
+            if (sprite_world->m_QuadVertexBuffer)
+                dmGraphics::DeleteVertexBuffer(sprite_world->m_QuadVertexBuffer);
+            dmGraphics::DeleteIndexBuffer(sprite_world->m_QuadIndexBuffer);
+            dmGraphics::DeleteVertexBuffer(sprite_world->m_InstanceBuffer);
+            free(sprite_world->m_InstanceData);
+            free(sprite_world->m_InstanceVertexData);
+        }
+
         delete sprite_world;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -296,6 +426,7 @@ namespace dmGameSystem
         if (frame != frame_current)
         {
             component->m_Size = GetSize(component, texture_set_ddf, component->m_AnimationID);
+            component->m_TransformDirty = 1;
         }
     }
 
@@ -317,6 +448,7 @@ namespace dmGameSystem
             component->m_AnimBackwards = animation->m_Playback == dmGameSystemDDF::PLAYBACK_ONCE_BACKWARD || animation->m_Playback == dmGameSystemDDF::PLAYBACK_LOOP_BACKWARD;
             component->m_Playing = animation->m_Playback != dmGameSystemDDF::PLAYBACK_NONE;
             component->m_Size = GetSize(component, texture_set->m_TextureSet, component->m_AnimationID);
+            component->m_TransformDirty = 1;
 
             offset = dmMath::Clamp(offset, 0.0f, 1.0f);
             if (animation->m_Playback == dmGameSystemDDF::PLAYBACK_ONCE_BACKWARD || animation->m_Playback == dmGameSystemDDF::PLAYBACK_LOOP_BACKWARD) {
@@ -383,6 +515,7 @@ namespace dmGameSystem
         component->m_FunctionRef = 0;
 
         component->m_ReHash = 1;
+        component->m_TransformDirty = 1;
 
         component->m_Size = Vector3(0.0f, 0.0f, 0.0f);
         component->m_AnimationID = 0;
@@ -508,13 +641,6 @@ namespace dmGameSystem
         }
         else // original path using quads
         {
-            static int tex_coord_order[] = {
-                0,1,2,2,3,0,
-                3,2,1,1,0,3,    //h
-                1,0,3,3,2,1,    //v
-                2,3,0,0,1,2     //hv
-            };
-
             const float* tex_coords = (const float*) texture_set->m_TextureSet->m_TexCoords.m_Data;
 
             for (uint32_t *i = begin;i != end; ++i)
@@ -539,7 +665,7 @@ namespace dmGameSystem
                     flip_flag |= 2;
                 }
 
-                const int* tex_lookup = &tex_coord_order[flip_flag * 6];
+                const int* tex_lookup = &TEX_COORD_ORDER[flip_flag * 6];
 
                 const Matrix4& w = component->m_World;
 
@@ -583,6 +709,69 @@ namespace dmGameSystem
         *ib_where = indices;
     }
 
+    static void CreateInstanceData(SpriteInstance** where, TextureSetResource* texture_set, const dmArray<SpriteComponent>& components, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    {
+        DM_PROFILE("CreateInstanceData");
+
+        dmGameSystemDDF::TextureSetAnimation* animations = texture_set->m_TextureSet->m_Animations.m_Data;
+        const float* tex_coords = (const float*) texture_set->m_TextureSet->m_TexCoords.m_Data;
+
+        SpriteInstance* instance = *where;
+        for (uint32_t *i = begin; i != end; ++i, ++instance)
+        {
+            uint32_t component_index = (uint32_t)buf[*i].m_UserData;
+            const SpriteComponent* component = (const SpriteComponent*) &components[component_index];
+
+            dmGameSystemDDF::TextureSetAnimation* animation_ddf = &animations[component->m_AnimationID];
+
+            uint32_t frame_index = animation_ddf->m_Start + component->m_CurrentAnimationFrame;
+            const float* tc = &tex_coords[frame_index * 4 * 2];
+            uint32_t flip_flag = (animation_ddf->m_FlipHorizontal ^ component->m_FlipHorizontal) | ((animation_ddf->m_FlipVertical ^ component->m_FlipVertical) << 1);
+            const int* tex_lookup = &TEX_COORD_ORDER[flip_flag * 6];
+
+            const Matrix4& w = component->m_World;
+            const Vector4 x = w.getCol0();
+            const Vector4 y = w.getCol1();
+            const Vector4 t = w.getCol3();
+            instance->m_WorldX[0] = x.getX();
+            instance->m_WorldX[1] = x.getY();
+            instance->m_WorldX[2] = x.getZ();
+            instance->m_WorldY[0] = y.getX();
+            instance->m_WorldY[1] = y.getY();
+            instance->m_WorldY[2] = y.getZ();
+            instance->m_WorldPosition[0] = t.getX();
+            instance->m_WorldPosition[1] = t.getY();
+            instance->m_WorldPosition[2] = t.getZ();
+
+            // Same corners as the quad path: (-0.5,-0.5), (-0.5,0.5) and (0.5,-0.5)
+            const float* uv0 = &tc[tex_lookup[0] * 2];
+            const float* uv1 = &tc[tex_lookup[1] * 2];
+            const float* uv3 = &tc[tex_lookup[4] * 2];
+            instance->m_UVOrigin[0] = uv0[0];
+            instance->m_UVOrigin[1] = uv0[1];
+            instance->m_UVAxes[0] = uv3[0] - uv0[0];
+            instance->m_UVAxes[1] = uv3[1] - uv0[1];
+            instance->m_UVAxes[2] = uv1[0] - uv0[0];
+            instance->m_UVAxes[3] = uv1[1] - uv0[1];
+        }
+        *where = instance;
+    }
+
+    static void ExpandInstanceData(const SpriteInstance* instances, uint32_t instance_count, SpriteInstanceVertex* vertices)
+    {
+        static const float corners[4][2] = { {-0.5f, -0.5f}, {-0.5f, 0.5f}, {0.5f, 0.5f}, {0.5f, -0.5f} };
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            for (uint32_t c = 0; c < 4; ++c, ++vertices)
+            {
+                vertices->m_Position[0] = corners[c][0];
+                vertices->m_Position[1] = corners[c][1];
+                vertices->m_Position[2] = 0.0f;
+                vertices->m_Instance = instances[i];
+            }
+        }
+    }
+
     static void RenderBatch(SpriteWorld* sprite_world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
     {
         DM_PROFILE("SpriteRenderBatch");
@@ -605,36 +794,75 @@ namespace dmGameSystem
         }
 
         dmRender::RenderObject& ro = *sprite_world->m_RenderObjects[sprite_world->m_RenderObjectsInUse++];
-
-        // Fill in vertex buffer
-        SpriteVertex* vb_begin = sprite_world->m_VertexBufferWritePtr;
-        uint8_t* ib_begin = (uint8_t*)sprite_world->m_IndexBufferWritePtr;
-        SpriteVertex* vb_iter = vb_begin;
-        uint8_t* ib_iter = ib_begin;
-        CreateVertexData(sprite_world, &vb_iter, &ib_iter, texture_set, buf, begin, end);
-
-        sprite_world->m_VertexBufferWritePtr = vb_iter;
-        sprite_world->m_IndexBufferWritePtr = ib_iter;
-
         ro.Init();
-        ro.m_VertexDeclaration = sprite_world->m_VertexDeclaration;
-        ro.m_VertexBuffer = sprite_world->m_VertexBuffer;
-        ro.m_IndexBuffer = sprite_world->m_IndexBuffer;
         ro.m_Material = GetMaterial(first, resource);
         ro.m_Textures[0] = texture_set->m_Texture;
         ro.m_PrimitiveType = dmGraphics::PRIMITIVE_TRIANGLES;
-        ro.m_IndexType = sprite_world->m_Is16BitIndex ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
 
-        // offset in bytes into element buffer
-        uint32_t index_offset = ib_begin - sprite_world->m_IndexBufferData;
+        if (dmRender::GetMaterialVertexSpace(ro.m_Material) == dmRenderDDF::MaterialDesc::VERTEX_SPACE_LOCAL)
+        {
+            if (!sprite_world->m_InstanceData)
+            {
+                AllocateInstanceBuffers(sprite_world, render_context, sprite_world->m_Components.Capacity());
+                sprite_world->m_InstanceWritePtr = sprite_world->m_InstanceData;
+            }
 
-        // num elements = Number of bytes / sizeof(index_type)
-        uint32_t index_type_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
-        uint32_t num_elements = ((uint8_t*)sprite_world->m_IndexBufferWritePtr - (uint8_t*)ib_begin) / index_type_size;
+            // Fill in the instance records
+            SpriteInstance* instance_begin = sprite_world->m_InstanceWritePtr;
+            CreateInstanceData(&sprite_world->m_InstanceWritePtr, texture_set, sprite_world->m_Components.m_Objects, buf, begin, end);
+            uint32_t instance_start = instance_begin - sprite_world->m_InstanceData;
+            uint32_t instance_count = sprite_world->m_InstanceWritePtr - instance_begin;
 
-        // // These should be named "element" or "index" (as opposed to vertex)
-        ro.m_VertexStart = index_offset;
-        ro.m_VertexCount = num_elements;
+            ro.m_IndexBuffer = sprite_world->m_QuadIndexBuffer;
+            ro.m_IndexType = sprite_world->m_IsQuad16BitIndex ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
+            if (sprite_world->m_UseInstancing)
+            {
+                ro.m_VertexDeclaration = sprite_world->m_QuadVertexDeclaration;
+                ro.m_VertexBuffer = sprite_world->m_QuadVertexBuffer;
+                ro.m_VertexStart = 0;
+                ro.m_VertexCount = 6;
+                ro.m_InstanceVertexDeclaration = sprite_world->m_InstanceVertexDeclaration;
+                ro.m_InstanceVertexBuffer = sprite_world->m_InstanceBuffer;
+                ro.m_InstanceStart = instance_start;
+                ro.m_InstanceCount = instance_count;
+            }
+            else
+            {
+                uint32_t index_type_size = sprite_world->m_IsQuad16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
+                ro.m_VertexDeclaration = sprite_world->m_InstanceExpandedVertexDeclaration;
+                ro.m_VertexBuffer = sprite_world->m_InstanceBuffer;
+                ro.m_VertexStart = instance_start * 6 * index_type_size;
+                ro.m_VertexCount = instance_count * 6;
+            }
+        }
+        else
+        {
+            // Fill in vertex buffer
+            SpriteVertex* vb_begin = sprite_world->m_VertexBufferWritePtr;
+            uint8_t* ib_begin = (uint8_t*)sprite_world->m_IndexBufferWritePtr;
+            SpriteVertex* vb_iter = vb_begin;
+            uint8_t* ib_iter = ib_begin;
+            CreateVertexData(sprite_world, &vb_iter, &ib_iter, texture_set, buf, begin, end);
+
+            sprite_world->m_VertexBufferWritePtr = vb_iter;
+            sprite_world->m_IndexBufferWritePtr = ib_iter;
+
+            ro.m_VertexDeclaration = sprite_world->m_VertexDeclaration;
+            ro.m_VertexBuffer = sprite_world->m_VertexBuffer;
+            ro.m_IndexBuffer = sprite_world->m_IndexBuffer;
+            ro.m_IndexType = sprite_world->m_Is16BitIndex ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
+
+            // offset in bytes into element buffer
+            uint32_t index_offset = ib_begin - sprite_world->m_IndexBufferData;
+
+            // num elements = Number of bytes / sizeof(index_type)
+            uint32_t index_type_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
+            uint32_t num_elements = ((uint8_t*)sprite_world->m_IndexBufferWritePtr - (uint8_t*)ib_begin) / index_type_size;
+
+            // // These should be named "element" or "index" (as opposed to vertex)
+            ro.m_VertexStart = index_offset;
+            ro.m_VertexCount = num_elements;
+        }
 
         if (first->m_RenderConstants) {
             dmGameSystem::EnableRenderObjectConstants(&ro, first->m_RenderConstants);
@@ -689,39 +917,36 @@ namespace dmGameSystem
         }
 
         // Note: We update all sprites, even though they might be disabled, or not added to update
+        // Only sprites whose game object has a new world transform, or whose scale or size has changed, are recalculated
 
-        if (scale_along_z) {
-            for (uint32_t i = 0; i < n; ++i)
-            {
-                SpriteComponent* c = &components[i];
-                Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
-                Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
-                Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
-                c->m_World = appendScale(world * local, size);
-            }
-        } else
+        uint32_t updated_count = 0;
+        for (uint32_t i = 0; i < n; ++i)
         {
-            for (uint32_t i = 0; i < n; ++i)
-            {
-                SpriteComponent* c = &components[i];
-                Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
-                Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
-                Matrix4 w = dmTransform::MulNoScaleZ(world, local);
-                Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
-                c->m_World = appendScale(w, size);
-            }
-        }
+            SpriteComponent* c = &components[i];
+            uint32_t version = dmGameObject::GetWorldTransformVersion(c->m_Instance);
+            if (!c->m_TransformDirty && c->m_WorldTransformVersion == version)
+                continue;
+
+            Matrix4 local = dmTransform::ToMatrix4(dmTransform::Transform(c->m_Position, c->m_Rotation, 1.0f));
+            Matrix4 world = dmGameObject::GetWorldMatrix(c->m_Instance);
+            Matrix4 w = scale_along_z ? world * local : dmTransform::MulNoScaleZ(world, local);
+            Vector3 size( c->m_Size.getX() * c->m_Scale.getX(), c->m_Size.getY() * c->m_Scale.getY(), 1);
+            c->m_World = appendScale(w, size);
 
-        // The "sub_pixels" is set by default
-        if (!sub_pixels) {
-            for (uint32_t i = 0; i < n; ++i) {
-                SpriteComponent* c = &components[i];
+            // The "sub_pixels" is set by default
+            if (!sub_pixels) {
                 Vector4 position = c->m_World.getCol3();
                 position.setX((int) position.getX());
                 position.setY((int) position.getY());
                 c->m_World.setCol3(position);
             }
+
+            c->m_WorldTransformVersion = version;
+            c->m_TransformDirty = 0;
+            ++updated_count;
         }
+
+        DM_PROPERTY_ADD_U32(rmtp_SpriteTransforms, updated_count);
     }
 
     static bool GetSender(SpriteComponent* component, dmMessage::URL* out_sender)
@@ -894,14 +1119,26 @@ namespace dmGameSystem
 
         const dmIntersection::Frustum frustum = *params.m_Frustum;
         uint32_t num_entries = params.m_NumEntries;
-        for (uint32_t i = 0; i < num_entries; ++i)
+
+        // The spheres are tested in chunks, to make use of the batched intersection test
+        const uint32_t chunk_size = 64;
+        dmVMath::Vector4 spheres[chunk_size];
+        bool intersect[chunk_size];
+        for (uint32_t chunk_start = 0; chunk_start < num_entries; chunk_start += chunk_size)
         {
-            dmRender::RenderListEntry* entry = &params.m_Entries[i];
+            dmRender::RenderListEntry* entries = &params.m_Entries[chunk_start];
+            uint32_t count = dmMath::Min(chunk_size, num_entries - chunk_start);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                spheres[i] = dmVMath::Vector4(Vector3(entries[i].m_WorldPosition), radiuses[entries[i].m_UserData]);
+            }
 
-            float radius = radiuses[entry->m_UserData];
+            dmIntersection::TestFrustumSpheres(frustum, spheres, count, true, intersect);
 
-            bool intersect = dmIntersection::TestFrustumSphere(frustum, entry->m_WorldPosition, radius, true);
-            entry->m_Visibility = intersect ? dmRender::VISIBILITY_FULL : dmRender::VISIBILITY_NONE;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                entries[i].m_Visibility = intersect[i] ? dmRender::VISIBILITY_FULL : dmRender::VISIBILITY_NONE;
+            }
         }
     }
 
@@ -915,6 +1152,7 @@ namespace dmGameSystem
             case dmRender::RENDER_LIST_OPERATION_BEGIN:
                 world->m_VertexBufferWritePtr = world->m_VertexBufferData;
                 world->m_IndexBufferWritePtr = world->m_IndexBufferData;
+                world->m_InstanceWritePtr = world->m_InstanceData;
                 world->m_RenderObjectsInUse = 0;
                 break;
             case dmRender::RENDER_LIST_OPERATION_END:
@@ -932,6 +1170,28 @@ namespace dmGameSystem
                     }
                 }
 
+                {
+                    uint32_t instance_count = world->m_InstanceWritePtr - world->m_InstanceData;
+                    if (instance_count)
+                    {
+                        uint32_t instance_size = sizeof(SpriteInstance) * instance_count;
+                        if (world->m_UseInstancing)
+                        {
+                            dmGraphics::SetVertexBufferData(world->m_InstanceBuffer, instance_size,
+                                                            world->m_InstanceData, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+                        }
+                        else
+                        {
+                            ExpandInstanceData(world->m_InstanceData, instance_count, world->m_InstanceVertexData);
+                            dmGraphics::SetVertexBufferData(world->m_InstanceBuffer, sizeof(SpriteInstanceVertex) * 4 * instance_count,
+                                                            world->m_InstanceVertexData, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+                        }
+
+                        DM_PROPERTY_ADD_U32(rmtp_SpriteInstanceCount, instance_count);
+                        DM_PROPERTY_ADD_U32(rmtp_SpriteInstanceSize, instance_size);
+                    }
+                }
+
                 if (world->m_UseGeometries)
                 {
                     uint32_t index_size = (world->m_IndexBufferWritePtr - world->m_IndexBufferData);
@@ -1124,6 +1384,7 @@ namespace dmGameSystem
             {
                 dmGameSystemDDF::SetScale* ddf = (dmGameSystemDDF::SetScale*)params.m_Message->m_Data;
                 component->m_Scale = ddf->m_Scale;
+                component->m_TransformDirty = 1;
             }
         }
 
@@ -1190,10 +1451,12 @@ namespace dmGameSystem
 
         if (IsReferencingProperty(SPRITE_PROP_SCALE, set_property))
         {
+            component->m_TransformDirty = 1;
             return SetProperty(set_property, params.m_Value, component->m_Scale, SPRITE_PROP_SCALE);
         }
         else if (IsReferencingProperty(SPRITE_PROP_SIZE, set_property))
         {
+            component->m_TransformDirty = 1;
             return SetProperty(set_property, params.m_Value, component->m_Size, SPRITE_PROP_SIZE);
         }
         else if (params.m_PropertyId == SPRITE_PROP_CURSOR)
@@ -29,6 +29,7 @@
 #include <gameobject/gameobject.h>
 #include <gameobject/gameobject_ddf.h>
 #include <dmsdk/dlib/vmath.h>
+#include <dmsdk/dlib/intersection.h>
 
 #include <gamesys/tile_ddf.h>
 #include "../gamesys.h"
@@ -42,20 +43,35 @@ DM_PROPERTY_EXTERN(rmtp_Components);
 DM_PROPERTY_U32(rmtp_TilemapTileCount, 0, FrameReset, "# vertices", &rmtp_Components);
 DM_PROPERTY_U32(rmtp_TilemapVertexCount, 0, FrameReset, "# vertices", &rmtp_Components);
 DM_PROPERTY_U32(rmtp_TilemapVertexSize, 0, FrameReset, "size of vertices in bytes", &rmtp_Components);
+DM_PROPERTY_U32(rmtp_TilemapRebuiltRegionCount, 0, FrameReset, "# region layers whose vertices were rebuilt", &rmtp_Components);
+DM_PROPERTY_U32(rmtp_TilemapCopiedVertexCount, 0, FrameReset, "# cached vertices copied to the vertex buffer", &rmtp_Components);
 
 namespace dmGameSystem
 {
     const uint32_t TILEGRID_REGION_SIZE = 32;
+    const uint32_t TILEGRID_REGION_CELL_COUNT = TILEGRID_REGION_SIZE * TILEGRID_REGION_SIZE;
+    // The cached vertices of a region layer are released when it hasn't been rendered for this many frames
+    const uint32_t TILEGRID_VERTEX_CACHE_FRAMES = 120;
 
     using namespace dmVMath;
 
+    struct TileGridCellFlags
+    {
+        uint8_t    m_TransformMask : 3;
+        uint8_t    : 5;
+    };
+
     // A "region" spans all layers (in Z) for a bounding box [(x1,y1), (x2,y2)]
-    // where the the box spans TILEGRID_REGION_SIZE tiles in each direction
+    // where the the box spans TILEGRID_REGION_SIZE tiles in each direction.
+    // The cells are only allocated for regions with tiles, so that large or
+    // streamed tile maps only use memory for the parts that are loaded.
     struct TileGridRegion
     {
-        uint8_t m_Dirty:1;
-        uint8_t m_Occupied:1;
-        uint8_t :6;
+        uint16_t*           m_Cells;        // [layer][y][x], 0x0 if the region has no tiles
+        TileGridCellFlags*  m_CellFlags;
+        uint8_t             m_Dirty:1;
+        uint8_t             m_Occupied:1;
+        uint8_t             :6;
     };
 
     struct TileGridLayer
@@ -64,22 +80,37 @@ namespace dmGameSystem
         uint8_t :7;
     };
 
+    struct TileGridVertex
+    {
+        float x, y, z, u, v;
+    };
+
+    // The vertices of one layer of a region, kept between frames and only
+    // rebuilt when the region, the transform or the tile source has changed
+    struct TileGridRegionVertices
+    {
+        TileGridVertex* m_Vertices;
+        uint32_t        m_VertexCount;
+        uint32_t        m_VertexCapacity;
+        uint32_t        m_Version;      // The vertex version of the component when the vertices were built
+        uint32_t        m_VertexStart;  // Where the vertices were last written in the world vertex data
+        uint32_t        m_FrameIndex;   // The dispatch they were last written
+        uint8_t         m_Dirty:1;
+        uint8_t         :7;
+    };
+
     struct TileGridComponent
     {
-        struct Flags
-        {
-            uint8_t    m_TransformMask : 3;
-            uint8_t    : 5;
-        };
+        typedef TileGridCellFlags Flags;
 
         TileGridComponent()
         : m_Instance(0)
-        , m_Cells(0)
-        , m_CellFlags(0)
         , m_RenderConstants(0)
         , m_Material(0)
         , m_TextureSet(0)
         , m_Resource(0)
+        , m_VertexTextureSet(0)
+        , m_VertexVersion(0)
         {
         }
 
@@ -87,15 +118,17 @@ namespace dmGameSystem
         dmVMath::Quat               m_Rotation;
         dmVMath::Matrix4            m_World;
         dmGameObject::HInstance     m_Instance;
-        uint16_t*                   m_Cells;
-        Flags*                      m_CellFlags;
         dmArray<TileGridRegion>     m_Regions;
+        dmArray<TileGridRegionVertices> m_RegionVertices; // [layer][region]
+        dmArray<uint32_t>           m_CachedRegionVertices; // Indices of the region vertices that hold vertex memory
         dmArray<TileGridLayer>      m_Layers;
         uint32_t                    m_MixedHash;
         HComponentRenderConstants   m_RenderConstants;
         dmRender::HMaterial         m_Material;
         TextureSetResource*         m_TextureSet;
         TileGridResource*           m_Resource;
+        TextureSetResource*         m_VertexTextureSet; // The texture set the cached vertices were built with
+        uint32_t                    m_VertexVersion;    // Incremented when all cached vertices need to be rebuilt
         uint16_t                    m_RegionsX; // number of regions in the x dimension
         uint16_t                    m_RegionsY; // number of regions in the y dimension
         uint16_t                    m_Occupied; // Number of occupied regions (regions with visible tiles)
@@ -104,11 +137,6 @@ namespace dmGameSystem
         uint8_t                     : 6;
     };
 
-    struct TileGridVertex
-    {
-        float x, y, z, u, v;
-    };
-
     struct TileGridWorld
     {
         TileGridWorld()
@@ -121,10 +149,15 @@ namespace dmGameSystem
         dmArray<dmRender::RenderObject> m_RenderObjects;
         dmGraphics::HVertexDeclaration  m_VertexDeclaration;
 
+        // The vertex data is kept between dispatches, and cached region vertices are only
+        // copied when they were rebuilt, or written at a different offset in the previous dispatch.
+        // The vertex buffer is orphaned on every upload, since it may still be in use by the GPU.
         dmGraphics::HVertexBuffer       m_VertexBuffer;
         TileGridVertex*                 m_VertexBufferData;
         TileGridVertex*                 m_VertexBufferDataEnd;
         TileGridVertex*                 m_VertexBufferWritePtr;
+        uint32_t                        m_FrameIndex; // Incremented for each dispatch
+        TileGridRenderStats             m_Stats;
 
         uint32_t                        m_MaxTilemapCount;
         uint32_t                        m_MaxTileCount;
@@ -143,10 +176,11 @@ namespace dmGameSystem
                 {"texcoord0", 1, 2, dmGraphics::TYPE_FLOAT, false},
         };
         world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, ve, sizeof(ve) / sizeof(ve[0]));
-        world->m_VertexBuffer = dmGraphics::NewVertexBuffer(dmRender::GetGraphicsContext(world->m_RenderContext), 0, 0x0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
         uint32_t vcount = 6 * world->m_MaxTileCount;
+        world->m_VertexBuffer = dmGraphics::NewVertexBuffer(graphics_context, 0, 0x0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
         world->m_VertexBufferData = (TileGridVertex*) malloc(sizeof(TileGridVertex) * vcount);
         world->m_VertexBufferDataEnd = world->m_VertexBufferData + vcount;
+        world->m_FrameIndex = 1;
     }
 
     dmGameObject::CreateResult CompTileGridNewWorld(const dmGameObject::ComponentNewWorldParams& params)
@@ -192,6 +226,58 @@ namespace dmGameSystem
         return layer * row_count * column_count + (cell_x + cell_y * column_count);
     }
 
+    static inline uint32_t CalculateRegionIndex(const TileGridComponent* component, int32_t cell_x, int32_t cell_y)
+    {
+        return (cell_y / TILEGRID_REGION_SIZE) * component->m_RegionsX + (cell_x / TILEGRID_REGION_SIZE);
+    }
+
+    // Index of a cell within the cells of its region
+    static inline uint32_t CalculateRegionCellIndex(uint32_t layer, int32_t cell_x, int32_t cell_y)
+    {
+        return layer * TILEGRID_REGION_CELL_COUNT + (cell_y % TILEGRID_REGION_SIZE) * TILEGRID_REGION_SIZE + (cell_x % TILEGRID_REGION_SIZE);
+    }
+
+    static void AllocateRegionCells(TileGridRegion* region, uint32_t n_layers)
+    {
+        uint32_t cell_count = n_layers * TILEGRID_REGION_CELL_COUNT;
+        region->m_Cells = new uint16_t[cell_count];
+        memset(region->m_Cells, 0xff, cell_count * sizeof(uint16_t));
+        region->m_CellFlags = new TileGridCellFlags[cell_count];
+        memset(region->m_CellFlags, 0, cell_count * sizeof(TileGridCellFlags));
+    }
+
+    static void FreeRegionCells(TileGridRegion* region)
+    {
+        delete [] region->m_Cells;
+        delete [] region->m_CellFlags;
+        region->m_Cells = 0;
+        region->m_CellFlags = 0;
+    }
+
+    static void FreeRegionVertices(TileGridRegionVertices* vertices)
+    {
+        free(vertices->m_Vertices);
+        vertices->m_Vertices = 0;
+        vertices->m_VertexCount = 0;
+        vertices->m_VertexCapacity = 0;
+        vertices->m_Dirty = 1;
+    }
+
+    static void FreeRegions(TileGridComponent* component)
+    {
+        for (uint32_t i = 0; i < component->m_Regions.Size(); ++i)
+        {
+            FreeRegionCells(&component->m_Regions[i]);
+        }
+        for (uint32_t i = 0; i < component->m_RegionVertices.Size(); ++i)
+        {
+            FreeRegionVertices(&component->m_RegionVertices[i]);
+        }
+        component->m_Regions.SetSize(0);
+        component->m_RegionVertices.SetSize(0);
+        component->m_CachedRegionVertices.SetSize(0);
+    }
+
     void GetTileGridBounds(const TileGridComponent* component, int32_t* x, int32_t* y, int32_t* w, int32_t* h)
     {
         TileGridResource* resource = component->m_Resource;
@@ -209,9 +295,12 @@ namespace dmGameSystem
 
     uint16_t GetTileGridTile(const TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y)
     {
-        TileGridResource* resource = component->m_Resource;
-        uint32_t cell_index = CalculateCellIndex(layer, cell_x, cell_y, resource->m_ColumnCount, resource->m_RowCount);
-        uint16_t cell = (component->m_Cells[cell_index] + 1);
+        const TileGridRegion* region = &component->m_Regions[CalculateRegionIndex(component, cell_x, cell_y)];
+        if (!region->m_Cells)
+        {
+            return 0;
+        }
+        uint16_t cell = (region->m_Cells[CalculateRegionCellIndex(layer, cell_x, cell_y)] + 1);
         return cell;
     }
 
@@ -221,25 +310,32 @@ namespace dmGameSystem
         layer->m_IsVisible = visible;
     }
 
-    static void SetRegionDirty(TileGridComponent* component, int32_t cell_x, int32_t cell_y)
+    bool SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t transform_mask)
     {
-        uint32_t region_x = cell_x / TILEGRID_REGION_SIZE;
-        uint32_t region_y = cell_y / TILEGRID_REGION_SIZE;
-        uint32_t region_index = region_y * component->m_RegionsX + region_x;
+        uint32_t region_index = CalculateRegionIndex(component, cell_x, cell_y);
         TileGridRegion* region = &component->m_Regions[region_index];
-        region->m_Dirty = 1;
-    }
+        if (!region->m_Cells)
+        {
+            if ((uint16_t)tile == 0xffff)
+            {
+                return false; // Already empty
+            }
+            AllocateRegionCells(region, component->m_Layers.Size());
+        }
 
-    void SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t transform_mask)
-    {
-        TileGridResource* resource = component->m_Resource;
-        uint32_t cell_index = CalculateCellIndex(layer, cell_x, cell_y, resource->m_ColumnCount, resource->m_RowCount);
-        component->m_Cells[cell_index] = tile;
+        uint32_t cell_index = CalculateRegionCellIndex(layer, cell_x, cell_y);
+        TileGridComponent::Flags* flags = &region->m_CellFlags[cell_index];
+        if (region->m_Cells[cell_index] == (uint16_t)tile && flags->m_TransformMask == transform_mask)
+        {
+            return false;
+        }
 
-        TileGridComponent::Flags* flags = &component->m_CellFlags[cell_index];
+        region->m_Cells[cell_index] = tile;
         flags->m_TransformMask = transform_mask;
 
-        SetRegionDirty(component, cell_x, cell_y);
+        region->m_Dirty = 1;
+        component->m_RegionVertices[layer * component->m_Regions.Size() + region_index].m_Dirty = 1;
+        return true;
     }
 
     uint16_t GetTileCount(const TileGridComponent* component) {
@@ -263,8 +359,10 @@ namespace dmGameSystem
         component->m_MixedHash = dmHashFinal32(&state);
     }
 
-    static void CreateRegions(TileGridComponent* component, TileGridResource* resource)
+    static void CreateRegions(TileGridComponent* component, TileGridResource* resource, uint32_t n_layers)
     {
+        FreeRegions(component);
+
         // Round up to closest multiple
         component->m_RegionsX = ((resource->m_ColumnCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
         component->m_RegionsY = ((resource->m_RowCount + TILEGRID_REGION_SIZE - 1) / TILEGRID_REGION_SIZE);
@@ -272,7 +370,15 @@ namespace dmGameSystem
 
         component->m_Regions.SetCapacity(region_count);
         component->m_Regions.SetSize(region_count);
-        memset(&component->m_Regions[0], 0xFF, region_count * sizeof(TileGridRegion)); // mark them all dirty
+        memset(component->m_Regions.Begin(), 0, region_count * sizeof(TileGridRegion));
+
+        component->m_RegionVertices.SetCapacity(region_count * n_layers);
+        component->m_RegionVertices.SetSize(region_count * n_layers);
+        memset(component->m_RegionVertices.Begin(), 0, region_count * n_layers * sizeof(TileGridRegionVertices));
+        for (uint32_t i = 0; i < region_count * n_layers; ++i)
+        {
+            component->m_RegionVertices[i].m_Dirty = 1;
+        }
     }
 
     static uint32_t UpdateRegion(TileGridComponent* component, uint32_t region_x, uint32_t region_y)
@@ -283,44 +389,34 @@ namespace dmGameSystem
             return region->m_Occupied;
         }
         region->m_Dirty = 0;
-
-        TileGridResource* resource = component->m_Resource;
-        dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
-
-        uint32_t n_layers = tile_grid_ddf->m_Layers.m_Count;
-
-        uint32_t column_count = resource->m_ColumnCount;
-        uint32_t row_count = resource->m_RowCount;
-        int32_t min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
-        int32_t min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
-        int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)column_count);
-        int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)row_count);
-
         region->m_Occupied = 0;
 
-        uint32_t visible_tiles = 0;
+        if (!region->m_Cells) {
+            return 0;
+        }
+
+        uint32_t n_layers = component->m_Layers.Size();
+        bool has_tiles = false;
         for (uint32_t j = 0; j < n_layers; ++j)
         {
-            TileGridLayer* layer = &component->m_Layers[j];
-            if (!layer->m_IsVisible)
-                continue;
-
-            for (int32_t y = min_y; y < max_y; ++y)
+            const uint16_t* cells = &region->m_Cells[j * TILEGRID_REGION_CELL_COUNT];
+            for (uint32_t i = 0; i < TILEGRID_REGION_CELL_COUNT; ++i)
             {
-                for (int32_t x = min_x; x < max_x; ++x)
+                if (cells[i] != 0xffff)
                 {
-                    uint32_t cell = CalculateCellIndex(j, x - resource->m_MinCellX, y - resource->m_MinCellY, column_count, row_count);
-                    uint16_t tile = component->m_Cells[cell];
-                    if (tile != 0xffff)
-                    {
-                        ++visible_tiles;
-                        region->m_Occupied = 1;
-                        return region->m_Occupied;
-                    }
+                    has_tiles = true;
+                    region->m_Occupied |= component->m_Layers[j].m_IsVisible;
+                    break;
                 }
             }
         }
 
+        // Release the cells of regions that have been cleared
+        if (!has_tiles)
+        {
+            FreeRegionCells(region);
+        }
+
         return region->m_Occupied;
     }
 
@@ -340,27 +436,14 @@ namespace dmGameSystem
         TileGridResource* resource = component->m_Resource;
         dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
         uint32_t n_layers = tile_grid_ddf->m_Layers.m_Count;
-        uint32_t cell_count = resource->m_ColumnCount * resource->m_RowCount * n_layers;
-        if (component->m_Cells != 0x0)
-        {
-            delete [] component->m_Cells;
-        }
-        component->m_Cells = new uint16_t[cell_count];
-        memset(component->m_Cells, 0xff, cell_count * sizeof(uint16_t));
-        if (component->m_CellFlags != 0x0)
-        {
-            delete [] component->m_CellFlags;
-        }
-        component->m_CellFlags = new TileGridComponent::Flags[cell_count];
-        memset(component->m_CellFlags, 0, cell_count * sizeof(TileGridComponent::Flags));
         int32_t min_x = resource->m_MinCellX;
         int32_t min_y = resource->m_MinCellY;
-        uint32_t column_count = resource->m_ColumnCount;
-        uint32_t row_count = resource->m_RowCount;
 
         component->m_Layers.SetCapacity(n_layers);
         component->m_Layers.SetSize(n_layers);
 
+        CreateRegions(component, resource, n_layers);
+
         for (uint32_t i = 0; i < n_layers; ++i)
         {
             dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[i];
@@ -371,27 +454,28 @@ namespace dmGameSystem
             for (uint32_t j = 0; j < n_cells; ++j)
             {
                 dmGameSystemDDF::TileCell* cell = &layer_ddf->m_Cell[j];
-                uint32_t cell_index = CalculateCellIndex(i, cell->m_X - min_x, cell->m_Y - min_y, column_count, row_count);
-                component->m_Cells[cell_index] = (uint16_t)cell->m_Tile;
-
-                TileGridComponent::Flags* flags = &component->m_CellFlags[cell_index];
-                flags->m_TransformMask = 0;
+                uint8_t transform_mask = 0;
                 if (cell->m_HFlip)
                 {
-                    flags->m_TransformMask = FLIP_HORIZONTAL;
+                    transform_mask = FLIP_HORIZONTAL;
                 }
                 if (cell->m_VFlip)
                 {
-                    flags->m_TransformMask |= FLIP_VERTICAL;
+                    transform_mask |= FLIP_VERTICAL;
                 }
                 if (cell->m_Rotate90)
                 {
-                    flags->m_TransformMask |= ROTATE_90;
+                    transform_mask |= ROTATE_90;
                 }
+                SetTileGridTile(component, i, cell->m_X - min_x, cell->m_Y - min_y, cell->m_Tile, transform_mask);
             }
         }
 
-        CreateRegions(component, resource);
+        // Make sure all regions are evaluated, also the empty ones
+        for (uint32_t i = 0; i < component->m_Regions.Size(); ++i)
+        {
+            component->m_Regions[i].m_Dirty = 1;
+        }
         component->m_Occupied = UpdateRegions(component);
         return n_layers;
     }
@@ -445,8 +529,7 @@ namespace dmGameSystem
                     dmResource::Release(dmGameObject::GetFactory(params.m_Instance), tile_grid->m_TextureSet);
                 }
 
-                delete [] tile_grid->m_Cells;
-                delete [] tile_grid->m_CellFlags;
+                FreeRegions(tile_grid);
 
                 if (tile_grid->m_RenderConstants)
                 {
@@ -496,13 +579,21 @@ namespace dmGameSystem
 
             Matrix4 local(component->m_Rotation, component->m_Translation);
             const Matrix4& go_world = dmGameObject::GetWorldMatrix(component->m_Instance);
+            Matrix4 world_matrix;
             if (dmGameObject::ScaleAlongZ(component->m_Instance))
             {
-                component->m_World = go_world * local;
+                world_matrix = go_world * local;
             }
             else
             {
-                component->m_World = dmTransform::MulNoScaleZ(go_world, local);
+                world_matrix = dmTransform::MulNoScaleZ(go_world, local);
+            }
+
+            // The cached vertices are in world space
+            if (memcmp(&world_matrix, &component->m_World, sizeof(Matrix4)) != 0)
+            {
+                component->m_World = world_matrix;
+                component->m_VertexVersion++;
             }
         }
         return dmGameObject::UPDATE_RESULT_OK;
@@ -521,13 +612,21 @@ namespace dmGameSystem
         region_y = (ptr >> 48) & 0xFFFF;
     }
 
-    TileGridVertex* CreateVertexData(TileGridWorld* world, TileGridVertex* where, TextureSetResource* texture_set, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    static inline void GetRegionCellBounds(const TileGridResource* resource, uint32_t region_x, uint32_t region_y, int32_t& min_x, int32_t& min_y, int32_t& max_x, int32_t& max_y)
+    {
+        min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
+        min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
+        max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)resource->m_ColumnCount);
+        max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)resource->m_RowCount);
+    }
+
+    // Builds the world space vertices of one layer of a region
+    static void BuildRegionVertices(const TileGridComponent* component, uint32_t layer, uint32_t region_x, uint32_t region_y, TileGridRegionVertices* out)
     {
-        DM_PROFILE("CreateVertexData");
         /*
          *   0----3
          *   | \  |
-         *   |  \ |   
+         *   |  \ |
          *   1____2
         */
         static int tex_coord_order[] = {
@@ -542,79 +641,150 @@ namespace dmGameSystem
             1,2,3,3,0,1     //hv
         };
 
-        dmGameSystemDDF::TextureSet* texture_set_ddf = texture_set->m_TextureSet;
+        out->m_VertexCount = 0;
+        out->m_Dirty = 0;
+        out->m_Version = component->m_VertexVersion;
+
+        const TileGridRegion* region = &component->m_Regions[region_y * component->m_RegionsX + region_x];
+        if (!region->m_Cells)
+        {
+            return;
+        }
+
+        const uint16_t* cells = &region->m_Cells[layer * TILEGRID_REGION_CELL_COUNT];
+        const TileGridCellFlags* cell_flags = &region->m_CellFlags[layer * TILEGRID_REGION_CELL_COUNT];
+
+        uint32_t tile_count = 0;
+        for (uint32_t i = 0; i < TILEGRID_REGION_CELL_COUNT; ++i)
+        {
+            tile_count += cells[i] != 0xffff;
+        }
+        if (tile_count * 6 > out->m_VertexCapacity)
+        {
+            out->m_VertexCapacity = tile_count * 6;
+            out->m_Vertices = (TileGridVertex*)realloc(out->m_Vertices, out->m_VertexCapacity * sizeof(TileGridVertex));
+        }
+
+        dmGameSystemDDF::TextureSet* texture_set_ddf = GetTextureSet(component)->m_TextureSet;
         const float* tex_coords = (const float*) texture_set_ddf->m_TexCoords.m_Data;
 
         uint32_t tile_width = texture_set_ddf->m_TileWidth;
         uint32_t tile_height = texture_set_ddf->m_TileHeight;
 
-        for (uint32_t* i = begin; i != end; ++i)
+        const TileGridResource* resource = component->m_Resource;
+        const Matrix4& w = component->m_World;
+        const float z = resource->m_TileGrid->m_Layers[layer].m_Z;
+
+        int32_t min_x, min_y, max_x, max_y;
+        GetRegionCellBounds(resource, region_x, region_y, min_x, min_y, max_x, max_y);
+
+        TileGridVertex* where = out->m_Vertices;
+        for (int32_t y = min_y; y < max_y; ++y)
         {
-            uint32_t index, layer, region_x, region_y;
-            DecodeGridAndLayer(buf[*i].m_UserData, index, layer, region_x, region_y);
+            for (int32_t x = min_x; x < max_x; ++x)
+            {
+                uint32_t cell = CalculateRegionCellIndex(0, x - resource->m_MinCellX, y - resource->m_MinCellY);
+                uint16_t tile = cells[cell];
+                if (tile == 0xffff)
+                {
+                    continue;
+                }
 
-            const TileGridComponent* component = world->m_Components[index];
-            const TileGridResource* resource = component->m_Resource;
-            dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
-            dmGameSystemDDF::TileLayer* layer_ddf = &tile_grid_ddf->m_Layers[layer];
+                float p[4];
+                CalculateCellBounds(x, y, 1, 1, p);
+                const float* puv = &tex_coords[tile * 8];
+
+                TileGridCellFlags flags = cell_flags[cell];
+                const int* tex_lookup = &tex_coord_order[flags.m_TransformMask * 6];
+
+                #define SET_VERTEX(_I, _X, _Y, _Z, _U, _V) \
+                    { \
+                        const Vector4 v = w * Point3(_X * tile_width, _Y * tile_height, _Z); \
+                        where[_I].x = v.getX(); \
+                        where[_I].y = v.getY(); \
+                        where[_I].z = v.getZ(); \
+                        where[_I].u = _U; \
+                        where[_I].v = _V; \
+                    }
+
+                SET_VERTEX(0, p[0], p[1], z, puv[tex_lookup[0] * 2], puv[tex_lookup[0] * 2 + 1]);
+                SET_VERTEX(1, p[0], p[3], z, puv[tex_lookup[1] * 2], puv[tex_lookup[1] * 2 + 1]);
+                SET_VERTEX(2, p[2], p[3], z, puv[tex_lookup[2] * 2], puv[tex_lookup[2] * 2 + 1]);
+                SET_VERTEX(3, p[2], p[3], z, puv[tex_lookup[3] * 2], puv[tex_lookup[3] * 2 + 1]);
+                SET_VERTEX(4, p[2], p[1], z, puv[tex_lookup[4] * 2], puv[tex_lookup[4] * 2 + 1]);
+                SET_VERTEX(5, p[0], p[1], z, puv[tex_lookup[5] * 2], puv[tex_lookup[5] * 2 + 1]);
+
+                where += 6;
 
-            const Matrix4& w = component->m_World;
-            const float z = layer_ddf->m_Z;
+                #undef SET_VERTEX
+            }
+        }
+        out->m_VertexCount = where - out->m_Vertices;
+    }
+
+    // Writes the cached vertices of the regions into the world vertex data. Regions are only rebuilt
+    // when they have changed, and only copied when they ended up at a different offset than in the previous dispatch.
+    TileGridVertex* CreateVertexData(TileGridWorld* world, TileGridVertex* where, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    {
+        DM_PROFILE("CreateVertexData");
 
-            uint32_t column_count = resource->m_ColumnCount;
-            uint32_t row_count = resource->m_RowCount;
+        for (uint32_t* i = begin; i != end; ++i)
+        {
+            uint32_t index, layer, region_x, region_y;
+            DecodeGridAndLayer(buf[*i].m_UserData, index, layer, region_x, region_y);
 
-            int32_t min_x = resource->m_MinCellX + region_x * TILEGRID_REGION_SIZE;
-            int32_t min_y = resource->m_MinCellY + region_y * TILEGRID_REGION_SIZE;
-            int32_t max_x = dmMath::Min(min_x + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellX + (int32_t)column_count);
-            int32_t max_y = dmMath::Min(min_y + (int32_t)TILEGRID_REGION_SIZE, resource->m_MinCellY + (int32_t)row_count);
+            TileGridComponent* component = world->m_Components[index];
+            uint32_t region_count = component->m_Regions.Size();
+            uint32_t vertices_index = layer * region_count + region_y * component->m_RegionsX + region_x;
+            TileGridRegionVertices* vertices = &component->m_RegionVertices[vertices_index];
 
-            for (int32_t y = min_y; y < max_y; ++y)
+            bool rebuilt = false;
+            if (vertices->m_Dirty || vertices->m_Version != component->m_VertexVersion)
             {
-                for (int32_t x = min_x; x < max_x; ++x)
+                bool cached = vertices->m_Vertices != 0;
+                BuildRegionVertices(component, layer, region_x, region_y, vertices);
+                if (!cached && vertices->m_Vertices)
                 {
-                    uint32_t cell = CalculateCellIndex(layer, x - resource->m_MinCellX, y - resource->m_MinCellY, column_count, row_count);
-                    uint16_t tile = component->m_Cells[cell];
-                    if (tile == 0xffff)
-                    {
-                        continue;
-                    }
-
-                    if( where >= world->m_VertexBufferDataEnd )
+                    dmArray<uint32_t>& cached_vertices = component->m_CachedRegionVertices;
+                    if (cached_vertices.Full())
                     {
-                        dmLogError("Out of tiles to render (%zu). You can change this with the game.project setting tilemap.max_tile_count", (size_t)((world->m_VertexBufferDataEnd - world->m_VertexBufferData) / 6));
-                        return world->m_VertexBufferDataEnd;
+                        cached_vertices.OffsetCapacity(dmMath::Max(cached_vertices.Capacity(), 16U));
                     }
+                    cached_vertices.Push(vertices_index);
+                }
+                DM_PROPERTY_ADD_U32(rmtp_TilemapRebuiltRegionCount, 1);
+                world->m_Stats.m_RebuiltRegionCount++;
+                rebuilt = true;
+            }
 
-                    float p[4];
-                    CalculateCellBounds(x, y, 1, 1, p);
-                    const float* puv = &tex_coords[tile * 8];
-
-                    TileGridComponent::Flags flags = component->m_CellFlags[cell];
-                    const int* tex_lookup = &tex_coord_order[flags.m_TransformMask * 6];
-
-                    #define SET_VERTEX(_I, _X, _Y, _Z, _U, _V) \
-                        { \
-                            const Vector4 v = w * Point3(_X * tile_width, _Y * tile_height, _Z); \
-                            where[_I].x = v.getX(); \
-                            where[_I].y = v.getY(); \
-                            where[_I].z = v.getZ(); \
-                            where[_I].u = _U; \
-                            where[_I].v = _V; \
-                        }
-
-                    SET_VERTEX(0, p[0], p[1], z, puv[tex_lookup[0] * 2], puv[tex_lookup[0] * 2 + 1]);
-                    SET_VERTEX(1, p[0], p[3], z, puv[tex_lookup[1] * 2], puv[tex_lookup[1] * 2 + 1]);
-                    SET_VERTEX(2, p[2], p[3], z, puv[tex_lookup[2] * 2], puv[tex_lookup[2] * 2 + 1]);
-                    SET_VERTEX(3, p[2], p[3], z, puv[tex_lookup[3] * 2], puv[tex_lookup[3] * 2 + 1]);
-                    SET_VERTEX(4, p[2], p[1], z, puv[tex_lookup[4] * 2], puv[tex_lookup[4] * 2 + 1]);
-                    SET_VERTEX(5, p[0], p[1], z, puv[tex_lookup[5] * 2], puv[tex_lookup[5] * 2 + 1]);
+            uint32_t vertex_count = vertices->m_VertexCount;
+            if (vertex_count == 0)
+            {
+                continue;
+            }
 
-                    where += 6;
+            uint32_t vertex_start = where - world->m_VertexBufferData;
+            if (where + vertex_count > world->m_VertexBufferDataEnd)
+            {
+                dmLogError("Out of tiles to render (%zu). You can change this with the game.project setting tilemap.max_tile_count", (size_t)((world->m_VertexBufferDataEnd - world->m_VertexBufferData) / 6));
+                uint32_t fit_count = world->m_VertexBufferDataEnd - where;
+                memcpy(where, vertices->m_Vertices, fit_count * sizeof(TileGridVertex));
+                DM_PROPERTY_ADD_U32(rmtp_TilemapCopiedVertexCount, fit_count);
+                world->m_Stats.m_CopiedVertexCount += fit_count;
+                vertices->m_FrameIndex = 0;
+                return world->m_VertexBufferDataEnd;
+            }
 
-                    #undef SET_VERTEX
-                }
+            if (rebuilt || vertices->m_FrameIndex + 1 != world->m_FrameIndex || vertices->m_VertexStart != vertex_start)
+            {
+                memcpy(where, vertices->m_Vertices, vertex_count * sizeof(TileGridVertex));
+                DM_PROPERTY_ADD_U32(rmtp_TilemapCopiedVertexCount, vertex_count);
+                world->m_Stats.m_CopiedVertexCount += vertex_count;
             }
+            vertices->m_VertexStart = vertex_start;
+            vertices->m_FrameIndex = world->m_FrameIndex;
+
+            where += vertex_count;
         }
         return where;
     }
@@ -631,12 +801,16 @@ namespace dmGameSystem
         TileGridResource* resource = first->m_Resource;
         TextureSetResource* texture_set = GetTextureSet(first);
 
-        dmRender::RenderObject& ro = *world->m_RenderObjects.End();
-        world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
-
         // Fill in vertex buffer
         TileGridVertex* vb_begin = world->m_VertexBufferWritePtr;
-        world->m_VertexBufferWritePtr = CreateVertexData(world, vb_begin, texture_set, buf, begin, end);
+        world->m_VertexBufferWritePtr = CreateVertexData(world, vb_begin, buf, begin, end);
+        if (world->m_VertexBufferWritePtr == vb_begin)
+        {
+            return;
+        }
+
+        dmRender::RenderObject& ro = *world->m_RenderObjects.End();
+        world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
 
         ro.Init();
         ro.m_VertexDeclaration = world->m_VertexDeclaration;
@@ -686,6 +860,31 @@ namespace dmGameSystem
         dmRender::AddToRender(render_context, &ro);
     }
 
+    // Uploads the vertices written by this dispatch. The buffer is orphaned, since the draws of
+    // earlier dispatches and frames may still read from it.
+    static void UploadVertices(TileGridWorld* world)
+    {
+        uint32_t vertex_count = world->m_VertexBufferWritePtr - world->m_VertexBufferData;
+        world->m_Stats.m_VertexCount = vertex_count;
+        for (uint32_t i = 0; i < world->m_Components.Size(); ++i)
+        {
+            world->m_Stats.m_CachedRegionCount += world->m_Components[i]->m_CachedRegionVertices.Size();
+        }
+        world->m_FrameIndex++;
+        if (vertex_count == 0)
+        {
+            return;
+        }
+
+        dmGraphics::SetVertexBufferData(world->m_VertexBuffer, 0, 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        dmGraphics::SetVertexBufferData(world->m_VertexBuffer, sizeof(TileGridVertex) * vertex_count,
+                                        world->m_VertexBufferData, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+
+        DM_PROPERTY_ADD_U32(rmtp_TilemapTileCount, vertex_count/6);
+        DM_PROPERTY_ADD_U32(rmtp_TilemapVertexCount, vertex_count);
+        DM_PROPERTY_ADD_U32(rmtp_TilemapVertexSize, vertex_count * sizeof(TileGridVertex));
+    }
+
     static void RenderListDispatch(dmRender::RenderListDispatchParams const &params)
     {
         TileGridWorld* world = (TileGridWorld*) params.m_UserData;
@@ -695,19 +894,11 @@ namespace dmGameSystem
         case dmRender::RENDER_LIST_OPERATION_BEGIN:
             world->m_VertexBufferWritePtr = world->m_VertexBufferData;
             world->m_RenderObjects.SetSize(0);
+            memset(&world->m_Stats, 0, sizeof(world->m_Stats));
             break;
 
         case dmRender::RENDER_LIST_OPERATION_END:
-            {
-                uint32_t vertex_count = world->m_VertexBufferWritePtr - world->m_VertexBufferData;
-                dmGraphics::SetVertexBufferData(world->m_VertexBuffer, 0, 0, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
-                dmGraphics::SetVertexBufferData(world->m_VertexBuffer, sizeof(TileGridVertex) * vertex_count,
-                                                world->m_VertexBufferData, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
-
-                DM_PROPERTY_ADD_U32(rmtp_TilemapTileCount, vertex_count/6);
-                DM_PROPERTY_ADD_U32(rmtp_TilemapVertexCount, vertex_count);
-                DM_PROPERTY_ADD_U32(rmtp_TilemapVertexSize, vertex_count * sizeof(TileGridVertex));
-            }
+            UploadVertices(world);
             break;
 
         case dmRender::RENDER_LIST_OPERATION_BATCH:
@@ -716,6 +907,55 @@ namespace dmGameSystem
         }
     }
 
+    void GetTileGridRenderStats(void* world, TileGridRenderStats* stats)
+    {
+        *stats = ((TileGridWorld*)world)->m_Stats;
+    }
+
+    static void RenderListFrustumCulling(dmRender::RenderListVisibilityParams const &params)
+    {
+        DM_PROFILE("FrustumCulling");
+
+        const TileGridWorld* world = (TileGridWorld*)params.m_UserData;
+        const dmIntersection::Frustum frustum = *params.m_Frustum;
+        uint32_t num_entries = params.m_NumEntries;
+
+        // The regions are tested as bounding spheres, in chunks, to make use of the batched intersection test
+        const uint32_t chunk_size = 64;
+        dmVMath::Vector4 spheres[chunk_size];
+        bool intersect[chunk_size];
+        for (uint32_t chunk_start = 0; chunk_start < num_entries; chunk_start += chunk_size)
+        {
+            dmRender::RenderListEntry* entries = &params.m_Entries[chunk_start];
+            uint32_t count = dmMath::Min(chunk_size, num_entries - chunk_start);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t index, layer, region_x, region_y;
+                DecodeGridAndLayer(entries[i].m_UserData, index, layer, region_x, region_y);
+                const TileGridComponent* component = world->m_Components[index];
+                const TileGridResource* resource = component->m_Resource;
+                const dmGameSystemDDF::TextureSet* texture_set_ddf = GetTextureSet(component)->m_TextureSet;
+
+                int32_t min_x, min_y, max_x, max_y;
+                GetRegionCellBounds(resource, region_x, region_y, min_x, min_y, max_x, max_y);
+                Vector3 half_extents(0.5f * (max_x - min_x) * texture_set_ddf->m_TileWidth, 0.5f * (max_y - min_y) * texture_set_ddf->m_TileHeight, 0.0f);
+                Point3 center(min_x * (float)texture_set_ddf->m_TileWidth + half_extents.getX(), min_y * (float)texture_set_ddf->m_TileHeight + half_extents.getY(), resource->m_TileGrid->m_Layers[layer].m_Z);
+
+                const Matrix4& w = component->m_World;
+                float scale = dmMath::Max(length(w.getCol0().getXYZ()), length(w.getCol1().getXYZ()));
+                Vector4 world_center = w * center;
+                spheres[i] = Vector4(world_center.getXYZ(), length(half_extents) * scale);
+            }
+
+            dmIntersection::TestFrustumSpheres(frustum, spheres, count, true, intersect);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                entries[i].m_Visibility = intersect[i] ? dmRender::VISIBILITY_FULL : dmRender::VISIBILITY_NONE;
+            }
+        }
+    }
+
     // Estimates the number of render entries needed
     static uint32_t CalcNumVisibleRegions(TileGridComponent** components, uint32_t num_components)
     {
@@ -739,6 +979,28 @@ namespace dmGameSystem
         return num_render_entries;
     }
 
+    // Releases the cached vertices of regions that haven't been rendered for a while,
+    // so that the memory used follows the visible part of large tile maps.
+    // Only the regions holding vertices are visited, not every region of the grid.
+    static void ReleaseUnusedRegionVertices(TileGridWorld* world, TileGridComponent* component)
+    {
+        dmArray<uint32_t>& cached_vertices = component->m_CachedRegionVertices;
+        uint32_t i = 0;
+        while (i < cached_vertices.Size())
+        {
+            TileGridRegionVertices* vertices = &component->m_RegionVertices[cached_vertices[i]];
+            if (vertices->m_FrameIndex + TILEGRID_VERTEX_CACHE_FRAMES < world->m_FrameIndex)
+            {
+                FreeRegionVertices(vertices);
+                cached_vertices.EraseSwap(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
     dmGameObject::UpdateResult CompTileGridRender(const dmGameObject::ComponentsRenderParams& params)
     {
         TilemapContext* context = (TilemapContext*)params.m_Context;
@@ -762,12 +1024,14 @@ namespace dmGameSystem
 
         dmRender::HRenderContext render_context = context->m_RenderContext;
         dmRender::RenderListEntry* render_list = dmRender::RenderListAlloc(render_context, num_render_entries);
-        dmRender::HRenderListDispatch dispatch = dmRender::RenderListMakeDispatch(render_context, &RenderListDispatch, world);
+        dmRender::HRenderListDispatch dispatch = dmRender::RenderListMakeDispatch(render_context, &RenderListDispatch, &RenderListFrustumCulling, world);
         dmRender::RenderListEntry* write_ptr = render_list;
 
         for (uint32_t i = 0; i < n; ++i)
         {
             TileGridComponent* component = components[i];
+            ReleaseUnusedRegionVertices(world, component);
+
             if (!component->m_Enabled || !component->m_AddedToUpdate || !component->m_Occupied) {
                 continue;
             }
@@ -777,8 +1041,15 @@ namespace dmGameSystem
                 ReHash(component);
             }
 
+            TextureSetResource* texture_set = GetTextureSet(component);
+            if (texture_set != component->m_VertexTextureSet)
+            {
+                component->m_VertexTextureSet = texture_set;
+                component->m_VertexVersion++;
+            }
+
             TileGridResource* resource = component->m_Resource;
-            dmGameSystemDDF::TextureSet* texture_set_ddf = GetTextureSet(component)->m_TextureSet;
+            dmGameSystemDDF::TextureSet* texture_set_ddf = texture_set->m_TextureSet;
             dmGameSystemDDF::TileGrid* tile_grid_ddf = resource->m_TileGrid;
 
             uint32_t tile_width = texture_set_ddf->m_TileWidth;
@@ -59,12 +59,24 @@ namespace dmGameSystem
 
     uint16_t GetTileGridTile(const TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y);
 
-    void SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t transform_mask);
+    // Returns false if the cell already had the tile and transform
+    bool SetTileGridTile(TileGridComponent* component, uint32_t layer, int32_t cell_x, int32_t cell_y, uint32_t tile, uint8_t transform_mask);
 
     uint16_t GetTileCount(const TileGridComponent* component);
 
     void SetLayerVisible(TileGridComponent* component, uint32_t layer, bool visible);
 
+    // Used in unit tests
+    struct TileGridRenderStats
+    {
+        uint32_t m_VertexCount;         // Vertices written by the last dispatch
+        uint32_t m_RebuiltRegionCount;  // Region layers whose vertices were rebuilt by the last dispatch
+        uint32_t m_CopiedVertexCount;   // Cached vertices copied by the last dispatch
+        uint32_t m_CachedRegionCount;   // Region layers holding cached vertices after the last dispatch
+    };
+
+    void GetTileGridRenderStats(void* world, TileGridRenderStats* stats);
+
     enum TileTransformMask
     {
         FLIP_HORIZONTAL = 1,
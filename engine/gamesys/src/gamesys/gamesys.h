@@ -95,6 +95,7 @@ namespace dmGameSystem
         }
         dmResource::HFactory m_Factory;
         dmRender::HRenderContext m_RenderContext;
+        dmJobPool::HJobPool m_JobPool;
         uint32_t m_MaxParticleFXCount;
         uint32_t m_MaxParticleCount;
         uint32_t m_MaxEmitterCount;
@@ -39,11 +39,6 @@ namespace dmGameSystem
         {
             return fr;
         }
-        if(dmRender::GetMaterialVertexSpace(resource->m_Material) != dmRenderDDF::MaterialDesc::VERTEX_SPACE_WORLD)
-        {
-            dmLogError("Failed to create Sprite component. This component only supports materials with the Vertex Space property set to 'vertex-space-world'");
-            return dmResource::RESULT_NOT_SUPPORTED;
-        }
         resource->m_DefaultAnimation = dmHashString64(resource->m_DDF->m_DefaultAnimation);
         if (!resource->m_TextureSet->m_AnimationIds.Get(resource->m_DefaultAnimation))
         {
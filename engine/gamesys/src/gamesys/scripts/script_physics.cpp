@@ -14,6 +14,7 @@
 
 #include <float.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include <dlib/hash.h>
@@ -127,6 +128,9 @@ namespace dmGameSystem
     {
         dmMessage::HSocket m_Socket;
         uint32_t m_ComponentIndex;
+        // Scratch buffers for physics.raycast_batch
+        dmArray<dmPhysics::RayCastRequest> m_RayCastRequests;
+        dmArray<dmPhysics::RayCastResponse> m_RayCastResponses;
     };
 
     /*# [type:number] collision object mass
@@ -344,14 +348,27 @@ namespace dmGameSystem
         return 0;
     }
 
+    // Sets a vector3 field of the table on top of the stack, updating the vector3 already there if any
+    static void SetVector3Field(lua_State* L, const char* name, const dmVMath::Vector3& value)
+    {
+        lua_getfield(L, -1, name);
+        dmVMath::Vector3* v = dmScript::ToVector3(L, -1);
+        lua_pop(L, 1);
+        if (v)
+        {
+            *v = value;
+            return;
+        }
+        dmScript::PushVector3(L, value);
+        lua_setfield(L, -2, name);
+    }
+
     static void PushRayCastResponse(lua_State* L, void* world, const dmPhysics::RayCastResponse& response)
     {
         lua_pushnumber(L, response.m_Fraction);
         lua_setfield(L, -2, "fraction");
-        dmScript::PushVector3(L, dmVMath::Vector3(response.m_Position));
-        lua_setfield(L, -2, "position");
-        dmScript::PushVector3(L, response.m_Normal);
-        lua_setfield(L, -2, "normal");
+        SetVector3Field(L, "position", dmVMath::Vector3(response.m_Position));
+        SetVector3Field(L, "normal", response.m_Normal);
 
         dmhash_t group = dmGameSystem::GetLSBGroupHash(world, response.m_CollisionObjectGroup);
         dmScript::PushHash(L, group);
@@ -491,6 +508,152 @@ namespace dmGameSystem
         return 1;
     }
 
+    /*# performs several ray casts at once
+     *
+     * Performs a list of ray casts in one call, which is faster than calling [ref:physics.raycast]
+     * for each ray. The closest hit of each ray is returned. With 2D physics, the rays are shared
+     * between the main thread and the threads set by `engine.job_thread_count` in game.project.
+     *
+     * Which collision objects to hit is filtered by their collision groups and can be configured
+     * through `groups`. Trigger objects do not intersect with ray casts.
+     *
+     * @name physics.raycast_batch
+     * @param from [type:table] a list of the world positions of the start of the rays, as vector3
+     * @param to [type:table] a list of the world positions of the end of the rays, as vector3, in the same order as `from`
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @param [results] [type:table] a table from a previous call to reuse. The result tables and vectors in it are updated in place.
+     * @return results [type:table] a list with one entry per ray. A hit is a table with the same fields as the `ray_cast_response` message, a miss is `false`.
+     * @examples
+     *
+     * How to check the line of sight of several enemies:
+     *
+     * ```lua
+     * function update(self, dt)
+     *     for i, enemy in ipairs(self.enemies) do
+     *         self.from[i] = go.get_position(enemy)
+     *         self.to[i] = self.player_position
+     *     end
+     *     self.results = physics.raycast_batch(self.from, self.to, self.groups, self.results)
+     *     for i, result in ipairs(self.results) do
+     *         if result and result.id == self.player_id then
+     *             -- enemy i sees the player
+     *         end
+     *     end
+     * end
+     * ```
+     */
+    int Physics_RayCastBatch(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            return luaL_error(L, "could not find a requesting instance for physics.raycast_batch");
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+        if (world == 0x0)
+        {
+            return DM_LUA_ERROR("Physics world doesn't exist. Make sure you have at least one physics component in collection.");
+        }
+
+        luaL_checktype(L, 1, LUA_TTABLE);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        uint32_t count = (uint32_t)lua_objlen(L, 1);
+        if (lua_objlen(L, 2) != count)
+        {
+            return DM_LUA_ERROR("the from and to lists must have the same length (%d and %d)", count, (uint32_t)lua_objlen(L, 2));
+        }
+
+        uint32_t mask = 0;
+        luaL_checktype(L, 3, LUA_TTABLE);
+        lua_pushnil(L);
+        while (lua_next(L, 3) != 0)
+        {
+            mask |= CompCollisionGetGroupBitIndex(world, dmScript::CheckHash(L, -1));
+            lua_pop(L, 1);
+        }
+
+        dmArray<dmPhysics::RayCastRequest>& requests = context->m_RayCastRequests;
+        dmArray<dmPhysics::RayCastResponse>& responses = context->m_RayCastResponses;
+        if (requests.Capacity() < count)
+        {
+            requests.SetCapacity(count);
+            responses.SetCapacity(count);
+        }
+        requests.SetSize(count);
+        responses.SetSize(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            lua_rawgeti(L, 1, i + 1);
+            dmVMath::Vector3* from = dmScript::ToVector3(L, -1);
+            lua_rawgeti(L, 2, i + 1);
+            dmVMath::Vector3* to = dmScript::ToVector3(L, -1);
+            lua_pop(L, 2);
+            if (from == 0x0 || to == 0x0)
+            {
+                return DM_LUA_ERROR("ray %d: the from and to positions must be vector3", i + 1);
+            }
+
+            dmPhysics::RayCastRequest& request = requests[i];
+            request = dmPhysics::RayCastRequest();
+            request.m_From = dmVMath::Point3(*from);
+            request.m_To = dmVMath::Point3(*to);
+            request.m_Mask = mask;
+            request.m_ReturnAllResults = 0;
+        }
+
+        dmGameSystem::RayCastBatch(world, requests.Begin(), count, responses.Begin());
+
+        if (lua_istable(L, 4))
+        {
+            lua_pushvalue(L, 4);
+        }
+        else
+        {
+            lua_createtable(L, count, 0);
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!responses[i].m_Hit)
+            {
+                lua_pushboolean(L, 0);
+                lua_rawseti(L, -2, i + 1);
+                continue;
+            }
+
+            // Result tables from a previous call are updated in place, to not create garbage
+            lua_rawgeti(L, -1, i + 1);
+            if (!lua_istable(L, -1))
+            {
+                lua_pop(L, 1);
+                lua_newtable(L);
+                lua_pushvalue(L, -1);
+                lua_rawseti(L, -3, i + 1);
+            }
+            PushRayCastResponse(L, world, responses[i]);
+            lua_pop(L, 1);
+        }
+
+        // Remove any results left from a longer previous call
+        uint32_t previous_count = (uint32_t)lua_objlen(L, -1);
+        for (uint32_t i = count + 1; i <= previous_count; ++i)
+        {
+            lua_pushnil(L);
+            lua_rawseti(L, -2, i);
+        }
+
+        return 1;
+    }
+
     // Matches JointResult in physics.h
     static const char* PhysicsResultString[] = {
         "result ok",
@@ -1270,11 +1433,315 @@ namespace dmGameSystem
         return 1;
     }
 
+    enum CollisionEventsTable
+    {
+        EVENTS_TABLE_COLLISIONS,
+        EVENTS_TABLE_CONTACTS,
+        EVENTS_TABLE_TRIGGERS,
+        EVENTS_TABLE_COUNT,
+    };
+
+    struct CollisionEventsListener
+    {
+        dmScript::LuaCallbackInfo* m_Callback;
+        // The events table passed to the callback, reused between frames
+        int m_EventsRef;
+        // The pairs currently held by the id and group arrays of each sub table
+        dmArray<CollisionEventPair> m_Pairs[EVENTS_TABLE_COUNT];
+        uint8_t m_Dispatching : 1;
+        uint8_t m_Removed : 1;
+    };
+
+    static void DeleteCollisionEventsListener(CollisionEventsListener* listener)
+    {
+        lua_State* L = dmScript::GetCallbackLuaContext(listener->m_Callback);
+        dmScript::Unref(L, LUA_REGISTRYINDEX, listener->m_EventsRef);
+        dmScript::DestroyCallback(listener->m_Callback);
+        delete listener;
+    }
+
+    static void NewEventsSubTable(lua_State* L, const char* name, const char** arrays, uint32_t array_count)
+    {
+        lua_newtable(L);
+        lua_pushinteger(L, 0);
+        lua_setfield(L, -2, "count");
+        for (uint32_t i = 0; i < array_count; ++i)
+        {
+            lua_newtable(L);
+            lua_setfield(L, -2, arrays[i]);
+        }
+        lua_setfield(L, -2, name);
+    }
+
+    // The hashes already in the arrays are kept, since the same pairs usually collide for many frames.
+    // Other elements are copied from the previous element when it's the same hash, and only pushed otherwise.
+    static void SetEventPairs(lua_State* L, const char* name, const CollisionEventPair* pairs, uint32_t count, dmArray<CollisionEventPair>& current)
+    {
+        static const char* names[] = {"id_a", "id_b", "group_a", "group_b"};
+        static dmhash_t CollisionEventPair::* members[] = {&CollisionEventPair::m_IdA, &CollisionEventPair::m_IdB, &CollisionEventPair::m_GroupA, &CollisionEventPair::m_GroupB};
+
+        uint32_t current_count = current.Size();
+        lua_getfield(L, -1, name);
+        lua_pushinteger(L, count);
+        lua_setfield(L, -2, "count");
+        for (uint32_t m = 0; m < DM_ARRAY_SIZE(members); ++m)
+        {
+            dmhash_t CollisionEventPair::* member = members[m];
+            lua_getfield(L, -1, names[m]);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                dmhash_t hash = pairs[i].*member;
+                if (i < current_count && current[i].*member == hash)
+                {
+                    continue;
+                }
+                if (i > 0 && pairs[i - 1].*member == hash)
+                {
+                    lua_rawgeti(L, -1, i);
+                }
+                else
+                {
+                    dmScript::PushHash(L, hash);
+                }
+                lua_rawseti(L, -2, i + 1);
+            }
+            lua_pop(L, 1);
+        }
+
+        if (count > current_count)
+        {
+            current.OffsetCapacity(count - current_count);
+            current.SetSize(count);
+        }
+        memcpy(current.Begin(), pairs, count * sizeof(CollisionEventPair));
+        // Leave the sub table on the stack, for the caller to add more arrays
+    }
+
+    template <typename T>
+    static void SetVector3Elements(lua_State* L, const char* name, const T* values, uint32_t count)
+    {
+        lua_getfield(L, -1, name);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // The vectors from previous frames are updated in place
+            lua_rawgeti(L, -1, i + 1);
+            dmVMath::Vector3* v = dmScript::ToVector3(L, -1);
+            lua_pop(L, 1);
+            if (v)
+            {
+                *v = dmVMath::Vector3(values[i]);
+                continue;
+            }
+            dmScript::PushVector3(L, dmVMath::Vector3(values[i]));
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_pop(L, 1);
+    }
+
+    static void SetNumberElements(lua_State* L, const char* name, const float* values, uint32_t count)
+    {
+        lua_getfield(L, -1, name);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            lua_pushnumber(L, values[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_pop(L, 1);
+    }
+
+    static bool DispatchScriptCollisionEvents(const CollisionEvents* events, void* user_data)
+    {
+        CollisionEventsListener* listener = (CollisionEventsListener*)user_data;
+        if (events == 0x0)
+        {
+            // Released from within the script callback, wait until it has returned
+            if (listener->m_Dispatching)
+                listener->m_Removed = 1;
+            else
+                DeleteCollisionEventsListener(listener);
+            return false;
+        }
+
+        if (!dmScript::IsCallbackValid(listener->m_Callback))
+        {
+            return false;
+        }
+
+        lua_State* L = dmScript::GetCallbackLuaContext(listener->m_Callback);
+        DM_LUA_STACK_CHECK(L, 0);
+
+        if (!dmScript::SetupCallback(listener->m_Callback))
+        {
+            return false;
+        }
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, listener->m_EventsRef);
+
+        SetEventPairs(L, "collisions", events->m_Collisions, events->m_CollisionCount, listener->m_Pairs[EVENTS_TABLE_COLLISIONS]);
+        lua_pop(L, 1);
+
+        uint32_t contact_count = events->m_ContactCount;
+        SetEventPairs(L, "contacts", events->m_Contacts, contact_count, listener->m_Pairs[EVENTS_TABLE_CONTACTS]);
+        SetVector3Elements(L, "position", events->m_ContactPositions, contact_count);
+        SetVector3Elements(L, "normal", events->m_ContactNormals, contact_count);
+        SetNumberElements(L, "distance", events->m_ContactDistances, contact_count);
+        SetNumberElements(L, "applied_impulse", events->m_ContactImpulses, contact_count);
+        lua_pop(L, 1);
+
+        uint32_t trigger_count = events->m_TriggerCount;
+        SetEventPairs(L, "triggers", events->m_Triggers, trigger_count, listener->m_Pairs[EVENTS_TABLE_TRIGGERS]);
+        lua_getfield(L, -1, "enter");
+        for (uint32_t i = 0; i < trigger_count; ++i)
+        {
+            lua_pushboolean(L, events->m_TriggerEnter[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_pop(L, 2);
+
+        listener->m_Dispatching = 1;
+        dmScript::PCall(L, 2, 0);
+        dmScript::TeardownCallback(listener->m_Callback);
+        listener->m_Dispatching = 0;
+
+        if (listener->m_Removed)
+        {
+            DeleteCollisionEventsListener(listener);
+            return false;
+        }
+        return true;
+    }
+
+    /*# sets a listener for all collision events of the collection
+     *
+     * Sets a function that receives all collision, contact point and trigger events
+     * of the physics world of the calling script's collection, once per physics update.
+     *
+     * Each script can have one listener, and setting a new one replaces the previous
+     * listener of the script. Listeners set by other scripts in the collection are kept.
+     *
+     * The `collision_response`, `contact_point_response` and `trigger_response` messages
+     * are still sent as usual. The `physics.max_collisions` and `physics.max_contacts`
+     * limits only apply to the messages, the listeners get all events.
+     * Each colliding pair is reported once, as objects `a` and `b`.
+     *
+     * The events table and its sub tables are reused between calls. Only the first
+     * `count` entries of each array are valid, so copy any values that should be kept
+     * after the callback has returned, and don't modify the arrays.
+     *
+     * @name physics.set_event_listener
+     * @param callback [type:function(self, events)|nil] the listener, or `nil` to remove the listener of the script
+     * @param [options] [type:table] a table with the following keys:
+     *
+     * `messages`
+     * : [type:boolean] set to `false` to stop the `collision_response`, `contact_point_response`
+     *   and `trigger_response` messages of the whole collection while the listener is set. Default is `true`.
+     *
+     * `self`
+     * : [type:object] The script instance that set the listener.
+     *
+     * `events`
+     * : [type:table] The events of the physics update:
+     *
+     * - `collisions` [type:table] with the arrays `id_a`, `id_b`, `group_a`, `group_b` and the number of events in `count`
+     * - `contacts` [type:table] the same arrays as `collisions`, and `position` (on object a), `normal` (pointing from a towards b), `distance` and `applied_impulse`
+     * - `triggers` [type:table] the same arrays as `collisions`, and `enter` which is `true` on enter and `false` on exit
+     *
+     * @examples
+     *
+     * ```lua
+     * local function on_events(self, events)
+     *     local contacts = events.contacts
+     *     for i = 1, contacts.count do
+     *         if contacts.applied_impulse[i] > 100 then
+     *             msg.post(contacts.id_a[i], "break")
+     *         end
+     *     end
+     * end
+     *
+     * function init(self)
+     *     -- the listener handles all the events of the collection
+     *     physics.set_event_listener(on_events, { messages = false })
+     * end
+     * ```
+     */
+    static int Physics_SetEventListener(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            return DM_LUA_ERROR("could not find a requesting instance for physics.set_event_listener");
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+        if (world == 0x0)
+        {
+            return DM_LUA_ERROR("Physics world doesn't exist. Make sure you have at least one physics component in collection.");
+        }
+
+        // One listener per script
+        dmhash_t owner_ids[] = {sender.m_Path, sender.m_Fragment};
+        dmhash_t owner = dmHashBuffer64(owner_ids, sizeof(owner_ids));
+
+        if (lua_isnoneornil(L, 1))
+        {
+            dmGameSystem::SetCollisionEventsListener(world, owner, 0x0, 0x0, true);
+            return 0;
+        }
+
+        luaL_checktype(L, 1, LUA_TFUNCTION);
+
+        bool post_messages = true;
+        if (!lua_isnoneornil(L, 2))
+        {
+            luaL_checktype(L, 2, LUA_TTABLE);
+            lua_getfield(L, 2, "messages");
+            if (!lua_isnil(L, -1))
+            {
+                post_messages = lua_toboolean(L, -1);
+            }
+            lua_pop(L, 1);
+        }
+
+        lua_pushvalue(L, 1);
+        dmScript::LuaCallbackInfo* callback = dmScript::CreateCallback(dmScript::GetMainThread(L), -1);
+        lua_pop(L, 1);
+        if (callback == 0x0)
+        {
+            return DM_LUA_ERROR("physics.set_event_listener failed to create callback");
+        }
+
+        static const char* contact_arrays[] = {"id_a", "id_b", "group_a", "group_b", "position", "normal", "distance", "applied_impulse"};
+        static const char* trigger_arrays[] = {"id_a", "id_b", "group_a", "group_b", "enter"};
+
+        lua_newtable(L);
+        NewEventsSubTable(L, "collisions", contact_arrays, 4);
+        NewEventsSubTable(L, "contacts", contact_arrays, DM_ARRAY_SIZE(contact_arrays));
+        NewEventsSubTable(L, "triggers", trigger_arrays, DM_ARRAY_SIZE(trigger_arrays));
+
+        CollisionEventsListener* listener = new CollisionEventsListener;
+        listener->m_Callback = callback;
+        listener->m_EventsRef = dmScript::Ref(L, LUA_REGISTRYINDEX);
+        listener->m_Dispatching = 0;
+        listener->m_Removed = 0;
+
+        dmGameSystem::SetCollisionEventsListener(world, owner, DispatchScriptCollisionEvents, listener, post_messages);
+        return 0;
+    }
+
     static const luaL_reg PHYSICS_FUNCTIONS[] =
     {
         {"ray_cast",        Physics_RayCastAsync}, // Deprecated
         {"raycast_async",   Physics_RayCastAsync},
         {"raycast",         Physics_RayCast},
+        {"raycast_batch",   Physics_RayCastBatch},
+        {"set_event_listener", Physics_SetEventListener},
 
         {"create_joint",    Physics_CreateJoint},
         {"destroy_joint",   Physics_DestroyJoint},
@@ -12,7 +12,7 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
-
+#include <stdlib.h>
 #include <dlib/configfile.h>
 #include <dlib/log.h>
 #include <ddf/ddf.h>
@@ -26,6 +26,7 @@
 #include "../gamesys_private.h"
 #include "../resources/res_tilegrid.h"
 #include "../components/comp_tilegrid.h"
+#include "../components/comp_collision_object.h"
 #include "script_tilemap.h"
 
 extern "C"
@@ -399,6 +400,247 @@ namespace dmGameSystem
         return 1;
     }
 
+    static void DestroySetGridShapeHullsMessage(dmMessage::Message* message)
+    {
+        dmPhysicsDDF::SetGridShapeHulls* ddf = (dmPhysicsDDF::SetGridShapeHulls*) message->m_Data;
+        free((void*) (uintptr_t) ddf->m_Cells);
+    }
+
+    /*# set a rectangle of tiles in a tile map
+     * Replace the tiles of a rectangular area in a tile map with new tiles.
+     * This is the same as calling [ref:tilemap.set_tile()] for each tile in the area,
+     * but only the tiles that change are updated, which makes it suitable for streaming
+     * chunks of large tile maps in and out.
+     *
+     * The tiles are given as a flat list of tile indices, row by row, starting with
+     * the bottom row of the area. The number of rows is the number of tiles divided
+     * by the width, rounded up. A tile of 0 clears the cell. The tiles are set without
+     * any flip or rotation.
+     *
+     * The area must be within the bounds of the tile map as it were created.
+     *
+     * @name tilemap.set_tiles
+     * @param url [type:string|hash|url] the tile map
+     * @param layer [type:string|hash] name of the layer for the tiles
+     * @param x [type:number] x-coordinate of the bottom left tile of the area
+     * @param y [type:number] y-coordinate of the bottom left tile of the area
+     * @param width [type:number] number of columns in the area
+     * @param tiles [type:table] list of tile indices to set. 0 resets the cell
+     * @return result [type:boolean] true if the tiles were set
+     * @examples
+     *
+     * ```lua
+     * -- Load a 32x32 chunk of the level, starting at tile 33,1
+     * tilemap.set_tiles("/level#tilemap", "ground", 33, 1, 32, chunk_tiles)
+     * ```
+     */
+    static int TileMap_SetTiles(lua_State* L)
+    {
+        int top = lua_gettop(L);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        uintptr_t user_data;
+        dmMessage::URL receiver;
+        dmGameObject::GetComponentUserDataFromLua(L, 1, collection, TILE_MAP_EXT, &user_data, &receiver, 0);
+        TileGridComponent* component = (TileGridComponent*) user_data;
+
+        dmhash_t layer_id = dmScript::CheckHashOrString(L, 2);
+
+        uint32_t layer_index = GetLayerIndex(component, layer_id);
+        if (layer_index == ~0u)
+        {
+            dmLogError("Could not find layer '%s'.", dmHashReverseSafe64(layer_id));
+            lua_pushboolean(L, 0);
+            assert(top + 1 == lua_gettop(L));
+            return 1;
+        }
+
+        int x = luaL_checkinteger(L, 3) - 1;
+        int y = luaL_checkinteger(L, 4) - 1;
+        int width = luaL_checkinteger(L, 5);
+        luaL_checktype(L, 6, LUA_TTABLE);
+
+        if (width <= 0)
+        {
+            return luaL_error(L, "tilemap.set_tiles called with invalid width (%d)", width);
+        }
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender))
+        {
+            return luaL_error(L, "tilemap.set_tiles is not available from this script-type.");
+        }
+
+        int tile_count = (int)lua_objlen(L, 6);
+        int height = (tile_count + width - 1) / width;
+
+        int min_x, min_y, grid_w, grid_h;
+        GetTileGridBounds(component, &min_x, &min_y, &grid_w, &grid_h);
+
+        int32_t cell_x, cell_y;
+        GetTileGridCellCoord(component, x, y, cell_x, cell_y);
+
+        if (cell_x < 0 || cell_x + width > grid_w || cell_y < 0 || cell_y + height > grid_h)
+        {
+            dmLogError("Could not set the tiles since the supplied area was out of range.");
+            lua_pushboolean(L, 0);
+            assert(top + 1 == lua_gettop(L));
+            return 1;
+        }
+
+        // Check all tiles before changing any of them
+        int max_tile = (int)GetTileCount(component);
+        for (int i = 0; i < tile_count; ++i)
+        {
+            lua_rawgeti(L, 6, i + 1);
+            int lua_tile = luaL_checkinteger(L, -1);
+            lua_pop(L, 1);
+
+            // See tilemap.set_tile for why the valid range is [0...N] and the tile index is subtracted by 1
+            if (lua_tile < 0 || lua_tile > max_tile)
+            {
+                return luaL_error(L, "tilemap.set_tiles called with out-of-range tile index (%d)", lua_tile);
+            }
+        }
+
+        // The hulls of the changed cells are sent to any collision object components in one message,
+        // which owns the cells and frees them once it has been dispatched
+        GridShapeHullCell* cells = 0x0;
+        uint32_t cell_count = 0;
+        for (int i = 0; i < tile_count; ++i)
+        {
+            lua_rawgeti(L, 6, i + 1);
+            uint32_t tile = (uint32_t) lua_tointeger(L, -1) - 1;
+            lua_pop(L, 1);
+
+            int32_t tile_x = cell_x + i % width;
+            int32_t tile_y = cell_y + i / width;
+            if (!SetTileGridTile(component, layer_index, tile_x, tile_y, tile, 0))
+            {
+                continue;
+            }
+
+            if (cells == 0x0)
+            {
+                cells = (GridShapeHullCell*) malloc(sizeof(GridShapeHullCell) * tile_count);
+            }
+            GridShapeHullCell& cell = cells[cell_count++];
+            cell.m_Row = tile_y;
+            cell.m_Column = tile_x;
+            cell.m_Hull = tile;
+        }
+
+        if (cell_count > 0)
+        {
+            // Broadcast to any collision object components
+            // TODO Filter broadcast to only collision objects
+            dmPhysicsDDF::SetGridShapeHulls set_hulls_ddf;
+            set_hulls_ddf.m_Shape = layer_index;
+            set_hulls_ddf.m_Count = cell_count;
+            set_hulls_ddf.m_Cells = (uint64_t) (uintptr_t) cells;
+            dmhash_t message_id = dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_NameHash;
+            uintptr_t descriptor = (uintptr_t)dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor;
+            uint32_t data_size = sizeof(dmPhysicsDDF::SetGridShapeHulls);
+            receiver.m_Fragment = 0;
+            dmMessage::Result result = dmMessage::Post(&sender, &receiver, message_id, 0, descriptor, &set_hulls_ddf, data_size, DestroySetGridShapeHullsMessage);
+            if (result != dmMessage::RESULT_OK)
+            {
+                free(cells);
+                dmLogError("Could not send %s to components, result: %d.", dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_Name, result);
+            }
+        }
+
+        lua_pushboolean(L, 1);
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
+    /*# get a rectangle of tiles from a tile map
+     * Get the tiles of a rectangular area in a tile map, as a flat list of tile
+     * indices, row by row, starting with the bottom row of the area.
+     * (see [ref:tilemap.set_tiles()])
+     *
+     * @name tilemap.get_tiles
+     * @param url [type:string|hash|url] the tile map
+     * @param layer [type:string|hash] name of the layer for the tiles
+     * @param x [type:number] x-coordinate of the bottom left tile of the area
+     * @param y [type:number] y-coordinate of the bottom left tile of the area
+     * @param width [type:number] number of columns in the area
+     * @param height [type:number] number of rows in the area
+     * @param [result] [type:table] optional table to write the tiles to, to avoid creating a new table each call
+     * @return tiles [type:table] list of the tile indices in the area
+     * @examples
+     *
+     * ```lua
+     * -- Save a 32x32 chunk of the level before unloading it
+     * self.chunk = tilemap.get_tiles("/level#tilemap", "ground", 33, 1, 32, 32, self.chunk)
+     * ```
+     */
+    static int TileMap_GetTiles(lua_State* L)
+    {
+        int top = lua_gettop(L);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        uintptr_t user_data;
+        dmGameObject::GetComponentUserDataFromLua(L, 1, collection, TILE_MAP_EXT, &user_data, 0, 0);
+        TileGridComponent* component = (TileGridComponent*) user_data;
+
+        dmhash_t layer_id = dmScript::CheckHashOrString(L, 2);
+        uint32_t layer_index = GetLayerIndex(component, layer_id);
+        if (layer_index == ~0u)
+        {
+            dmLogError("Could not find layer '%s'.", dmHashReverseSafe64(layer_id));
+            lua_pushnil(L);
+            assert(top + 1 == lua_gettop(L));
+            return 1;
+        }
+
+        int x = luaL_checkinteger(L, 3) - 1;
+        int y = luaL_checkinteger(L, 4) - 1;
+        int width = luaL_checkinteger(L, 5);
+        int height = luaL_checkinteger(L, 6);
+
+        int min_x, min_y, grid_w, grid_h;
+        GetTileGridBounds(component, &min_x, &min_y, &grid_w, &grid_h);
+
+        int32_t cell_x, cell_y;
+        GetTileGridCellCoord(component, x, y, cell_x, cell_y);
+
+        if (width <= 0 || height <= 0 || cell_x < 0 || cell_x + width > grid_w || cell_y < 0 || cell_y + height > grid_h)
+        {
+            dmLogError("Could not get the tiles since the supplied area was out of range.");
+            lua_pushnil(L);
+            assert(top + 1 == lua_gettop(L));
+            return 1;
+        }
+
+        if (lua_istable(L, 7))
+        {
+            lua_pushvalue(L, 7);
+        }
+        else
+        {
+            lua_createtable(L, width * height, 0);
+        }
+
+        int i = 1;
+        for (int32_t tile_y = cell_y; tile_y < cell_y + height; ++tile_y)
+        {
+            for (int32_t tile_x = cell_x; tile_x < cell_x + width; ++tile_x, ++i)
+            {
+                lua_pushinteger(L, GetTileGridTile(component, layer_index, tile_x, tile_y));
+                lua_rawseti(L, -2, i);
+            }
+        }
+
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
     /*# get the bounds of a tile map
      * Get the bounds for a tile map. This function returns multiple values:
      * The lower left corner index x and y coordinates (1-indexed),
@@ -511,6 +753,8 @@ namespace dmGameSystem
         {"reset_constant",  TileMap_ResetConstant},
         {"set_tile",        TileMap_SetTile},
         {"get_tile",        TileMap_GetTile},
+        {"set_tiles",       TileMap_SetTiles},
+        {"get_tiles",       TileMap_GetTiles},
         {"get_bounds",      TileMap_GetBounds},
         {"set_visible",     TileMap_SetVisible},
         {0, 0}
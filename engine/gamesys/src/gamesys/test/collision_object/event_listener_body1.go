@@ -0,0 +1,12 @@
+components {
+  id: "co"
+  component: "/collision_object/groupmask.collisionobject"
+}
+components {
+  id: "script"
+  component: "/collision_object/event_listener.script"
+}
+components {
+  id: "script2"
+  component: "/collision_object/event_listener2.script"
+}
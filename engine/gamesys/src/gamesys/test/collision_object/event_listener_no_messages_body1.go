@@ -0,0 +1,8 @@
+components {
+  id: "co"
+  component: "/collision_object/groupmask.collisionobject"
+}
+components {
+  id: "script"
+  component: "/collision_object/event_listener_no_messages.script"
+}
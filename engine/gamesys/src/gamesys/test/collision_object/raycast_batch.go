@@ -0,0 +1,8 @@
+components {
+  id: "script"
+  component: "/collision_object/raycast_batch.script"
+}
+components {
+  id: "collisionobject"
+  component: "/collision_object/raycast_batch.collisionobject"
+}
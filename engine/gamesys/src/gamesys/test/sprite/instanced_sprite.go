@@ -0,0 +1,8 @@
+components {
+  id: "sprite1"
+  component: "/sprite/instanced.sprite"
+}
+components {
+  id: "sprite2"
+  component: "/sprite/instanced.sprite"
+}
@@ -31,6 +31,7 @@
 #include <gamesys/gamesys_ddf.h>
 #include <gamesys/sprite_ddf.h>
 #include "../components/comp_label.h"
+#include "../components/comp_tilegrid.h"
 
 #include <dmsdk/gamesys/render_constants.h>
 
@@ -823,6 +824,114 @@ TEST_F(GuiTest, GuiFlipbookAnim)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+static dmGameSystem::GuiWorld* RenderGui(dmRender::HRenderContext render_context, dmGameObject::HCollection collection, dmGameObject::UpdateContext* update_context)
+{
+    if (!dmGameObject::Update(collection, update_context))
+        return 0;
+
+    dmRender::RenderListBegin(render_context);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    dmRender::DrawRenderList(render_context, 0x0, 0x0, 0x0);
+
+    uint32_t component_type_index = dmGameObject::GetComponentTypeIndex(collection, dmHashString64("guic"));
+    return (dmGameSystem::GuiWorld*)dmGameObject::GetWorld(collection, component_type_index);
+}
+
+// Verify that the vertices of the box nodes are only generated again when the nodes change
+TEST_F(GuiTest, GuiVertexCache)
+{
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/gui/vertex_cache_test.goc", dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0x0, go);
+
+    dmGameSystem::GuiWorld* world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_NE((void*)0x0, world);
+    dmGui::HScene scene = world->m_Components[0]->m_Scene;
+    dmGui::HNode box1 = dmGui::GetNodeById(scene, "box1");
+    dmGui::HNode box2 = dmGui::GetNodeById(scene, "box2");
+    ASSERT_NE(dmGui::INVALID_HANDLE, box1);
+    ASSERT_NE(dmGui::INVALID_HANDLE, box2);
+
+    ASSERT_EQ(12U, world->m_Stats.m_VertexCount);
+    ASSERT_EQ(12U, world->m_Stats.m_GeneratedVertexCount);
+    ASSERT_EQ(0U, world->m_Stats.m_ReusedVertexCount);
+    ASSERT_EQ(12U, world->m_Stats.m_UploadedVertexCount);
+
+    // Nothing changed, all vertices are copied from the previous frame. Each vertex buffer in the ring
+    // gets all of them the first time it is used
+    for (uint32_t i = 1; i < dmGameSystem::GUI_VERTEX_BUFFER_COUNT; ++i)
+    {
+        world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+        ASSERT_EQ(12U, world->m_Stats.m_VertexCount);
+        ASSERT_EQ(0U, world->m_Stats.m_GeneratedVertexCount);
+        ASSERT_EQ(12U, world->m_Stats.m_ReusedVertexCount);
+        ASSERT_EQ(12U, world->m_Stats.m_UploadedVertexCount);
+        ASSERT_EQ(world->m_PrevClientVertexBuffer.Size(), world->m_ClientVertexBuffer.Size());
+        ASSERT_EQ(0, memcmp(world->m_PrevClientVertexBuffer.Begin(), world->m_ClientVertexBuffer.Begin(), 12 * sizeof(dmGameSystem::BoxVertex)));
+    }
+
+    // After that, a buffer that already holds the vertices isn't written
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(12U, world->m_Stats.m_ReusedVertexCount);
+    ASSERT_EQ(0U, world->m_Stats.m_UploadedVertexCount);
+
+    // Color
+    dmGui::SetNodeProperty(scene, box1, dmGui::PROPERTY_COLOR, Vector4(1.0f, 0.0f, 0.0f, 1.0f));
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(12U, world->m_Stats.m_VertexCount);
+    ASSERT_EQ(6U, world->m_Stats.m_GeneratedVertexCount);
+    ASSERT_EQ(6U, world->m_Stats.m_ReusedVertexCount);
+    ASSERT_EQ(6U, world->m_Stats.m_UploadedVertexCount);
+    ASSERT_EQ(0.0f, world->m_ClientVertexBuffer[0].m_Color[1]);
+
+    // The changed vertices are uploaded to the other buffers of the ring as they come up
+    for (uint32_t i = 1; i < dmGameSystem::GUI_VERTEX_BUFFER_COUNT; ++i)
+    {
+        world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+        ASSERT_EQ(12U, world->m_Stats.m_ReusedVertexCount);
+        ASSERT_EQ(6U, world->m_Stats.m_UploadedVertexCount);
+    }
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(0U, world->m_Stats.m_UploadedVertexCount);
+
+    // Transform
+    dmGui::SetNodeProperty(scene, box2, dmGui::PROPERTY_POSITION, Vector4(32.0f, 0.0f, 0.0f, 1.0f));
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(12U, world->m_Stats.m_VertexCount);
+    ASSERT_EQ(6U, world->m_Stats.m_GeneratedVertexCount);
+    ASSERT_EQ(6U, world->m_Stats.m_ReusedVertexCount);
+
+    // Texture
+    ASSERT_EQ(dmGui::RESULT_OK, dmGui::SetNodeTexture(scene, box1, "render_box2"));
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(12U, world->m_Stats.m_VertexCount);
+    ASSERT_EQ(6U, world->m_Stats.m_GeneratedVertexCount);
+    ASSERT_EQ(6U, world->m_Stats.m_ReusedVertexCount);
+
+    // Render order, the cache is indexed by the render order of the nodes
+    dmGui::MoveNodeAbove(scene, box1, box2);
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(12U, world->m_Stats.m_VertexCount);
+    ASSERT_EQ(12U, world->m_Stats.m_GeneratedVertexCount);
+    ASSERT_EQ(0U, world->m_Stats.m_ReusedVertexCount);
+
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(0U, world->m_Stats.m_GeneratedVertexCount);
+    ASSERT_EQ(12U, world->m_Stats.m_ReusedVertexCount);
+
+    // Reloading any resource might change the texture set data the vertices were generated from
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::ReloadResource(m_Factory, "/gui/render_box_test3.t.texturesetc", 0));
+    world = RenderGui(m_RenderContext, m_Collection, &m_UpdateContext);
+    ASSERT_EQ(12U, world->m_Stats.m_VertexCount);
+    ASSERT_EQ(12U, world->m_Stats.m_GeneratedVertexCount);
+    ASSERT_EQ(0U, world->m_Stats.m_ReusedVertexCount);
+
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    dmGraphics::Flip(m_GraphicsContext);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
 TEST_P(CursorTest, Cursor)
 {
     const CursorTestParams& params = GetParam();
@@ -1312,6 +1421,7 @@ TEST_P(DrawCountTest, DrawCount)
     const DrawCountParams& p = GetParam();
     const char* go_path = p.m_GOPath;
     const uint64_t expected_draw_count = p.m_ExpectedDrawCount;
+    const uint64_t expected_instance_count = p.m_ExpectedInstanceCount;
 
     ASSERT_TRUE(dmGameObject::Init(m_Collection));
 
@@ -1331,6 +1441,7 @@ TEST_P(DrawCountTest, DrawCount)
     ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
 
     ASSERT_EQ(expected_draw_count, dmGraphics::GetDrawCount());
+    ASSERT_EQ(expected_instance_count, dmGraphics::GetInstanceCount());
     dmGraphics::Flip(m_GraphicsContext);
 
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
@@ -1535,6 +1646,40 @@ TEST_F(CollisionObject2DTest, PropertiesTest)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+// Test case for physics.raycast_batch
+TEST_F(CollisionObject2DTest, RayCastBatchTest)
+{
+    dmHashEnableReverseHash(true);
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    // a static box spanning [-10, 10] on both axes, with the script casting the rays against it
+    const char* path_go = "/collision_object/raycast_batch.goc";
+    dmhash_t hash_go = dmHashString64("/go");
+    dmGameObject::HInstance raycast_go = Spawn(m_Factory, m_Collection, path_go, hash_go, 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, raycast_go);
+
+    // iterate until the lua env signals the end of the test of error occurs
+    bool tests_done = false;
+    while (!tests_done)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+        // check if tests are done
+        lua_getglobal(L, "tests_done");
+        tests_done = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
 TEST_P(GroupAndMask2DTest, GroupAndMaskTest )
 {
     const GroupAndMaskParams& params = GetParam();
@@ -1663,6 +1808,217 @@ GroupAndMaskParams groupandmask_params[] = {
 INSTANTIATE_TEST_CASE_P(GroupAndMaskTest, GroupAndMask2DTest, jc_test_values_in(groupandmask_params));
 INSTANTIATE_TEST_CASE_P(GroupAndMaskTest, GroupAndMask3DTest, jc_test_values_in(groupandmask_params));
 
+TEST_F(ComponentTest, CollisionEventListenerTest)
+{
+    dmHashEnableReverseHash(true);
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    // body2 is spawned first, since the script in body1 throws body1 at it in init()
+    const char* path_body2_go = "/collision_object/groupmask_body2.goc";
+    dmhash_t hash_body2_go = dmHashString64("/body2-go");
+    dmGameObject::HInstance body2_go = Spawn(m_Factory, m_Collection, path_body2_go, hash_body2_go, 0, 0, Point3(30,5, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, body2_go);
+
+    const char* path_body1_go = "/collision_object/event_listener_body1.goc";
+    dmhash_t hash_body1_go = dmHashString64("/body1-go");
+    dmGameObject::HInstance body1_go = Spawn(m_Factory, m_Collection, path_body1_go, hash_body1_go, 0, 0, Point3(5,5, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, body1_go);
+
+    // iterate until the lua env signals the end of the test of error occurs
+    bool tests_done = false;
+    while (!tests_done)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+        // check if tests are done
+        lua_getglobal(L, "tests_done");
+        tests_done = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+
+TEST_F(ComponentTest, CollisionEventListenerNoMessagesTest)
+{
+    dmHashEnableReverseHash(true);
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    // body2 is spawned first, since the script in body1 throws body1 at it in init()
+    const char* path_body2_go = "/collision_object/groupmask_body2.goc";
+    dmhash_t hash_body2_go = dmHashString64("/body2-go");
+    dmGameObject::HInstance body2_go = Spawn(m_Factory, m_Collection, path_body2_go, hash_body2_go, 0, 0, Point3(30,5, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, body2_go);
+
+    const char* path_body1_go = "/collision_object/event_listener_no_messages_body1.goc";
+    dmhash_t hash_body1_go = dmHashString64("/body1-go");
+    dmGameObject::HInstance body1_go = Spawn(m_Factory, m_Collection, path_body1_go, hash_body1_go, 0, 0, Point3(5,5, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, body1_go);
+
+    // iterate until the lua env signals the end of the test of error occurs
+    bool tests_done = false;
+    while (!tests_done)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+        // check if tests are done
+        lua_getglobal(L, "tests_done");
+        tests_done = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+
+TEST_F(ComponentTest, TileMapSetGetTilesTest)
+{
+    dmHashEnableReverseHash(true);
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    const char* path_tilemap_go = "/tile/set_get_tiles.goc";
+    dmhash_t hash_tilemap_go = dmHashString64("/tilemap-go");
+    dmGameObject::HInstance tilemap_go = Spawn(m_Factory, m_Collection, path_tilemap_go, hash_tilemap_go, 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, tilemap_go);
+
+    // iterate until the lua env signals the end of the test of error occurs
+    bool tests_done = false;
+    while (!tests_done)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+        // check if tests are done
+        lua_getglobal(L, "tests_done");
+        tests_done = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+static void RenderTileGrids(dmRender::HRenderContext render_context, dmGameObject::HCollection collection, const dmVMath::Matrix4* frustum_matrix, dmGameSystem::TileGridRenderStats* stats)
+{
+    dmRender::RenderListBegin(render_context);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    dmRender::DrawRenderList(render_context, 0x0, 0x0, frustum_matrix);
+
+    uint32_t component_type_index = dmGameObject::GetComponentTypeIndex(collection, dmHashString64("tilemapc"));
+    dmGameSystem::GetTileGridRenderStats(dmGameObject::GetWorld(collection, component_type_index), stats);
+}
+
+// Verify that the cached vertices of the tile map regions are only rebuilt when needed
+TEST_F(ComponentTest, TileMapRegionCacheTest)
+{
+    dmHashEnableReverseHash(true);
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    void* tile_source = 0;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/tile/valid2.t.texturesetc", &tile_source));
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/tile/regions.goc", dmHashString64("/tilemap-go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    // the script sets tiles across the region boundaries
+    bool tests_done = false;
+    while (!tests_done)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+        lua_getglobal(L, "tests_done");
+        tests_done = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+
+    // 6 tiles in regions (0,0), (1,0) and (1,1)
+    dmGameSystem::TileGridRenderStats stats;
+    RenderTileGrids(m_RenderContext, m_Collection, 0x0, &stats);
+    ASSERT_EQ(6U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(3U, stats.m_RebuiltRegionCount);
+    ASSERT_EQ(6U * 6U, stats.m_CopiedVertexCount);
+    ASSERT_EQ(3U, stats.m_CachedRegionCount);
+
+    // Nothing changed
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    RenderTileGrids(m_RenderContext, m_Collection, 0x0, &stats);
+    ASSERT_EQ(6U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(0U, stats.m_RebuiltRegionCount);
+    ASSERT_EQ(0U, stats.m_CopiedVertexCount);
+
+    // Only region (0,0) is within the frustum, and the culled regions keep their cached vertices
+    dmVMath::Matrix4 frustum_matrix = dmVMath::Matrix4::orthographic(-10.0f, 100.0f, -10.0f, 100.0f, -10.0f, 10.0f);
+    RenderTileGrids(m_RenderContext, m_Collection, &frustum_matrix, &stats);
+    ASSERT_EQ(3U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(0U, stats.m_RebuiltRegionCount);
+
+    RenderTileGrids(m_RenderContext, m_Collection, 0x0, &stats);
+    ASSERT_EQ(6U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(0U, stats.m_RebuiltRegionCount);
+    ASSERT_LT(0U, stats.m_CopiedVertexCount);
+
+    // Transform
+    dmGameObject::SetPosition(go, Point3(10, 0, 0));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    RenderTileGrids(m_RenderContext, m_Collection, 0x0, &stats);
+    ASSERT_EQ(6U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(3U, stats.m_RebuiltRegionCount);
+    ASSERT_EQ(6U * 6U, stats.m_CopiedVertexCount);
+
+    // Tile source
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, SetResourceProperty(go, dmHashString64("tilegrid"), dmHashString64("tile_source"), dmHashString64("/tile/valid2.t.texturesetc")));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    RenderTileGrids(m_RenderContext, m_Collection, 0x0, &stats);
+    ASSERT_EQ(6U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(3U, stats.m_RebuiltRegionCount);
+    ASSERT_EQ(6U * 6U, stats.m_CopiedVertexCount);
+
+    // The culled regions release their cached vertices after 120 frames (TILEGRID_VERTEX_CACHE_FRAMES)
+    for (uint32_t i = 0; i < 120; ++i)
+    {
+        RenderTileGrids(m_RenderContext, m_Collection, &frustum_matrix, &stats);
+        ASSERT_EQ(3U, stats.m_CachedRegionCount);
+    }
+    RenderTileGrids(m_RenderContext, m_Collection, &frustum_matrix, &stats);
+    ASSERT_EQ(3U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(1U, stats.m_CachedRegionCount);
+
+    RenderTileGrids(m_RenderContext, m_Collection, 0x0, &stats);
+    ASSERT_EQ(6U * 6U, stats.m_VertexCount);
+    ASSERT_EQ(2U, stats.m_RebuiltRegionCount);
+    ASSERT_EQ(3U, stats.m_CachedRegionCount);
+
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    dmGraphics::Flip(m_GraphicsContext);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+    dmResource::Release(m_Factory, tile_source);
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+}
 
 
 
@@ -2113,7 +2469,7 @@ INSTANTIATE_TEST_CASE_P(CollectionFactory, ComponentFailTest, jc_test_values_in(
 
 /* Sprite */
 
-const char* valid_sprite_resources[] = {"/sprite/valid.spritec"};
+const char* valid_sprite_resources[] = {"/sprite/valid.spritec", "/sprite/instanced.spritec"};
 INSTANTIATE_TEST_CASE_P(Sprite, ResourceTest, jc_test_values_in(valid_sprite_resources));
 
 ResourceFailParams invalid_sprite_resources[] =
@@ -2122,7 +2478,7 @@ ResourceFailParams invalid_sprite_resources[] =
 };
 INSTANTIATE_TEST_CASE_P(Sprite, ResourceFailTest, jc_test_values_in(invalid_sprite_resources));
 
-const char* valid_sprite_gos[] = {"/sprite/valid_sprite.goc"};
+const char* valid_sprite_gos[] = {"/sprite/valid_sprite.goc", "/sprite/instanced_sprite.goc"};
 INSTANTIATE_TEST_CASE_P(Sprite, ComponentTest, jc_test_values_in(valid_sprite_gos));
 
 const char* invalid_sprite_gos[] = {"/sprite/invalid_sprite.goc"};
@@ -2238,7 +2594,6 @@ INSTANTIATE_TEST_CASE_P(Label, ComponentFailTest, jc_test_values_in(invalid_labe
 
 const char* invalid_vertexspace_resources[] =
 {
-    "/sprite/invalid_vertexspace.spritec",
     "/model/invalid_vertexspace.modelc",
     "/tile/invalid_vertexspace.tilegridc",
     "/particlefx/invalid_vertexspace.particlefxc",
@@ -2288,8 +2643,9 @@ INSTANTIATE_TEST_CASE_P(CollectionFactory, CollectionFactoryTest, jc_test_values
 
 DrawCountParams draw_count_params[] =
 {
-    {"/gui/draw_count_test.goc", 1},
-    {"/gui/draw_count_test2.goc", 1},
+    {"/gui/draw_count_test.goc", 1, 0},
+    {"/gui/draw_count_test2.goc", 1, 0},
+    {"/sprite/instanced_sprite.goc", 1, 2},
 };
 INSTANTIATE_TEST_CASE_P(DrawCount, DrawCountTest, jc_test_values_in(draw_count_params));
 
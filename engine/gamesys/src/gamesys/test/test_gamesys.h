@@ -258,6 +258,7 @@ struct DrawCountParams
 {
     const char* m_GOPath;
     uint64_t m_ExpectedDrawCount;
+    uint64_t m_ExpectedInstanceCount;
 };
 
 class DrawCountTest : public GamesysTest<DrawCountParams>
@@ -0,0 +1,8 @@
+components {
+  id: "tilegrid"
+  component: "/tile/regions.tilegrid"
+}
+components {
+  id: "script"
+  component: "/tile/regions.script"
+}
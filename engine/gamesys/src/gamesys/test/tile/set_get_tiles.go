@@ -0,0 +1,8 @@
+components {
+  id: "tilegrid"
+  component: "/tile/valid.tilegrid"
+}
+components {
+  id: "script"
+  component: "/tile/set_get_tiles.script"
+}
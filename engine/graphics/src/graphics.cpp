@@ -572,6 +572,22 @@ namespace dmGraphics
     {
         g_functions.m_Draw(context, prim_type, first, count);
     }
+    bool IsInstancingSupported(HContext context)
+    {
+        return g_functions.m_IsInstancingSupported(context);
+    }
+    void EnableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, uint32_t first_instance, HProgram program)
+    {
+        g_functions.m_EnableInstanceVertexDeclaration(context, vertex_declaration, vertex_buffer, first_instance, program);
+    }
+    void DisableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
+    {
+        g_functions.m_DisableInstanceVertexDeclaration(context, vertex_declaration);
+    }
+    void DrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
+    {
+        g_functions.m_DrawElementsInstanced(context, prim_type, first, count, instance_count, type, index_buffer);
+    }
     HVertexProgram NewVertexProgram(HContext context, ShaderDesc::Shader* ddf)
     {
         return g_functions.m_NewVertexProgram(context, ddf);
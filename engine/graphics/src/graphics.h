@@ -509,6 +509,30 @@ namespace dmGraphics
     void DrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer);
     void Draw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count);
 
+    /**
+     * Check if the context can draw instanced geometry, i.e. source vertex attributes once per instance
+     * @param context Graphics context
+     * @return true if EnableInstanceVertexDeclaration and DrawElementsInstanced can be used
+     */
+    bool IsInstancingSupported(HContext context);
+
+    /**
+     * Bind a vertex buffer whose attributes advance once per instance instead of once per vertex.
+     * Used together with a regular vertex declaration enabled with EnableVertexDeclaration.
+     * @param context Graphics context
+     * @param vertex_declaration Declaration of the per-instance record
+     * @param vertex_buffer Buffer holding the per-instance records
+     * @param first_instance Index of the first record to source
+     * @param program Program the attributes are bound for
+     */
+    void EnableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, uint32_t first_instance, HProgram program);
+    void DisableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration);
+
+    /**
+     * Draw indexed geometry instance_count times, sourcing the instance vertex declaration once per instance
+     */
+    void DrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer);
+
     HVertexProgram NewVertexProgram(HContext context, ShaderDesc::Shader* ddf);
     HFragmentProgram NewFragmentProgram(HContext context, ShaderDesc::Shader* ddf);
     HProgram NewProgram(HContext context, HVertexProgram vertex_program, HFragmentProgram fragment_program);
@@ -100,6 +100,10 @@ namespace dmGraphics
     typedef void (*HashVertexDeclarationFn)(HashState32* state, HVertexDeclaration vertex_declaration);
     typedef void (*DrawElementsFn)(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer);
     typedef void (*DrawFn)(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count);
+    typedef bool (*IsInstancingSupportedFn)(HContext context);
+    typedef void (*EnableInstanceVertexDeclarationFn)(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, uint32_t first_instance, HProgram program);
+    typedef void (*DisableInstanceVertexDeclarationFn)(HContext context, HVertexDeclaration vertex_declaration);
+    typedef void (*DrawElementsInstancedFn)(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer);
     typedef HVertexProgram (*NewVertexProgramFn)(HContext context, ShaderDesc::Shader* ddf);
     typedef HFragmentProgram (*NewFragmentProgramFn)(HContext context, ShaderDesc::Shader* ddf);
     typedef HProgram (*NewProgramFn)(HContext context, HVertexProgram vertex_program, HFragmentProgram fragment_program);
@@ -210,6 +214,10 @@ namespace dmGraphics
         HashVertexDeclarationFn m_HashVertexDeclaration;
         DrawElementsFn m_DrawElements;
         DrawFn m_Draw;
+        IsInstancingSupportedFn m_IsInstancingSupported;
+        EnableInstanceVertexDeclarationFn m_EnableInstanceVertexDeclaration;
+        DisableInstanceVertexDeclarationFn m_DisableInstanceVertexDeclaration;
+        DrawElementsInstancedFn m_DrawElementsInstanced;
         NewVertexProgramFn m_NewVertexProgram;
         NewFragmentProgramFn m_NewFragmentProgram;
         NewProgramFn m_NewProgram;
@@ -21,6 +21,8 @@
 namespace dmGraphics
 {
     uint64_t GetDrawCount();
+    // Number of instances drawn with DrawElementsInstanced since the last flip
+    uint64_t GetInstanceCount();
     void SetForceFragmentReloadFail(bool should_fail);
     void SetForceVertexReloadFail(bool should_fail);
 
@@ -28,6 +28,7 @@
 #include "glsl_uniform_parser.h"
 
 uint64_t g_DrawCount = 0;
+uint64_t g_InstanceCount = 0;
 uint64_t g_Flipped = 0;
 
 // Used only for tests
@@ -488,11 +489,9 @@ namespace dmGraphics
         delete vertex_declaration;
     }
 
-    static void EnableVertexStream(HContext context, uint16_t stream, uint16_t size, Type type, uint16_t stride, const void* vertex_buffer)
+    static void EnableVertexStream(VertexStream& s, uint16_t size, Type type, uint16_t stride, const void* vertex_buffer)
     {
-        assert(context);
         assert(vertex_buffer);
-        VertexStream& s = context->m_VertexStreams[stream];
         assert(s.m_Source == 0x0);
         assert(s.m_Buffer == 0x0);
         s.m_Source = vertex_buffer;
@@ -500,10 +499,8 @@ namespace dmGraphics
         s.m_Stride = stride;
     }
 
-    static void DisableVertexStream(HContext context, uint16_t stream)
+    static void DisableVertexStream(VertexStream& s)
     {
-        assert(context);
-        VertexStream& s = context->m_VertexStreams[stream];
         s.m_Size = 0;
         if (s.m_Buffer != 0x0)
         {
@@ -513,27 +510,40 @@ namespace dmGraphics
         s.m_Source = 0x0;
     }
 
-    static void NullEnableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer)
+    static void EnableVertexStreams(VertexStream* streams, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, uint32_t first)
     {
-        assert(context);
         assert(vertex_declaration);
         assert(vertex_buffer);
         VertexBuffer* vb = (VertexBuffer*)vertex_buffer;
         uint16_t stride = 0;
         for (uint32_t i = 0; i < vertex_declaration->m_Count; ++i)
             stride += vertex_declaration->m_Elements[i].m_Size * TYPE_SIZE[vertex_declaration->m_Elements[i].m_Type - dmGraphics::TYPE_BYTE];
-        uint32_t offset = 0;
+        uint32_t offset = first * stride;
         for (uint16_t i = 0; i < vertex_declaration->m_Count; ++i)
         {
             VertexElement& ve = vertex_declaration->m_Elements[i];
             if (ve.m_Size > 0)
             {
-                EnableVertexStream(context, i, ve.m_Size, ve.m_Type, stride, &vb->m_Buffer[offset]);
+                EnableVertexStream(streams[i], ve.m_Size, ve.m_Type, stride, &vb->m_Buffer[offset]);
                 offset += ve.m_Size * TYPE_SIZE[ve.m_Type - dmGraphics::TYPE_BYTE];
             }
         }
     }
 
+    static void DisableVertexStreams(VertexStream* streams, HVertexDeclaration vertex_declaration)
+    {
+        assert(vertex_declaration);
+        for (uint32_t i = 0; i < vertex_declaration->m_Count; ++i)
+            if (vertex_declaration->m_Elements[i].m_Size > 0)
+                DisableVertexStream(streams[i]);
+    }
+
+    static void NullEnableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer)
+    {
+        assert(context);
+        EnableVertexStreams(context->m_VertexStreams, vertex_declaration, vertex_buffer, 0);
+    }
+
     static void NullEnableVertexDeclarationProgram(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, HProgram program)
     {
         NullEnableVertexDeclaration(context, vertex_declaration, vertex_buffer);
@@ -542,10 +552,24 @@ namespace dmGraphics
     static void NullDisableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
     {
         assert(context);
-        assert(vertex_declaration);
-        for (uint32_t i = 0; i < vertex_declaration->m_Count; ++i)
-            if (vertex_declaration->m_Elements[i].m_Size > 0)
-                DisableVertexStream(context, i);
+        DisableVertexStreams(context->m_VertexStreams, vertex_declaration);
+    }
+
+    static bool NullIsInstancingSupported(HContext context)
+    {
+        return true;
+    }
+
+    static void NullEnableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, uint32_t first_instance, HProgram program)
+    {
+        assert(context);
+        EnableVertexStreams(context->m_InstanceVertexStreams, vertex_declaration, vertex_buffer, first_instance);
+    }
+
+    static void NullDisableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
+    {
+        assert(context);
+        DisableVertexStreams(context->m_InstanceVertexStreams, vertex_declaration);
     }
 
     void NullHashVertexDeclaration(HashState32 *state, HVertexDeclaration vertex_declaration)
@@ -626,8 +650,53 @@ namespace dmGraphics
         {
             g_Flipped = 0;
             g_DrawCount = 0;
+            g_InstanceCount = 0;
+        }
+        g_DrawCount++;
+    }
+
+    // Expands the draw the way the vertex fetch would see it: for each instance, the indexed
+    // vertices followed by one copy of the instance record per vertex.
+    static void NullDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
+    {
+        assert(context);
+        assert(index_buffer);
+        const uint32_t vertex_count = count * instance_count;
+        for (uint32_t i = 0; i < MAX_VERTEX_STREAM_COUNT; ++i)
+        {
+            VertexStream& vs = context->m_VertexStreams[i];
+            if (vs.m_Size > 0)
+                vs.m_Buffer = new char[vs.m_Size * vertex_count];
+            VertexStream& is = context->m_InstanceVertexStreams[i];
+            if (is.m_Size > 0)
+                is.m_Buffer = new char[is.m_Size * vertex_count];
+        }
+        for (uint32_t n = 0; n < instance_count; ++n)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t index = GetIndex(type, index_buffer, i + first);
+                uint32_t out = n * count + i;
+                for (uint32_t j = 0; j < MAX_VERTEX_STREAM_COUNT; ++j)
+                {
+                    VertexStream& vs = context->m_VertexStreams[j];
+                    if (vs.m_Size > 0)
+                        memcpy(&((char*)vs.m_Buffer)[out * vs.m_Size], &((char*)vs.m_Source)[index * vs.m_Stride], vs.m_Size);
+                    VertexStream& is = context->m_InstanceVertexStreams[j];
+                    if (is.m_Size > 0)
+                        memcpy(&((char*)is.m_Buffer)[out * is.m_Size], &((char*)is.m_Source)[n * is.m_Stride], is.m_Size);
+                }
+            }
+        }
+
+        if (g_Flipped)
+        {
+            g_Flipped = 0;
+            g_DrawCount = 0;
+            g_InstanceCount = 0;
         }
         g_DrawCount++;
+        g_InstanceCount += instance_count;
     }
 
     static void NullDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
@@ -638,6 +707,7 @@ namespace dmGraphics
         {
             g_Flipped = 0;
             g_DrawCount = 0;
+            g_InstanceCount = 0;
         }
         g_DrawCount++;
     }
@@ -648,6 +718,11 @@ namespace dmGraphics
         return g_DrawCount;
     }
 
+    uint64_t GetInstanceCount()
+    {
+        return g_InstanceCount;
+    }
+
     struct VertexProgram
     {
         char* m_Data;
@@ -1261,6 +1336,10 @@ namespace dmGraphics
         fn_table.m_HashVertexDeclaration = NullHashVertexDeclaration;
         fn_table.m_DrawElements = NullDrawElements;
         fn_table.m_Draw = NullDraw;
+        fn_table.m_IsInstancingSupported = NullIsInstancingSupported;
+        fn_table.m_EnableInstanceVertexDeclaration = NullEnableInstanceVertexDeclaration;
+        fn_table.m_DisableInstanceVertexDeclaration = NullDisableInstanceVertexDeclaration;
+        fn_table.m_DrawElementsInstanced = NullDrawElementsInstanced;
         fn_table.m_NewVertexProgram = NullNewVertexProgram;
         fn_table.m_NewFragmentProgram = NullNewFragmentProgram;
         fn_table.m_NewProgram = NullNewProgram;
@@ -85,6 +85,7 @@ namespace dmGraphics
         Context(const ContextParams& params);
 
         VertexStream                m_VertexStreams[MAX_VERTEX_STREAM_COUNT];
+        VertexStream                m_InstanceVertexStreams[MAX_VERTEX_STREAM_COUNT];
         dmVMath::Vector4            m_ProgramRegisters[MAX_REGISTER_COUNT];
         HTexture                    m_Textures[MAX_TEXTURE_COUNT];
         FrameBuffer                 m_MainFrameBuffer;
@@ -348,8 +348,17 @@ static void LogFrameBufferError(GLenum status)
 
     // Cross-platform OpenGL/ES extension points. We define our own function pointer typedefs to handle the combination of statically or dynamically linked or core functionality.
     // The alternative is a matrix of conditional typedefs, linked statically/dynamically or core. OpenGL function prototypes does not change, so this is safe.
-    typedef void (* DM_PFNGLINVALIDATEFRAMEBUFFERPROC) (GLenum target, GLsizei numAttachments, const GLenum *attachments);
+#if defined(_WIN32)
+    #define DM_GL_APIENTRY APIENTRY
+#else
+    #define DM_GL_APIENTRY
+#endif
+    typedef void (DM_GL_APIENTRY * DM_PFNGLINVALIDATEFRAMEBUFFERPROC) (GLenum target, GLsizei numAttachments, const GLenum *attachments);
+    typedef void (DM_GL_APIENTRY * DM_PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+    typedef void (DM_GL_APIENTRY * DM_PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei instance_count);
     DM_PFNGLINVALIDATEFRAMEBUFFERPROC PFN_glInvalidateFramebuffer = NULL;
+    DM_PFNGLVERTEXATTRIBDIVISORPROC PFN_glVertexAttribDivisor = NULL;
+    DM_PFNGLDRAWELEMENTSINSTANCEDPROC PFN_glDrawElementsInstanced = NULL;
 
     Context* g_Context = 0x0;
 
@@ -973,6 +982,28 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
         }
 
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glInvalidateFramebuffer, "glDiscardFramebuffer", "discard_framebuffer", "glInvalidateFramebuffer", DM_PFNGLINVALIDATEFRAMEBUFFERPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glVertexAttribDivisor, "glVertexAttribDivisor", "instanced_arrays", "glVertexAttribDivisor", DM_PFNGLVERTEXATTRIBDIVISORPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced, "glDrawElementsInstanced", "instanced_arrays", "glDrawElementsInstanced", DM_PFNGLDRAWELEMENTSINSTANCEDPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced, "glDrawElementsInstanced", "draw_instanced", "glDrawElementsInstanced", DM_PFNGLDRAWELEMENTSINSTANCEDPROC, context);
+#if defined(GL_ES_VERSION_2_0) || defined(__EMSCRIPTEN__)
+        // Instancing is core in OpenGL ES 3.0 / WebGL 2, and only available through ANGLE_instanced_arrays on WebGL 1
+        if (context->m_IsGles3Version)
+        {
+            if (PFN_glVertexAttribDivisor == 0x0)
+                PFN_glVertexAttribDivisor = (DM_PFNGLVERTEXATTRIBDIVISORPROC) glfwGetProcAddress("glVertexAttribDivisor");
+            if (PFN_glDrawElementsInstanced == 0x0)
+                PFN_glDrawElementsInstanced = (DM_PFNGLDRAWELEMENTSINSTANCEDPROC) glfwGetProcAddress("glDrawElementsInstanced");
+        }
+    #if defined(__EMSCRIPTEN__)
+        else if (OpenGLIsExtensionSupported(context, "GL_ANGLE_instanced_arrays") || OpenGLIsExtensionSupported(context, "ANGLE_instanced_arrays"))
+        {
+            if (PFN_glVertexAttribDivisor == 0x0)
+                PFN_glVertexAttribDivisor = (DM_PFNGLVERTEXATTRIBDIVISORPROC) glfwGetProcAddress("glVertexAttribDivisorANGLE");
+            if (PFN_glDrawElementsInstanced == 0x0)
+                PFN_glDrawElementsInstanced = (DM_PFNGLDRAWELEMENTSINSTANCEDPROC) glfwGetProcAddress("glDrawElementsInstancedANGLE");
+        }
+    #endif
+#endif
 
         if (OpenGLIsExtensionSupported(context, "GL_IMG_texture_compression_pvrtc") ||
             OpenGLIsExtensionSupported(context, "WEBGL_compressed_texture_pvrtc"))
@@ -1618,6 +1649,70 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
         CHECK_GL_ERROR;
     }
 
+    static bool OpenGLIsInstancingSupported(HContext context)
+    {
+        return PFN_glVertexAttribDivisor != 0x0 && PFN_glDrawElementsInstanced != 0x0;
+    }
+
+    static void OpenGLEnableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, uint32_t first_instance, HProgram program)
+    {
+        assert(context);
+        assert(vertex_buffer);
+        assert(vertex_declaration);
+        assert(PFN_glVertexAttribDivisor);
+
+        if (!(context->m_ModificationVersion == vertex_declaration->m_ModificationVersion && vertex_declaration->m_BoundForProgram == program))
+        {
+            BindVertexDeclarationProgram(context, vertex_declaration, program);
+        }
+
+        #define BUFFER_OFFSET(i) ((char*)0x0 + (i))
+
+        glBindBufferARB(GL_ARRAY_BUFFER, vertex_buffer);
+        CHECK_GL_ERROR;
+
+        // There is no base instance in GLES, so the first instance is applied as an offset into the buffer
+        const uint32_t base_offset = first_instance * vertex_declaration->m_Stride;
+        for (uint32_t i=0; i<vertex_declaration->m_StreamCount; i++)
+        {
+            if (vertex_declaration->m_Streams[i].m_PhysicalIndex != -1)
+            {
+                glEnableVertexAttribArray(vertex_declaration->m_Streams[i].m_PhysicalIndex);
+                CHECK_GL_ERROR;
+                glVertexAttribPointer(
+                        vertex_declaration->m_Streams[i].m_PhysicalIndex,
+                        vertex_declaration->m_Streams[i].m_Size,
+                        GetOpenGLType(vertex_declaration->m_Streams[i].m_Type),
+                        vertex_declaration->m_Streams[i].m_Normalize,
+                        vertex_declaration->m_Stride,
+                BUFFER_OFFSET(base_offset + vertex_declaration->m_Streams[i].m_Offset) );
+                CHECK_GL_ERROR;
+                PFN_glVertexAttribDivisor(vertex_declaration->m_Streams[i].m_PhysicalIndex, 1);
+                CHECK_GL_ERROR;
+            }
+        }
+
+        #undef BUFFER_OFFSET
+    }
+
+    static void OpenGLDisableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
+    {
+        assert(context);
+        assert(vertex_declaration);
+
+        // The divisor is attribute state, so it has to be reset before the location is reused by a per-vertex stream
+        for (uint32_t i=0; i<vertex_declaration->m_StreamCount; i++)
+        {
+            if (vertex_declaration->m_Streams[i].m_PhysicalIndex != -1)
+            {
+                PFN_glVertexAttribDivisor(vertex_declaration->m_Streams[i].m_PhysicalIndex, 0);
+                CHECK_GL_ERROR;
+                glDisableVertexAttribArray(vertex_declaration->m_Streams[i].m_PhysicalIndex);
+                CHECK_GL_ERROR;
+            }
+        }
+    }
+
     void OpenGLHashVertexDeclaration(HashState32 *state, HVertexDeclaration vertex_declaration)
     {
         uint16_t stream_count = vertex_declaration->m_StreamCount;
@@ -1650,6 +1745,20 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
         CHECK_GL_ERROR
     }
 
+    static void OpenGLDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
+    {
+        DM_PROFILE(__FUNCTION__);
+        DM_PROPERTY_ADD_U32(rmtp_DrawCalls, 1);
+        assert(context);
+        assert(index_buffer);
+        assert(PFN_glDrawElementsInstanced);
+        glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+        CHECK_GL_ERROR;
+
+        PFN_glDrawElementsInstanced(GetOpenGLPrimitiveType(prim_type), count, GetOpenGLType(type), (GLvoid*)(uintptr_t) first, instance_count);
+        CHECK_GL_ERROR
+    }
+
     static void OpenGLDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
     {
         DM_PROFILE(__FUNCTION__);
@@ -3044,6 +3153,10 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
         fn_table.m_HashVertexDeclaration = OpenGLHashVertexDeclaration;
         fn_table.m_DrawElements = OpenGLDrawElements;
         fn_table.m_Draw = OpenGLDraw;
+        fn_table.m_IsInstancingSupported = OpenGLIsInstancingSupported;
+        fn_table.m_EnableInstanceVertexDeclaration = OpenGLEnableInstanceVertexDeclaration;
+        fn_table.m_DisableInstanceVertexDeclaration = OpenGLDisableInstanceVertexDeclaration;
+        fn_table.m_DrawElementsInstanced = OpenGLDrawElementsInstanced;
         fn_table.m_NewVertexProgram = OpenGLNewVertexProgram;
         fn_table.m_NewFragmentProgram = OpenGLNewFragmentProgram;
         fn_table.m_NewProgram = OpenGLNewProgram;
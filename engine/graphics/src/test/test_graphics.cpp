@@ -329,6 +329,69 @@ TEST_F(dmGraphicsTest, Drawing)
     dmGraphics::DeleteVertexDeclaration(vd);
 }
 
+TEST_F(dmGraphicsTest, DrawingInstanced)
+{
+    ASSERT_TRUE(dmGraphics::IsInstancingSupported(m_Context));
+
+    float v[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+    uint16_t i[] = { 0, 1, 2 };
+    // Two records of (offset.xy, tint), skipping the first one
+    float inst[] = { -1.0f, -1.0f, -1.0f,  10.0f, 20.0f, 0.5f,  30.0f, 40.0f, 0.25f };
+
+    dmGraphics::VertexElement ve[] =
+    {
+        {"position", 0, 2, dmGraphics::TYPE_FLOAT, false },
+    };
+    dmGraphics::VertexElement ive[] =
+    {
+        {"offset", 0, 2, dmGraphics::TYPE_FLOAT, false },
+        {"tint", 1, 1, dmGraphics::TYPE_FLOAT, false },
+    };
+    dmGraphics::HVertexDeclaration vd = dmGraphics::NewVertexDeclaration(m_Context, ve, 1);
+    dmGraphics::HVertexDeclaration ivd = dmGraphics::NewVertexDeclaration(m_Context, ive, 2);
+    dmGraphics::HVertexBuffer vb = dmGraphics::NewVertexBuffer(m_Context, sizeof(v), v, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+    dmGraphics::HVertexBuffer ivb = dmGraphics::NewVertexBuffer(m_Context, sizeof(inst), inst, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+    dmGraphics::HIndexBuffer ib = dmGraphics::NewIndexBuffer(m_Context, sizeof(i), i, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+
+    dmGraphics::Flip(m_Context);
+
+    dmGraphics::EnableVertexDeclaration(m_Context, vd, vb);
+    dmGraphics::EnableInstanceVertexDeclaration(m_Context, ivd, ivb, 1, 0);
+    dmGraphics::DrawElementsInstanced(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 3, 2, dmGraphics::TYPE_UNSIGNED_SHORT, ib);
+
+    ASSERT_EQ(1u, dmGraphics::GetDrawCount());
+    ASSERT_EQ(2u, dmGraphics::GetInstanceCount());
+
+    // Every instance sees all vertices, and every vertex of an instance sees the same record
+    const float* positions = (const float*)m_Context->m_VertexStreams[0].m_Buffer;
+    const float* offsets = (const float*)m_Context->m_InstanceVertexStreams[0].m_Buffer;
+    const float* tints = (const float*)m_Context->m_InstanceVertexStreams[1].m_Buffer;
+    for (uint32_t n = 0; n < 2; ++n)
+    {
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            uint32_t out = n * 3 + j;
+            ASSERT_EQ(v[j * 2 + 0], positions[out * 2 + 0]);
+            ASSERT_EQ(v[j * 2 + 1], positions[out * 2 + 1]);
+            ASSERT_EQ(inst[(n + 1) * 3 + 0], offsets[out * 2 + 0]);
+            ASSERT_EQ(inst[(n + 1) * 3 + 1], offsets[out * 2 + 1]);
+            ASSERT_EQ(inst[(n + 1) * 3 + 2], tints[out]);
+        }
+    }
+
+    dmGraphics::DisableInstanceVertexDeclaration(m_Context, ivd);
+    dmGraphics::DisableVertexDeclaration(m_Context, vd);
+
+    ASSERT_EQ(0u, m_Context->m_InstanceVertexStreams[0].m_Size);
+    ASSERT_EQ(0u, m_Context->m_InstanceVertexStreams[1].m_Size);
+
+    dmGraphics::DeleteIndexBuffer(ib);
+    dmGraphics::DeleteVertexBuffer(ivb);
+    dmGraphics::DeleteVertexBuffer(vb);
+    dmGraphics::DeleteVertexDeclaration(ivd);
+    dmGraphics::DeleteVertexDeclaration(vd);
+}
+
 static inline dmGraphics::ShaderDesc::Shader MakeDDFShader(const char* data, uint32_t count)
 {
     dmGraphics::ShaderDesc::Shader ddf;
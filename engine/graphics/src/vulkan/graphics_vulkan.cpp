@@ -1364,13 +1364,17 @@ bail:
 
     static Pipeline* GetOrCreatePipeline(VkDevice vk_device, VkSampleCountFlagBits vk_sample_count,
         const PipelineState pipelineState, PipelineCache& pipelineCache,
-        Program* program, RenderTarget* rt, DeviceBuffer* vertexBuffer, HVertexDeclaration vertexDeclaration)
+        Program* program, RenderTarget* rt, DeviceBuffer* vertexBuffer, HVertexDeclaration vertexDeclaration, HVertexDeclaration instanceVertexDeclaration)
     {
         HashState64 pipeline_hash_state;
         dmHashInit64(&pipeline_hash_state, false);
         dmHashUpdateBuffer64(&pipeline_hash_state, &program->m_Hash, sizeof(program->m_Hash));
         dmHashUpdateBuffer64(&pipeline_hash_state, &pipelineState, sizeof(pipelineState));
         dmHashUpdateBuffer64(&pipeline_hash_state, &vertexDeclaration->m_Hash, sizeof(vertexDeclaration->m_Hash));
+        if (instanceVertexDeclaration)
+        {
+            dmHashUpdateBuffer64(&pipeline_hash_state, &instanceVertexDeclaration->m_Hash, sizeof(instanceVertexDeclaration->m_Hash));
+        }
         dmHashUpdateBuffer64(&pipeline_hash_state, &rt->m_Id, sizeof(rt->m_Id));
         dmHashUpdateBuffer64(&pipeline_hash_state, &vk_sample_count, sizeof(vk_sample_count));
         uint64_t pipeline_hash = dmHashFinal64(&pipeline_hash_state);
@@ -1387,7 +1391,7 @@ bail:
             vk_scissor.offset.x = 0;
             vk_scissor.offset.y = 0;
 
-            VkResult res = CreatePipeline(vk_device, vk_scissor, vk_sample_count, pipelineState, program, vertexBuffer, vertexDeclaration, rt->m_RenderPass, &new_pipeline);
+            VkResult res = CreatePipeline(vk_device, vk_scissor, vk_sample_count, pipelineState, program, vertexBuffer, vertexDeclaration, instanceVertexDeclaration, rt->m_RenderPass, &new_pipeline);
             CHECK_VK_ERROR(res);
 
             if (pipelineCache.Full())
@@ -1672,11 +1676,8 @@ bail:
         context->m_CurrentVertexDeclaration = (VertexDeclaration*) vertex_declaration;
     }
 
-    static void VulkanEnableVertexDeclarationProgram(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, HProgram program)
+    static void BindVertexDeclarationProgram(HVertexDeclaration vertex_declaration, Program* program_ptr)
     {
-        Program* program_ptr = (Program*) program;
-        VulkanEnableVertexDeclaration(context, vertex_declaration, vertex_buffer);
-
         for (uint32_t i=0; i < vertex_declaration->m_StreamCount; i++)
         {
             VertexDeclaration::Stream& stream = vertex_declaration->m_Streams[i];
@@ -1696,11 +1697,37 @@ bail:
         }
     }
 
+    static void VulkanEnableVertexDeclarationProgram(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, HProgram program)
+    {
+        VulkanEnableVertexDeclaration(context, vertex_declaration, vertex_buffer);
+        BindVertexDeclarationProgram(vertex_declaration, (Program*) program);
+    }
+
     static void VulkanDisableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
     {
         context->m_CurrentVertexDeclaration = 0;
     }
 
+    static bool VulkanIsInstancingSupported(HContext context)
+    {
+        return true;
+    }
+
+    static void VulkanEnableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, uint32_t first_instance, HProgram program)
+    {
+        context->m_CurrentInstanceVertexBuffer      = (DeviceBuffer*) vertex_buffer;
+        context->m_CurrentInstanceVertexDeclaration = (VertexDeclaration*) vertex_declaration;
+        context->m_CurrentInstanceOffset            = first_instance * vertex_declaration->m_Stride;
+        BindVertexDeclarationProgram(vertex_declaration, (Program*) program);
+    }
+
+    static void VulkanDisableInstanceVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
+    {
+        context->m_CurrentInstanceVertexBuffer      = 0;
+        context->m_CurrentInstanceVertexDeclaration = 0;
+        context->m_CurrentInstanceOffset            = 0;
+    }
+
     static inline bool IsUniformTextureSampler(ShaderResourceBinding uniform)
     {
         return uniform.m_Type == ShaderDesc::SHADER_TYPE_SAMPLER2D ||
@@ -1976,7 +2003,7 @@ bail:
         Pipeline* pipeline = GetOrCreatePipeline(vk_device, vk_sample_count,
             context->m_PipelineState, context->m_PipelineCache,
             program_ptr, context->m_CurrentRenderTarget,
-            vertex_buffer, context->m_CurrentVertexDeclaration);
+            vertex_buffer, context->m_CurrentVertexDeclaration, context->m_CurrentInstanceVertexDeclaration);
         vkCmdBindPipeline(vk_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *pipeline);
 
 
@@ -1998,6 +2025,13 @@ bail:
         VkBuffer vk_vertex_buffer             = vertex_buffer->m_Handle.m_Buffer;
         VkDeviceSize vk_vertex_buffer_offsets = 0;
         vkCmdBindVertexBuffers(vk_command_buffer, 0, 1, &vk_vertex_buffer, &vk_vertex_buffer_offsets);
+
+        if (context->m_CurrentInstanceVertexDeclaration)
+        {
+            VkBuffer vk_instance_buffer             = context->m_CurrentInstanceVertexBuffer->m_Handle.m_Buffer;
+            VkDeviceSize vk_instance_buffer_offsets = context->m_CurrentInstanceOffset;
+            vkCmdBindVertexBuffers(vk_command_buffer, 1, 1, &vk_instance_buffer, &vk_instance_buffer_offsets);
+        }
     }
 
     void VulkanHashVertexDeclaration(HashState32 *state, HVertexDeclaration vertex_declaration)
@@ -2029,6 +2063,21 @@ bail:
         vkCmdDrawIndexed(vk_command_buffer, count, 1, index_offset, 0, 0);
     }
 
+    static void VulkanDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count, Type type, HIndexBuffer index_buffer)
+    {
+        DM_PROFILE(__FUNCTION__);
+        DM_PROPERTY_ADD_U32(rmtp_DrawCalls, 1);
+        assert(context->m_FrameBegun);
+        assert(context->m_CurrentInstanceVertexDeclaration);
+        const uint8_t image_ix = context->m_SwapChain->m_ImageIndex;
+        VkCommandBuffer vk_command_buffer = context->m_MainCommandBuffers[image_ix];
+        context->m_PipelineState.m_PrimtiveType = prim_type;
+        DrawSetup(context, vk_command_buffer, &context->m_MainScratchBuffers[image_ix], (DeviceBuffer*) index_buffer, type);
+
+        uint32_t index_offset = first / (type == TYPE_UNSIGNED_SHORT ? 2 : 4);
+        vkCmdDrawIndexed(vk_command_buffer, count, instance_count, index_offset, 0, 0);
+    }
+
     static void VulkanDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
     {
         DM_PROFILE(__FUNCTION__);
@@ -3455,6 +3504,10 @@ bail:
         fn_table.m_HashVertexDeclaration = VulkanHashVertexDeclaration;
         fn_table.m_DrawElements = VulkanDrawElements;
         fn_table.m_Draw = VulkanDraw;
+        fn_table.m_IsInstancingSupported = VulkanIsInstancingSupported;
+        fn_table.m_EnableInstanceVertexDeclaration = VulkanEnableInstanceVertexDeclaration;
+        fn_table.m_DisableInstanceVertexDeclaration = VulkanDisableInstanceVertexDeclaration;
+        fn_table.m_DrawElementsInstanced = VulkanDrawElementsInstanced;
         fn_table.m_NewVertexProgram = VulkanNewVertexProgram;
         fn_table.m_NewFragmentProgram = VulkanNewFragmentProgram;
         fn_table.m_NewProgram = VulkanNewProgram;
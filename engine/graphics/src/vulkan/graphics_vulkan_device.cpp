@@ -53,7 +53,7 @@ namespace dmGraphics
         memset(this, 0, sizeof(*this));
     }
 
-    static uint16_t FillVertexInputAttributeDesc(HVertexDeclaration vertexDeclaration, VkVertexInputAttributeDescription* vk_vertex_input_descs)
+    static uint16_t FillVertexInputAttributeDesc(HVertexDeclaration vertexDeclaration, uint32_t binding, VkVertexInputAttributeDescription* vk_vertex_input_descs)
     {
         uint16_t num_attributes = 0;
         for (uint16_t i = 0; i < vertexDeclaration->m_StreamCount; ++i)
@@ -63,7 +63,7 @@ namespace dmGraphics
                 continue;
             }
 
-            vk_vertex_input_descs[num_attributes].binding  = 0;
+            vk_vertex_input_descs[num_attributes].binding  = binding;
             vk_vertex_input_descs[num_attributes].location = vertexDeclaration->m_Streams[i].m_Location;
             vk_vertex_input_descs[num_attributes].format   = vertexDeclaration->m_Streams[i].m_Format;
             vk_vertex_input_descs[num_attributes].offset   = vertexDeclaration->m_Streams[i].m_Offset;
@@ -899,27 +899,39 @@ bail:
 
     VkResult CreatePipeline(VkDevice vk_device, VkRect2D vk_scissor, VkSampleCountFlagBits vk_sample_count,
         PipelineState pipelineState, Program* program, DeviceBuffer* vertexBuffer,
-        HVertexDeclaration vertexDeclaration, const VkRenderPass vk_render_pass, Pipeline* pipelineOut)
+        HVertexDeclaration vertexDeclaration, HVertexDeclaration instanceVertexDeclaration,
+        const VkRenderPass vk_render_pass, Pipeline* pipelineOut)
     {
         assert(pipelineOut && *pipelineOut == VK_NULL_HANDLE);
 
-        VkVertexInputAttributeDescription vk_vertex_input_descs[DM_MAX_VERTEX_STREAM_COUNT];
-        uint16_t active_attributes = FillVertexInputAttributeDesc(vertexDeclaration, vk_vertex_input_descs);
+        VkVertexInputAttributeDescription vk_vertex_input_descs[DM_MAX_VERTEX_STREAM_COUNT * 2];
+        uint16_t active_attributes = FillVertexInputAttributeDesc(vertexDeclaration, 0, vk_vertex_input_descs);
         assert(active_attributes != 0);
 
-        VkVertexInputBindingDescription vk_vx_input_description;
-        memset(&vk_vx_input_description, 0, sizeof(vk_vx_input_description));
+        VkVertexInputBindingDescription vk_vx_input_descriptions[2];
+        memset(vk_vx_input_descriptions, 0, sizeof(vk_vx_input_descriptions));
 
-        vk_vx_input_description.binding   = 0;
-        vk_vx_input_description.stride    = vertexDeclaration->m_Stride;
-        vk_vx_input_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        vk_vx_input_descriptions[0].binding   = 0;
+        vk_vx_input_descriptions[0].stride    = vertexDeclaration->m_Stride;
+        vk_vx_input_descriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        uint32_t binding_count = 1;
+
+        // Per-instance attributes are sourced from a second binding that advances once per instance
+        if (instanceVertexDeclaration)
+        {
+            active_attributes += FillVertexInputAttributeDesc(instanceVertexDeclaration, 1, &vk_vertex_input_descs[active_attributes]);
+            vk_vx_input_descriptions[1].binding   = 1;
+            vk_vx_input_descriptions[1].stride    = instanceVertexDeclaration->m_Stride;
+            vk_vx_input_descriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+            binding_count = 2;
+        }
 
         VkPipelineVertexInputStateCreateInfo vk_vertex_input_info;
         memset(&vk_vertex_input_info, 0, sizeof(vk_vertex_input_info));
 
         vk_vertex_input_info.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vk_vertex_input_info.vertexBindingDescriptionCount   = 1;
-        vk_vertex_input_info.pVertexBindingDescriptions      = &vk_vx_input_description;
+        vk_vertex_input_info.vertexBindingDescriptionCount   = binding_count;
+        vk_vertex_input_info.pVertexBindingDescriptions      = vk_vx_input_descriptions;
         vk_vertex_input_info.vertexAttributeDescriptionCount = active_attributes;
         vk_vertex_input_info.pVertexAttributeDescriptions    = vk_vertex_input_descs;
 
@@ -413,6 +413,9 @@ namespace dmGraphics
         RenderTarget*                   m_CurrentRenderTarget;
         DeviceBuffer*                   m_CurrentVertexBuffer;
         VertexDeclaration*              m_CurrentVertexDeclaration;
+        DeviceBuffer*                   m_CurrentInstanceVertexBuffer;
+        VertexDeclaration*              m_CurrentInstanceVertexDeclaration;
+        uint32_t                        m_CurrentInstanceOffset;
         Program*                        m_CurrentProgram;
         // Misc state
         TextureFilter                   m_DefaultTextureMinFilter;
@@ -487,7 +490,8 @@ namespace dmGraphics
         const void* source, uint32_t sourceSize, ShaderModule* shaderModuleOut);
     VkResult CreatePipeline(VkDevice vk_device, VkRect2D vk_scissor, VkSampleCountFlagBits vk_sample_count,
         const PipelineState pipelineState, Program* program, DeviceBuffer* vertexBuffer,
-        HVertexDeclaration vertexDeclaration, const VkRenderPass vk_render_pass, Pipeline* pipelineOut);
+        HVertexDeclaration vertexDeclaration, HVertexDeclaration instanceVertexDeclaration,
+        const VkRenderPass vk_render_pass, Pipeline* pipelineOut);
     // Reset functions
     void           ResetScratchBuffer(VkDevice vk_device, ScratchBuffer* scratchBuffer);
     // Destroy funcions
@@ -49,6 +49,7 @@ DM_PROPERTY_U32(rmtp_GuiStaticTextures, 0, FrameReset, "", &rmtp_Gui);
 DM_PROPERTY_U32(rmtp_GuiDynamicTextures, 0, FrameReset, "", &rmtp_Gui);
 DM_PROPERTY_U32(rmtp_GuiTextures, 0, FrameReset, "", &rmtp_Gui);
 DM_PROPERTY_U32(rmtp_GuiParticlefx, 0, FrameReset, "", &rmtp_Gui);
+DM_PROPERTY_U32(rmtp_GuiRetainedNodes, 0, FrameReset, "", &rmtp_Gui);
 
 namespace dmGui
 {
@@ -289,6 +290,7 @@ namespace dmGui
     void SetSceneAdjustReference(HScene scene, AdjustReference adjust_reference)
     {
         scene->m_AdjustReference = adjust_reference;
+        InvalidateRenderState(scene);
     }
 
     void SetDefaultNewSceneParams(NewSceneParams* params)
@@ -360,6 +362,7 @@ namespace dmGui
         scene->m_UserData = params->m_UserData;
         scene->m_RenderHead = INVALID_INDEX;
         scene->m_RenderTail = INVALID_INDEX;
+        scene->m_DirtyRenderEntries = 1;
         scene->m_NextVersionNumber = 0;
         scene->m_RenderOrder = 0;
         scene->m_Width = context->m_DefaultProjectWidth;
@@ -463,6 +466,7 @@ namespace dmGui
                 nodes[i].m_Node.m_TextureType = texture_type;
             }
         }
+        InvalidateRenderState(scene);
         return RESULT_OK;
     }
 
@@ -808,6 +812,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             if (nodes[i].m_Node.m_LayerHash == layer_hash)
                 nodes[i].m_Node.m_LayerIndex = index;
         }
+        InvalidateRenderEntries(scene);
         return RESULT_OK;
     }
 
@@ -907,6 +912,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             set_node_callback(scene, GetNodeHandle(n), n->m_Node.m_NodeDescTable[index]);
             n->m_Node.m_DirtyLocal = 1;
         }
+        InvalidateRenderEntries(scene);
         return RESULT_OK;
     }
 
@@ -1115,14 +1121,6 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         }
     };
 
-    struct RenderEntrySortDisabledPred
-    {
-        bool operator ()(const RenderEntry& a, const RenderEntry& b) const
-        {
-            return a.m_RenderKey < b.m_RenderKey;
-        }
-    };
-
     struct ScopeContext {
         ScopeContext() {
             memset(this, 0, sizeof(*this));
@@ -1405,30 +1403,52 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         CollectRenderEntries(scene, scene->m_RenderHead, 0, 0x0, clippers, render_entries);
     }
 
-    void RenderScene(HScene scene, const RenderSceneParams& params, void* context)
+    // Collects and sorts the render entries and the stencil clipping scopes of the scene
+    static void CollectSortedRenderEntries(HScene scene)
+    {
+        dmArray<RenderEntry>& entries = scene->m_CollectedRenderEntries;
+        dmArray<InternalClippingNode>& clippers = scene->m_StencilClippingNodes;
+        entries.SetSize(0);
+        clippers.SetSize(0);
+        uint32_t capacity = scene->m_NodePool.Size() * 2;
+        if (capacity > entries.Capacity())
+        {
+            entries.SetCapacity(capacity);
+        }
+        if (capacity > clippers.Capacity())
+        {
+            clippers.SetCapacity(capacity);
+        }
+
+        CollectNodes(scene, clippers, entries);
+        std::sort(entries.Begin(), entries.End(), RenderEntrySortPred());
+    }
+
+    // Calculates the transforms, opacities and stencil scopes of the collected render entries,
+    // and prunes the ones that shouldn't be rendered
+    static void CalculateRenderState(HScene scene)
     {
         Context* c = scene->m_Context;
+        const dmArray<RenderEntry>& entries = scene->m_CollectedRenderEntries;
+        uint32_t node_count = entries.Size();
 
-        UpdateDynamicTextures(scene, params, context);
-        DeferredDeleteDynamicTextures(scene, params, context);
+        scene->m_RenderNodes.SetSize(0);
+        scene->m_RenderTransforms.SetSize(0);
+        scene->m_RenderOpacities.SetSize(0);
+        scene->m_StencilScopes.SetSize(0);
+        if (node_count > scene->m_RenderNodes.Capacity())
+        {
+            scene->m_RenderNodes.SetCapacity(node_count);
+            scene->m_RenderTransforms.SetCapacity(node_count);
+            scene->m_RenderOpacities.SetCapacity(node_count);
+            scene->m_StencilScopes.SetCapacity(node_count);
+        }
 
-        c->m_RenderNodes.SetSize(0);
-        c->m_RenderTransforms.SetSize(0);
-        c->m_RenderOpacities.SetSize(0);
-        c->m_StencilClippingNodes.SetSize(0);
-        c->m_StencilScopes.SetSize(0);
-        c->m_StencilScopeIndices.SetSize(0);
-        uint32_t capacity = scene->m_NodePool.Size() * 2;
-        if (capacity > c->m_RenderNodes.Capacity())
+        uint32_t capacity = dmMath::Max((uint32_t) scene->m_NodePool.Size() * 2, node_count);
+        if (capacity > c->m_SceneTraversalCache.m_Data.Capacity())
         {
-            c->m_RenderNodes.SetCapacity(capacity);
-            c->m_RenderTransforms.SetCapacity(capacity);
-            c->m_RenderOpacities.SetCapacity(capacity);
             c->m_SceneTraversalCache.m_Data.SetCapacity(capacity);
             c->m_SceneTraversalCache.m_Data.SetSize(capacity);
-            c->m_StencilClippingNodes.SetCapacity(capacity);
-            c->m_StencilScopes.SetCapacity(capacity);
-            c->m_StencilScopeIndices.SetCapacity(capacity);
         }
 
         c->m_SceneTraversalCache.m_NodeIndex = 0;
@@ -1437,27 +1457,10 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             c->m_SceneTraversalCache.m_Version = 0;
         }
 
-        CollectNodes(scene, c->m_StencilClippingNodes, c->m_RenderNodes);
-        uint32_t node_count = c->m_RenderNodes.Size();
-        std::sort(c->m_RenderNodes.Begin(), c->m_RenderNodes.End(), RenderEntrySortPred());
         Matrix4 transform;
-
-        if (c->m_RenderNodes.Capacity() > c->m_RenderTransforms.Capacity())
-        {
-            uint32_t new_capacity = c->m_RenderNodes.Capacity();
-            c->m_RenderTransforms.SetCapacity(new_capacity);
-            c->m_RenderOpacities.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetSize(new_capacity);
-            c->m_StencilClippingNodes.SetCapacity(new_capacity);
-            c->m_StencilScopes.SetCapacity(new_capacity);
-            c->m_StencilScopeIndices.SetCapacity(new_capacity);
-        }
-
-        uint32_t num_pruned = 0;
         for (uint32_t i = 0; i < node_count; ++i)
         {
-            RenderEntry& entry = c->m_RenderNodes[i];
+            const RenderEntry& entry = entries[i];
             uint16_t index = entry.m_Node & 0xffff;
             InternalNode* n = &scene->m_Nodes[index];
             float opacity = 1.0f;
@@ -1470,45 +1473,66 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             CalculateNodeTransformAndAlphaCached(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform, opacity);
 
             // Ideally, we'd like to have this update step in the Update function (I'm not even sure why it isn't tbh)
-            // But for now, let's prune the list here
+            // But for now, let's prune the list here.
+            // The entries are sorted on unique render keys, so skipping the pruned ones keeps the order
             if (opacity == 0.0f || n->m_Node.m_IsBone)
             {
-                entry.m_Node = INVALID_HANDLE;
-                entry.m_RenderKey = INVALID_RENDER_KEY;
-                ++num_pruned;
                 continue;
             }
 
-            c->m_RenderTransforms.Push(transform);
-            c->m_RenderOpacities.Push(opacity);
+            scene->m_RenderNodes.Push(entry);
+            scene->m_RenderTransforms.Push(transform);
+            scene->m_RenderOpacities.Push(opacity);
             if (n->m_ClipperIndex != INVALID_INDEX) {
-                InternalClippingNode* clipper = &c->m_StencilClippingNodes[n->m_ClipperIndex];
+                InternalClippingNode* clipper = &scene->m_StencilClippingNodes[n->m_ClipperIndex];
                 if (clipper->m_NodeIndex == index) {
                     if (clipper->m_VisibleRenderKey == entry.m_RenderKey) {
                         StencilScope* scope = 0x0;
                         if (clipper->m_ParentIndex != INVALID_INDEX) {
-                            scope = &c->m_StencilClippingNodes[clipper->m_ParentIndex].m_ChildScope;
+                            scope = &scene->m_StencilClippingNodes[clipper->m_ParentIndex].m_ChildScope;
                         }
-                        c->m_StencilScopes.Push(scope);
+                        scene->m_StencilScopes.Push(scope);
                     } else {
-                        c->m_StencilScopes.Push(&clipper->m_Scope);
+                        scene->m_StencilScopes.Push(&clipper->m_Scope);
                     }
                 } else {
-                    c->m_StencilScopes.Push(&clipper->m_ChildScope);
+                    scene->m_StencilScopes.Push(&clipper->m_ChildScope);
                 }
             } else {
-                c->m_StencilScopes.Push(0x0);
+                scene->m_StencilScopes.Push(0x0);
             }
         }
+    }
 
-        if (num_pruned)
+    void RenderScene(HScene scene, const RenderSceneParams& params, void* context)
+    {
+        UpdateDynamicTextures(scene, params, context);
+        DeferredDeleteDynamicTextures(scene, params, context);
+
+        // The render entries, transforms and stencil scopes are retained in the scene, and only
+        // recalculated when something affecting them has changed since the last frame.
+        // Particle emitters change their render data every frame, so scenes with live particlefx
+        // are always collected. Destroying a particlefx invalidates the entries, since they point
+        // to the emitter render data.
+        if (scene->m_DirtyRenderEntries || scene->m_AliveParticlefxs.Size() > 0)
         {
-            std::sort(c->m_RenderNodes.Begin(), c->m_RenderNodes.End(), RenderEntrySortDisabledPred());
-            c->m_RenderNodes.SetSize(c->m_RenderNodes.Size() - num_pruned);
+            CollectSortedRenderEntries(scene);
+            scene->m_DirtyRenderState = 1;
         }
 
+        if (scene->m_DirtyRenderState || scene->m_ResChanged)
+        {
+            CalculateRenderState(scene);
+        }
+        else
+        {
+            DM_PROPERTY_ADD_U32(rmtp_GuiRetainedNodes, scene->m_RenderNodes.Size());
+        }
+
+        scene->m_DirtyRenderEntries = 0;
+        scene->m_DirtyRenderState = 0;
         scene->m_ResChanged = 0;
-        params.m_RenderNodes(scene, c->m_RenderNodes.Begin(), c->m_RenderTransforms.Begin(), c->m_RenderOpacities.Begin(), (const StencilScope**)c->m_StencilScopes.Begin(), c->m_RenderNodes.Size(), context);
+        params.m_RenderNodes(scene, scene->m_RenderNodes.Begin(), scene->m_RenderTransforms.Begin(), scene->m_RenderOpacities.Begin(), (const StencilScope**)scene->m_StencilScopes.Begin(), scene->m_RenderNodes.Size(), context);
     }
 
     static bool IsNodeEnabledRecursive(HScene scene, uint16_t node_index)
@@ -1658,6 +1682,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                 *anim->m_Value = anim->m_From + (anim->m_To - anim->m_From) * x;
                 // Flag local transform as dirty for the node
                 scene->m_Nodes[anim->m_Node & 0xffff].m_Node.m_DirtyLocal = 1;
+                InvalidateRenderState(scene);
 
                 // Animation complete, see above
                 if (t >= 1.0f)
@@ -2065,6 +2090,8 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             dmParticle::DestroyInstance(scene->m_ParticlefxContext, c->m_Instance);
         }
         scene->m_AliveParticlefxs.SetSize(0);
+        // The retained render entries point to the emitter render data of the destroyed instances
+        InvalidateRenderEntries(scene);
 
         ClearLayouts(scene);
         return result;
@@ -2157,6 +2184,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
                 dmParticle::DestroyInstance(scene->m_ParticlefxContext, c->m_Instance);
                 scene->m_AliveParticlefxs.EraseSwap(i);
+                InvalidateRenderEntries(scene);
                 --count;
             }
             else
@@ -2443,6 +2471,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
     static void AddToNodeList(HScene scene, InternalNode* n, InternalNode* parent_n, InternalNode* prev_n)
     {
+        InvalidateRenderEntries(scene);
         uint16_t* head = &scene->m_RenderHead, * tail = &scene->m_RenderTail;
         uint16_t parent_index = INVALID_INDEX;
         if (parent_n != 0x0)
@@ -2487,6 +2516,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
     static void RemoveFromNodeList(HScene scene, InternalNode* n)
     {
+        InvalidateRenderEntries(scene);
         // Remove from list
         if (n->m_PrevIndex != INVALID_INDEX)
             scene->m_Nodes[n->m_PrevIndex].m_NextIndex = n->m_NextIndex;
@@ -2541,6 +2571,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                         dmParticle::DestroyInstance(scene->m_ParticlefxContext, comp_n->m_Node.m_ParticleInstance);
                         n->m_Node.m_ParticleInstance = dmParticle::INVALID_INSTANCE;
                         scene->m_AliveParticlefxs.EraseSwap(i);
+                        InvalidateRenderEntries(scene);
                         --count;
                     }
                     else
@@ -2607,6 +2638,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NodePool.Clear();
         scene->m_Animations.SetSize(0);
+        InvalidateRenderEntries(scene);
     }
 
     static Vector4 ApplyAdjustOnReferenceScale(const Vector4& reference_scale, uint32_t adjust_mode)
@@ -2724,6 +2756,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             }
         }
         scene->m_Animations.SetSize(0);
+        InvalidateRenderEntries(scene);
     }
 
     uint16_t GetRenderOrder(HScene scene)
@@ -2780,6 +2813,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Properties[PROPERTY_POSITION] = Vector4(position);
         n->m_Node.m_DirtyLocal = 1;
+        InvalidateRenderState(scene);
     }
 
     bool HasPropertyHash(HScene scene, HNode node, dmhash_t property)
@@ -2818,6 +2852,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Properties[property] = value;
         n->m_Node.m_DirtyLocal = 1;
+        InvalidateRenderState(scene);
     }
 
     void SetNodeResetPoint(HScene scene, HNode node)
@@ -2902,6 +2937,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     Result SetNodeTexture(HScene scene, HNode node, dmhash_t texture_id)
     {
         InternalNode* n = GetNode(scene, node);
+        InvalidateRenderState(scene);
         if (n->m_Node.m_TextureType == NODE_TEXTURE_TYPE_TEXTURE_SET)
             CancelNodeFlipbookAnim(scene, node);
         if (TextureInfo* texture_info = scene->m_Textures.Get(texture_id)) {
@@ -2943,6 +2979,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     Result SetNodeTexture(HScene scene, HNode node, NodeTextureType type, void* texture)
     {
         InternalNode* n = GetNode(scene, node);
+        InvalidateRenderState(scene);
         n->m_Node.m_TextureHash = (uintptr_t)texture;
         n->m_Node.m_TextureType = type;
         n->m_Node.m_Texture = texture;
@@ -3068,6 +3105,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             InternalNode* n = GetNode(scene, node);
             n->m_Node.m_LayerHash = layer_id;
             n->m_Node.m_LayerIndex = *layer_index;
+            InvalidateRenderEntries(scene);
             return RESULT_OK;
         }
         else
@@ -3091,12 +3129,14 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_InheritAlpha = inherit_alpha;
+        InvalidateRenderState(scene);
     }
 
     void SetNodeAlpha(HScene scene, HNode node, float alpha)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Properties[PROPERTY_COLOR].setW(alpha);
+        InvalidateRenderState(scene);
     }
 
     float GetNodeAlpha(HScene scene, HNode node)
@@ -3119,6 +3159,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
         cursor = dmMath::Clamp(cursor, 0.0f, 1.0f);
         n->m_Node.m_FlipbookAnimPosition = cursor;
+        InvalidateRenderState(scene);
         if (n->m_Node.m_FlipbookAnimHash) {
             Animation* anim = GetComponentAnimation(scene, node, &n->m_Node.m_FlipbookAnimPosition);
             if (anim) {
@@ -3211,6 +3252,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         n->m_Node.m_ParticleInstance = inst;
 
         dmParticle::StartInstance(scene->m_ParticlefxContext, inst);
+        InvalidateRenderEntries(scene);
 
         return RESULT_OK;
     }
@@ -3229,6 +3271,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             if (component->m_Node == node)
             {
                 dmParticle::StopInstance(scene->m_ParticlefxContext, component->m_Instance);
+                InvalidateRenderEntries(scene);
             }
         }
 
@@ -3239,6 +3282,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingMode = mode;
+        InvalidateRenderEntries(scene);
     }
 
     ClippingMode GetNodeClippingMode(HScene scene, HNode node)
@@ -3251,6 +3295,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingVisible = (uint32_t) visible;
+        InvalidateRenderEntries(scene);
     }
 
     bool GetNodeClippingVisible(HScene scene, HNode node)
@@ -3263,6 +3308,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingInverted = (uint32_t) inverted;
+        InvalidateRenderEntries(scene);
     }
 
     bool GetNodeClippingInverted(HScene scene, HNode node)
@@ -3310,6 +3356,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_XAnchor = (uint32_t) x_anchor;
+        InvalidateRenderState(scene);
     }
 
     YAnchor GetNodeYAnchor(HScene scene, HNode node)
@@ -3322,6 +3369,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_YAnchor = (uint32_t) y_anchor;
+        InvalidateRenderState(scene);
     }
 
 
@@ -3383,6 +3431,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Pivot = (uint32_t) pivot;
+        InvalidateRenderState(scene);
     }
 
     bool GetNodeIsBone(HScene scene, HNode node)
@@ -3395,18 +3444,21 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_IsBone = is_bone;
+        InvalidateRenderState(scene);
     }
 
     void SetNodeAdjustMode(HScene scene, HNode node, AdjustMode adjust_mode)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_AdjustMode = (uint32_t) adjust_mode;
+        InvalidateRenderState(scene);
     }
 
     void SetNodeSizeMode(HScene scene, HNode node, SizeMode size_mode)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_SizeMode = (uint32_t) size_mode;
+        InvalidateRenderState(scene);
         if((n->m_Node.m_SizeMode != SIZE_MODE_MANUAL) && (n->m_Node.m_NodeType != NODE_TYPE_CUSTOM) && (n->m_Node.m_NodeType != NODE_TYPE_PARTICLEFX))
         {
             if (TextureInfo* texture_info = scene->m_Textures.Get(n->m_Node.m_TextureHash))
@@ -3704,16 +3756,23 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         // update animationdata, compare state to current and early bail if equal
         TextureSetAnimDesc& anim_desc = n->m_Node.m_TextureSetAnimDesc;
         const TextureSetAnimDesc::State state_previous = anim_desc.m_State;
+        const float* tex_coords_previous = anim_desc.m_TexCoords;
         if(FetchTextureSetAnim(scene, n, anim_hash)!=FETCH_ANIMATION_OK)
         {
             // general error in retreiving animation. This could be it being deleted or otherwise changed erraneously
             anim_desc.Init();
             CancelAnimationComponent(scene, GetNodeHandle(n), &n->m_Node.m_FlipbookAnimPosition);
+            InvalidateRenderState(scene);
             dmLogWarning("Failed to update animation '%s'.", dmHashReverseSafe64(anim_hash));
             return;
         }
 
-        if (anim_desc.m_State.IsEqual(state_previous))
+        // A reloaded texture set may change the frame sizes used by the auto size mode
+        bool state_equal = anim_desc.m_State.IsEqual(state_previous);
+        if (!state_equal || anim_desc.m_TexCoords != tex_coords_previous)
+            InvalidateRenderState(scene);
+
+        if (state_equal)
             return;
 
         n->m_Node.m_FlipbookAnimPosition = 0.0f;
@@ -3771,6 +3830,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         else
             AnimateTextureSetAnim(scene, node, offset, playback_rate, anim_complete_callback, callback_userdata1, callback_userdata2);
         CalculateNodeSize(n);
+        InvalidateRenderState(scene);
         return RESULT_OK;
     }
 
@@ -3861,6 +3921,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Enabled = enabled;
+        InvalidateRenderEntries(scene);
         if(enabled)
         {
             SetDirtyLocalRecursive(scene, node);
@@ -4005,6 +4066,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         Vector3 local_position = ScreenToLocalPosition(scene, node, parent_node, screen_position);
         node->m_Node.m_Properties[dmGui::PROPERTY_POSITION] = Vector4(local_position, 1.0f);
         node->m_Node.m_DirtyLocal = 1;
+        InvalidateRenderState(scene);
     }
 
     void SetScreenPosition(HScene scene, HNode node, const Point3& screen_position)
@@ -91,12 +91,6 @@ namespace dmGui
         uint32_t                        m_DefaultProjectHeight;
         uint32_t                        m_Dpi;
         dmArray<HScene>                 m_Scenes;
-        dmArray<RenderEntry>            m_RenderNodes;
-        dmArray<dmVMath::Matrix4>       m_RenderTransforms;
-        dmArray<float>                	m_RenderOpacities;
-        dmArray<InternalClippingNode>   m_StencilClippingNodes;
-        dmArray<StencilScope*>          m_StencilScopes;
-        dmArray<uint16_t>               m_StencilScopeIndices;
         dmArray<HNode>                  m_ScratchBoneNodes;
         dmHID::HContext                 m_HidContext;
         void*                           m_DefaultFont;
@@ -294,6 +288,8 @@ namespace dmGui
         uint16_t                m_RenderOrder; // For the render-key
         uint16_t                m_NextLayerIndex;
         uint16_t                m_ResChanged : 1;
+        uint16_t                m_DirtyRenderEntries : 1; // See InvalidateRenderEntries
+        uint16_t                m_DirtyRenderState : 1;   // See InvalidateRenderState
         uint32_t                m_Width;
         uint32_t                m_Height;
         dmScript::ScriptWorld*  m_ScriptWorld;
@@ -306,8 +302,32 @@ namespace dmGui
         void*                       m_GetResourceCallbackContext;
         FetchTextureSetAnimCallback m_FetchTextureSetAnimCallback;
         OnWindowResizeCallback   m_OnWindowResizeCallback;
+
+        // Render data retained between frames by RenderScene
+        dmArray<RenderEntry>            m_CollectedRenderEntries; // All collected entries, sorted on render key
+        dmArray<InternalClippingNode>   m_StencilClippingNodes;
+        dmArray<RenderEntry>            m_RenderNodes;
+        dmArray<dmVMath::Matrix4>       m_RenderTransforms;
+        dmArray<float>                  m_RenderOpacities;
+        dmArray<StencilScope*>          m_StencilScopes;
     };
 
+    /** flags the render entries of the scene to be collected and sorted again in the next RenderScene
+     * Needed when the hierarchy, draw order, layers, clipping or enabled state of the nodes change.
+     */
+    inline void InvalidateRenderEntries(HScene scene)
+    {
+        scene->m_DirtyRenderEntries = 1;
+    }
+
+    /** flags the render transforms and opacities of the scene to be calculated again in the next RenderScene
+     * Needed when any property affecting the transform, size or opacity of a node changes.
+     */
+    inline void InvalidateRenderState(HScene scene)
+    {
+        scene->m_DirtyRenderState = 1;
+    }
+
     InternalNode* GetNode(HScene scene, HNode node);
 
     bool IsNodeValid(HScene scene, HNode node);
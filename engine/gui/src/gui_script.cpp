@@ -2094,6 +2094,7 @@ namespace dmGui
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
         int clipping_mode = (int) luaL_checknumber(L, 2);
         n->m_Node.m_ClippingMode = (ClippingMode) clipping_mode;
+        InvalidateRenderEntries(GetScene(L));
         return 0;
     }
 
@@ -2125,6 +2126,7 @@ namespace dmGui
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
         int visible = lua_toboolean(L, 2);
         n->m_Node.m_ClippingVisible = visible;
+        InvalidateRenderEntries(GetScene(L));
         return 0;
     }
 
@@ -2156,6 +2158,7 @@ namespace dmGui
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
         int inverted = lua_toboolean(L, 2);
         n->m_Node.m_ClippingInverted = inverted;
+        InvalidateRenderEntries(GetScene(L));
         return 0;
     }
 
@@ -2953,6 +2956,7 @@ namespace dmGui
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
         int adjust_mode = (int) luaL_checknumber(L, 2);
         n->m_Node.m_AdjustMode = (AdjustMode) adjust_mode;
+        InvalidateRenderState(GetScene(L));
         return 0;
     }
 
@@ -3513,6 +3517,7 @@ namespace dmGui
                 v = *dmScript::CheckVector4(L, 2);\
             n->m_Node.m_Properties[property] = v;\
             n->m_Node.m_DirtyLocal = 1;\
+            InvalidateRenderState(GetScene(L));\
             return 0;\
         }\
 
@@ -3578,6 +3583,7 @@ namespace dmGui
         }
         n->m_Node.m_Properties[PROPERTY_ROTATION] = v;
         n->m_Node.m_DirtyLocal = 1;
+        InvalidateRenderState(GetScene(L));
         return 0;
     }
 
@@ -3624,6 +3630,7 @@ namespace dmGui
             v = *dmScript::CheckVector4(L, 2);
         n->m_Node.m_Properties[PROPERTY_SIZE] = v;
         n->m_Node.m_DirtyLocal = 1;
+        InvalidateRenderState(GetScene(L));
         return 0;
     }
 
@@ -4084,6 +4091,7 @@ namespace dmGui
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
         int inherit_alpha = lua_toboolean(L, 2);
         n->m_Node.m_InheritAlpha = inherit_alpha;
+        InvalidateRenderState(GetScene(L));
 
         assert(top == lua_gettop(L));
         return 0;
@@ -4164,6 +4164,103 @@ TEST_F(dmGuiTest, SceneTransformCacheCoherence)
     }
 }
 
+struct RetainedRenderData
+{
+    TransformColorData  m_Nodes[3];
+    uint32_t            m_Count;
+};
+
+static void RenderNodesRetained(dmGui::HScene scene, const dmGui::RenderEntry* nodes, const dmVMath::Matrix4* node_transforms, const float* node_opacities,
+        const dmGui::StencilScope** stencil_scopes, uint32_t node_count, void* context)
+{
+    RetainedRenderData* data = (RetainedRenderData*) context;
+    RenderNodesStoreOpacityAndTransform(scene, nodes, node_transforms, node_opacities, stencil_scopes, node_count, data->m_Nodes);
+    data->m_Count = node_count;
+}
+
+// Verify that the render data retained between frames is recalculated when the nodes change
+//
+// - n1
+//   - n2
+// - n3
+//
+TEST_F(dmGuiTest, RetainedRenderScene)
+{
+    Vector3 size(1, 1, 0);
+    dmGui::HNode n1 = dmGui::NewNode(m_Scene, Point3(1, 0, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n2 = dmGui::NewNode(m_Scene, Point3(0, 1, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::HNode n3 = dmGui::NewNode(m_Scene, Point3(2, 0, 0), size, dmGui::NODE_TYPE_BOX, 0);
+    dmGui::SetNodeParent(m_Scene, n2, n1, false);
+    dmGui::SetNodeInheritAlpha(m_Scene, n2, true);
+    dmGui::SetNodePivot(m_Scene, n1, dmGui::PIVOT_SW);
+    dmGui::SetNodePivot(m_Scene, n2, dmGui::PIVOT_SW);
+    dmGui::SetNodePivot(m_Scene, n3, dmGui::PIVOT_SW);
+
+    dmGui::RenderSceneParams render_params;
+    render_params.m_RenderNodes = RenderNodesRetained;
+
+    RetainedRenderData first;
+    memset(&first, 0, sizeof(first));
+    dmGui::RenderScene(m_Scene, render_params, &first);
+    ASSERT_EQ(3U, first.m_Count);
+    ASSERT_NEAR(1.0f, first.m_Nodes[0].m_Transform.getTranslation().getX(), EPSILON);
+    ASSERT_NEAR(1.0f, first.m_Nodes[1].m_Transform.getTranslation().getY(), EPSILON);
+    ASSERT_NEAR(2.0f, first.m_Nodes[2].m_Transform.getTranslation().getX(), EPSILON);
+
+    // Nothing changed
+    RetainedRenderData data;
+    memset(&data, 0, sizeof(data));
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_EQ(0, memcmp(&first, &data, sizeof(data)));
+
+    // Transform of the parent
+    dmGui::SetNodePosition(m_Scene, n1, Point3(3, 0, 0));
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_EQ(3U, data.m_Count);
+    ASSERT_NEAR(3.0f, data.m_Nodes[0].m_Transform.getTranslation().getX(), EPSILON);
+    ASSERT_NEAR(3.0f, data.m_Nodes[1].m_Transform.getTranslation().getX(), EPSILON);
+
+    // Inherited opacity prunes the child
+    dmGui::SetNodeProperty(m_Scene, n1, dmGui::PROPERTY_COLOR, Vector4(1, 1, 1, 0));
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_EQ(1U, data.m_Count);
+    ASSERT_NEAR(2.0f, data.m_Nodes[0].m_Transform.getTranslation().getX(), EPSILON);
+
+    dmGui::SetNodeAlpha(m_Scene, n1, 0.5f);
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_EQ(3U, data.m_Count);
+    ASSERT_EQ(0.5f, data.m_Nodes[1].m_Opacity);
+
+    // Enabled state
+    dmGui::SetNodeEnabled(m_Scene, n3, false);
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_EQ(2U, data.m_Count);
+
+    dmGui::SetNodeEnabled(m_Scene, n3, true);
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_EQ(3U, data.m_Count);
+
+    // Draw order
+    dmGui::MoveNodeBelow(m_Scene, n3, n1);
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_EQ(3U, data.m_Count);
+    ASSERT_NEAR(2.0f, data.m_Nodes[0].m_Transform.getTranslation().getX(), EPSILON);
+    ASSERT_NEAR(3.0f, data.m_Nodes[1].m_Transform.getTranslation().getX(), EPSILON);
+
+    // Animations
+    dmhash_t property = dmGui::GetPropertyHash(dmGui::PROPERTY_POSITION);
+    dmGui::AnimateNodeHash(m_Scene, n3, property, Vector4(4, 0, 0, 0), dmEasing::Curve(dmEasing::TYPE_LINEAR), dmGui::PLAYBACK_ONCE_FORWARD, 1.0f, 0.0f, 0, 0, 0);
+    dmGui::UpdateScene(m_Scene, 0.5f);
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_NEAR(3.0f, data.m_Nodes[0].m_Transform.getTranslation().getX(), EPSILON);
+
+    // Resolution
+    dmGui::SetSceneAdjustReference(m_Scene, dmGui::ADJUST_REFERENCE_PARENT);
+    dmGui::SetPhysicalResolution(m_Context, 2, 2);
+    dmGui::RenderScene(m_Scene, render_params, &data);
+    ASSERT_NEAR(6.0f, data.m_Nodes[0].m_Transform.getTranslation().getX(), EPSILON);
+}
+
 TEST_F(dmGuiTest, ScriptClippingFunctions)
 {
     dmGui::HNode node = dmGui::NewNode(m_Scene, Point3(0,0,0), Vector3(1,1,0), dmGui::NODE_TYPE_BOX, 0);
@@ -5204,6 +5301,57 @@ TEST_F(dmGuiTest, StopNodeParticlefxMultiplePlaying)
     UnloadParticlefxPrototype(prototype);
 }
 
+static void RenderNodesCountRenderData(dmGui::HScene scene, const dmGui::RenderEntry* nodes, const dmVMath::Matrix4* node_transforms, const float* node_opacities,
+        const dmGui::StencilScope** stencil_scopes, uint32_t node_count, void* context)
+{
+    uint32_t* count = (uint32_t*) context;
+    *count = 0;
+    for (uint32_t i = 0; i < node_count; ++i)
+    {
+        if (nodes[i].m_RenderData != 0x0)
+            ++*count;
+    }
+}
+
+// The retained render entries must not keep pointing at the emitter render data of destroyed particlefx
+TEST_F(dmGuiTest, RetainedRenderSceneParticlefx)
+{
+    const char* particlefx_name = "once.particlefxc";
+    dmParticle::HPrototype prototype;
+    dmGui::HNode node_pfx = SetupGuiTestScene(this, particlefx_name, prototype);
+
+    dmGui::RenderSceneParams render_params;
+    render_params.m_RenderNodes = RenderNodesCountRenderData;
+
+    float dt = 1.2f;
+    uint32_t render_data_count = 0;
+    ASSERT_EQ(dmGui::RESULT_OK, dmGui::PlayNodeParticlefx(m_Scene, node_pfx, 0));
+    dmParticle::Update(m_Scene->m_ParticlefxContext, dt, 0);
+    dmGui::RenderScene(m_Scene, render_params, &render_data_count);
+    ASSERT_LT(0U, render_data_count);
+
+    // Last live particlefx is pruned
+    dmParticle::Update(m_Scene->m_ParticlefxContext, dt, 0); // Sleeping
+    dmGui::UpdateScene(m_Scene, dt);
+    ASSERT_EQ(0U, dmGui::GetParticlefxCount(m_Scene));
+    dmGui::RenderScene(m_Scene, render_params, &render_data_count);
+    ASSERT_EQ(0U, render_data_count);
+
+    // Deleted together with its node
+    ASSERT_EQ(dmGui::RESULT_OK, dmGui::PlayNodeParticlefx(m_Scene, node_pfx, 0));
+    dmParticle::Update(m_Scene->m_ParticlefxContext, dt, 0);
+    dmGui::RenderScene(m_Scene, render_params, &render_data_count);
+    ASSERT_LT(0U, render_data_count);
+
+    dmGui::DeleteNode(m_Scene, node_pfx, true);
+    ASSERT_EQ(0U, dmGui::GetParticlefxCount(m_Scene));
+    dmGui::RenderScene(m_Scene, render_params, &render_data_count);
+    ASSERT_EQ(0U, render_data_count);
+
+    dmGui::FinalScene(m_Scene);
+    UnloadParticlefxPrototype(prototype);
+}
+
 TEST_F(dmGuiTest, SetNodeParticlefx)
 {
     uint32_t width = 100;
@@ -14,13 +14,15 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <float.h>
-#include <algorithm>
 #include <dlib/hash.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
 #include <dlib/vmath.h>
 #include <dlib/profile.h>
+#include <dlib/simd.h>
+#include <dlib/static_assert.h>
 #include <dlib/time.h>
 #include <dmsdk/dlib/vmath.h>
 
@@ -56,6 +58,72 @@ namespace dmParticle
     /// Simulate motion blur at 60 fps with a 180 deg shutter
     const static float STRETCH_SCALING = (1.0f/60.0f) * 0.5f;
 
+    /// Number of particles simulated per block, see Simulate
+    const static uint32_t SIMULATE_BLOCK_SIZE = 256;
+
+    /// Cleared by SetSimdEnabled to run everything on the scalar code
+    static bool g_SimdEnabled = true;
+
+    void SetSimdEnabled(bool enabled)
+    {
+        g_SimdEnabled = enabled;
+    }
+
+#if defined(DM_SIMD)
+
+    using dmSimd::Float4;
+
+    // Number of leading particles to run through the four-wide kernels
+    static inline uint32_t SimdCount(uint32_t count)
+    {
+        return g_SimdEnabled ? (count & ~3u) : 0;
+    }
+
+    // The particle kernels process four particles at a time. Four consecutive floats at the same offset
+    // in four elements are loaded and transposed, so that each register holds one member for all four elements.
+    // The kernels mirror the operation order of the scalar code, which they also fall back to for the remainder.
+
+    DM_STATIC_ASSERT(offsetof(Particle, m_SpreadFactor) == offsetof(Particle, m_TimeLeft) + 3 * sizeof(float), Invalid_Particle_Layout);
+    DM_STATIC_ASSERT(offsetof(Particle, m_SourceStretchFactorY) == offsetof(Particle, m_SourceSize) + 2 * sizeof(float), Invalid_Particle_Layout);
+    DM_STATIC_ASSERT(offsetof(Particle, m_SourceAngularVelocity) == offsetof(Particle, m_SortKey) + 3 * sizeof(float), Invalid_Particle_Layout);
+
+    static inline void LoadTransposed(const void* base, uint32_t stride, uint32_t offset, Float4& a, Float4& b, Float4& c, Float4& d)
+    {
+        const uint8_t* p = (const uint8_t*)base + offset;
+        a = dmSimd::Load((const float*)p);
+        b = dmSimd::Load((const float*)(p + stride));
+        c = dmSimd::Load((const float*)(p + stride * 2));
+        d = dmSimd::Load((const float*)(p + stride * 3));
+        dmSimd::Transpose(a, b, c, d);
+    }
+
+    static inline void StoreTransposed(void* base, uint32_t stride, uint32_t offset, Float4 a, Float4 b, Float4 c, Float4 d)
+    {
+        uint8_t* p = (uint8_t*)base + offset;
+        dmSimd::Transpose(a, b, c, d);
+        dmSimd::Store((float*)p, a);
+        dmSimd::Store((float*)(p + stride), b);
+        dmSimd::Store((float*)(p + stride * 2), c);
+        dmSimd::Store((float*)(p + stride * 3), d);
+    }
+
+#define LOAD_PARTICLES(particles, member, a, b, c, d) LoadTransposed(particles, sizeof(Particle), offsetof(Particle, member), a, b, c, d)
+#define STORE_PARTICLES(particles, member, a, b, c, d) StoreTransposed(particles, sizeof(Particle), offsetof(Particle, member), a, b, c, d)
+
+    // Same as rotate(const Quat&, const Vector3&)
+    static inline void Rotate4(Float4 qx, Float4 qy, Float4 qz, Float4 qw, Float4 vx, Float4 vy, Float4 vz, Float4& rx, Float4& ry, Float4& rz)
+    {
+        Float4 tx = dmSimd::Sub(dmSimd::Add(dmSimd::Mul(qw, vx), dmSimd::Mul(qy, vz)), dmSimd::Mul(qz, vy));
+        Float4 ty = dmSimd::Sub(dmSimd::Add(dmSimd::Mul(qw, vy), dmSimd::Mul(qz, vx)), dmSimd::Mul(qx, vz));
+        Float4 tz = dmSimd::Sub(dmSimd::Add(dmSimd::Mul(qw, vz), dmSimd::Mul(qx, vy)), dmSimd::Mul(qy, vx));
+        Float4 tw = dmSimd::Add(dmSimd::Add(dmSimd::Mul(qx, vx), dmSimd::Mul(qy, vy)), dmSimd::Mul(qz, vz));
+        rx = dmSimd::Add(dmSimd::Sub(dmSimd::Add(dmSimd::Mul(tw, qx), dmSimd::Mul(tx, qw)), dmSimd::Mul(ty, qz)), dmSimd::Mul(tz, qy));
+        ry = dmSimd::Add(dmSimd::Sub(dmSimd::Add(dmSimd::Mul(tw, qy), dmSimd::Mul(ty, qw)), dmSimd::Mul(tz, qx)), dmSimd::Mul(tx, qz));
+        rz = dmSimd::Add(dmSimd::Sub(dmSimd::Add(dmSimd::Mul(tw, qz), dmSimd::Mul(tz, qw)), dmSimd::Mul(tx, qy)), dmSimd::Mul(ty, qx));
+    }
+
+#endif
+
     AnimationData::AnimationData()
     {
         memset(this, 0, sizeof(*this));
@@ -105,6 +173,11 @@ namespace dmParticle
         context->m_MaxParticleCount = max_particle_count;
     }
 
+    void SetContextJobPool(HParticleContext context, dmJobPool::HJobPool pool)
+    {
+        context->m_JobPool = pool;
+    }
+
     static Instance* GetInstance(HParticleContext context, HInstance instance)
     {
         if (instance == INVALID_INSTANCE)
@@ -263,6 +336,7 @@ namespace dmParticle
             Emitter* emitter = &i->m_Emitters[emitter_i];
             emitter->m_Particles.SetCapacity(0);
             emitter->m_RenderConstants.SetCapacity(0);
+            emitter->m_SortBuffer.SetCapacity(0);
         }
         delete i;
     }
@@ -368,6 +442,7 @@ namespace dmParticle
                 for (uint32_t emitter_i = prototype_emitter_count; emitter_i < emitter_count; ++emitter_i)
                 {
                     emitters[emitter_i].m_Particles.SetCapacity(0);
+                    emitters[emitter_i].m_SortBuffer.SetCapacity(0);
                 }
             }
             emitters.SetCapacity(prototype_emitter_count);
@@ -579,33 +654,58 @@ namespace dmParticle
         return IsSleeping(GetInstance(context, instance));
     }
 
+    // Whether the particles need to be drawn in order. Additive blending gives the same result in any order.
+    static inline bool IsDrawOrderDependent(dmParticleDDF::Emitter* emitter_ddf)
+    {
+        return emitter_ddf->m_BlendMode != BLEND_MODE_ADD && emitter_ddf->m_BlendMode != BLEND_MODE_ADD_ALPHA;
+    }
+
     // helper functions in update
     static void FetchAnimation(Emitter* emitter, EmitterPrototype* prototype, FetchAnimationCallback fetch_animation_callback);
     static void UpdateParticles(Instance* instance, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt);
     static void UpdateEmitterState(Instance* instance, Emitter* emitter, EmitterPrototype* emitter_prototype, dmParticleDDF::Emitter* emitter_ddf, float dt);
     static void EvaluateEmitterProperties(Emitter* emitter, Property* emitter_properties, float duration, float properties[EMITTER_KEY_COUNT]);
-    static void EvaluateParticleProperties(Emitter* emitter, Property* particle_properties, dmParticleDDF::Emitter* emitter_ddf, float dt);
+    static void EvaluateParticleProperties(Particle* particles, uint32_t count, Property* particle_properties, dmParticleDDF::Emitter* emitter_ddf, float dt);
     static uint32_t UpdateRenderData(HParticleContext context, Instance* instance, Emitter* emitter, dmParticleDDF::Emitter* ddf, const Vector4& color, uint32_t vertex_index, void* vertex_buffer, uint32_t vertex_buffer_size, float dt, ParticleVertexFormat format);
-    static void GenerateKeys(Emitter* emitter, float max_particle_life_time);
+    static bool GenerateKeys(Emitter* emitter, float max_particle_life_time);
     static void SortParticles(Emitter* emitter);
     static void Simulate(Instance* instance, Emitter* emitter, EmitterPrototype* prototype, dmParticleDDF::Emitter* ddf, float dt);
 
-    static void UpdateEmitter(Prototype* prototype, Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
+    // Retires and spawns particles, and updates the emitter state. Returns false if the emitter shouldn't be simulated.
+    // Must be called on the thread updating the context, since the state changes invoke the emitter state changed callback.
+    static bool SpawnEmitter(Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
         // Don't update emitter if time is standing still
         if (IsSleeping(emitter) || dt <= 0.0f)
-            return;
+            return false;
 
         UpdateParticles(instance, emitter, emitter_ddf, dt);
 
         UpdateEmitterState(instance, emitter, emitter_prototype, emitter_ddf, dt);
+        return true;
+    }
 
-        GenerateKeys(emitter, emitter_prototype->m_MaxParticleLifeTime);
-        SortParticles(emitter);
+    // Sorts and simulates the particles. Only touches the emitter itself, so emitters can be simulated in parallel.
+    static void SimulateEmitter(Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
+    {
+        if (IsDrawOrderDependent(emitter_ddf))
+        {
+            // Only sort when spawned particles have broken the order
+            if (!GenerateKeys(emitter, emitter_prototype->m_MaxParticleLifeTime))
+                SortParticles(emitter);
+        }
 
         Simulate(instance, emitter, emitter_prototype, emitter_ddf, dt);
     }
 
+    static void UpdateEmitter(Prototype* prototype, Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
+    {
+        if (SpawnEmitter(instance, emitter_prototype, emitter, emitter_ddf, dt))
+        {
+            SimulateEmitter(instance, emitter_prototype, emitter, emitter_ddf, dt);
+        }
+    }
+
     static void UpdateEmitterVelocity(Instance* instance, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
         // Update emitter velocity (1-frame estimate)
@@ -662,10 +762,111 @@ namespace dmParticle
         context->m_Stats.m_Particles = vertex_index / 6; // Debug data for editor playback
     }
 
+    struct VertexJobs
+    {
+        HParticleContext    m_Context;
+        VertexJob*          m_Jobs;
+        void*               m_VertexBuffer;
+        uint32_t            m_VertexBufferSize;
+        float               m_DT;
+        ParticleVertexFormat m_VertexFormat;
+    };
+
+    static void GenerateVertexJob(void* context, uint32_t job_index)
+    {
+        VertexJobs* jobs = (VertexJobs*)context;
+        VertexJob* job = &jobs->m_Jobs[job_index];
+        UpdateRenderData(jobs->m_Context, job->m_Instance, job->m_Emitter, job->m_DDF, job->m_Color, job->m_VertexIndex, jobs->m_VertexBuffer, jobs->m_VertexBufferSize, jobs->m_DT, jobs->m_VertexFormat);
+    }
+
+    void GenerateVertexDataBatch(HParticleContext context, float dt, const EmitterVertexRequest* requests, uint32_t request_count, void* vertex_buffer, uint32_t vertex_buffer_size, uint32_t* out_vertex_buffer_size, ParticleVertexFormat vertex_format)
+    {
+        DM_PROFILE(__FUNCTION__);
+
+        uint32_t vertex_size = sizeof(Vertex);
+
+        if (vertex_format == PARTICLE_GUI)
+        {
+            vertex_size = sizeof(ParticleGuiVertex);
+        }
+
+        uint32_t vertex_index = *out_vertex_buffer_size / vertex_size;
+        if (vertex_buffer == 0x0 || vertex_buffer_size == 0)
+            return;
+
+        // Each emitter writes all of its particles, or as many as fit in the buffer, so the vertex index of
+        // each emitter is known up front. This gives the same layout as when generating one emitter at a time.
+        dmArray<VertexJob>& jobs = context->m_VertexJobs;
+        jobs.SetSize(0);
+        if (jobs.Capacity() < request_count)
+        {
+            jobs.SetCapacity(request_count);
+        }
+        uint32_t max_vertex_count = vertex_buffer_size / vertex_size;
+        for (uint32_t i = 0; i < request_count; ++i)
+        {
+            const EmitterVertexRequest& request = requests[i];
+            if (request.m_Instance == INVALID_INSTANCE)
+                continue;
+            Instance* inst = GetInstance(context, request.m_Instance);
+            if (IsSleeping(inst))
+                continue;
+
+            VertexJob job;
+            job.m_Color = request.m_Color;
+            job.m_Instance = inst;
+            job.m_Emitter = &inst->m_Emitters[request.m_EmitterIndex];
+            job.m_DDF = &inst->m_Prototype->m_DDF->m_Emitters[request.m_EmitterIndex];
+            job.m_VertexIndex = vertex_index;
+            jobs.Push(job);
+
+            uint32_t emitter_vertex_count = GetEmitterVertexCount(context, request.m_Instance, request.m_EmitterIndex);
+            if (vertex_index < max_vertex_count)
+            {
+                vertex_index += dmMath::Min(emitter_vertex_count, (max_vertex_count - vertex_index) / 6 * 6);
+            }
+        }
+
+        VertexJobs vertex_jobs;
+        vertex_jobs.m_Context = context;
+        vertex_jobs.m_Jobs = jobs.Begin();
+        vertex_jobs.m_VertexBuffer = vertex_buffer;
+        vertex_jobs.m_VertexBufferSize = vertex_buffer_size;
+        vertex_jobs.m_DT = dt;
+        vertex_jobs.m_VertexFormat = vertex_format;
+        dmJobPool::Run(context->m_JobPool, GenerateVertexJob, &vertex_jobs, jobs.Size());
+
+        *out_vertex_buffer_size = vertex_index * vertex_size;
+
+        context->m_Stats.m_Particles = vertex_index / 6; // Debug data for editor playback
+    }
+
+    struct SimulateJobs
+    {
+        EmitterJob* m_Jobs;
+        float       m_DT;
+    };
+
+    static void SimulateJob(void* context, uint32_t job_index)
+    {
+        SimulateJobs* jobs = (SimulateJobs*)context;
+        EmitterJob* job = &jobs->m_Jobs[job_index];
+        if (job->m_Simulate)
+        {
+            SimulateEmitter(job->m_Instance, job->m_Prototype, job->m_Emitter, job->m_DDF, jobs->m_DT);
+        }
+    }
+
     void Update(HParticleContext context, float dt, FetchAnimationCallback fetch_animation_callback)
     {
         DM_PROFILE(__FUNCTION__);
 
+        // The emitters are updated in three passes. Spawning and the state changes, which invoke the state
+        // changed callbacks, are done on the calling thread, followed by the simulation of all emitters (in
+        // parallel if there is a worker pool), and finally the animation and render data on the calling thread.
+        dmArray<EmitterJob>& jobs = context->m_EmitterJobs;
+        jobs.SetSize(0);
+
         uint32_t size = context->m_Instances.Size();
         uint32_t TotalAliveParticles = 0;
         for (uint32_t i = 0; i < size; i++)
@@ -692,21 +893,42 @@ namespace dmParticle
             instance->m_PlayTime += dt;
             Prototype* prototype = instance->m_Prototype;
             uint32_t emitter_count = instance->m_Emitters.Size();
+            if (jobs.Remaining() < emitter_count)
+            {
+                jobs.OffsetCapacity(dmMath::Max(emitter_count, 32U));
+            }
             for (uint32_t emitter_i = 0; emitter_i < emitter_count; ++emitter_i)
             {
-                Emitter* emitter = &instance->m_Emitters[emitter_i];
-                EmitterPrototype* emitter_prototype = &prototype->m_Emitters[emitter_i];
-                dmParticleDDF::Emitter* emitter_ddf = &prototype->m_DDF->m_Emitters[emitter_i];
+                EmitterJob job;
+                job.m_Instance = instance;
+                job.m_Emitter = &instance->m_Emitters[emitter_i];
+                job.m_Prototype = &prototype->m_Emitters[emitter_i];
+                job.m_DDF = &prototype->m_DDF->m_Emitters[emitter_i];
+                job.m_InstanceHandle = instance_handle;
+                job.m_EmitterIndex = emitter_i;
+
+                UpdateEmitterVelocity(instance, job.m_Emitter, job.m_DDF, dt);
+                job.m_Simulate = SpawnEmitter(instance, job.m_Prototype, job.m_Emitter, job.m_DDF, dt);
+                jobs.Push(job);
+            }
+        }
 
-                UpdateEmitterVelocity(instance, emitter, emitter_ddf, dt);
-                UpdateEmitter(prototype, instance, emitter_prototype, emitter, emitter_ddf, dt);
-                TotalAliveParticles += (uint32_t)emitter->m_Particles.Size();
-                FetchAnimation(emitter, emitter_prototype, fetch_animation_callback);
-                UpdateEmitterRenderData(instance_handle, emitter_i, instance, emitter, emitter_ddf);
+        SimulateJobs simulate_jobs;
+        simulate_jobs.m_Jobs = jobs.Begin();
+        simulate_jobs.m_DT = dt;
+        dmJobPool::Run(context->m_JobPool, SimulateJob, &simulate_jobs, jobs.Size());
 
-                if (emitter->m_ReHash)
-                    ReHashEmitter(emitter);
-            }
+        uint32_t job_count = jobs.Size();
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            EmitterJob* job = &jobs[i];
+            Emitter* emitter = job->m_Emitter;
+            TotalAliveParticles += (uint32_t)emitter->m_Particles.Size();
+            FetchAnimation(emitter, job->m_Prototype, fetch_animation_callback);
+            UpdateEmitterRenderData(job->m_InstanceHandle, job->m_EmitterIndex, job->m_Instance, emitter, job->m_DDF);
+
+            if (emitter->m_ReHash)
+                ReHashEmitter(emitter);
         }
 
         DM_PROPERTY_SET_U32(rmtp_ParticlesAlive, TotalAliveParticles);
@@ -741,6 +963,31 @@ namespace dmParticle
 
         // Step particle life, prune dead particles
         uint32_t particle_count = emitter->m_Particles.Size();
+        if (IsDrawOrderDependent(emitter_ddf))
+        {
+            // Keep the particles in order, so they don't need to be sorted again. Stepping the life time keeps the
+            // order, and since the particles are sorted on time left, the dead ones are found at the end.
+            Particle* particles = emitter->m_Particles.Begin();
+            uint32_t alive_count = 0;
+            for (uint32_t j = 0; j < particle_count; ++j)
+            {
+                Particle* p = &particles[j];
+                p->SetTimeLeft(p->GetTimeLeft() - dt);
+                if (p->GetTimeLeft() < 0.0f)
+                {
+                    // TODO Handle death-action
+                    continue;
+                }
+                if (alive_count != j)
+                {
+                    particles[alive_count] = *p;
+                }
+                ++alive_count;
+            }
+            emitter->m_Particles.SetSize(alive_count);
+            return;
+        }
+
         uint32_t j = 0;
         while (j < particle_count)
         {
@@ -1008,6 +1255,99 @@ namespace dmParticle
         particle->m_SourceAngularVelocity = emitter_properties[EMITTER_KEY_PARTICLE_ANGULAR_VELOCITY];
     }
 
+    /// Per particle data evaluated before the corners of the particle quad are calculated
+    struct QuadInput
+    {
+        Vector3         m_Size;
+        float           m_WidthFactor;
+        float           m_HeightFactor;
+        const float*    m_TexCoord;
+    };
+
+    static inline void CalcQuadCorners(const dmTransform::TransformS1& emission_transform, const Particle* particle, const QuadInput& quad, Vector3 corners[4])
+    {
+        dmTransform::Transform particle_transform;
+        particle_transform.SetTranslation(Vector3(particle->GetPosition()));
+        particle_transform.SetRotation(particle->GetRotation());
+        particle_transform.SetScale(quad.m_Size);
+        particle_transform.SetRotation(emission_transform.GetRotation() * particle_transform.GetRotation());
+        particle_transform.SetTranslation(Vector3(Apply(emission_transform, Point3(particle_transform.GetTranslation()))));
+        particle_transform.SetScale(emission_transform.GetScale() * particle_transform.GetScale());
+
+        Vector3 x = dmTransform::Apply(particle_transform, Vector3(quad.m_WidthFactor, 0.0f, 0.0f));
+        Vector3 y = dmTransform::Apply(particle_transform, Vector3(0.0f, quad.m_HeightFactor, 0.0f));
+
+        corners[0] = -x - y + particle_transform.GetTranslation();
+        corners[1] = -x + y + particle_transform.GetTranslation();
+        corners[2] = x - y + particle_transform.GetTranslation();
+        corners[3] = x + y + particle_transform.GetTranslation();
+    }
+
+#if defined(DM_SIMD)
+    // Same as CalcQuadCorners, for four particles
+    static inline void CalcQuadCorners4(const dmTransform::TransformS1& emission_transform, const Particle* particles, const QuadInput* quads, Vector3 corners[4][4])
+    {
+        Quat emission_rotation = emission_transform.GetRotation();
+        Vector3 emission_translation = emission_transform.GetTranslation();
+        Float4 erx = dmSimd::Splat(emission_rotation.getX());
+        Float4 ery = dmSimd::Splat(emission_rotation.getY());
+        Float4 erz = dmSimd::Splat(emission_rotation.getZ());
+        Float4 erw = dmSimd::Splat(emission_rotation.getW());
+        Float4 es = dmSimd::Splat(emission_transform.GetScale());
+        const Float4 zero = dmSimd::Splat(0.0f);
+
+        Float4 px, py, pz, pw;
+        LOAD_PARTICLES(particles, m_Position, px, py, pz, pw);
+        Float4 qx, qy, qz, qw;
+        LOAD_PARTICLES(particles, m_Rotation, qx, qy, qz, qw);
+
+        // Rotation in emission space
+        Float4 rx = dmSimd::Sub(dmSimd::Add(dmSimd::Add(dmSimd::Mul(erw, qx), dmSimd::Mul(erx, qw)), dmSimd::Mul(ery, qz)), dmSimd::Mul(erz, qy));
+        Float4 ry = dmSimd::Sub(dmSimd::Add(dmSimd::Add(dmSimd::Mul(erw, qy), dmSimd::Mul(ery, qw)), dmSimd::Mul(erz, qx)), dmSimd::Mul(erx, qz));
+        Float4 rz = dmSimd::Sub(dmSimd::Add(dmSimd::Add(dmSimd::Mul(erw, qz), dmSimd::Mul(erz, qw)), dmSimd::Mul(erx, qy)), dmSimd::Mul(ery, qx));
+        Float4 rw = dmSimd::Sub(dmSimd::Sub(dmSimd::Sub(dmSimd::Mul(erw, qw), dmSimd::Mul(erx, qx)), dmSimd::Mul(ery, qy)), dmSimd::Mul(erz, qz));
+
+        // Translation in emission space
+        Float4 tx, ty, tz;
+        Rotate4(erx, ery, erz, erw, dmSimd::Mul(px, es), dmSimd::Mul(py, es), dmSimd::Mul(pz, es), tx, ty, tz);
+        tx = dmSimd::Add(tx, dmSimd::Splat(emission_translation.getX()));
+        ty = dmSimd::Add(ty, dmSimd::Splat(emission_translation.getY()));
+        tz = dmSimd::Add(tz, dmSimd::Splat(emission_translation.getZ()));
+
+        // Scale in emission space
+        Float4 sx, sy, sz, sw;
+        LoadTransposed(quads, sizeof(QuadInput), offsetof(QuadInput, m_Size), sx, sy, sz, sw);
+        sx = dmSimd::Mul(sx, es);
+        sy = dmSimd::Mul(sy, es);
+        sz = dmSimd::Mul(sz, es);
+
+        Float4 wf = dmSimd::Set(quads[0].m_WidthFactor, quads[1].m_WidthFactor, quads[2].m_WidthFactor, quads[3].m_WidthFactor);
+        Float4 hf = dmSimd::Set(quads[0].m_HeightFactor, quads[1].m_HeightFactor, quads[2].m_HeightFactor, quads[3].m_HeightFactor);
+
+        Float4 xx, xy, xz;
+        Rotate4(rx, ry, rz, rw, dmSimd::Mul(wf, sx), dmSimd::Mul(zero, sy), dmSimd::Mul(zero, sz), xx, xy, xz);
+        Float4 yx, yy, yz;
+        Rotate4(rx, ry, rz, rw, dmSimd::Mul(zero, sx), dmSimd::Mul(hf, sy), dmSimd::Mul(zero, sz), yx, yy, yz);
+
+        const Float4 minus_one = dmSimd::Splat(-1.0f);
+        Float4 nxx = dmSimd::Mul(xx, minus_one);
+        Float4 nxy = dmSimd::Mul(xy, minus_one);
+        Float4 nxz = dmSimd::Mul(xz, minus_one);
+
+        // -x - y, -x + y, x - y, x + y
+        Float4 c[4][4] = {
+            { dmSimd::Add(dmSimd::Sub(nxx, yx), tx), dmSimd::Add(dmSimd::Sub(nxy, yy), ty), dmSimd::Add(dmSimd::Sub(nxz, yz), tz), zero },
+            { dmSimd::Add(dmSimd::Add(nxx, yx), tx), dmSimd::Add(dmSimd::Add(nxy, yy), ty), dmSimd::Add(dmSimd::Add(nxz, yz), tz), zero },
+            { dmSimd::Add(dmSimd::Sub(xx, yx), tx), dmSimd::Add(dmSimd::Sub(xy, yy), ty), dmSimd::Add(dmSimd::Sub(xz, yz), tz), zero },
+            { dmSimd::Add(dmSimd::Add(xx, yx), tx), dmSimd::Add(dmSimd::Add(xy, yy), ty), dmSimd::Add(dmSimd::Add(xz, yz), tz), zero },
+        };
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            StoreTransposed(&corners[0][i], sizeof(corners[0]), 0, c[i][0], c[i][1], c[i][2], c[i][3]);
+        }
+    }
+#endif
+
     static float unit_tex_coords[] =
     {
             0.0f,1.0f, 0.0f,0.0f, 1.0f,0.0f, 1.0f,1.0f
@@ -1064,7 +1404,6 @@ namespace dmParticle
 
         // calculate emission space
         dmTransform::TransformS1 emission_transform;
-        dmTransform::Transform particle_transform;
         emission_transform.SetIdentity();
         if (ddf->m_Space == EMISSION_SPACE_EMITTER)
         {
@@ -1073,7 +1412,11 @@ namespace dmParticle
 
         uint32_t max_vertex_count = vertex_buffer_size / vertex_size;
         uint32_t particle_count = emitter->m_Particles.Size();
-        uint32_t j;
+        uint32_t render_count = 0;
+        if (vertex_index < max_vertex_count)
+        {
+            render_count = dmMath::Min(particle_count, (max_vertex_count - vertex_index) / 6);
+        }
 
         float width_factor = 1.0f;
         float height_factor = 1.0f;
@@ -1092,83 +1435,105 @@ namespace dmParticle
             height_factor *= 0.5f;
         }
 
-        for (j = 0; j < particle_count && vertex_index + 6 <= max_vertex_count; j++)
+        uint32_t flip_flag = 0;
+        if (hFlip)
+        {
+            flip_flag = 1;
+        }
+        if (vFlip)
+        {
+            flip_flag |= 2;
+        }
+        const int* tex_lookup = &tex_coord_order[flip_flag * 6];
+
+        // Particles are processed in batches, to let the corners of the quads be calculated four at a time
+        QuadInput quads[4];
+        Vector3 corners[4][4];
+        uint32_t j = 0;
+        while (j < render_count)
         {
-            Particle* particle = &emitter->m_Particles[j];
-            // Evaluate anim frame
-            uint32_t tile = 0;
-            Vector3 size;
-            if (anim_playing)
+            Particle* batch = &emitter->m_Particles[j];
+            uint32_t batch_count = dmMath::Min(render_count - j, 4u);
+
+            for (uint32_t k = 0; k < batch_count; ++k)
             {
-                float anim_cursor = particle->GetMaxLifeTime() - particle->GetTimeLeft() - half_dt;
-                float anim_t = 0.0f;
-                if (anim_once) // stretch over particle life
-                {
-                    anim_t = anim_cursor * particle->GetooMaxLifeTime();
-                }
-                else // use anim FPS
+                Particle* particle = &batch[k];
+                // Evaluate anim frame
+                uint32_t tile = 0;
+                Vector3 size;
+                if (anim_playing)
                 {
-                    anim_t = anim_cursor * inv_anim_length;
-                }
-                tile = (uint32_t)(tile_count * anim_t);
-                tile = tile % tile_count;
-                if (tile >= interval) {
-                    tile = (interval-1) * 2 - tile;
-                }
-                if (anim_bwd)
-                    tile = tile_count - tile - 1;
+                    float anim_cursor = particle->GetMaxLifeTime() - particle->GetTimeLeft() - half_dt;
+                    float anim_t = 0.0f;
+                    if (anim_once) // stretch over particle life
+                    {
+                        anim_t = anim_cursor * particle->GetooMaxLifeTime();
+                    }
+                    else // use anim FPS
+                    {
+                        anim_t = anim_cursor * inv_anim_length;
+                    }
+                    tile = (uint32_t)(tile_count * anim_t);
+                    tile = tile % tile_count;
+                    if (tile >= interval) {
+                        tile = (interval-1) * 2 - tile;
+                    }
+                    if (anim_bwd)
+                        tile = tile_count - tile - 1;
 
-                size = particle->GetScale();
-                if(anim_auto_size)
-                {
-                    const float* td = &tex_dims[(start_tile + tile) << 1];
-                    width_factor = td[0] * 0.5;
-                    height_factor = td[1] * 0.5;
+                    size = particle->GetScale();
+                    if(anim_auto_size)
+                    {
+                        const float* td = &tex_dims[(start_tile + tile) << 1];
+                        width_factor = td[0] * 0.5;
+                        height_factor = td[1] * 0.5;
+                    }
+                    else
+                    {
+                        size *= particle->GetSourceSize();
+                    }
                 }
                 else
                 {
-                    size *= particle->GetSourceSize();
+                    size = particle->GetScale() * particle->GetSourceSize();
                 }
+                tile += start_tile;
+
+                QuadInput& quad = quads[k];
+                quad.m_Size = size;
+                quad.m_WidthFactor = width_factor;
+                quad.m_HeightFactor = height_factor;
+                quad.m_TexCoord = &tex_coords[tile << 3];
             }
-            else
+
+#if defined(DM_SIMD)
+            if (batch_count == 4 && g_SimdEnabled)
             {
-                size = particle->GetScale() * particle->GetSourceSize();
+                CalcQuadCorners4(emission_transform, batch, quads, corners);
             }
-            tile += start_tile;
-            float* tex_coord = &tex_coords[tile << 3];
-
-            particle_transform.SetTranslation(Vector3(particle->GetPosition()));
-            particle_transform.SetRotation(particle->GetRotation());
-            particle_transform.SetScale(size);
-            particle_transform.SetRotation(emission_transform.GetRotation() * particle_transform.GetRotation());
-            particle_transform.SetTranslation(Vector3(Apply(emission_transform, Point3(particle_transform.GetTranslation()))));
-            particle_transform.SetScale(emission_transform.GetScale() * particle_transform.GetScale());
-
-            Vector3 x = dmTransform::Apply(particle_transform, Vector3(width_factor, 0.0f, 0.0f));
-            Vector3 y = dmTransform::Apply(particle_transform, Vector3(0.0f, height_factor, 0.0f));
-
-            Vector3 p0 = -x - y + particle_transform.GetTranslation();
-            Vector3 p1 = -x + y + particle_transform.GetTranslation();
-            Vector3 p2 = x - y + particle_transform.GetTranslation();
-            Vector3 p3 = x + y + particle_transform.GetTranslation();
-
-            uint32_t flip_flag = 0;
-            if (hFlip)
+            else
+#endif
             {
-                flip_flag = 1;
+                for (uint32_t k = 0; k < batch_count; ++k)
+                {
+                    CalcQuadCorners(emission_transform, &batch[k], quads[k], corners[k]);
+                }
             }
-            if (vFlip)
+
+            for (uint32_t k = 0; k < batch_count; ++k)
             {
-                flip_flag |= 2;
-            }
-            const int* tex_lookup = &tex_coord_order[flip_flag * 6];
+                const float* tex_coord = quads[k].m_TexCoord;
+                const Vector3& p0 = corners[k][0];
+                const Vector3& p1 = corners[k][1];
+                const Vector3& p2 = corners[k][2];
+                const Vector3& p3 = corners[k][3];
 
-            Vector4 c = particle->GetColor();
-            c = Vector4(mulPerElem(c.getXYZ(), color.getXYZ()), c.getW() * color.getW());
+                Vector4 c = batch[k].GetColor();
+                c = Vector4(mulPerElem(c.getXYZ(), color.getXYZ()), c.getW() * color.getW());
 
-            if (format == PARTICLE_GO)
-            {
-                Vertex* vertex = &((Vertex*)vertex_buffer)[vertex_index];
+                if (format == PARTICLE_GO)
+                {
+                    Vertex* vertex = &((Vertex*)vertex_buffer)[vertex_index];
 
 #define SET_VERTEX_GO(vertex, p, c, u, v)\
     vertex->m_X = p.getX();\
@@ -1181,23 +1546,23 @@ namespace dmParticle
     vertex->m_U = u;\
     vertex->m_V = v;
 
-                SET_VERTEX_GO(vertex, p0, c, tex_coord[tex_lookup[0] * 2], tex_coord[tex_lookup[0] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GO(vertex, p1, c, tex_coord[tex_lookup[1] * 2], tex_coord[tex_lookup[1] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GO(vertex, p3, c, tex_coord[tex_lookup[2] * 2], tex_coord[tex_lookup[2] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GO(vertex, p3, c, tex_coord[tex_lookup[3] * 2], tex_coord[tex_lookup[3] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GO(vertex, p2, c, tex_coord[tex_lookup[4] * 2], tex_coord[tex_lookup[4] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GO(vertex, p0, c, tex_coord[tex_lookup[5] * 2], tex_coord[tex_lookup[5] * 2 + 1])
+                    SET_VERTEX_GO(vertex, p0, c, tex_coord[tex_lookup[0] * 2], tex_coord[tex_lookup[0] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GO(vertex, p1, c, tex_coord[tex_lookup[1] * 2], tex_coord[tex_lookup[1] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GO(vertex, p3, c, tex_coord[tex_lookup[2] * 2], tex_coord[tex_lookup[2] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GO(vertex, p3, c, tex_coord[tex_lookup[3] * 2], tex_coord[tex_lookup[3] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GO(vertex, p2, c, tex_coord[tex_lookup[4] * 2], tex_coord[tex_lookup[4] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GO(vertex, p0, c, tex_coord[tex_lookup[5] * 2], tex_coord[tex_lookup[5] * 2 + 1])
 
 #undef SET_VERTEX_GO
-            }
-            else if (format == PARTICLE_GUI)
-            {
-                ParticleGuiVertex* vertex = &((ParticleGuiVertex*)vertex_buffer)[vertex_index];
+                }
+                else if (format == PARTICLE_GUI)
+                {
+                    ParticleGuiVertex* vertex = &((ParticleGuiVertex*)vertex_buffer)[vertex_index];
 
 #define SET_VERTEX_GUI(vertex, p, c, u, v)\
     vertex->m_Position[0] = p.getX();\
@@ -1210,21 +1575,23 @@ namespace dmParticle
     vertex->m_UV[0] = u;\
     vertex->m_UV[1] = v;
 
-                SET_VERTEX_GUI(vertex, p0, c, tex_coord[tex_lookup[0] * 2], tex_coord[tex_lookup[0] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GUI(vertex, p1, c, tex_coord[tex_lookup[1] * 2], tex_coord[tex_lookup[1] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GUI(vertex, p3, c, tex_coord[tex_lookup[2] * 2], tex_coord[tex_lookup[2] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GUI(vertex, p3, c, tex_coord[tex_lookup[3] * 2], tex_coord[tex_lookup[3] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GUI(vertex, p2, c, tex_coord[tex_lookup[4] * 2], tex_coord[tex_lookup[4] * 2 + 1])
-                ++vertex;
-                SET_VERTEX_GUI(vertex, p0, c, tex_coord[tex_lookup[5] * 2], tex_coord[tex_lookup[5] * 2 + 1])
+                    SET_VERTEX_GUI(vertex, p0, c, tex_coord[tex_lookup[0] * 2], tex_coord[tex_lookup[0] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GUI(vertex, p1, c, tex_coord[tex_lookup[1] * 2], tex_coord[tex_lookup[1] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GUI(vertex, p3, c, tex_coord[tex_lookup[2] * 2], tex_coord[tex_lookup[2] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GUI(vertex, p3, c, tex_coord[tex_lookup[3] * 2], tex_coord[tex_lookup[3] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GUI(vertex, p2, c, tex_coord[tex_lookup[4] * 2], tex_coord[tex_lookup[4] * 2 + 1])
+                    ++vertex;
+                    SET_VERTEX_GUI(vertex, p0, c, tex_coord[tex_lookup[5] * 2], tex_coord[tex_lookup[5] * 2 + 1])
 #undef SET_VERTEX_GUI
-            }
+                }
 
-            vertex_index += 6;
+                vertex_index += 6;
+            }
+            j += batch_count;
         }
         if (j < particle_count)
         {
@@ -1243,43 +1610,103 @@ namespace dmParticle
         return emitter->m_VertexCount;
     }
 
-    struct SortPred
-    {
-        inline bool operator () (const Particle& p1, const Particle& p2)
-        {
-            return p1.GetSortKey().m_Key < p2.GetSortKey().m_Key;
-        }
-
-    };
-
-    void GenerateKeys(Emitter* emitter, float max_particle_life_time)
+    // Generates the sort keys, and returns true if the particles are already in order
+    bool GenerateKeys(Emitter* emitter, float max_particle_life_time)
     {
         dmArray<Particle>& particles = emitter->m_Particles;
         uint32_t n = particles.Size();
 
         float range = 1.0f / max_particle_life_time;
 
-        Particle* first = particles.Begin();
+        uint32_t prev_lt = 0;
+        bool sorted = true;
         for (uint32_t i = 0; i < n; ++i)
         {
             Particle* p = &particles[i];
-            uint32_t index = p - first;
 
             float life_time = (1.0f - p->GetTimeLeft() * range) * 65535;
             life_time = dmMath::Clamp(life_time, 0.0f, 65535.0f);
             uint16_t lt = (uint16_t) life_time;
             SortKey key;
-            key.m_LifeTime = lt;
-            key.m_Index = index;
+            key.m_Key = lt;
             p->SetSortKey(key);
+            sorted = sorted && lt >= prev_lt;
+            prev_lt = lt;
         }
+        return sorted;
     }
 
+    // Stable sort on the life time of the keys. The particle indices are sorted with a two pass radix sort, after
+    // which the particles are moved into place by following the cycles of the permutation.
     void SortParticles(Emitter* emitter)
     {
         DM_PROFILE(__FUNCTION__);
 
-        std::sort(emitter->m_Particles.Begin(), emitter->m_Particles.End(), SortPred());
+        dmArray<Particle>& particles = emitter->m_Particles;
+        uint32_t n = particles.Size();
+        dmArray<uint32_t>& buffer = emitter->m_SortBuffer;
+        if (buffer.Capacity() < n * 3)
+        {
+            buffer.SetCapacity(dmMath::Max(n, particles.Capacity()) * 3);
+        }
+        buffer.SetSize(n * 3);
+        uint32_t* keys = buffer.Begin();
+        uint32_t* tmp = keys + n;
+        uint32_t* order = tmp + n;
+
+        uint32_t low_offsets[256];
+        uint32_t high_offsets[256];
+        memset(low_offsets, 0, sizeof(low_offsets));
+        memset(high_offsets, 0, sizeof(high_offsets));
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            uint32_t key = particles[i].GetSortKey().m_LifeTime;
+            keys[i] = key;
+            ++low_offsets[key & 0xff];
+            ++high_offsets[key >> 8];
+        }
+        uint32_t low_sum = 0;
+        uint32_t high_sum = 0;
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t low_count = low_offsets[i];
+            uint32_t high_count = high_offsets[i];
+            low_offsets[i] = low_sum;
+            high_offsets[i] = high_sum;
+            low_sum += low_count;
+            high_sum += high_count;
+        }
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            tmp[low_offsets[keys[i] & 0xff]++] = i;
+        }
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            uint32_t index = tmp[i];
+            order[high_offsets[keys[index] >> 8]++] = index;
+        }
+
+        // order[i] is the index of the particle to move to i, and is set to i once moved
+        Particle* p = particles.Begin();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (order[i] == i)
+                continue;
+            Particle tmp_particle = p[i];
+            uint32_t j = i;
+            while (true)
+            {
+                uint32_t k = order[j];
+                order[j] = j;
+                if (k == i)
+                {
+                    p[j] = tmp_particle;
+                    break;
+                }
+                p[j] = p[k];
+                j = k;
+            }
+        }
     }
 
 #define SAMPLE_PROP(segment, x, target)\
@@ -1298,13 +1725,108 @@ namespace dmParticle
         }
     }
 
-    void EvaluateParticleProperties(Emitter* emitter, Property* particle_properties, dmParticleDDF::Emitter* emitter_ddf, float dt)
+#if defined(DM_SIMD)
+    // Samples a property for four particles, with the segment indices calculated from x
+    static inline Float4 SampleProperty4(const Property& property, const uint32_t* segment_indices, Float4 x)
+    {
+        // NOTE Four floats are loaded for each three float segment, which is safe since the segments are followed by the spread
+        Float4 seg_x = dmSimd::Load(&property.m_Segments[segment_indices[0]].m_X);
+        Float4 seg_y = dmSimd::Load(&property.m_Segments[segment_indices[1]].m_X);
+        Float4 seg_k = dmSimd::Load(&property.m_Segments[segment_indices[2]].m_X);
+        Float4 unused = dmSimd::Load(&property.m_Segments[segment_indices[3]].m_X);
+        dmSimd::Transpose(seg_x, seg_y, seg_k, unused);
+        return dmSimd::Add(dmSimd::Mul(dmSimd::Sub(x, seg_x), seg_k), seg_y);
+    }
+
+    // Relative life time of four particles, and the property segments to sample
+    static inline Float4 CalcLifeTime4(const Particle* particles, uint32_t segment_indices[4])
+    {
+        const Float4 zero = dmSimd::Splat(0.0f);
+        const Float4 one = dmSimd::Splat(1.0f);
+
+        Float4 time_left, max_life_time, oo_max_life_time, spread_factor;
+        LOAD_PARTICLES(particles, m_TimeLeft, time_left, max_life_time, oo_max_life_time, spread_factor);
+        // Zero when the max life time is not positive, see dmMath::Select
+        Float4 x = dmSimd::And(dmSimd::CmpLt(zero, max_life_time), dmSimd::Sub(one, dmSimd::Mul(time_left, oo_max_life_time)));
+
+        float xs[4];
+        dmSimd::Store(xs, x);
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            segment_indices[i] = dmMath::Min((uint32_t)(xs[i] * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
+        }
+        return x;
+    }
+
+    // Same as the first loop of EvaluateParticleProperties, for four particles
+    static inline void EvaluateParticleProperties4(Particle* particles, Property* particle_properties)
+    {
+        const Float4 zero = dmSimd::Splat(0.0f);
+        const Float4 one = dmSimd::Splat(1.0f);
+
+        uint32_t segment_indices[4];
+        Float4 x = CalcLifeTime4(particles, segment_indices);
+
+        Float4 scale = SampleProperty4(particle_properties[PARTICLE_KEY_SCALE], segment_indices, x);
+        dmSimd::Store((float*)&particles[0].m_Scale, dmSimd::SplatLane<0>(scale));
+        dmSimd::Store((float*)&particles[1].m_Scale, dmSimd::SplatLane<1>(scale));
+        dmSimd::Store((float*)&particles[2].m_Scale, dmSimd::SplatLane<2>(scale));
+        dmSimd::Store((float*)&particles[3].m_Scale, dmSimd::SplatLane<3>(scale));
+
+        // Clamp to [0, 1], with the same operand order as dmMath::Clamp
+        Float4 r, g, b, a;
+        LOAD_PARTICLES(particles, m_SourceColor, r, g, b, a);
+        r = dmSimd::Min(one, dmSimd::Max(zero, dmSimd::Mul(r, SampleProperty4(particle_properties[PARTICLE_KEY_RED], segment_indices, x))));
+        g = dmSimd::Min(one, dmSimd::Max(zero, dmSimd::Mul(g, SampleProperty4(particle_properties[PARTICLE_KEY_GREEN], segment_indices, x))));
+        b = dmSimd::Min(one, dmSimd::Max(zero, dmSimd::Mul(b, SampleProperty4(particle_properties[PARTICLE_KEY_BLUE], segment_indices, x))));
+        a = dmSimd::Min(one, dmSimd::Max(zero, dmSimd::Mul(a, SampleProperty4(particle_properties[PARTICLE_KEY_ALPHA], segment_indices, x))));
+        STORE_PARTICLES(particles, m_Color, r, g, b, a);
+
+        Float4 source_size, source_stretch_x, source_stretch_y, unused;
+        LOAD_PARTICLES(particles, m_SourceSize, source_size, source_stretch_x, source_stretch_y, unused);
+        Float4 sort_key, stretch_x, stretch_y, source_angular_velocity;
+        LOAD_PARTICLES(particles, m_SortKey, sort_key, stretch_x, stretch_y, source_angular_velocity);
+        stretch_x = dmSimd::Add(source_stretch_x, SampleProperty4(particle_properties[PARTICLE_KEY_STRETCH_FACTOR_X], segment_indices, x));
+        stretch_y = dmSimd::Add(source_stretch_y, SampleProperty4(particle_properties[PARTICLE_KEY_STRETCH_FACTOR_Y], segment_indices, x));
+        STORE_PARTICLES(particles, m_SortKey, sort_key, stretch_x, stretch_y, source_angular_velocity);
+    }
+
+    // Same as the rotation over life time loop of EvaluateParticleProperties, for four particles
+    static inline void EvaluateParticleRotation4(Particle* particles, const Property& rotation_property)
+    {
+        uint32_t segment_indices[4];
+        Float4 x = CalcLifeTime4(particles, segment_indices);
+        Float4 rotation = SampleProperty4(rotation_property, segment_indices, x);
+
+        // See QuatFromAngle, the trig lookups are done per particle
+        float half_angles[4];
+        dmSimd::Store(half_angles, dmSimd::Mul(dmSimd::Splat(0.5f), dmSimd::Mul(dmSimd::Splat(DEG_RAD), rotation)));
+        Float4 s = dmSimd::Set(dmTrigLookup::Sin(half_angles[0]), dmTrigLookup::Sin(half_angles[1]), dmTrigLookup::Sin(half_angles[2]), dmTrigLookup::Sin(half_angles[3]));
+        Float4 c = dmSimd::Set(dmTrigLookup::Cos(half_angles[0]), dmTrigLookup::Cos(half_angles[1]), dmTrigLookup::Cos(half_angles[2]), dmTrigLookup::Cos(half_angles[3]));
+        const Float4 zero = dmSimd::Splat(0.0f);
+
+        // Source rotation * (0, 0, s, c)
+        Float4 qx, qy, qz, qw;
+        LOAD_PARTICLES(particles, m_SourceRotation, qx, qy, qz, qw);
+        Float4 rx = dmSimd::Sub(dmSimd::Add(dmSimd::Add(dmSimd::Mul(qw, zero), dmSimd::Mul(qx, c)), dmSimd::Mul(qy, s)), dmSimd::Mul(qz, zero));
+        Float4 ry = dmSimd::Sub(dmSimd::Add(dmSimd::Add(dmSimd::Mul(qw, zero), dmSimd::Mul(qy, c)), dmSimd::Mul(qz, zero)), dmSimd::Mul(qx, s));
+        Float4 rz = dmSimd::Sub(dmSimd::Add(dmSimd::Add(dmSimd::Mul(qw, s), dmSimd::Mul(qz, c)), dmSimd::Mul(qx, zero)), dmSimd::Mul(qy, zero));
+        Float4 rw = dmSimd::Sub(dmSimd::Sub(dmSimd::Sub(dmSimd::Mul(qw, c), dmSimd::Mul(qx, zero)), dmSimd::Mul(qy, zero)), dmSimd::Mul(qz, s));
+        STORE_PARTICLES(particles, m_Rotation, rx, ry, rz, rw);
+    }
+#endif
+
+    void EvaluateParticleProperties(Particle* particles, uint32_t count, Property* particle_properties, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
         float properties[PARTICLE_KEY_COUNT];
-        // TODO Optimize this
-        dmArray<Particle>& particles = emitter->m_Particles;
-        uint32_t count = particles.Size();
-        for (uint32_t i = 0; i < count; ++i)
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        for (uint32_t simd_count = SimdCount(count); i < simd_count; i += 4)
+        {
+            EvaluateParticleProperties4(&particles[i], particle_properties);
+        }
+#endif
+        for (; i < count; ++i)
         {
             Particle* particle = &particles[i];
             float x = dmMath::Select(-particle->GetMaxLifeTime(), 0.0f, 1.0f - particle->GetTimeLeft() * particle->GetooMaxLifeTime());
@@ -1357,7 +1879,14 @@ namespace dmParticle
             }
 
         } else {
-            for (uint32_t i = 0; i < count; ++i)
+            uint32_t i = 0;
+#if defined(DM_SIMD)
+            for (uint32_t simd_count = SimdCount(count); i < simd_count; i += 4)
+            {
+                EvaluateParticleRotation4(&particles[i], particle_properties[PARTICLE_KEY_ROTATION]);
+            }
+#endif
+            for (; i < count; ++i)
             {
                 Particle* particle = &particles[i];
                 float x = dmMath::Select(-particle->GetMaxLifeTime(), 0.0f, 1.0f - particle->GetTimeLeft() * particle->GetooMaxLifeTime());
@@ -1369,32 +1898,85 @@ namespace dmParticle
 
     }
 
-    void ApplyAcceleration(dmArray<Particle>& particles, Property* modifier_properties, const Quat& rotation, float scale, float emitter_t, float dt)
+    void ApplyAcceleration(Particle* particles, uint32_t particle_count, Property* modifier_properties, const Quat& rotation, float scale, float emitter_t, float dt)
     {
-        uint32_t particle_count = particles.Size();
         Vector3 acc_step = rotate(rotation, ACCELERATION_LOCAL_DIR) * dt * scale;
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
         float mag_spread = magnitude_property.m_Spread;
-        for (uint32_t i = 0; i < particle_count; ++i)
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        Float4 acc_x = dmSimd::Splat(acc_step.getX());
+        Float4 acc_y = dmSimd::Splat(acc_step.getY());
+        Float4 acc_z = dmSimd::Splat(acc_step.getZ());
+        Float4 magnitude4 = dmSimd::Splat(magnitude);
+        Float4 mag_spread4 = dmSimd::Splat(mag_spread);
+        for (uint32_t simd_count = SimdCount(particle_count); i < simd_count; i += 4)
+        {
+            Particle* p = &particles[i];
+            Float4 time_left, max_life_time, oo_max_life_time, spread_factor;
+            LOAD_PARTICLES(p, m_TimeLeft, time_left, max_life_time, oo_max_life_time, spread_factor);
+            Float4 vx, vy, vz, vw;
+            LOAD_PARTICLES(p, m_Velocity, vx, vy, vz, vw);
+            Float4 f = dmSimd::Add(magnitude4, dmSimd::Mul(mag_spread4, spread_factor));
+            vx = dmSimd::Add(vx, dmSimd::Mul(acc_x, f));
+            vy = dmSimd::Add(vy, dmSimd::Mul(acc_y, f));
+            vz = dmSimd::Add(vz, dmSimd::Mul(acc_z, f));
+            STORE_PARTICLES(p, m_Velocity, vx, vy, vz, vw);
+        }
+#endif
+        for (; i < particle_count; ++i)
         {
             Particle* particle = &particles[i];
             particle->SetVelocity(particle->GetVelocity() + acc_step * (magnitude + mag_spread * particle->GetSpreadFactor()));
         }
     }
 
-    void ApplyDrag(dmArray<Particle>& particles, Property* modifier_properties, dmParticleDDF::Modifier* modifier_ddf, const Quat& rotation, float emitter_t, float dt)
+    void ApplyDrag(Particle* particles, uint32_t particle_count, Property* modifier_properties, dmParticleDDF::Modifier* modifier_ddf, const Quat& rotation, float emitter_t, float dt)
     {
-        uint32_t particle_count = particles.Size();
         Vector3 direction = rotate(rotation, DRAG_LOCAL_DIR);
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
         float mag_spread = magnitude_property.m_Spread;
-        for (uint32_t i = 0; i < particle_count; ++i)
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        bool use_direction = modifier_ddf->m_UseDirection != 0;
+        Float4 dir_x = dmSimd::Splat(direction.getX());
+        Float4 dir_y = dmSimd::Splat(direction.getY());
+        Float4 dir_z = dmSimd::Splat(direction.getZ());
+        Float4 magnitude4 = dmSimd::Splat(magnitude);
+        Float4 mag_spread4 = dmSimd::Splat(mag_spread);
+        Float4 dt4 = dmSimd::Splat(dt);
+        const Float4 one = dmSimd::Splat(1.0f);
+        for (uint32_t simd_count = SimdCount(particle_count); i < simd_count; i += 4)
+        {
+            Particle* p = &particles[i];
+            Float4 time_left, max_life_time, oo_max_life_time, spread_factor;
+            LOAD_PARTICLES(p, m_TimeLeft, time_left, max_life_time, oo_max_life_time, spread_factor);
+            Float4 vx, vy, vz, vw;
+            LOAD_PARTICLES(p, m_Velocity, vx, vy, vz, vw);
+            Float4 dx = vx;
+            Float4 dy = vy;
+            Float4 dz = vz;
+            if (use_direction)
+            {
+                Float4 proj = dmSimd::Add(dmSimd::Add(dmSimd::Mul(vx, dir_x), dmSimd::Mul(vy, dir_y)), dmSimd::Mul(vz, dir_z));
+                dx = dmSimd::Mul(dir_x, proj);
+                dy = dmSimd::Mul(dir_y, proj);
+                dz = dmSimd::Mul(dir_z, proj);
+            }
+            Float4 applied_drag = dmSimd::Min(dmSimd::Mul(dmSimd::Add(magnitude4, dmSimd::Mul(mag_spread4, spread_factor)), dt4), one);
+            vx = dmSimd::Sub(vx, dmSimd::Mul(dx, applied_drag));
+            vy = dmSimd::Sub(vy, dmSimd::Mul(dy, applied_drag));
+            vz = dmSimd::Sub(vz, dmSimd::Mul(dz, applied_drag));
+            STORE_PARTICLES(p, m_Velocity, vx, vy, vz, vw);
+        }
+#endif
+        for (; i < particle_count; ++i)
         {
             Particle* particle = &particles[i];
             Vector3 v = particle->GetVelocity();
@@ -1421,9 +2003,8 @@ namespace dmParticle
         return result;
     }
 
-    void ApplyRadial(dmArray<Particle>& particles, Property* modifier_properties, const Point3& position, float scale, float emitter_t, float dt)
+    void ApplyRadial(Particle* particles, uint32_t particle_count, Property* modifier_properties, const Point3& position, float scale, float emitter_t, float dt)
     {
-        uint32_t particle_count = particles.Size();
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         const Property& max_distance_property = modifier_properties[MODIFIER_KEY_MAX_DISTANCE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
@@ -1447,9 +2028,8 @@ namespace dmParticle
         }
     }
 
-    void ApplyVortex(dmArray<Particle>& particles, Property* modifier_properties, const Point3& position, const Quat& rotation, float scale, float emitter_t, float dt)
+    void ApplyVortex(Particle* particles, uint32_t particle_count, Property* modifier_properties, const Point3& position, const Quat& rotation, float scale, float emitter_t, float dt)
     {
-        uint32_t particle_count = particles.Size();
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         const Property& max_distance_property = modifier_properties[MODIFIER_KEY_MAX_DISTANCE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
@@ -1503,53 +2083,40 @@ namespace dmParticle
         return emitter_ddf->m_Rotation * modifier_ddf->m_Rotation;
     }
 
-    void Simulate(Instance* instance, Emitter* emitter, EmitterPrototype* prototype, dmParticleDDF::Emitter* ddf, float dt)
+    static void Integrate(Particle* particles, uint32_t particle_count, bool stretch_with_velocity, float dt)
     {
-        DM_PROFILE(__FUNCTION__);
-
-        dmArray<Particle>& particles = emitter->m_Particles;
-        EvaluateParticleProperties(emitter, prototype->m_ParticleProperties, ddf, dt);
-        float emitter_t = dmMath::Select(-ddf->m_Duration, 0.0f, emitter->m_Timer / ddf->m_Duration);
-        float scale = 1.0f;
-        if (ddf->m_Space == EMISSION_SPACE_WORLD)
-            scale = instance->m_WorldTransform.GetScale();
-        // Apply modifiers
-        uint32_t modifier_count = prototype->m_Modifiers.Size();
-        for (uint32_t i = 0; i < modifier_count; ++i)
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        Float4 dt4 = dmSimd::Splat(dt);
+        Float4 stretch_scaling = dmSimd::Splat(STRETCH_SCALING);
+        for (uint32_t simd_count = SimdCount(particle_count); i < simd_count; i += 4)
         {
-            ModifierPrototype* modifier = &prototype->m_Modifiers[i];
-            dmParticleDDF::Modifier* modifier_ddf = &ddf->m_Modifiers[i];
-            switch (modifier_ddf->m_Type)
+            Particle* p = &particles[i];
+            Float4 px, py, pz, pw;
+            LOAD_PARTICLES(p, m_Position, px, py, pz, pw);
+            Float4 vx, vy, vz, vw;
+            LOAD_PARTICLES(p, m_Velocity, vx, vy, vz, vw);
+            px = dmSimd::Add(px, dmSimd::Mul(vx, dt4));
+            py = dmSimd::Add(py, dmSimd::Mul(vy, dt4));
+            pz = dmSimd::Add(pz, dmSimd::Mul(vz, dt4));
+            STORE_PARTICLES(p, m_Position, px, py, pz, pw);
+
+            Float4 sx, sy, sz, sw;
+            LOAD_PARTICLES(p, m_Scale, sx, sy, sz, sw);
+            Float4 sort_key, stretch_x, stretch_y, source_angular_velocity;
+            LOAD_PARTICLES(p, m_SortKey, sort_key, stretch_x, stretch_y, source_angular_velocity);
+            sx = dmSimd::Add(sx, dmSimd::Mul(sx, stretch_x));
+            Float4 stretch = dmSimd::Mul(sy, stretch_y);
+            if (stretch_with_velocity)
             {
-            case dmParticleDDF::MODIFIER_TYPE_ACCELERATION:
-                {
-                    Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
-                    ApplyAcceleration(particles, modifier->m_Properties, rotation, scale, emitter_t, dt);
-                }
-                break;
-            case dmParticleDDF::MODIFIER_TYPE_DRAG:
-                {
-                    Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
-                    ApplyDrag(particles, modifier->m_Properties, modifier_ddf, rotation, emitter_t, dt);
-                }
-                break;
-            case dmParticleDDF::MODIFIER_TYPE_RADIAL:
-                {
-                    Point3 position = CalculateModifierPosition(instance, ddf, modifier_ddf);
-                    ApplyRadial(particles, modifier->m_Properties, position, scale, emitter_t, dt);
-                }
-                break;
-            case dmParticleDDF::MODIFIER_TYPE_VORTEX:
-                {
-                    Point3 position = CalculateModifierPosition(instance, ddf, modifier_ddf);
-                    Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
-                    ApplyVortex(particles, modifier->m_Properties, position, rotation, scale, emitter_t, dt);
-                }
-                break;
+                Float4 speed = dmSimd::Sqrt(dmSimd::Add(dmSimd::Add(dmSimd::Mul(vx, vx), dmSimd::Mul(vy, vy)), dmSimd::Mul(vz, vz)));
+                stretch = dmSimd::Mul(dmSimd::Mul(stretch, speed), stretch_scaling);
             }
+            sy = dmSimd::Add(sy, stretch);
+            STORE_PARTICLES(p, m_Scale, sx, sy, sz, sw);
         }
-        uint32_t particle_count = particles.Size();
-        for (uint32_t i = 0; i < particle_count; ++i)
+#endif
+        for (; i < particle_count; ++i)
         {
             Particle* p = &particles[i];
             // NOTE This velocity integration has a larger error than normal since we don't use the velocity at the
@@ -1557,13 +2124,75 @@ namespace dmParticle
             p->SetPosition(p->GetPosition() + p->m_Velocity * dt);
 
             p->m_Scale[0] += p->m_Scale[0] * p->m_StretchFactorX;
-            if (!ddf->m_StretchWithVelocity)
+            if (!stretch_with_velocity)
                 p->m_Scale[1] += p->m_Scale[1] * p->m_StretchFactorY;
             else
                 p->m_Scale[1] += p->m_Scale[1] * p->m_StretchFactorY * length(p->m_Velocity) * STRETCH_SCALING;
         }
     }
 
+    void Simulate(Instance* instance, Emitter* emitter, EmitterPrototype* prototype, dmParticleDDF::Emitter* ddf, float dt)
+    {
+        DM_PROFILE(__FUNCTION__);
+
+        float emitter_t = dmMath::Select(-ddf->m_Duration, 0.0f, emitter->m_Timer / ddf->m_Duration);
+        float scale = 1.0f;
+        if (ddf->m_Space == EMISSION_SPACE_WORLD)
+            scale = instance->m_WorldTransform.GetScale();
+        uint32_t modifier_count = prototype->m_Modifiers.Size();
+        bool stretch_with_velocity = ddf->m_StretchWithVelocity != 0;
+
+        // The particles are simulated in blocks, small enough to stay in the cache between the passes
+        uint32_t particle_count = emitter->m_Particles.Size();
+        for (uint32_t block = 0; block < particle_count; block += SIMULATE_BLOCK_SIZE)
+        {
+            Particle* particles = &emitter->m_Particles[block];
+            uint32_t count = dmMath::Min(SIMULATE_BLOCK_SIZE, particle_count - block);
+
+            EvaluateParticleProperties(particles, count, prototype->m_ParticleProperties, ddf, dt);
+
+            // Apply modifiers
+            for (uint32_t i = 0; i < modifier_count; ++i)
+            {
+                ModifierPrototype* modifier = &prototype->m_Modifiers[i];
+                dmParticleDDF::Modifier* modifier_ddf = &ddf->m_Modifiers[i];
+                switch (modifier_ddf->m_Type)
+                {
+                case dmParticleDDF::MODIFIER_TYPE_ACCELERATION:
+                    {
+                        Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
+                        ApplyAcceleration(particles, count, modifier->m_Properties, rotation, scale, emitter_t, dt);
+                    }
+                    break;
+                case dmParticleDDF::MODIFIER_TYPE_DRAG:
+                    {
+                        Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
+                        ApplyDrag(particles, count, modifier->m_Properties, modifier_ddf, rotation, emitter_t, dt);
+                    }
+                    break;
+                case dmParticleDDF::MODIFIER_TYPE_RADIAL:
+                    {
+                        Point3 position = CalculateModifierPosition(instance, ddf, modifier_ddf);
+                        ApplyRadial(particles, count, modifier->m_Properties, position, scale, emitter_t, dt);
+                    }
+                    break;
+                case dmParticleDDF::MODIFIER_TYPE_VORTEX:
+                    {
+                        Point3 position = CalculateModifierPosition(instance, ddf, modifier_ddf);
+                        Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
+                        ApplyVortex(particles, count, modifier->m_Properties, position, rotation, scale, emitter_t, dt);
+                    }
+                    break;
+                }
+            }
+
+            Integrate(particles, count, stretch_with_velocity, dt);
+        }
+    }
+
+#undef LOAD_PARTICLES
+#undef STORE_PARTICLES
+
     void DebugRender(HParticleContext context, void* user_context, RenderLineCallback render_line_callback)
     {
         uint32_t instance_count = context->m_Instances.Size();
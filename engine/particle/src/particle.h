@@ -18,6 +18,7 @@
 #include <dmsdk/dlib/vmath.h>
 #include <dlib/configfile.h>
 #include <dlib/hash.h>
+#include <dlib/job_pool.h>
 #include <ddf/ddf.h>
 #include "particle/particle_ddf.h"
 
@@ -268,6 +269,15 @@ namespace dmParticle
      */
     DM_PARTICLE_PROTO(void, SetContextMaxParticleCount, HParticleContext context, uint32_t max_particle_count);
 
+    /**
+     * Set the job pool used to update the emitters of the context in parallel.
+     * The calling thread takes part in the work. Emitters are updated on the calling thread
+     * when the pool is 0x0, which is the default.
+     * @param context Context to update.
+     * @param pool Job pool, or 0x0
+     */
+    void SetContextJobPool(HParticleContext context, dmJobPool::HJobPool pool);
+
     /**
      * Create an instance from the supplied path and fetch resources using the supplied factory.
      * @param context Context in which to create the instance, must be valid.
@@ -382,6 +392,34 @@ namespace dmParticle
      */
     DM_PARTICLE_PROTO(void, GenerateVertexData, HParticleContext context, float dt, HInstance instance, uint32_t emitter_index, const dmVMath::Vector4& color, void* vertex_buffer, uint32_t vertex_buffer_size, uint32_t* out_vertex_buffer_size, ParticleVertexFormat vertex_format);
 
+    /**
+     * Emitter to generate vertex data for, see GenerateVertexDataBatch
+     */
+    struct EmitterVertexRequest
+    {
+        /// Color multiplied with the particle colors
+        dmVMath::Vector4 m_Color;
+        /// Particle instance handle
+        HInstance        m_Instance;
+        /// Emitter index for which to generate vertex data for
+        uint32_t         m_EmitterIndex;
+    };
+
+    /**
+     * Generates vertex data for several emitters, with the same result as calling GenerateVertexData for each of them in order.
+     * Each emitter is given its own range of the vertex buffer, sized from GetEmitterVertexCount, which
+     * lets the emitters be generated in parallel when the context has a worker pool. An emitter may only be requested once.
+     * @param context Particle context
+     * @param dt Time step.
+     * @param requests Emitters to generate vertex data for
+     * @param request_count Number of emitters
+     * @param vertex_buffer Vertex buffer into which to store the particle vertex data. If this is 0x0, no data will be generated.
+     * @param vertex_buffer_size Size in bytes of the supplied vertex buffer.
+     * @param out_vertex_buffer_size Size in bytes of the total data written to vertex buffer.
+     * @param vertex_format Which vertex format to use
+     */
+    void GenerateVertexDataBatch(HParticleContext context, float dt, const EmitterVertexRequest* requests, uint32_t request_count, void* vertex_buffer, uint32_t vertex_buffer_size, uint32_t* out_vertex_buffer_size, ParticleVertexFormat vertex_format);
+
     /**
      * Debug render the status of the instances within the specified context.
      * @param context Context of the instances to render.
@@ -21,6 +21,7 @@
 #include <dlib/transform.h>
 
 #include "particle/particle_ddf.h"
+#include "particle.h"
 
 namespace dmParticle
 {
@@ -31,14 +32,14 @@ namespace dmParticle
     struct Prototype;
 
     /**
-     * Key when sorting particles, based on life time with additional index for stable sort
+     * Key when sorting particles, based on life time. The sort is stable, so only the life time is compared.
      */
     union SortKey
     {
         struct
         {
-            uint32_t m_Index : 16;  // Index is used to ensure stable sort
             uint32_t m_LifeTime : 16; // Quantified relative life time
+            uint32_t : 16;
         };
         uint32_t     m_Key;
     };
@@ -46,6 +47,9 @@ namespace dmParticle
     /**
      * Representation of a particle.
      *
+     * NOTE The simulation kernels load m_TimeLeft - m_SpreadFactor, m_SourceSize - m_SourceStretchFactorY and
+     * m_SortKey - m_SourceAngularVelocity as groups of four floats, see particle.cpp.
+     *
      * TODO Separate source state from current (chaining modifiers)
      */
     struct Particle
@@ -117,6 +121,8 @@ namespace dmParticle
         /// Particle buffer.
         dmArray<Particle>       m_Particles;
         dmArray<RenderConstant> m_RenderConstants;
+        /// Scratch buffer used when sorting the particles
+        dmArray<uint32_t>       m_SortBuffer;
         dmVMath::Vector3        m_Velocity;
         dmVMath::Point3         m_LastPosition;
         dmhash_t                m_Id;
@@ -183,13 +189,41 @@ namespace dmParticle
         uint16_t                m_ScaleAlongZ : 1;
     };
 
+    /**
+     * Emitter updated by Update. The simulation of the particles is run as a separate job for each emitter.
+     */
+    struct EmitterJob
+    {
+        Instance*               m_Instance;
+        Emitter*                m_Emitter;
+        EmitterPrototype*       m_Prototype;
+        dmParticleDDF::Emitter* m_DDF;
+        HInstance               m_InstanceHandle;
+        uint32_t                m_EmitterIndex;
+        /// If the particles should be simulated this frame
+        uint32_t                m_Simulate : 1;
+    };
+
+    /**
+     * Emitter to generate vertex data for in GenerateVertexDataBatch, at a precalculated vertex index.
+     */
+    struct VertexJob
+    {
+        dmVMath::Vector4        m_Color;
+        Instance*               m_Instance;
+        Emitter*                m_Emitter;
+        dmParticleDDF::Emitter* m_DDF;
+        uint32_t                m_VertexIndex;
+    };
+
     /**
      * Representation of a context to hold a set of emitters.
      */
     struct Context
     {
         Context(uint32_t max_instance_count, uint32_t max_particle_count)
-        : m_MaxParticleCount(max_particle_count)
+        : m_JobPool(0x0)
+        , m_MaxParticleCount(max_particle_count)
         , m_NextVersionNumber(1)
         , m_InstanceSeeding(0)
         {
@@ -212,6 +246,12 @@ namespace dmParticle
         dmArray<Instance*>  m_Instances;
         /// Index pool used to index the instance buffer.
         dmIndexPool16       m_InstanceIndexPool;
+        /// Emitters updated in the current frame, reused between frames
+        dmArray<EmitterJob> m_EmitterJobs;
+        /// Emitters to generate vertex data for, reused between calls
+        dmArray<VertexJob>  m_VertexJobs;
+        /// Job pool used to update the emitters, 0x0 to update them on the calling thread
+        dmJobPool::HJobPool m_JobPool;
         /// Maximum number of particles allowed
         uint32_t            m_MaxParticleCount;
         /// Version number used to create new handles.
@@ -288,6 +328,12 @@ namespace dmParticle
     };
 
     void UpdateRenderData(HParticleContext context, HInstance instance, uint32_t emitter_index);
+
+    /**
+     * Enables or disables the four-wide simulation and vertex kernels. Used by the tests to compare
+     * them with the scalar code, which always runs when DM_SIMD isn't defined.
+     */
+    void SetSimdEnabled(bool enabled);
 }
 
 #endif // DM_PARTICLE_PRIVATE_H
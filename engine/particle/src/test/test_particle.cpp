@@ -21,6 +21,7 @@
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/time.h>
 #include <dlib/vmath.h>
 
 #include <ddf/ddf.h>
@@ -170,6 +171,12 @@ uint32_t ParticleCount(dmParticle::Emitter* emitter)
     return emitter->m_Particles.Size();
 }
 
+// True when the tests to run were selected with --test-filter
+bool IsSelectedByFilter()
+{
+    return jc_test_get_state()->num_filter_patterns > 0;
+}
+
 bool LoadPrototype(const char* filename, dmParticle::HPrototype* prototype)
 {
     char path[128];
@@ -1510,6 +1517,42 @@ TEST_F(ParticleTest, StableSort)
     dmParticle::DestroyInstance(m_Context, instance);
 }
 
+// Particles spawned with different life times are kept in order, except for additive emitters which are not sorted
+TEST_F(ParticleTest, SortSpawnedParticles)
+{
+    float dt = 1.0f / 60.0f;
+
+    ASSERT_TRUE(LoadPrototype("sort_spawned.particlefxc", &m_Prototype));
+    dmParticle::HInstance instance = dmParticle::CreateInstance(m_Context, m_Prototype, 0x0);
+    dmParticle::StartInstance(m_Context, instance);
+
+    dmParticle::Emitter* alpha_emitter = GetEmitter(m_Context, instance, 0);
+    dmParticle::Emitter* add_emitter = GetEmitter(m_Context, instance, 1);
+    for (uint32_t frame = 0; frame < 60; ++frame)
+    {
+        dmParticle::Update(m_Context, dt, 0x0);
+
+        uint32_t particle_count = ParticleCount(alpha_emitter);
+        ASSERT_LT(0u, particle_count);
+        dmParticle::Particle* p = alpha_emitter->m_Particles.Begin();
+        for (uint32_t i = 1; i < particle_count; ++i)
+        {
+            ASSERT_LE(p[i - 1].GetSortKey().m_LifeTime, p[i].GetSortKey().m_LifeTime);
+            ASSERT_GE(p[i - 1].GetTimeLeft(), p[i].GetTimeLeft());
+        }
+
+        particle_count = ParticleCount(add_emitter);
+        ASSERT_LT(0u, particle_count);
+        p = add_emitter->m_Particles.Begin();
+        for (uint32_t i = 0; i < particle_count; ++i)
+        {
+            ASSERT_EQ(0u, p[i].GetSortKey().m_Key);
+        }
+    }
+
+    dmParticle::DestroyInstance(m_Context, instance);
+}
+
 TEST_F(ParticleTest, ReloadPrototype)
 {
     ASSERT_TRUE(LoadPrototype("reload1.particlefxc", &m_Prototype));
@@ -2094,6 +2137,223 @@ TEST_F(ParticleTest, Stats)
     dmParticle::DestroyInstance(m_Context, instance);
 }
 
+// Updating with a job pool, and generating the vertex data in a batch, should give the same result as the serial update
+TEST_F(ParticleTest, JobPool)
+{
+    const uint32_t instance_count = 8;
+    const uint32_t emitter_count = 3;
+    const uint32_t max_particle_count = instance_count * 600;
+    float dt = 1.0f / 60.0f;
+
+    dmJobPool::HJobPool pool = dmJobPool::New(3);
+    ASSERT_NE((dmJobPool::HJobPool)0x0, pool);
+    dmParticle::HParticleContext contexts[2];
+    contexts[0] = dmParticle::CreateContext(64, max_particle_count);
+    contexts[1] = dmParticle::CreateContext(64, max_particle_count);
+    dmParticle::SetContextJobPool(contexts[1], pool);
+
+    uint32_t vertex_buffer_size = dmParticle::GetVertexBufferSize(max_particle_count, dmParticle::PARTICLE_GO);
+    uint8_t* vertex_buffers[2];
+    vertex_buffers[0] = new uint8_t[vertex_buffer_size];
+    vertex_buffers[1] = new uint8_t[vertex_buffer_size];
+
+    ASSERT_TRUE(LoadPrototype("parallel.particlefxc", &m_Prototype));
+    dmParticle::HInstance instances[2][instance_count];
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        for (uint32_t c = 0; c < 2; ++c)
+        {
+            dmParticle::HParticleContext context = contexts[c];
+            dmParticle::HInstance instance = dmParticle::CreateInstance(context, m_Prototype, 0x0);
+            dmParticle::SetPosition(context, instance, Point3(i * 10.0f, 0, 0));
+            dmParticle::SetRotation(context, instance, Quat::rotationZ(i * 0.5f));
+            instances[c][i] = instance;
+        }
+        // Same random sequences in both contexts
+        for (uint32_t e = 0; e < emitter_count; ++e)
+        {
+            dmParticle::Emitter* src = GetEmitter(contexts[0], instances[0][i], e);
+            dmParticle::Emitter* dst = GetEmitter(contexts[1], instances[1][i], e);
+            dst->m_OriginalSeed = src->m_OriginalSeed;
+            dst->m_Seed = src->m_Seed;
+            dst->m_Duration = src->m_Duration;
+            dst->m_StartDelay = src->m_StartDelay;
+            dst->m_SpawnRateSpread = src->m_SpawnRateSpread;
+        }
+        dmParticle::StartInstance(contexts[0], instances[0][i]);
+        dmParticle::StartInstance(contexts[1], instances[1][i]);
+    }
+
+    dmParticle::EmitterVertexRequest requests[instance_count * emitter_count];
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        for (uint32_t e = 0; e < emitter_count; ++e)
+        {
+            dmParticle::EmitterVertexRequest& request = requests[i * emitter_count + e];
+            request.m_Color = Vector4(1.0f, 0.5f, 1.0f, (e + 1) / (float)emitter_count);
+            request.m_Instance = instances[1][i];
+            request.m_EmitterIndex = e;
+        }
+    }
+
+    uint32_t total_size = 0;
+    for (uint32_t frame = 0; frame < 90; ++frame)
+    {
+        dmParticle::Update(contexts[0], dt, 0x0);
+        dmParticle::Update(contexts[1], dt, 0x0);
+
+        uint32_t out_sizes[2] = {0, 0};
+        for (uint32_t i = 0; i < instance_count * emitter_count; ++i)
+        {
+            dmParticle::GenerateVertexData(contexts[0], dt, instances[0][i / emitter_count], i % emitter_count, requests[i].m_Color, vertex_buffers[0], vertex_buffer_size, &out_sizes[0], dmParticle::PARTICLE_GO);
+        }
+        dmParticle::GenerateVertexDataBatch(contexts[1], dt, requests, instance_count * emitter_count, vertex_buffers[1], vertex_buffer_size, &out_sizes[1], dmParticle::PARTICLE_GO);
+
+        ASSERT_EQ(out_sizes[0], out_sizes[1]);
+        ASSERT_EQ(0, memcmp(vertex_buffers[0], vertex_buffers[1], out_sizes[0]));
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            for (uint32_t e = 0; e < emitter_count; ++e)
+            {
+                ASSERT_EQ(GetEmitter(contexts[0], instances[0][i], e)->m_State, GetEmitter(contexts[1], instances[1][i], e)->m_State);
+                ASSERT_EQ(GetEmitter(contexts[0], instances[0][i], e)->m_VertexIndex, GetEmitter(contexts[1], instances[1][i], e)->m_VertexIndex);
+                ASSERT_EQ(GetEmitter(contexts[0], instances[0][i], e)->m_VertexCount, GetEmitter(contexts[1], instances[1][i], e)->m_VertexCount);
+            }
+        }
+        total_size += out_sizes[0];
+    }
+    ASSERT_LT(0u, total_size);
+
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            dmParticle::DestroyInstance(contexts[c], instances[c][i]);
+        }
+        dmParticle::DestroyContext(contexts[c]);
+        delete [] vertex_buffers[c];
+    }
+    dmJobPool::Delete(pool);
+}
+
+/**
+ * Runs the four-wide kernels and the scalar code over the same particles, and expects bit identical vertices.
+ * The particle count isn't a multiple of four, so the scalar remainder loops run in both contexts.
+ */
+TEST_F(ParticleTest, SimdMatchesScalar)
+{
+    const uint32_t max_particle_count = 1023;
+    float dt = 1.0f / 60.0f;
+
+    dmParticle::HParticleContext contexts[2];
+    contexts[0] = dmParticle::CreateContext(64, max_particle_count);
+    contexts[1] = dmParticle::CreateContext(64, max_particle_count);
+
+    uint32_t vertex_buffer_size = dmParticle::GetVertexBufferSize(max_particle_count, dmParticle::PARTICLE_GO);
+    uint8_t* vertex_buffers[2];
+    vertex_buffers[0] = new uint8_t[vertex_buffer_size];
+    vertex_buffers[1] = new uint8_t[vertex_buffer_size];
+
+    ASSERT_TRUE(LoadPrototype("simd.particlefxc", &m_Prototype));
+    dmParticle::HInstance instances[2];
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        instances[c] = dmParticle::CreateInstance(contexts[c], m_Prototype, 0x0);
+        dmParticle::SetPosition(contexts[c], instances[c], Point3(10, 20, 0));
+        dmParticle::SetRotation(contexts[c], instances[c], Quat::rotationZ(0.5f));
+        dmParticle::SetScale(contexts[c], instances[c], 2.0f);
+    }
+    // Same random sequences in both contexts
+    dmParticle::Emitter* src = GetEmitter(contexts[0], instances[0], 0);
+    dmParticle::Emitter* dst = GetEmitter(contexts[1], instances[1], 0);
+    dst->m_OriginalSeed = src->m_OriginalSeed;
+    dst->m_Seed = src->m_Seed;
+    dst->m_Duration = src->m_Duration;
+    dst->m_StartDelay = src->m_StartDelay;
+    dst->m_SpawnRateSpread = src->m_SpawnRateSpread;
+    dmParticle::StartInstance(contexts[0], instances[0]);
+    dmParticle::StartInstance(contexts[1], instances[1]);
+
+    uint32_t max_count = 0;
+    for (uint32_t frame = 0; frame < 90; ++frame)
+    {
+        uint32_t out_sizes[2] = {0, 0};
+        for (uint32_t c = 0; c < 2; ++c)
+        {
+            dmParticle::SetSimdEnabled(c == 0);
+            dmParticle::Update(contexts[c], dt, 0x0);
+            dmParticle::GenerateVertexData(contexts[c], dt, instances[c], 0, Vector4(1,1,1,1), vertex_buffers[c], vertex_buffer_size, &out_sizes[c], dmParticle::PARTICLE_GO);
+        }
+        dmParticle::SetSimdEnabled(true);
+
+        ASSERT_EQ(out_sizes[0], out_sizes[1]);
+        ASSERT_EQ(0, memcmp(vertex_buffers[0], vertex_buffers[1], out_sizes[0]));
+        max_count = dmMath::Max(max_count, ParticleCount(GetEmitter(contexts[0], instances[0], 0)));
+    }
+    ASSERT_EQ(max_particle_count, max_count);
+
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        dmParticle::DestroyInstance(contexts[c], instances[c]);
+        dmParticle::DestroyContext(contexts[c]);
+        delete [] vertex_buffers[c];
+    }
+}
+
+/**
+ * Measures the update and vertex generation of a 100k particle emitter, with modifiers.
+ * Too slow for the default run, it only runs when selected, e.g. with --test-filter Bench
+ */
+TEST_F(ParticleTest, DISABLED_Bench)
+{
+    if (!IsSelectedByFilter())
+    {
+        SKIP();
+    }
+
+    const uint32_t particle_count = 100000;
+    const uint32_t frame_count = 30;
+    float dt = 1.0f / 60.0f;
+
+    dmParticle::HParticleContext context = dmParticle::CreateContext(64, particle_count);
+    uint32_t vertex_buffer_size = dmParticle::GetVertexBufferSize(particle_count, dmParticle::PARTICLE_GO);
+    uint8_t* vertex_buffer = new uint8_t[vertex_buffer_size];
+    uint32_t out_vertex_buffer_size = 0;
+
+    ASSERT_TRUE(LoadPrototype("bench.particlefxc", &m_Prototype));
+    dmParticle::HInstance instance = dmParticle::CreateInstance(context, m_Prototype, 0x0);
+    dmParticle::SetPosition(context, instance, Point3(10, 20, 0));
+    dmParticle::SetRotation(context, instance, Quat::rotationZ(0.5f));
+    dmParticle::StartInstance(context, instance);
+
+    // Spawn all particles
+    dmParticle::Update(context, dt, 0x0);
+    ASSERT_EQ(particle_count, ParticleCount(GetEmitter(context, instance, 0)));
+
+    uint64_t update_time = 0;
+    uint64_t render_time = 0;
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        uint64_t start = dmTime::GetTime();
+        dmParticle::Update(context, dt, 0x0);
+        uint64_t updated = dmTime::GetTime();
+        out_vertex_buffer_size = 0;
+        dmParticle::GenerateVertexData(context, dt, instance, 0, Vector4(1,1,1,1), vertex_buffer, vertex_buffer_size, &out_vertex_buffer_size, dmParticle::PARTICLE_GO);
+        uint64_t end = dmTime::GetTime();
+        update_time += updated - start;
+        render_time += end - updated;
+    }
+    ASSERT_EQ(particle_count * 6 * sizeof(dmParticle::Vertex), out_vertex_buffer_size);
+
+    uint64_t particle_frames = (uint64_t)particle_count * frame_count;
+    printf("Bench update: %.3f ms/frame (%.0f particles/ms)\n", update_time / (1000.0 * frame_count), particle_frames / dmMath::Max(update_time / 1000.0, 0.001));
+    printf("Bench render: %.3f ms/frame (%.0f particles/ms)\n", render_time / (1000.0 * frame_count), particle_frames / dmMath::Max(render_time / 1000.0, 0.001));
+
+    dmParticle::DestroyInstance(context, instance);
+    dmParticle::DestroyContext(context);
+    delete [] vertex_buffer;
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -20,6 +20,7 @@
 #include <dmsdk/dlib/vmath.h>
 
 #include <dlib/hash.h>
+#include <dlib/job_pool.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
 
@@ -128,6 +129,29 @@ namespace dmPhysics
      */
     typedef void (*SetWorldTransformCallback)(void* user_data, const dmVMath::Point3& position, const dmVMath::Quat& rotation);
 
+    /**
+     * Transform of a 2D body, as exchanged in batches with the external objects.
+     */
+    struct BodyTransform2D
+    {
+        /// User data pointing to the external object
+        void*   m_UserData;
+        /// Position of the body in the xy-plane
+        float   m_X;
+        float   m_Y;
+        /// Rotation of the body around the z-axis, in radians
+        float   m_Angle;
+    };
+
+    /**
+     * Callback used to propagate the world transforms of all moving bodies from the 2D physics simulation
+     * to the external objects, once per step.
+     *
+     * @param transforms Transforms of the bodies that were awake during the step
+     * @param count Number of transforms
+     */
+    typedef void (*SetWorldTransforms2DCallback)(const BodyTransform2D* transforms, uint32_t count);
+
     /**
      * Callback used to signal collisions.
      *
@@ -241,6 +265,8 @@ namespace dmPhysics
         uint32_t m_RayCastLimit2D;
         /// Maximum number of ray casts per frame when using 3D physics
         uint32_t m_RayCastLimit3D;
+        /// Job pool sharing the batched ray casts with the calling thread when using 2D physics, 0x0 to run them on the calling thread only
+        dmJobPool::HJobPool m_JobPool;
         /// Maximum number of overlapping triggers
         uint32_t m_TriggerOverlapCapacity;
         /// If true, the collision objects will retrieve the position of its game object
@@ -305,6 +331,8 @@ namespace dmPhysics
         GetWorldTransformCallback m_GetWorldTransformCallback;
         /// param set_world_transform Callback for copying the transform from the collision object to the corresponding user data
         SetWorldTransformCallback m_SetWorldTransformCallback;
+        /// param set_world_transforms_2d Callback for copying the transforms from all moving 2D collision objects at once, used instead of set_world_transform when set. Ignored by 3D worlds
+        SetWorldTransforms2DCallback m_SetWorldTransforms2DCallback;
     };
 
     /**
@@ -1167,6 +1195,28 @@ namespace dmPhysics
      */
     void RayCast2D(HWorld2D world, const RayCastRequest& request, dmArray<RayCastResponse>& results);
 
+    /**
+     * Perform a batch of synchronous ray casts, finding the closest hit of each ray
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Requests to perform, RayCastRequest::m_ReturnAllResults is ignored
+     * @param count Number of requests
+     * @param responses Array of count responses, one per request in the same order. RayCastResponse::m_Hit is 0 for rays that didn't hit anything
+     */
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses);
+
+    /**
+     * Perform a batch of synchronous ray casts, finding the closest hit of each ray.
+     * The rays are shared between the calling thread and the job pool of the context,
+     * see NewContextParams::m_JobPool. The world must not be modified during the call.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Requests to perform, RayCastRequest::m_ReturnAllResults is ignored
+     * @param count Number of requests
+     * @param responses Array of count responses, one per request in the same order. RayCastResponse::m_Hit is 0 for rays that didn't hit anything
+     */
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses);
+
     /**
      * Set the gravity for a 2D physics world.
      *
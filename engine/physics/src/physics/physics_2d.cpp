@@ -42,6 +42,7 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_JobPool(0x0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -52,13 +53,18 @@ namespace dmPhysics
     , m_Context(context)
     , m_World(context->m_Gravity)
     , m_RayCastRequests()
+    , m_RayCastResponses()
+    , m_AwakeBodies()
+    , m_BodyTransforms()
     , m_DebugDraw(&context->m_DebugCallbacks)
     , m_ContactListener(this)
     , m_GetWorldTransformCallback(params.m_GetWorldTransformCallback)
     , m_SetWorldTransformCallback(params.m_SetWorldTransformCallback)
+    , m_SetWorldTransforms2DCallback(params.m_SetWorldTransforms2DCallback)
     , m_AllowDynamicTransforms(context->m_AllowDynamicTransforms)
     {
         m_RayCastRequests.SetCapacity(context->m_RayCastLimit);
+        m_RayCastResponses.SetCapacity(context->m_RayCastLimit);
         OverlapCacheInit(&m_TriggerOverlaps);
     }
 
@@ -132,6 +138,41 @@ namespace dmPhysics
             return -1.f;
     }
 
+    // Finds the closest hit of a ray, the world is only read
+    static void RayCastClosest2D(HWorld2D world, const RayCastRequest& request, RayCastResponse& response)
+    {
+        response.m_Hit = 0;
+        float scale = world->m_Context->m_Scale;
+        b2Vec2 from;
+        ToB2(request.m_From, from, scale);
+        b2Vec2 to;
+        ToB2(request.m_To, to, scale);
+        if (b2DistanceSquared(from, to) <= 0.0f)
+            return;
+        ProcessRayCastResultCallback2D callback;
+        callback.m_Context = world->m_Context;
+        callback.m_Request = &request;
+        callback.m_IgnoredUserData = request.m_IgnoredUserData;
+        callback.m_CollisionMask = request.m_Mask;
+        callback.m_Response.m_Hit = 0;
+        world->m_World.RayCast(&callback, from, to);
+        response = callback.m_Response;
+    }
+
+    // Number of rays per job
+    static const uint32_t RAY_CAST_BATCH_CHUNK = 16;
+
+    static void RayCastBatchJob(void* ctx, uint32_t index)
+    {
+        RayCastBatch* batch = (RayCastBatch*)ctx;
+        uint32_t start = index * RAY_CAST_BATCH_CHUNK;
+        uint32_t end = dmMath::Min(start + RAY_CAST_BATCH_CHUNK, batch->m_Count);
+        for (uint32_t i = start; i < end; ++i)
+        {
+            RayCastClosest2D(batch->m_World, batch->m_Requests[i], batch->m_Responses[i]);
+        }
+    }
+
     ContactListener::ContactListener(HWorld2D world)
     : m_World(world)
     {
@@ -229,6 +270,7 @@ namespace dmPhysics
             DeleteContext2D(context);
             return 0x0;
         }
+        context->m_JobPool = params.m_JobPool;
         return context;
     }
 
@@ -415,12 +457,18 @@ namespace dmPhysics
         if (world->m_GetWorldTransformCallback)
         {
             DM_PROFILE("UpdateKinematic");
+            // Compared against the squared sine of the rotation difference
+            const float ROT_EPSILON_SQ = ROT_EPSILON * ROT_EPSILON;
             for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
             {
-                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
+                b2BodyType type = body->GetType();
+                if (type == b2_staticBody)
+                    continue;
+
+                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms;
 
                 // translate & rotation
-                if (retrieve_gameworld_transform || body->GetType() == b2_kinematicBody)
+                if (retrieve_gameworld_transform || type == b2_kinematicBody)
                 {
                     Point3 old_position = GetWorldPosition2D(context, body);
                     dmTransform::Transform world_transform;
@@ -430,15 +478,20 @@ namespace dmPhysics
                     position.setZ(0.0f);
                     Quat rotation = world_transform.GetRotation();
                     float dp = distSqr(old_position, position);
-                    float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
-                    float old_angle = body->GetAngle();
-                    float da = old_angle - angle;
-
-                    if (dp > POS_EPSILON || fabsf(da) > ROT_EPSILON)
+                    // (x, y) is the direction of the rotated x-axis, scaled by some r. Compare it to the
+                    // rotation of the body with cross and dot products, and only calculate the angle when it's needed
+                    float x = 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ());
+                    float y = 2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY());
+                    const b2Rot& old_rotation = body->GetTransform().q;
+                    float sin_da = old_rotation.c * y - old_rotation.s * x; // r * sin(da)
+                    float cos_da = old_rotation.c * x + old_rotation.s * y; // r * cos(da)
+                    bool rotated = cos_da < 0.0f || sin_da * sin_da > ROT_EPSILON_SQ * (x * x + y * y);
+
+                    if (dp > POS_EPSILON || rotated)
                     {
                         b2Vec2 b2_position;
                         ToB2(position, b2_position, scale);
-                        body->SetTransform(b2_position, angle);
+                        body->SetTransform(b2_position, atan2f(y, x));
                         body->SetSleepingAllowed(false);
                     }
                     else
@@ -454,23 +507,78 @@ namespace dmPhysics
                 }
             }
         }
+        bool update_dynamic = world->m_SetWorldTransformCallback || world->m_SetWorldTransforms2DCallback;
+        if (update_dynamic)
+        {
+            // Bodies that fall asleep during the step still need their final transforms written back
+            dmArray<b2Body*>& awake_bodies = world->m_AwakeBodies;
+            awake_bodies.SetSize(0);
+            for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+            {
+                if (body->GetType() == b2_dynamicBody && body->IsActive() && body->IsAwake())
+                {
+                    if (awake_bodies.Full())
+                    {
+                        awake_bodies.OffsetCapacity(dmMath::Max(awake_bodies.Capacity(), 16U));
+                    }
+                    awake_bodies.Push(body);
+                }
+            }
+        }
         {
             DM_PROFILE("StepSimulation");
             world->m_ContactListener.SetStepWorldContext(&step_context);
             world->m_World.Step(dt, 10, 10);
+        }
+        // Update transforms of dynamic bodies
+        if (update_dynamic)
+        {
+            DM_PROFILE("UpdateDynamic");
             float inv_scale = world->m_Context->m_InvScale;
-            // Update transforms of dynamic bodies
-            if (world->m_SetWorldTransformCallback)
+            dmArray<BodyTransform2D>& transforms = world->m_BodyTransforms;
+            transforms.SetSize(0);
+            // Bodies are neither added nor removed during the step, so the awake bodies are in the same order as the body list
+            b2Body** awake_body = world->m_AwakeBodies.Begin();
+            b2Body** awake_end = world->m_AwakeBodies.End();
+            for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
             {
-                for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+                bool was_awake = awake_body != awake_end && *awake_body == body;
+                if (was_awake)
                 {
-                    if (body->GetType() == b2_dynamicBody && body->IsActive())
-                    {
-                        Point3 position;
-                        FromB2(body->GetPosition(), position, inv_scale);
-                        Quat rotation = Quat::rotationZ(body->GetAngle());
-                        (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
-                    }
+                    ++awake_body;
+                }
+                else if (!body->IsAwake() || body->GetType() != b2_dynamicBody || !body->IsActive())
+                {
+                    continue;
+                }
+                if (transforms.Full())
+                {
+                    transforms.OffsetCapacity(dmMath::Max(transforms.Capacity(), 16U));
+                }
+                const b2Vec2& position = body->GetPosition();
+                BodyTransform2D transform;
+                transform.m_UserData = body->GetUserData();
+                transform.m_X = position.x * inv_scale;
+                transform.m_Y = position.y * inv_scale;
+                transform.m_Angle = body->GetAngle();
+                transforms.Push(transform);
+            }
+
+            if (world->m_SetWorldTransforms2DCallback)
+            {
+                if (!transforms.Empty())
+                {
+                    (*world->m_SetWorldTransforms2DCallback)(transforms.Begin(), transforms.Size());
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < transforms.Size(); ++i)
+                {
+                    const BodyTransform2D& transform = transforms[i];
+                    Point3 position(transform.m_X, transform.m_Y, 0.0f);
+                    Quat rotation = Quat::rotationZ(transform.m_Angle);
+                    (*world->m_SetWorldTransformCallback)(transform.m_UserData, position, rotation);
                 }
             }
         }
@@ -479,20 +587,12 @@ namespace dmPhysics
         if (size > 0)
         {
             DM_PROFILE("RayCasts");
-            ProcessRayCastResultCallback2D callback;
-            callback.m_Context = world->m_Context;
+            // The responses are reported in request order once all rays are done
+            world->m_RayCastResponses.SetSize(size);
+            RayCastBatch2D(world, world->m_RayCastRequests.Begin(), size, world->m_RayCastResponses.Begin());
             for (uint32_t i = 0; i < size; ++i)
             {
-                RayCastRequest& request = world->m_RayCastRequests[i];
-                b2Vec2 from;
-                ToB2(request.m_From, from, scale);
-                b2Vec2 to;
-                ToB2(request.m_To, to, scale);
-                callback.m_IgnoredUserData = request.m_IgnoredUserData;
-                callback.m_CollisionMask = request.m_Mask;
-                callback.m_Response.m_Hit = 0;
-                world->m_World.RayCast(&callback, from, to);
-                (*step_context.m_RayCastCallback)(callback.m_Response, request, step_context.m_RayCastUserData);
+                (*step_context.m_RayCastCallback)(world->m_RayCastResponses[i], world->m_RayCastRequests[i], step_context.m_RayCastUserData);
             }
             world->m_RayCastRequests.SetSize(0);
         }
@@ -1300,6 +1400,19 @@ namespace dmPhysics
         }
     }
 
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        DM_PROFILE("RayCastBatch2D");
+
+        RayCastBatch batch;
+        batch.m_World = world;
+        batch.m_Requests = requests;
+        batch.m_Responses = responses;
+        batch.m_Count = count;
+
+        dmJobPool::Run(world->m_Context->m_JobPool, RayCastBatchJob, &batch, (count + RAY_CAST_BATCH_CHUNK - 1) / RAY_CAST_BATCH_CHUNK);
+    }
+
     void SetGravity2D(HWorld2D world, const Vector3& gravity)
     {
         b2Vec2 gravity_b;
@@ -17,6 +17,7 @@
 
 #include <dlib/array.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_pool.h>
 #include <dmsdk/dlib/vmath.h>
 
 #include "physics.h"
@@ -48,14 +49,28 @@ namespace dmPhysics
         HContext2D                  m_Context;
         b2World                     m_World;
         dmArray<RayCastRequest>     m_RayCastRequests;
+        dmArray<RayCastResponse>    m_RayCastResponses;
+        // Dynamic bodies awake before the current step, in body list order
+        dmArray<b2Body*>            m_AwakeBodies;
+        dmArray<BodyTransform2D>    m_BodyTransforms;
         DebugDraw2D                 m_DebugDraw;
         ContactListener             m_ContactListener;
         GetWorldTransformCallback   m_GetWorldTransformCallback;
         SetWorldTransformCallback   m_SetWorldTransformCallback;
+        SetWorldTransforms2DCallback m_SetWorldTransforms2DCallback;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
 
+    /// Ray casts shared between the jobs, see RayCastBatch2D
+    struct RayCastBatch
+    {
+        HWorld2D                    m_World;
+        const RayCastRequest*       m_Requests;
+        RayCastResponse*            m_Responses;
+        uint32_t                    m_Count;
+    };
+
     struct Context2D
     {
         Context2D();
@@ -71,6 +86,8 @@ namespace dmPhysics
         float                       m_VelocityThreshold;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        // Pool sharing the batched ray casts with the calling thread, see RayCastBatch2D
+        dmJobPool::HJobPool         m_JobPool;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -358,6 +358,27 @@ namespace dmPhysics
 
     static void UpdateOverlapCache(OverlapCache* cache, HContext3D context, btDispatcher* dispatcher, const StepWorldContext& step_context);
 
+    static void RayCastClosest3D(HWorld3D world, const RayCastRequest& request, RayCastResponse& response)
+    {
+        float scale = world->m_Context->m_Scale;
+        btVector3 from;
+        ToBt(request.m_From, from, scale);
+        btVector3 to;
+        ToBt(request.m_To, to, scale);
+        RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+        world->m_DynamicsWorld->rayTest(from, to, result_callback);
+        response.m_Hit = result_callback.hasHit() ? 1 : 0;
+        response.m_Fraction = result_callback.m_closestHitFraction;
+        float inv_scale = world->m_Context->m_InvScale;
+        FromBt(result_callback.m_hitPointWorld, response.m_Position, inv_scale);
+        FromBt(result_callback.m_hitNormalWorld, response.m_Normal, 1.0f); // don't scale normal
+        if (result_callback.m_collisionObject != 0x0)
+        {
+            response.m_CollisionObjectUserData = result_callback.m_collisionObject->getUserPointer();
+            response.m_CollisionObjectGroup = result_callback.m_collisionObject->getBroadphaseHandle()->m_collisionFilterGroup;
+        }
+    }
+
     void StepWorld3D(HWorld3D world, const StepWorldContext& step_context)
     {
         HContext3D context = world->m_Context;
@@ -444,24 +465,8 @@ namespace dmPhysics
                     dmLogWarning("Ray cast requested without any response callback, skipped.");
                     continue;
                 }
-                float scale = world->m_Context->m_Scale;
-                btVector3 from;
-                ToBt(request.m_From, from, scale);
-                btVector3 to;
-                ToBt(request.m_To, to, scale);
-                RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
-                world->m_DynamicsWorld->rayTest(from, to, result_callback);
                 RayCastResponse response;
-                response.m_Hit = result_callback.hasHit() ? 1 : 0;
-                response.m_Fraction = result_callback.m_closestHitFraction;
-                float inv_scale = world->m_Context->m_InvScale;
-                FromBt(result_callback.m_hitPointWorld, response.m_Position, inv_scale);
-                FromBt(result_callback.m_hitNormalWorld, response.m_Normal, 1.0f); // don't scale normal
-                if (result_callback.m_collisionObject != 0x0)
-                {
-                    response.m_CollisionObjectUserData = result_callback.m_collisionObject->getUserPointer();
-                    response.m_CollisionObjectGroup = result_callback.m_collisionObject->getBroadphaseHandle()->m_collisionFilterGroup;
-                }
+                RayCastClosest3D(world, request, response);
                 step_context.m_RayCastCallback(response, request, step_context.m_RayCastUserData);
             }
             world->m_RayCastRequests.SetSize(0);
@@ -1235,6 +1240,22 @@ namespace dmPhysics
         }
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        DM_PROFILE("RayCastBatch3D");
+        // Bullet makes no guarantees about ray tests being free of shared state, so these run on the calling thread
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const RayCastRequest& request = requests[i];
+            if (lengthSqr(request.m_To - request.m_From) <= 0.0f)
+            {
+                responses[i].m_Hit = 0;
+                continue;
+            }
+            RayCastClosest3D(world, request, responses[i]);
+        }
+    }
+
     void SetGravity3D(HWorld3D world, const Vector3& gravity)
     {
         HContext3D context = world->m_Context;
@@ -218,6 +218,14 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i].m_Hit = 0;
+        }
+    }
+
     void SetGravity3D(HWorld3D world, const dmVMath::Vector3& gravity)
     {
     }
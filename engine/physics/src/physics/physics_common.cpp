@@ -30,6 +30,7 @@ namespace dmPhysics
     , m_VelocityThreshold(1.0f)
     , m_RayCastLimit2D(0)
     , m_RayCastLimit3D(0)
+    , m_JobPool(0x0)
     , m_TriggerOverlapCapacity(0)
     , m_AllowDynamicTransforms(0)
     {
@@ -43,6 +44,7 @@ namespace dmPhysics
     , m_WorldMax(WORLD_EXTENT, WORLD_EXTENT, WORLD_EXTENT)
     , m_GetWorldTransformCallback(0x0)
     , m_SetWorldTransformCallback(0x0)
+    , m_SetWorldTransforms2DCallback(0x0)
     {
 
     }
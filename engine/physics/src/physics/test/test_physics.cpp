@@ -128,6 +128,7 @@ Test3D::Test3D()
 , m_GetMassFunc(dmPhysics::GetMass3D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast3D)
 , m_RayCastFunc(dmPhysics::RayCast3D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch3D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks3D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape3D)
 , m_SetGravityFunc(dmPhysics::SetGravity3D)
@@ -186,6 +187,7 @@ Test2D::Test2D()
 , m_GetMassFunc(dmPhysics::GetMass2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
 , m_RayCastFunc(dmPhysics::RayCast2D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
 , m_SetGravityFunc(dmPhysics::SetGravity2D)
@@ -1246,6 +1248,75 @@ TYPED_TEST(PhysicsTest, SynchronousRayCasting)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
 }
 
+TYPED_TEST(PhysicsTest, BatchedRayCasting)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject vo_a;
+    vo_a.m_Position.setX(1.0f);
+
+    VisualObject vo_b;
+    vo_b.m_Position.setX(2.5f);
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+
+    dmPhysics::CollisionObjectData data_a;
+    data_a.m_Group = 1;
+    data_a.m_Mass = 0.0f;
+    data_a.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data_a.m_UserData = &vo_a;
+    typename TypeParam::CollisionObjectType box_co_a = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data_a, &shape, 1u);
+
+    dmPhysics::CollisionObjectData data_b;
+    data_b.m_Group = 2;
+    data_b.m_Mass = 0.0f;
+    data_b.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data_b.m_UserData = &vo_b;
+    typename TypeParam::CollisionObjectType box_co_b = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data_b, &shape, 1u);
+
+    const uint32_t count = 4;
+    dmPhysics::RayCastRequest requests[count];
+    dmPhysics::RayCastResponse responses[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        requests[i].m_ReturnAllResults = 0;
+    }
+    // A miss
+    requests[0].m_From = Point3(-1.0f, 0.0f, 0.0f);
+    requests[0].m_To = Point3(0.0f, 0.0f, 0.0f);
+    requests[0].m_Mask = 3;
+    // A hit on the closest object, even when asking for all results
+    requests[1].m_From = Point3(-1.0f, 0.0f, 0.0f);
+    requests[1].m_To = Point3(5.0f, 0.0f, 0.0f);
+    requests[1].m_Mask = 3;
+    requests[1].m_ReturnAllResults = 1;
+    // The first object has the wrong group
+    requests[2].m_From = Point3(-1.0f, 0.0f, 0.0f);
+    requests[2].m_To = Point3(5.0f, 0.0f, 0.0f);
+    requests[2].m_Mask = 2;
+    // A ray without length
+    requests[3].m_From = Point3(1.0f, 0.0f, 0.0f);
+    requests[3].m_To = Point3(1.0f, 0.0f, 0.0f);
+    requests[3].m_Mask = 3;
+
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests, count, responses);
+
+    ASSERT_FALSE(responses[0].m_Hit);
+    ASSERT_TRUE(responses[1].m_Hit);
+    ASSERT_EQ(0.25f, responses[1].m_Fraction);
+    ASSERT_EQ(0.5f, responses[1].m_Position.getX());
+    ASSERT_EQ(&vo_a, responses[1].m_CollisionObjectUserData);
+    ASSERT_TRUE(responses[2].m_Hit);
+    ASSERT_EQ(0.5f, responses[2].m_Fraction);
+    ASSERT_EQ(&vo_b, responses[2].m_CollisionObjectUserData);
+    ASSERT_EQ(2, responses[2].m_CollisionObjectGroup);
+    ASSERT_FALSE(responses[3].m_Hit);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co_a);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co_b);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 enum Groups
 {
     GROUP_A = 1 << 0,
@@ -53,6 +53,8 @@ protected:
         context_params.m_RayCastLimit2D = 64;
         context_params.m_RayCastLimit3D = 128;
         context_params.m_TriggerOverlapCapacity = 16;
+        m_JobPool = dmJobPool::New(2);
+        context_params.m_JobPool = m_JobPool;
         m_Context = (*m_Test.m_NewContextFunc)(context_params);
         dmPhysics::NewWorldParams world_params;
         world_params.m_GetWorldTransformCallback = GetWorldTransform;
@@ -72,8 +74,10 @@ protected:
     {
         (*m_Test.m_DeleteWorldFunc)(m_Context, m_World);
         (*m_Test.m_DeleteContextFunc)(m_Context);
+        dmJobPool::Delete(m_JobPool);
     }
 
+    dmJobPool::HJobPool m_JobPool;
     typename T::ContextType m_Context;
     typename T::WorldType m_World;
     T m_Test;
@@ -124,6 +128,7 @@ struct Funcs
     typedef float (*GetMassFunc)(typename T::CollisionObjectType collision_object);
     typedef void (*RequestRayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request);
     typedef void (*RayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
+    typedef void (*RayCastBatchFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses);
     typedef void (*SetDebugCallbacks)(typename T::ContextType context, const dmPhysics::DebugCallbacks& callbacks);
     typedef void (*ReplaceShapeFunc)(typename T::ContextType context, typename T::CollisionShapeType old_shape, typename T::CollisionShapeType new_shape);
     typedef void (*SetGravityFunc)(typename T::WorldType world, const dmVMath::Vector3& gravity);
@@ -181,6 +186,7 @@ struct Test3D
     Funcs<Test3D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test3D>::RequestRayCastFunc               m_RequestRayCastFunc;
     Funcs<Test3D>::RayCastFunc                      m_RayCastFunc;
+    Funcs<Test3D>::RayCastBatchFunc                 m_RayCastBatchFunc;
     Funcs<Test3D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test3D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
     Funcs<Test3D>::SetGravityFunc                   m_SetGravityFunc;
@@ -239,6 +245,7 @@ struct Test2D
     Funcs<Test2D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test2D>::RequestRayCastFunc               m_RequestRayCastFunc;
     Funcs<Test2D>::RayCastFunc                      m_RayCastFunc;
+    Funcs<Test2D>::RayCastBatchFunc                 m_RayCastBatchFunc;
     Funcs<Test2D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test2D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
     Funcs<Test2D>::SetGravityFunc                   m_SetGravityFunc;
@@ -117,6 +117,8 @@ Test2D::Test2D()
 , m_GetLinearVelocityFunc(dmPhysics::GetLinearVelocity2D)
 , m_GetAngularVelocityFunc(dmPhysics::GetAngularVelocity2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
+, m_RayCastFunc(dmPhysics::RayCast2D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
 , m_IsBulletFunc(dmPhysics::IsBullet2D)
@@ -1737,6 +1739,158 @@ TYPED_TEST(PhysicsTest, SetGridShapeEnable)
     dmPhysics::DeleteHullSet2D(hull_set);
 }
 
+static uint32_t g_BodyTransformsCount = 0;
+
+static void SetWorldTransforms2D(const dmPhysics::BodyTransform2D* transforms, uint32_t count)
+{
+    g_BodyTransformsCount = count;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        VisualObject* o = (VisualObject*)transforms[i].m_UserData;
+        o->m_Position = Point3(transforms[i].m_X, transforms[i].m_Y, 0.0f);
+        o->m_Rotation = Quat::rotationZ(transforms[i].m_Angle);
+    }
+}
+
+TYPED_TEST(PhysicsTest, SetWorldTransformsBatched)
+{
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    world_params.m_SetWorldTransforms2DCallback = SetWorldTransforms2D;
+    dmPhysics::HWorld2D world = dmPhysics::NewWorld2D(TestFixture::m_Context, world_params);
+
+    float ground_height_half_ext = 1.0f;
+    float box_half_ext = 0.5f;
+
+    VisualObject ground_visual_object;
+    dmPhysics::CollisionObjectData ground_data;
+    dmPhysics::HCollisionShape2D ground_shape = dmPhysics::NewBoxShape2D(TestFixture::m_Context, Vector3(100, ground_height_half_ext, 0));
+    ground_data.m_Mass = 0.0f;
+    ground_data.m_Restitution = 0.0f;
+    ground_data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    ground_data.m_UserData = &ground_visual_object;
+    dmPhysics::HCollisionObject2D ground_co = dmPhysics::NewCollisionObject2D(world, ground_data, &ground_shape, 1u);
+
+    const uint32_t box_count = 3;
+    VisualObject box_visual_objects[box_count];
+    dmPhysics::HCollisionShape2D box_shape = dmPhysics::NewBoxShape2D(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, 0));
+    dmPhysics::HCollisionObject2D box_cos[box_count];
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        box_visual_objects[i].m_Position = Point3(i * 4.0f, 2.0f, 0.0f);
+        dmPhysics::CollisionObjectData box_data;
+        box_data.m_Restitution = 0.0f;
+        box_data.m_UserData = &box_visual_objects[i];
+        box_cos[i] = dmPhysics::NewCollisionObject2D(world, box_data, &box_shape, 1u);
+    }
+
+    // Only the dynamic bodies are reported
+    dmPhysics::StepWorld2D(world, TestFixture::m_StepWorldContext);
+    ASSERT_EQ(box_count, g_BodyTransformsCount);
+    ASSERT_GT(2.0f, box_visual_objects[0].m_Position.getY());
+
+    for (int i = 0; i < 300; ++i)
+    {
+        dmPhysics::StepWorld2D(world, TestFixture::m_StepWorldContext);
+    }
+
+    // Sleeping bodies are no longer reported, but their final transforms were
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        ASSERT_TRUE(dmPhysics::IsSleeping2D(box_cos[i]));
+        Point3 position = dmPhysics::GetWorldPosition2D(TestFixture::m_Context, box_cos[i]);
+        ASSERT_EQ(position.getX(), box_visual_objects[i].m_Position.getX());
+        ASSERT_EQ(position.getY(), box_visual_objects[i].m_Position.getY());
+        ASSERT_NEAR(ground_height_half_ext + box_half_ext, box_visual_objects[i].m_Position.getY(), 2.0f * TestFixture::m_Test.m_PolygonRadius / PHYSICS_SCALE);
+    }
+    g_BodyTransformsCount = ~0u;
+    dmPhysics::StepWorld2D(world, TestFixture::m_StepWorldContext);
+    ASSERT_EQ(~0u, g_BodyTransformsCount);
+
+    dmPhysics::Wakeup2D(box_cos[1]);
+    dmPhysics::StepWorld2D(world, TestFixture::m_StepWorldContext);
+    ASSERT_EQ(1u, g_BodyTransformsCount);
+
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        dmPhysics::DeleteCollisionObject2D(world, box_cos[i]);
+    }
+    dmPhysics::DeleteCollisionObject2D(world, ground_co);
+    dmPhysics::DeleteCollisionShape2D(ground_shape);
+    dmPhysics::DeleteCollisionShape2D(box_shape);
+    dmPhysics::DeleteWorld2D(TestFixture::m_Context, world);
+}
+
+TYPED_TEST(PhysicsTest, BatchedRayCastingThreads)
+{
+    // The rays are shared with the ray cast threads of the test context
+    dmPhysics::HContext2D context = TestFixture::m_Context;
+    dmPhysics::HWorld2D world = TestFixture::m_World;
+
+    // A row of boxes, where every other box is in group 2
+    const uint32_t box_count = 16;
+    VisualObject box_visual_objects[box_count];
+    dmPhysics::HCollisionObject2D box_cos[box_count];
+    dmPhysics::HCollisionShape2D shape = dmPhysics::NewBoxShape2D(context, Vector3(0.5f, 0.5f, 0.0f));
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        box_visual_objects[i].m_Position = Point3(i * 2.0f, 0.0f, 0.0f);
+        dmPhysics::CollisionObjectData data;
+        data.m_Group = 1 + (i & 1);
+        data.m_Mass = 0.0f;
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+        data.m_UserData = &box_visual_objects[i];
+        box_cos[i] = dmPhysics::NewCollisionObject2D(world, data, &shape, 1u);
+        dmPhysics::SetCollisionObjectUserData2D(box_cos[i], &box_visual_objects[i]);
+    }
+    dmPhysics::StepWorld2D(world, TestFixture::m_StepWorldContext);
+
+    // Vertical rays along the row, some between the boxes
+    const uint32_t count = 1000;
+    dmArray<dmPhysics::RayCastRequest> requests;
+    requests.SetCapacity(count);
+    requests.SetSize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float x = -1.0f + 2.0f * box_count * i / count;
+        requests[i].m_From = Point3(x, 2.0f, 0.0f);
+        requests[i].m_To = Point3(x, -2.0f, 0.0f);
+        requests[i].m_Mask = (i % 3) == 0 ? 2 : 3;
+        requests[i].m_ReturnAllResults = 0;
+    }
+    dmArray<dmPhysics::RayCastResponse> responses;
+    responses.SetCapacity(count);
+    responses.SetSize(count);
+
+    dmPhysics::RayCastBatch2D(world, requests.Begin(), count, responses.Begin());
+
+    // Same results as one ray at a time
+    uint32_t hit_count = 0;
+    dmArray<dmPhysics::RayCastResponse> hits;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        hits.SetSize(0);
+        dmPhysics::RayCast2D(world, requests[i], hits);
+        ASSERT_EQ(hits.Size(), (uint32_t)responses[i].m_Hit);
+        if (responses[i].m_Hit)
+        {
+            ASSERT_EQ(hits[0].m_Fraction, responses[i].m_Fraction);
+            ASSERT_EQ(hits[0].m_CollisionObjectUserData, responses[i].m_CollisionObjectUserData);
+            ASSERT_EQ(hits[0].m_CollisionObjectGroup, responses[i].m_CollisionObjectGroup);
+            ++hit_count;
+        }
+    }
+    ASSERT_LT(0u, hit_count);
+    ASSERT_GT(count, hit_count);
+
+    for (uint32_t i = 0; i < box_count; ++i)
+    {
+        dmPhysics::DeleteCollisionObject2D(world, box_cos[i]);
+    }
+    dmPhysics::DeleteCollisionShape2D(shape);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
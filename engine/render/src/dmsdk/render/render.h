@@ -168,7 +168,11 @@ namespace dmRender
      * @member m_DestinationBlendFactor [type: dmGraphics::BlendFactor] the destination blend factor
      * @member m_StencilTestParams [type: dmRender::StencilTestParams] the stencil test params
      * @member m_VertexStart [type: uint32_t] the vertex start
-     * @member m_VertexCount [type: uint32_t] the vertex count
+     * @member m_VertexCount [type: uint32_t] the vertex count (the index count when drawing instanced)
+     * @member m_InstanceVertexBuffer [type: dmGraphics::HVertexBuffer] the vertex buffer holding one record per instance
+     * @member m_InstanceVertexDeclaration [type: dmGraphics::HVertexDeclaration] the vertex declaration of the per-instance records
+     * @member m_InstanceStart [type: uint32_t] the first instance record to draw
+     * @member m_InstanceCount [type: uint32_t] the number of instances to draw. If non zero, the index buffer is drawn once per instance
      * @member m_SetBlendFactors [type: uint8_t:1] use the blend factors
      * @member m_SetStencilTest [type: uint8_t:1] use the stencil test
      */
@@ -195,6 +199,10 @@ namespace dmRender
         StencilTestParams               m_StencilTestParams;
         uint32_t                        m_VertexStart;
         uint32_t                        m_VertexCount;
+        dmGraphics::HVertexBuffer       m_InstanceVertexBuffer;
+        dmGraphics::HVertexDeclaration  m_InstanceVertexDeclaration;
+        uint32_t                        m_InstanceStart;
+        uint32_t                        m_InstanceCount;
         uint8_t                         m_SetBlendFactors : 1;
         uint8_t                         m_SetStencilTest : 1;
         uint8_t                         m_SetFaceWinding : 1;
@@ -290,10 +298,12 @@ namespace dmRender
     };
 
     /*#
-     * Render dispatch function callback.
+     * Visibility function callback.
+     * A batch may be split into several calls, which can run in parallel on worker threads.
+     * The function should only set the visibility of the given entries.
      * @typedef
-     * @name RenderListDispatchFn
-     * @param params [type: dmRender::RenderListDispatchParams] the params
+     * @name RenderListVisibilityFn
+     * @param params [type: dmRender::RenderListVisibilityParams] the params
      */
     typedef void (*RenderListVisibilityFn)(RenderListVisibilityParams const &params);
 
@@ -40,6 +40,8 @@
 DM_PROPERTY_EXTERN(rmtp_Render);
 DM_PROPERTY_U32(rmtp_FontCharacterCount, 0, FrameReset, "# glyphs", &rmtp_Render);
 DM_PROPERTY_U32(rmtp_FontVertexSize, 0, FrameReset, "size of vertices in bytes", &rmtp_Render);
+DM_PROPERTY_U32(rmtp_FontGlyphCacheMissCount, 0, FrameReset, "# glyphs added to the glyph cache", &rmtp_Render);
+DM_PROPERTY_U32(rmtp_FontGlyphCacheUploadSize, 0, FrameReset, "size of glyph cache uploads in bytes", &rmtp_Render);
 
 namespace dmRender
 {
@@ -87,6 +89,38 @@ namespace dmRender
 
     }
 
+    static const uint32_t INVALID_GLYPH_CACHE_SLOT = 0xffffffff;
+
+    // A row in the glyph cache texture. Glyphs are placed left to right in the
+    // shelf that fits them best, and new shelves are added below the previous ones.
+    struct GlyphCacheShelf
+    {
+        uint32_t m_Y;
+        uint32_t m_Height;
+        uint32_t m_Width;       // The used width
+        uint32_t m_LastSlot;    // The rightmost slot
+        uint32_t m_FreeSlots;   // First slot in the list of free slots
+        uint32_t m_DirtyStart;  // The columns of the shelf that haven't been uploaded yet
+        uint32_t m_DirtyEnd;
+    };
+
+    // A rectangle in a shelf. The slots of a shelf are linked left to right, and adjacent free slots are merged.
+    // A used slot is linked into the LRU list of the font map, a free slot into the free list of its shelf,
+    // and a slot record that isn't part of any shelf into the list of spare records.
+    struct GlyphCacheSlot
+    {
+        Glyph*   m_Glyph;       // 0 if the slot is free
+        uint32_t m_X;
+        uint32_t m_Width;
+        uint32_t m_Shelf;
+        uint32_t m_Left;
+        uint32_t m_Right;
+        uint32_t m_Prev;
+        uint32_t m_Next;
+        uint8_t  m_Pending:1;   // The slot is in the list of slots to decode
+        uint8_t  :7;
+    };
+
     struct FontMap
     {
         FontMap()
@@ -100,11 +134,14 @@ namespace dmRender
         , m_CacheWidth(0)
         , m_CacheHeight(0)
         , m_GlyphData(0)
-        , m_Cache(0)
-        , m_CacheCursor(0)
-        , m_CacheColumns(0)
-        , m_CacheRows(0)
+        , m_CacheLRUFirst(INVALID_GLYPH_CACHE_SLOT)
+        , m_CacheLRULast(INVALID_GLYPH_CACHE_SLOT)
+        , m_CacheSpareSlots(INVALID_GLYPH_CACHE_SLOT)
+        , m_CacheData(0)
+        , m_CacheUploadCount(0)
+        , m_CacheUploadSize(0)
         , m_CellTempData(0)
+        , m_CellTempDataCount(0)
         , m_CacheCellWidth(0)
         , m_CacheCellHeight(0)
         , m_CacheCellMaxAscent(0)
@@ -119,8 +156,8 @@ namespace dmRender
             if (m_GlyphData) {
                 free(m_GlyphData);
             }
-            if (m_Cache) {
-                free(m_Cache);
+            if (m_CacheData) {
+                free(m_CacheData);
             }
             if (m_CellTempData) {
                 free(m_CellTempData);
@@ -147,16 +184,23 @@ namespace dmRender
         uint32_t                m_CacheHeight;
         void*                   m_GlyphData;
 
-        Glyph**                 m_Cache;
-        uint32_t                m_CacheCursor;
+        dmArray<GlyphCacheShelf> m_CacheShelves;
+        dmArray<GlyphCacheSlot> m_CacheSlots;
+        uint32_t                m_CacheLRUFirst;    // The least recently used glyph
+        uint32_t                m_CacheLRULast;
+        uint32_t                m_CacheSpareSlots;
+        dmArray<uint32_t>       m_CachePendingSlots; // Slots with glyphs that are decoded in UploadGlyphCache
+        uint8_t*                m_CacheData;        // A copy of the cache texture, the glyphs are decoded into it
+        dmArray<uint8_t>        m_CacheUploadData;  // The texels of a dirty rectangle that is narrower than the cache
+        uint32_t                m_CacheUploadCount; // Number of rectangles uploaded by the last UploadGlyphCache, used in unit tests
+        uint32_t                m_CacheUploadSize;  // Number of bytes uploaded by the last UploadGlyphCache
         dmGraphics::TextureFormat m_CacheFormat;
         dmGraphics::TextureFilter m_MinFilter;
         dmGraphics::TextureFilter m_MagFilter;
+        uint8_t                 m_CacheChannels;
 
-        uint32_t                m_CacheColumns;
-        uint32_t                m_CacheRows;
-
-        uint8_t*                m_CellTempData; // a temporary unpack buffer for the compressed glyphs
+        uint8_t*                m_CellTempData; // temporary unpack buffers for the compressed glyphs, one per decode job
+        uint32_t                m_CellTempDataCount;
 
         uint32_t                m_CacheCellWidth;
         uint32_t                m_CacheCellHeight;
@@ -167,19 +211,24 @@ namespace dmRender
 
     static float GetLineTextMetrics(HFontMap font_map, float tracking, const char* text, int n, bool measure_trailing_space);
 
-    static void InitFontmap(FontMapParams& params, dmGraphics::TextureParams& tex_params, uint8_t init_val)
+    // Empties the glyph cache and clears its texture data
+    static void ResetGlyphCache(HFontMap font_map, uint8_t channels, dmGraphics::TextureParams& tex_params)
     {
-        uint8_t bpp = params.m_GlyphChannels;
-        uint32_t data_size = tex_params.m_Width * tex_params.m_Height * bpp;
-        tex_params.m_Data = malloc(data_size);
+        font_map->m_CacheShelves.SetSize(0);
+        font_map->m_CacheSlots.SetSize(0);
+        font_map->m_CacheLRUFirst = INVALID_GLYPH_CACHE_SLOT;
+        font_map->m_CacheLRULast = INVALID_GLYPH_CACHE_SLOT;
+        font_map->m_CacheSpareSlots = INVALID_GLYPH_CACHE_SLOT;
+        font_map->m_CachePendingSlots.SetSize(0);
+
+        uint32_t data_size = font_map->m_CacheWidth * font_map->m_CacheHeight * channels;
+        free(font_map->m_CacheData);
+        font_map->m_CacheData = (uint8_t*)malloc(data_size);
+        memset(font_map->m_CacheData, 0, data_size);
+        font_map->m_CacheChannels = channels;
+
+        tex_params.m_Data = font_map->m_CacheData;
         tex_params.m_DataSize = data_size;
-        memset((void*)tex_params.m_Data, init_val, tex_params.m_DataSize);
-    }
-
-    static void CleanupFontmap(dmGraphics::TextureParams& tex_params)
-    {
-        free((void*)tex_params.m_Data);
-        tex_params.m_DataSize = 0;
     }
 
     // Font maps have no mips, so we need to make sure we use a supported min filter
@@ -231,11 +280,8 @@ namespace dmRender
         font_map->m_CacheCellMaxAscent = params.m_CacheCellMaxAscent;
         font_map->m_CacheCellPadding = params.m_CacheCellPadding;
 
-        font_map->m_CacheColumns = params.m_CacheWidth / params.m_CacheCellWidth;
-        font_map->m_CacheRows = params.m_CacheHeight / params.m_CacheCellHeight;
-        uint32_t cell_count = font_map->m_CacheColumns * font_map->m_CacheRows;
-
         font_map->m_CellTempData = (uint8_t*)malloc(font_map->m_CacheCellWidth*font_map->m_CacheCellHeight*4);
+        font_map->m_CellTempDataCount = 1;
 
         switch (params.m_GlyphChannels)
         {
@@ -266,9 +312,6 @@ namespace dmRender
             font_map->m_MagFilter = dmGraphics::TEXTURE_FILTER_LINEAR;
         }
 
-        font_map->m_Cache = (Glyph**)malloc(sizeof(Glyph*) * cell_count);
-        memset(font_map->m_Cache, 0, sizeof(Glyph*) * cell_count);
-
         // create new texture to be used as a cache
         dmGraphics::TextureCreationParams tex_create_params;
         dmGraphics::TextureParams tex_params;
@@ -286,9 +329,8 @@ namespace dmRender
         tex_params.m_MagFilter = dmGraphics::TEXTURE_FILTER_LINEAR;
         font_map->m_Texture = dmGraphics::NewTexture(graphics_context, tex_create_params);
 
-        InitFontmap(params, tex_params, 0);
+        ResetGlyphCache(font_map, params.m_GlyphChannels, tex_params);
         dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-        CleanupFontmap(tex_params);
 
         return font_map;
     }
@@ -311,7 +353,6 @@ namespace dmRender
         // release previous glyph data bank
         if (font_map->m_GlyphData) {
             free(font_map->m_GlyphData);
-            free(font_map->m_Cache);
             free(font_map->m_CellTempData);
         }
 
@@ -337,11 +378,8 @@ namespace dmRender
         font_map->m_CacheCellMaxAscent = params.m_CacheCellMaxAscent;
         font_map->m_CacheCellPadding = params.m_CacheCellPadding;
 
-        font_map->m_CacheColumns = params.m_CacheWidth / params.m_CacheCellWidth;
-        font_map->m_CacheRows = params.m_CacheHeight / params.m_CacheCellHeight;
-        uint32_t cell_count = font_map->m_CacheColumns * font_map->m_CacheRows;
-
         font_map->m_CellTempData = (uint8_t*)malloc(font_map->m_CacheCellWidth*font_map->m_CacheCellHeight*4);
+        font_map->m_CellTempDataCount = 1;
 
         switch (params.m_GlyphChannels)
         {
@@ -360,9 +398,6 @@ namespace dmRender
                 return;
         };
 
-        font_map->m_Cache = (Glyph**)malloc(sizeof(Glyph*) * cell_count);
-        memset(font_map->m_Cache, 0, sizeof(Glyph*) * cell_count);
-
         dmGraphics::TextureParams tex_params;
         tex_params.m_Format = font_map->m_CacheFormat;
         tex_params.m_Data = 0x0;
@@ -370,9 +405,8 @@ namespace dmRender
         tex_params.m_Width = params.m_CacheWidth;
         tex_params.m_Height = params.m_CacheHeight;
 
-        InitFontmap(params, tex_params, 0);
+        ResetGlyphCache(font_map, params.m_GlyphChannels, tex_params);
         dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-        CleanupFontmap(tex_params);
     }
 
     dmGraphics::HTexture GetFontMapTexture(HFontMap font_map)
@@ -594,85 +628,499 @@ namespace dmRender
         return true;
     }
 
-    void AddGlyphToCache(HFontMap font_map, TextContext& text_context, Glyph* g, int16_t g_offset_y) {
-        uint32_t prev_cache_cursor = font_map->m_CacheCursor;
+    // Unlinks a slot from the list starting at *first. The end of the list is only tracked if last isn't 0
+    static void UnlinkGlyphCacheSlot(dmArray<GlyphCacheSlot>& slots, uint32_t* first, uint32_t* last, uint32_t index)
+    {
+        GlyphCacheSlot& slot = slots[index];
+        if (slot.m_Prev != INVALID_GLYPH_CACHE_SLOT)
+            slots[slot.m_Prev].m_Next = slot.m_Next;
+        else
+            *first = slot.m_Next;
+        if (slot.m_Next != INVALID_GLYPH_CACHE_SLOT)
+            slots[slot.m_Next].m_Prev = slot.m_Prev;
+        else if (last)
+            *last = slot.m_Prev;
+        slot.m_Prev = INVALID_GLYPH_CACHE_SLOT;
+        slot.m_Next = INVALID_GLYPH_CACHE_SLOT;
+    }
+
+    static void PushGlyphCacheSlotFront(dmArray<GlyphCacheSlot>& slots, uint32_t* first, uint32_t index)
+    {
+        GlyphCacheSlot& slot = slots[index];
+        slot.m_Prev = INVALID_GLYPH_CACHE_SLOT;
+        slot.m_Next = *first;
+        if (*first != INVALID_GLYPH_CACHE_SLOT)
+            slots[*first].m_Prev = index;
+        *first = index;
+    }
+
+    static void PushGlyphCacheSlotBack(dmArray<GlyphCacheSlot>& slots, uint32_t* first, uint32_t* last, uint32_t index)
+    {
+        GlyphCacheSlot& slot = slots[index];
+        slot.m_Prev = *last;
+        slot.m_Next = INVALID_GLYPH_CACHE_SLOT;
+        if (*last != INVALID_GLYPH_CACHE_SLOT)
+            slots[*last].m_Next = index;
+        else
+            *first = index;
+        *last = index;
+    }
+
+    // Returns a slot record, reusing a spare one if possible. Note that this may reallocate the slot array.
+    static uint32_t NewGlyphCacheSlot(HFontMap font_map)
+    {
+        dmArray<GlyphCacheSlot>& slots = font_map->m_CacheSlots;
+        uint32_t index = font_map->m_CacheSpareSlots;
+        if (index != INVALID_GLYPH_CACHE_SLOT)
+        {
+            font_map->m_CacheSpareSlots = slots[index].m_Next;
+        }
+        else
+        {
+            if (slots.Full())
+            {
+                slots.OffsetCapacity(64);
+            }
+            GlyphCacheSlot slot;
+            slot.m_Pending = 0;
+            slots.Push(slot);
+            index = slots.Size() - 1;
+        }
+        GlyphCacheSlot& slot = slots[index];
+        slot.m_Glyph = 0;
+        slot.m_Left = INVALID_GLYPH_CACHE_SLOT;
+        slot.m_Right = INVALID_GLYPH_CACHE_SLOT;
+        slot.m_Prev = INVALID_GLYPH_CACHE_SLOT;
+        slot.m_Next = INVALID_GLYPH_CACHE_SLOT;
+        return index;
+    }
+
+    // Removes a free slot from its shelf, and puts the record in the list of spare records
+    static void RemoveGlyphCacheSlot(HFontMap font_map, uint32_t index)
+    {
+        dmArray<GlyphCacheSlot>& slots = font_map->m_CacheSlots;
+        GlyphCacheSlot& slot = slots[index];
+        if (slot.m_Left != INVALID_GLYPH_CACHE_SLOT)
+            slots[slot.m_Left].m_Right = slot.m_Right;
+        if (slot.m_Right != INVALID_GLYPH_CACHE_SLOT)
+            slots[slot.m_Right].m_Left = slot.m_Left;
+        else
+            font_map->m_CacheShelves[slot.m_Shelf].m_LastSlot = slot.m_Left;
+
+        slot.m_Glyph = 0;
+        slot.m_Next = font_map->m_CacheSpareSlots;
+        font_map->m_CacheSpareSlots = index;
+    }
+
+    // Adds a free slot at the end of a shelf
+    static uint32_t AddGlyphCacheSlot(HFontMap font_map, uint32_t shelf_index, uint32_t width)
+    {
+        uint32_t index = NewGlyphCacheSlot(font_map);
+        GlyphCacheShelf& shelf = font_map->m_CacheShelves[shelf_index];
+        GlyphCacheSlot& slot = font_map->m_CacheSlots[index];
+        slot.m_X = shelf.m_Width;
+        slot.m_Width = width;
+        slot.m_Shelf = shelf_index;
+        slot.m_Left = shelf.m_LastSlot;
+        if (shelf.m_LastSlot != INVALID_GLYPH_CACHE_SLOT)
+        {
+            font_map->m_CacheSlots[shelf.m_LastSlot].m_Right = index;
+        }
+        shelf.m_LastSlot = index;
+        shelf.m_Width += width;
+        return index;
+    }
+
+    // Frees a slot that isn't linked into any list, and merges it with the free slots next to it.
+    // A free slot at the end of the shelf is given back to the shelf.
+    // Returns the merged free slot, or INVALID_GLYPH_CACHE_SLOT if it was given back to the shelf.
+    static uint32_t FreeGlyphCacheSlot(HFontMap font_map, uint32_t index)
+    {
+        dmArray<GlyphCacheSlot>& slots = font_map->m_CacheSlots;
+        GlyphCacheShelf& shelf = font_map->m_CacheShelves[slots[index].m_Shelf];
+        slots[index].m_Glyph = 0;
+
+        uint32_t right = slots[index].m_Right;
+        if (right != INVALID_GLYPH_CACHE_SLOT && !slots[right].m_Glyph)
+        {
+            UnlinkGlyphCacheSlot(slots, &shelf.m_FreeSlots, 0, right);
+            slots[index].m_Width += slots[right].m_Width;
+            RemoveGlyphCacheSlot(font_map, right);
+        }
+
+        uint32_t left = slots[index].m_Left;
+        if (left != INVALID_GLYPH_CACHE_SLOT && !slots[left].m_Glyph)
+        {
+            UnlinkGlyphCacheSlot(slots, &shelf.m_FreeSlots, 0, left);
+            slots[left].m_Width += slots[index].m_Width;
+            RemoveGlyphCacheSlot(font_map, index);
+            index = left;
+        }
+
+        if (slots[index].m_Right == INVALID_GLYPH_CACHE_SLOT)
+        {
+            shelf.m_Width = slots[index].m_X;
+            RemoveGlyphCacheSlot(font_map, index);
+            return INVALID_GLYPH_CACHE_SLOT;
+        }
+
+        PushGlyphCacheSlotFront(slots, &shelf.m_FreeSlots, index);
+        return index;
+    }
+
+    // Puts the glyph in a free slot that isn't linked into any list. The part of the slot to the right of the glyph is freed.
+    static uint32_t TakeGlyphCacheSlot(HFontMap font_map, uint32_t index, Glyph* g, uint32_t frame, uint32_t width)
+    {
+        uint32_t remainder = font_map->m_CacheSlots[index].m_Width - width;
+        if (remainder > 0)
+        {
+            uint32_t right_index = NewGlyphCacheSlot(font_map);
+            GlyphCacheSlot& slot = font_map->m_CacheSlots[index];
+            GlyphCacheSlot& right = font_map->m_CacheSlots[right_index];
+            right.m_X = slot.m_X + width;
+            right.m_Width = remainder;
+            right.m_Shelf = slot.m_Shelf;
+            right.m_Left = index;
+            right.m_Right = slot.m_Right;
+            if (slot.m_Right != INVALID_GLYPH_CACHE_SLOT)
+                font_map->m_CacheSlots[slot.m_Right].m_Left = right_index;
+            else
+                font_map->m_CacheShelves[slot.m_Shelf].m_LastSlot = right_index;
+            slot.m_Right = right_index;
+            slot.m_Width = width;
+            slot.m_Glyph = g;
+            FreeGlyphCacheSlot(font_map, right_index);
+        }
+
+        font_map->m_CacheSlots[index].m_Glyph = g;
+        g->m_Frame = frame;
+        PushGlyphCacheSlotBack(font_map->m_CacheSlots, &font_map->m_CacheLRUFirst, &font_map->m_CacheLRULast, index);
+        return index;
+    }
+
+    // Finds room for a glyph of the given size in the cache texture. In order of preference, the glyph is placed in
+    // the best fitting free slot, at the end of a shelf, in a new shelf or in the room freed by evicting the least
+    // recently used glyphs. Returns the index of the slot, or -1 if all glyphs that could be evicted are used this frame.
+    static int32_t AllocateGlyphCacheSlot(HFontMap font_map, Glyph* g, uint32_t frame, uint32_t width, uint32_t height)
+    {
+        dmArray<GlyphCacheShelf>& shelves = font_map->m_CacheShelves;
+        dmArray<GlyphCacheSlot>& slots = font_map->m_CacheSlots;
+
+        if (width > font_map->m_CacheWidth || height > font_map->m_CacheHeight)
+        {
+            return -1;
+        }
+
+        uint32_t free_slot = INVALID_GLYPH_CACHE_SLOT;
+        uint32_t free_slot_waste = 0xffffffff;
+        int32_t best_shelf = -1;
+        uint32_t best_shelf_waste = 0xffffffff;
+        for (uint32_t i = 0; i < shelves.Size(); ++i)
+        {
+            GlyphCacheShelf& shelf = shelves[i];
+            if (shelf.m_Height < height)
+                continue;
+
+            for (uint32_t j = shelf.m_FreeSlots; j != INVALID_GLYPH_CACHE_SLOT; j = slots[j].m_Next)
+            {
+                uint32_t slot_width = slots[j].m_Width;
+                if (slot_width < width)
+                    continue;
+                uint32_t waste = slot_width * shelf.m_Height - width * height;
+                if (waste < free_slot_waste)
+                {
+                    free_slot = j;
+                    free_slot_waste = waste;
+                }
+            }
+
+            uint32_t waste = shelf.m_Height - height;
+            if (font_map->m_CacheWidth - shelf.m_Width >= width && waste < best_shelf_waste)
+            {
+                best_shelf = (int32_t)i;
+                best_shelf_waste = waste;
+            }
+        }
+
+        if (free_slot != INVALID_GLYPH_CACHE_SLOT)
+        {
+            UnlinkGlyphCacheSlot(slots, &shelves[slots[free_slot].m_Shelf].m_FreeSlots, 0, free_slot);
+            return TakeGlyphCacheSlot(font_map, free_slot, g, frame, width);
+        }
+
+        // Start a new shelf if there is none, or if the best one is much higher than the glyph
+        uint32_t shelves_end = shelves.Empty() ? 0 : shelves.Back().m_Y + shelves.Back().m_Height;
+        uint32_t shelf_height = dmMath::Min((height + 3) & ~3u, font_map->m_CacheHeight - shelves_end);
+        if ((best_shelf == -1 || best_shelf_waste > height / 2) && shelf_height >= height)
+        {
+            if (shelves.Full())
+            {
+                shelves.OffsetCapacity(16);
+            }
+            GlyphCacheShelf shelf;
+            shelf.m_Y = shelves_end;
+            shelf.m_Height = shelf_height;
+            shelf.m_Width = 0;
+            shelf.m_LastSlot = INVALID_GLYPH_CACHE_SLOT;
+            shelf.m_FreeSlots = INVALID_GLYPH_CACHE_SLOT;
+            shelf.m_DirtyStart = font_map->m_CacheWidth;
+            shelf.m_DirtyEnd = 0;
+            shelves.Push(shelf);
+            best_shelf = shelves.Size() - 1;
+        }
+
+        if (best_shelf != -1)
+        {
+            return TakeGlyphCacheSlot(font_map, AddGlyphCacheSlot(font_map, best_shelf, width), g, frame, width);
+        }
+
+        // Evict the least recently used glyphs in shelves that are high enough, until the freed room, merged with
+        // the free slots next to it, fits the glyph. The glyphs after the first one used this frame are used this frame too.
+        uint32_t next = font_map->m_CacheLRUFirst;
+        while (next != INVALID_GLYPH_CACHE_SLOT && slots[next].m_Glyph->m_Frame != frame)
+        {
+            uint32_t index = next;
+            next = slots[index].m_Next;
+
+            uint32_t shelf_index = slots[index].m_Shelf;
+            GlyphCacheShelf& shelf = shelves[shelf_index];
+            if (shelf.m_Height < height)
+                continue;
+
+            UnlinkGlyphCacheSlot(slots, &font_map->m_CacheLRUFirst, &font_map->m_CacheLRULast, index);
+            slots[index].m_Glyph->m_InCache = false;
+            uint32_t free_index = FreeGlyphCacheSlot(font_map, index);
+            if (free_index == INVALID_GLYPH_CACHE_SLOT)
+            {
+                if (font_map->m_CacheWidth - shelf.m_Width >= width)
+                {
+                    return TakeGlyphCacheSlot(font_map, AddGlyphCacheSlot(font_map, shelf_index, width), g, frame, width);
+                }
+            }
+            else if (slots[free_index].m_Width >= width)
+            {
+                UnlinkGlyphCacheSlot(slots, &shelf.m_FreeSlots, 0, free_index);
+                return TakeGlyphCacheSlot(font_map, free_index, g, frame, width);
+            }
+        }
+        return -1;
+    }
+
+    // Moves a cached glyph last in the LRU list, the first time it is used in a frame
+    static void UseCachedGlyph(HFontMap font_map, Glyph* g, uint32_t frame)
+    {
+        if (g->m_Frame == frame)
+        {
+            return;
+        }
+        g->m_Frame = frame;
+        UnlinkGlyphCacheSlot(font_map->m_CacheSlots, &font_map->m_CacheLRUFirst, &font_map->m_CacheLRULast, g->m_CacheSlot);
+        PushGlyphCacheSlotBack(font_map->m_CacheSlots, &font_map->m_CacheLRUFirst, &font_map->m_CacheLRULast, g->m_CacheSlot);
+    }
+
+    // Reserves room for the glyph in the cache texture. The glyph is decoded into the texture data in UploadGlyphCache
+    void AddGlyphToCache(HFontMap font_map, TextContext& text_context, Glyph* g) {
+        uint32_t width = g->m_Width + font_map->m_CacheCellPadding*2;
+        uint32_t height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
+
+        int32_t slot_index = AllocateGlyphCacheSlot(font_map, g, text_context.m_Frame, width, height);
+        if (slot_index == -1)
+        {
+            dmLogError("Out of available cache cells! Consider increasing cache_width or cache_height for the font.");
+            return;
+        }
+
+        GlyphCacheSlot& slot = font_map->m_CacheSlots[slot_index];
+        g->m_X = slot.m_X;
+        g->m_Y = font_map->m_CacheShelves[slot.m_Shelf].m_Y;
+        g->m_CacheSlot = slot_index;
+        g->m_InCache = true;
+
+        if (!slot.m_Pending)
+        {
+            slot.m_Pending = 1;
+            if (font_map->m_CachePendingSlots.Full())
+            {
+                font_map->m_CachePendingSlots.OffsetCapacity(64);
+            }
+            font_map->m_CachePendingSlots.Push(slot_index);
+        }
+
+        DM_PROPERTY_ADD_U32(rmtp_FontGlyphCacheMissCount, 1);
+    }
+
+    // Decodes the glyph of a slot into the cache texture data. Slots never overlap, so the glyphs can be decoded in parallel,
+    // each with its own temp_data for the compressed glyphs.
+    static void DecodeGlyphCacheSlot(HFontMap font_map, const GlyphCacheSlot& slot, uint8_t* temp_data)
+    {
+        const Glyph* g = slot.m_Glyph;
+        const GlyphCacheShelf& shelf = font_map->m_CacheShelves[slot.m_Shelf];
+        uint32_t width = g->m_Width + font_map->m_CacheCellPadding*2;
+        uint32_t height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
+
+        // Clear the whole slot, so that no pixels of a previous, larger, glyph are left around the new one
+        uint32_t channels = font_map->m_CacheChannels;
+        uint32_t stride = font_map->m_CacheWidth * channels;
+        uint8_t* dst = font_map->m_CacheData + shelf.m_Y * stride + slot.m_X * channels;
+        for (uint32_t y = 0; y < shelf.m_Height; ++y, dst += stride)
+        {
+            memset(dst, 0, slot.m_Width * channels);
+        }
+
+        uint8_t* glyph_data = (uint8_t*)(uint8_t*)font_map->m_GlyphData + g->m_GlyphDataOffset;
+        uint32_t glyph_data_size = g->m_GlyphDataSize-1; // The first byte is a header
+        uint8_t compression_type = *glyph_data++;
+
+        if (compression_type) {
+
+            // When if came to choosing between the different algorithms, here are some speed/compression tests
+            // Decoding 100 glyphs
+            // lz4:     0.1060 ms  compression: 72%
+            // deflate: 0.2190 ms  compression: 66%
+            // png:     0.6930 ms  compression: 67%
+            // webp:    1.5170 ms  compression: 55%
+            // further improvements (different test, Android, 92 glyphs)
+            // webp          2.9440 ms  compression: 55%
+            // deflate       0.7110 ms  compression: 66%
+            // deflate+delta 0.7680 ms  compression: 62%
+
+            FontGlyphInflaterContext deflate_context;
+            deflate_context.m_Output = temp_data;
+            deflate_context.m_Cursor = 0;
+            dmZlib::Result zlib_result = dmZlib::InflateBuffer(glyph_data, glyph_data_size, &deflate_context, FontGlyphInflater);
+            if (zlib_result != dmZlib::RESULT_OK)
+            {
+                dmLogError("Failed to decompress glyph (%c)", g->m_Character);
+                return;
+            }
+
+            uint32_t uncompressed_size = deflate_context.m_Cursor;
+            delta_decode(temp_data, uncompressed_size);
+
+            glyph_data = temp_data;
+        }
+
+        dst = font_map->m_CacheData + shelf.m_Y * stride + slot.m_X * channels;
+        for (uint32_t y = 0; y < height; ++y, dst += stride)
+        {
+            memcpy(dst, glyph_data + y * width * channels, width * channels);
+        }
+    }
+
+    struct DecodeGlyphCacheContext
+    {
+        HFontMap m_FontMap;
+        uint32_t m_JobCount;
+    };
+
+    // Decodes every m_JobCount:th pending slot, starting at the job index
+    static void DecodeGlyphCacheJob(void* _ctx, uint32_t index)
+    {
+        DecodeGlyphCacheContext* ctx = (DecodeGlyphCacheContext*)_ctx;
+        HFontMap font_map = ctx->m_FontMap;
+        uint8_t* temp_data = font_map->m_CellTempData + index * font_map->m_CacheCellWidth * font_map->m_CacheCellHeight * 4;
+        const dmArray<uint32_t>& pending = font_map->m_CachePendingSlots;
+        for (uint32_t i = index; i < pending.Size(); i += ctx->m_JobCount)
+        {
+            const GlyphCacheSlot& slot = font_map->m_CacheSlots[pending[i]];
+            if (slot.m_Glyph)
+            {
+                DecodeGlyphCacheSlot(font_map, slot, temp_data);
+            }
+        }
+    }
+
+    // Uploads the dirty columns of a shelf as one rectangle
+    static void UploadGlyphCacheShelf(HFontMap font_map, GlyphCacheShelf& shelf)
+    {
+        uint32_t channels = font_map->m_CacheChannels;
+        uint32_t stride = font_map->m_CacheWidth * channels;
+        uint32_t width = shelf.m_DirtyEnd - shelf.m_DirtyStart;
+        uint32_t row_size = width * channels;
+        const uint8_t* data = font_map->m_CacheData + shelf.m_Y * stride + shelf.m_DirtyStart * channels;
+        if (width < font_map->m_CacheWidth)
+        {
+            // The rows of the rectangle have to be tightly packed
+            dmArray<uint8_t>& upload_data = font_map->m_CacheUploadData;
+            if (upload_data.Capacity() < row_size * shelf.m_Height)
+            {
+                upload_data.SetCapacity(row_size * shelf.m_Height);
+            }
+            upload_data.SetSize(row_size * shelf.m_Height);
+            for (uint32_t y = 0; y < shelf.m_Height; ++y)
+            {
+                memcpy(upload_data.Begin() + y * row_size, data + y * stride, row_size);
+            }
+            data = upload_data.Begin();
+        }
+
         dmGraphics::TextureParams tex_params;
         tex_params.m_SubUpdate = true;
         tex_params.m_MipMap = 0;
         tex_params.m_Format = font_map->m_CacheFormat;
         tex_params.m_MinFilter = font_map->m_MinFilter;
         tex_params.m_MagFilter = font_map->m_MagFilter;
+        tex_params.m_X = shelf.m_DirtyStart;
+        tex_params.m_Y = shelf.m_Y;
+        tex_params.m_Width = width;
+        tex_params.m_Height = shelf.m_Height;
+        tex_params.m_Data = data;
+        tex_params.m_DataSize = row_size * shelf.m_Height;
+        dmGraphics::SetTexture(font_map->m_Texture, tex_params);
 
-        // Locate a cache cell candidate
-        do {
-            uint32_t cur = font_map->m_CacheCursor++;
-            Glyph* candidate = font_map->m_Cache[cur];
-            font_map->m_CacheCursor = font_map->m_CacheCursor % (font_map->m_CacheColumns * font_map->m_CacheRows);
-            if (candidate == 0x0 || text_context.m_Frame != candidate->m_Frame) {
-
-                if (candidate) {
-                    candidate->m_InCache = false;
-                }
-                font_map->m_Cache[cur] = g;
-
-                uint32_t col = cur % font_map->m_CacheColumns;
-                uint32_t row = cur / font_map->m_CacheColumns;
-
-                g->m_X = col * font_map->m_CacheCellWidth;
-                g->m_Y = row * font_map->m_CacheCellHeight;
-                g->m_Frame = text_context.m_Frame;
-                g->m_InCache = true;
-
-                // Upload glyph data to GPU
-                tex_params.m_Width = g->m_Width + font_map->m_CacheCellPadding*2;
-                tex_params.m_Height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
-
-                uint8_t* glyph_data = (uint8_t*)(uint8_t*)font_map->m_GlyphData + g->m_GlyphDataOffset;
-                uint32_t glyph_data_size = g->m_GlyphDataSize-1; // The first byte is a header
-                uint8_t compression_type = *glyph_data++;
-
-                if (compression_type) {
-
-                    // When if came to choosing between the different algorithms, here are some speed/compression tests
-                    // Decoding 100 glyphs
-                    // lz4:     0.1060 ms  compression: 72%
-                    // deflate: 0.2190 ms  compression: 66%
-                    // png:     0.6930 ms  compression: 67%
-                    // webp:    1.5170 ms  compression: 55%
-                    // further improvements (different test, Android, 92 glyphs)
-                    // webp          2.9440 ms  compression: 55%
-                    // deflate       0.7110 ms  compression: 66%
-                    // deflate+delta 0.7680 ms  compression: 62%
-
-                    FontGlyphInflaterContext deflate_context;
-                    deflate_context.m_Output = font_map->m_CellTempData;
-                    deflate_context.m_Cursor = 0;
-                    dmZlib::Result zlib_result = dmZlib::InflateBuffer(glyph_data, glyph_data_size, &deflate_context, FontGlyphInflater);
-                    if (zlib_result != dmZlib::RESULT_OK)
-                    {
-                        dmLogError("Failed to decompress glyph (%c)", g->m_Character);
-                        return;
-                    }
+        shelf.m_DirtyStart = font_map->m_CacheWidth;
+        shelf.m_DirtyEnd = 0;
 
-                    uint32_t uncompressed_size = deflate_context.m_Cursor;
-                    delta_decode(font_map->m_CellTempData, uncompressed_size);
+        font_map->m_CacheUploadCount++;
+        font_map->m_CacheUploadSize += tex_params.m_DataSize;
+        DM_PROPERTY_ADD_U32(rmtp_FontGlyphCacheUploadSize, tex_params.m_DataSize);
+    }
 
-                    tex_params.m_Data = font_map->m_CellTempData;
-                } else {
-                    tex_params.m_Data = glyph_data;
-                }
+    // Decodes the glyphs added to the cache on the job pool, and uploads the changed part of each shelf of the cache texture
+    static void UploadGlyphCache(HRenderContext render_context, HFontMap font_map)
+    {
+        font_map->m_CacheUploadCount = 0;
+        font_map->m_CacheUploadSize = 0;
+        dmArray<uint32_t>& pending = font_map->m_CachePendingSlots;
+        if (pending.Empty())
+        {
+            return;
+        }
 
-                tex_params.m_X = g->m_X;
-                tex_params.m_Y = g->m_Y + g_offset_y;
+        DM_PROFILE("UploadGlyphCache");
 
-                dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-                break;
+        for (uint32_t i = 0; i < pending.Size(); ++i)
+        {
+            GlyphCacheSlot& slot = font_map->m_CacheSlots[pending[i]];
+            slot.m_Pending = 0;
+            // The glyph may have been evicted before it was decoded
+            if (slot.m_Glyph)
+            {
+                GlyphCacheShelf& shelf = font_map->m_CacheShelves[slot.m_Shelf];
+                shelf.m_DirtyStart = dmMath::Min(shelf.m_DirtyStart, slot.m_X);
+                shelf.m_DirtyEnd = dmMath::Max(shelf.m_DirtyEnd, slot.m_X + slot.m_Width);
             }
+        }
 
-        } while (prev_cache_cursor != font_map->m_CacheCursor);
+        DecodeGlyphCacheContext ctx;
+        ctx.m_FontMap = font_map;
+        ctx.m_JobCount = dmMath::Min(pending.Size(), dmJobPool::GetThreadCount(render_context->m_JobPool) + 1);
+        if (ctx.m_JobCount > font_map->m_CellTempDataCount)
+        {
+            free(font_map->m_CellTempData);
+            font_map->m_CellTempData = (uint8_t*)malloc(ctx.m_JobCount * font_map->m_CacheCellWidth * font_map->m_CacheCellHeight * 4);
+            font_map->m_CellTempDataCount = ctx.m_JobCount;
+        }
+        dmJobPool::Run(render_context->m_JobPool, DecodeGlyphCacheJob, &ctx, ctx.m_JobCount);
+        pending.SetSize(0);
 
-        if (prev_cache_cursor == font_map->m_CacheCursor) {
-            dmLogError("Out of available cache cells! Consider increasing cache_width or cache_height for the font.");
+        for (uint32_t i = 0; i < font_map->m_CacheShelves.Size(); ++i)
+        {
+            GlyphCacheShelf& shelf = font_map->m_CacheShelves[i];
+            if (shelf.m_DirtyStart < shelf.m_DirtyEnd)
+            {
+                UploadGlyphCacheShelf(font_map, shelf);
+            }
         }
     }
 
@@ -766,13 +1214,11 @@ namespace dmRender
 
                     if (g->m_Width > 0)
                     {
-                        int16_t px_cell_offset_y = font_map->m_CacheCellMaxAscent - (int16_t)g->m_Ascent;
-
                         // Prepare the cache here aswell since we only count glyphs we definitely
                         // will render.
                         if (!g->m_InCache)
                         {
-                            AddGlyphToCache(font_map, text_context, g, px_cell_offset_y);
+                            AddGlyphToCache(font_map, text_context, g);
                         }
 
                         if (g->m_InCache)
@@ -821,15 +1267,12 @@ namespace dmRender
                     int16_t descent = (int16_t) g->m_Descent;
                     int16_t ascent  = (int16_t) g->m_Ascent;
 
-                    // Calculate y-offset in cache-cell space by moving glyphs down to baseline
-                    int16_t px_cell_offset_y = font_map->m_CacheCellMaxAscent - ascent;
-
                     if (!g->m_InCache) {
-                        AddGlyphToCache(font_map, text_context, g, px_cell_offset_y);
+                        AddGlyphToCache(font_map, text_context, g);
                     }
 
                     if (g->m_InCache) {
-                        g->m_Frame = text_context.m_Frame;
+                        UseCachedGlyph(font_map, g, text_context.m_Frame);
 
                         uint32_t face_index = vertexindex + vertices_per_quad * valid_glyph_count * (layer_count-1);
 
@@ -847,16 +1290,16 @@ namespace dmRender
                         (Vector4&) v6_layer_face.m_Position = te.m_Transform * Vector4(x + g->m_LeftBearing + width, y + ascent, 0, 1);
 
                         v1_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding) * recip_w;
-                        v1_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent + px_cell_offset_y) * recip_h;
+                        v1_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent) * recip_h;
 
                         v2_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding) * recip_w;
-                        v2_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + px_cell_offset_y) * recip_h;
+                        v2_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding) * recip_h;
 
                         v3_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding + g->m_Width) * recip_w;
-                        v3_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent + px_cell_offset_y) * recip_h;
+                        v3_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + ascent + descent) * recip_h;
 
                         v6_layer_face.m_UV[0] = (g->m_X + font_map->m_CacheCellPadding + g->m_Width) * recip_w;
-                        v6_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding + px_cell_offset_y) * recip_h;
+                        v6_layer_face.m_UV[1] = (g->m_Y + font_map->m_CacheCellPadding) * recip_h;
 
                         #define SET_VERTEX_FONT_PROPERTIES(v) \
                             v.m_FaceColor[0]    = face_color[0]; \
@@ -1047,6 +1490,8 @@ namespace dmRender
 
         ro->m_VertexCount = text_context.m_VertexIndex - ro->m_VertexStart;
 
+        UploadGlyphCache(render_context, font_map);
+
         dmRender::AddToRender(render_context, ro);
     }
 
@@ -1192,6 +1637,9 @@ namespace dmRender
         uint32_t size = sizeof(FontMap);
         size += font_map->m_Glyphs.Capacity()*(sizeof(Glyph)+sizeof(uint32_t));
         size += dmGraphics::GetTextureResourceSize(font_map->m_Texture);
+        size += font_map->m_CacheWidth * font_map->m_CacheHeight * font_map->m_CacheChannels;
+        size += font_map->m_CacheShelves.Capacity() * sizeof(GlyphCacheShelf) + font_map->m_CacheSlots.Capacity() * sizeof(GlyphCacheSlot);
+        size += font_map->m_CachePendingSlots.Capacity() * sizeof(uint32_t) + font_map->m_CacheUploadData.Capacity();
         return size;
     }
 
@@ -1204,4 +1652,25 @@ namespace dmRender
     {
         return font_map->m_MagFilter == filter;
     }
+
+    uint32_t GetFontMapCacheGlyphCount(dmRender::HFontMap font_map)
+    {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < font_map->m_CacheSlots.Size(); ++i)
+        {
+            count += font_map->m_CacheSlots[i].m_Glyph != 0;
+        }
+        return count;
+    }
+
+    const uint8_t* GetFontMapCacheData(dmRender::HFontMap font_map)
+    {
+        return font_map->m_CacheData;
+    }
+
+    void GetFontMapCacheUploadStats(dmRender::HFontMap font_map, uint32_t* upload_count, uint32_t* upload_size)
+    {
+        *upload_count = font_map->m_CacheUploadCount;
+        *upload_size = font_map->m_CacheUploadSize;
+    }
 }
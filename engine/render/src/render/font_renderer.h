@@ -51,6 +51,8 @@ namespace dmRender
         int32_t     m_Y;
 
         bool        m_InCache;
+        /// Index of the glyph cache slot, when the glyph is in the cache
+        uint32_t    m_CacheSlot;
         uint64_t    m_GlyphDataOffset;
         uint64_t    m_GlyphDataSize;
         uint32_t    m_Frame;
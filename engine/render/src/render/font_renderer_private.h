@@ -165,6 +165,9 @@ namespace dmRender
     // Used in unit tests
     bool VerifyFontMapMinFilter(dmRender::HFontMap font_map, dmGraphics::TextureFilter filter);
     bool VerifyFontMapMagFilter(dmRender::HFontMap font_map, dmGraphics::TextureFilter filter);
+    uint32_t GetFontMapCacheGlyphCount(dmRender::HFontMap font_map);
+    const uint8_t* GetFontMapCacheData(dmRender::HFontMap font_map);
+    void GetFontMapCacheUploadStats(dmRender::HFontMap font_map, uint32_t* upload_count, uint32_t* upload_size);
 }
 
 #endif // #ifndef DM_FONT_RENDERER_PRIVATE
@@ -86,6 +86,7 @@ namespace dmRender
     , m_MaxCharacters(0)
     , m_CommandBufferSize(1024)
     , m_MaxDebugVertexCount(0)
+    , m_JobPool(0x0)
     {
 
     }
@@ -133,6 +134,15 @@ namespace dmRender
         context->m_StencilBufferCleared = 0;
 
         context->m_RenderListDispatch.SetCapacity(255);
+        context->m_JobPool = params.m_JobPool;
+
+        context->m_RenderListVersion = 1;
+        context->m_RenderListSortCacheNext = 0;
+        context->m_RenderListSortCount = 0;
+        for (uint32_t i = 0; i < MAX_RENDER_LIST_SORT_CACHE_COUNT; ++i)
+        {
+            context->m_RenderListSortCache[i].m_Version = 0;
+        }
 
         dmMessage::Result r = dmMessage::NewSocket(RENDER_SOCKET_NAME, &context->m_Socket);
         assert(r == dmMessage::RESULT_OK);
@@ -163,6 +173,7 @@ namespace dmRender
         render_context->m_RenderListSortIndices.SetSize(0);
         render_context->m_RenderListDispatch.SetSize(0);
         render_context->m_RenderListRanges.SetSize(0);
+        render_context->m_RenderListVersion++;
         render_context->m_FrustumHash = 0xFFFFFFFF; // trigger a first recalculation each frame
     }
 
@@ -207,9 +218,6 @@ namespace dmRender
         uint32_t size = render_list.Size();
         render_list.SetSize(size + entries);
 
-        // If we push new items after the last frustum culling, we need to reevaluate it
-        render_context->m_FrustumHash = 0xFFFFFFFF;
-
         return (render_list.Begin() + size);
     }
 
@@ -242,18 +250,12 @@ namespace dmRender
 
         // invalidate the ranges if this is a call to the debug rendering (happening in the middle of the frame)
         render_context->m_RenderListRanges.SetSize(0);
-    }
 
-    struct RenderListSorter
-    {
-        bool operator()(uint32_t a, uint32_t b) const
-        {
-            const RenderListSortValue& u = values[a];
-            const RenderListSortValue& v = values[b];
-            return u.m_SortKey < v.m_SortKey;
-        }
-        RenderListSortValue* values;
-    };
+        // If we push new items after the last frustum culling, we need to reevaluate it
+        render_context->m_FrustumHash = 0xFFFFFFFF;
+        // ...and the sorted render lists are no longer valid
+        render_context->m_RenderListVersion++;
+    }
 
     void RenderListEnd(HRenderContext render_context)
     {
@@ -372,110 +374,180 @@ namespace dmRender
         return false;
     }
 
+    // Number of sorted render list indices handled by each sort job
+    static const uint32_t SORT_JOB_SIZE = 1024;
+
+    struct SortJobsContext
+    {
+        HRenderContext  m_Context;
+        // Only the z and w rows of the view projection are needed
+        Vector4         m_RowZ;
+        Vector4         m_RowW;
+        float           m_MinZW;
+        float           m_RC;
+        uint32_t*       m_SortBuffer;
+    };
+
+    // Writes the z values of the visible world entries, and counts the visible entries
+    static void SortZJob(void* _ctx, uint32_t job_index)
+    {
+        SortJobsContext* ctx = (SortJobsContext*)_ctx;
+        HRenderContext context = ctx->m_Context;
+        RenderListSortJob& job = context->m_RenderListSortJobs[job_index];
+        RenderListSortValue* sort_values = context->m_RenderListSortValues.Begin();
+        const RenderListEntry* entries = context->m_RenderList.Begin();
+        const uint32_t* indices = context->m_RenderListSortIndices.Begin();
+        const Vector4 row_z = ctx->m_RowZ;
+        const Vector4 row_w = ctx->m_RowW;
+
+        float minZW = FLT_MAX;
+        float maxZW = -FLT_MAX;
+        uint32_t visible_count = 0;
+        for (uint32_t i = job.m_Start; i < job.m_Start + job.m_Count; ++i)
+        {
+            uint32_t idx = indices[i];
+            const RenderListEntry* entry = &entries[idx];
+            if (entry->m_Visibility == dmRender::VISIBILITY_NONE)
+            {
+                continue;
+            }
+            ++visible_count;
+
+            if (entry->m_MajorOrder != RENDER_ORDER_WORLD)
+            {
+                continue; // Could perhaps break here, if we also sorted on the major order (cost more when I tested it /MAWE)
+            }
+
+            const Point3& p = entry->m_WorldPosition;
+            const float z = row_z.getX() * p.getX() + row_z.getY() * p.getY() + row_z.getZ() * p.getZ() + row_z.getW();
+            const float w = row_w.getX() * p.getX() + row_w.getY() * p.getY() + row_w.getZ() * p.getZ() + row_w.getW();
+            const float zw = z / w;
+            sort_values[idx].m_ZW = zw;
+            if (zw < minZW) minZW = zw;
+            if (zw > maxZW) maxZW = zw;
+        }
+
+        job.m_VisibleCount = visible_count;
+        job.m_MinZW = minZW;
+        job.m_MaxZW = maxZW;
+    }
+
+    // Writes the sort values of the visible entries, and their indices to the part of the sort buffer owned by the job
+    static void SortValueJob(void* _ctx, uint32_t job_index)
+    {
+        SortJobsContext* ctx = (SortJobsContext*)_ctx;
+        HRenderContext context = ctx->m_Context;
+        const RenderListSortJob& job = context->m_RenderListSortJobs[job_index];
+        RenderListSortValue* sort_values = context->m_RenderListSortValues.Begin();
+        const RenderListEntry* entries = context->m_RenderList.Begin();
+        const uint32_t* indices = context->m_RenderListSortIndices.Begin();
+        uint32_t* sort_buffer = ctx->m_SortBuffer + job.m_SortBufferOffset;
+        const float minZW = ctx->m_MinZW;
+        const float rc = ctx->m_RC;
+
+        for (uint32_t i = job.m_Start; i < job.m_Start + job.m_Count; ++i)
+        {
+            uint32_t idx = indices[i];
+            const RenderListEntry* entry = &entries[idx];
+
+            if (entry->m_Visibility == dmRender::VISIBILITY_NONE)
+            {
+                continue;
+            }
+
+            sort_values[idx].m_MajorOrder = entry->m_MajorOrder;
+            if (entry->m_MajorOrder == RENDER_ORDER_WORLD)
+            {
+                const float z = sort_values[idx].m_ZW;
+                sort_values[idx].m_Order = (uint32_t) (0xfffff8 - 0xfffff0 * rc * (z - minZW));
+            }
+            else
+            {
+                // use the integer value provided.
+                sort_values[idx].m_Order = entry->m_Order;
+            }
+            sort_values[idx].m_MinorOrder = entry->m_MinorOrder;
+            sort_values[idx].m_BatchKey = entry->m_BatchKey & 0x00ffffff;
+            sort_values[idx].m_Dispatch = entry->m_Dispatch;
+            *sort_buffer++ = idx;
+        }
+    }
+
     // Compute new sort values for everything that matches tag_mask
-    static void MakeSortBuffer(HRenderContext context, uint32_t tag_count, dmhash_t* tags)
+    // The matching ranges are split into jobs, run in two passes since the z range of all of them is needed for the sort order
+    static void MakeSortBuffer(HRenderContext context, uint32_t tag_count, dmhash_t* tags, dmArray<uint32_t>& sort_buffer)
     {
         DM_PROFILE("MakeSortBuffer");
 
         const uint32_t required_capacity = context->m_RenderListSortIndices.Capacity();
         // SetCapacity does early out if they are the same, so just call anyway.
-        context->m_RenderListSortBuffer.SetCapacity(required_capacity);
-        context->m_RenderListSortBuffer.SetSize(0);
+        sort_buffer.SetCapacity(required_capacity);
+        sort_buffer.SetSize(0);
         context->m_RenderListSortValues.SetCapacity(required_capacity);
         context->m_RenderListSortValues.SetSize(context->m_RenderListSortIndices.Size());
 
-        RenderListSortValue* sort_values = context->m_RenderListSortValues.Begin();
-        RenderListEntry* entries = context->m_RenderList.Begin();
-
-        const Matrix4& transform = context->m_ViewProj;
-
-        float minZW = FLT_MAX;
-        float maxZW = -FLT_MAX;
+        dmArray<RenderListSortJob>& jobs = context->m_RenderListSortJobs;
+        jobs.SetSize(0);
 
-        RenderListRange* ranges = context->m_RenderListRanges.Begin();
+        const RenderListRange* ranges = context->m_RenderListRanges.Begin();
         uint32_t num_ranges = context->m_RenderListRanges.Size();
         for( uint32_t r = 0; r < num_ranges; ++r)
         {
-            RenderListRange& range = ranges[r];
+            const RenderListRange& range = ranges[r];
 
             MaterialTagList taglist;
             dmRender::GetMaterialTagList(context, range.m_TagListKey, &taglist);
 
-            range.m_Skip = 0;
             if (tag_count > 0 && !dmRender::MatchMaterialTags(taglist.m_Count, taglist.m_Tags, tag_count, tags))
             {
-                range.m_Skip = 1;
                 continue;
             }
 
-            // Write z values...
-            int num_visibility_skipped = 0;
-            for (uint32_t i = range.m_Start; i < range.m_Start+range.m_Count; ++i)
+            uint32_t end = range.m_Start + range.m_Count;
+            for (uint32_t start = range.m_Start; start < end; start += SORT_JOB_SIZE)
             {
-                uint32_t idx = context->m_RenderListSortIndices[i];
-                RenderListEntry* entry = &entries[idx];
-                if (entry->m_Visibility == dmRender::VISIBILITY_NONE)
+                if (jobs.Full())
                 {
-                    num_visibility_skipped++;
-                    continue;
+                    jobs.OffsetCapacity(16);
                 }
+                RenderListSortJob job;
+                job.m_Start = start;
+                job.m_Count = dmMath::Min(SORT_JOB_SIZE, end - start);
+                jobs.Push(job);
+            }
+        }
 
-                if (entry->m_MajorOrder != RENDER_ORDER_WORLD)
-                {
-                    continue; // Could perhaps break here, if we also sorted on the major order (cost more when I tested it /MAWE)
-                }
+        SortJobsContext ctx;
+        ctx.m_Context = context;
+        ctx.m_RowZ = context->m_ViewProj.getRow(2);
+        ctx.m_RowW = context->m_ViewProj.getRow(3);
 
-                const Vector4 res = transform * entry->m_WorldPosition;
-                const float zw = res.getZ() / res.getW();
-                sort_values[idx].m_ZW = zw;
-                if (zw < minZW) minZW = zw;
-                if (zw > maxZW) maxZW = zw;
-            }
+        // Write z values...
+        uint32_t job_count = jobs.Size();
+        dmJobPool::Run(context->m_JobPool, SortZJob, &ctx, job_count);
 
-            if (num_visibility_skipped == range.m_Count)
-            {
-                range.m_Skip = 1;
-            }
+        // ... and compute range, and where each job writes its indices
+        float minZW = FLT_MAX;
+        float maxZW = -FLT_MAX;
+        uint32_t visible_count = 0;
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            RenderListSortJob& job = jobs[i];
+            minZW = dmMath::Min(minZW, job.m_MinZW);
+            maxZW = dmMath::Max(maxZW, job.m_MaxZW);
+            job.m_SortBufferOffset = visible_count;
+            visible_count += job.m_VisibleCount;
         }
 
-        // ... and compute range
         float rc = 0;
         if (maxZW > minZW)
             rc = 1.0f / (maxZW - minZW);
 
-        for( uint32_t i = 0; i < num_ranges; ++i)
-        {
-            const RenderListRange& range = ranges[i];
-            if (range.m_Skip)
-                continue;
-
-            for (uint32_t i = range.m_Start; i < range.m_Start+range.m_Count; ++i)
-            {
-                uint32_t idx = context->m_RenderListSortIndices[i];
-                RenderListEntry* entry = &entries[idx];
-
-                if (entry->m_Visibility == dmRender::VISIBILITY_NONE)
-                {
-                    continue;
-                }
-
-                sort_values[idx].m_MajorOrder = entry->m_MajorOrder;
-                if (entry->m_MajorOrder == RENDER_ORDER_WORLD)
-                {
-                    const float z = sort_values[idx].m_ZW;
-                    sort_values[idx].m_Order = (uint32_t) (0xfffff8 - 0xfffff0 * rc * (z - minZW));
-                }
-                else
-                {
-                    // use the integer value provided.
-                    sort_values[idx].m_Order = entry->m_Order;
-                }
-                sort_values[idx].m_MinorOrder = entry->m_MinorOrder;
-                sort_values[idx].m_BatchKey = entry->m_BatchKey & 0x00ffffff;
-                sort_values[idx].m_Dispatch = entry->m_Dispatch;
-                context->m_RenderListSortBuffer.Push(idx);
-            }
-        }
+        sort_buffer.SetSize(visible_count);
+        ctx.m_MinZW = minZW;
+        ctx.m_RC = rc;
+        ctx.m_SortBuffer = sort_buffer.Begin();
+        dmJobPool::Run(context->m_JobPool, SortValueJob, &ctx, job_count);
     }
 
     static void CollectRenderEntryRange(void* _ctx, uint32_t tag_list_key, size_t start, size_t count)
@@ -513,6 +585,79 @@ namespace dmRender
         FindRenderListRanges(first, high - first, size - (high - rangefirst), entries, comp, ctx, callback);
     }
 
+    void RadixSort64(uint32_t count, uint64_t* keys, uint32_t* values, uint64_t* tmp_keys, uint32_t* tmp_values)
+    {
+        if (count < 2)
+            return;
+
+        const uint32_t pass_count = sizeof(uint64_t);
+        uint32_t histograms[pass_count][256];
+        memset(histograms, 0, sizeof(histograms));
+
+        // All histograms are gathered in one pass over the keys
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint64_t key = keys[i];
+            for (uint32_t pass = 0; pass < pass_count; ++pass)
+            {
+                histograms[pass][(key >> (pass * 8)) & 0xff]++;
+            }
+        }
+
+        uint64_t* src_keys = keys;
+        uint32_t* src_values = values;
+        uint64_t* dst_keys = tmp_keys;
+        uint32_t* dst_values = tmp_values;
+        for (uint32_t pass = 0; pass < pass_count; ++pass)
+        {
+            const uint32_t shift = pass * 8;
+            uint32_t* offsets = histograms[pass];
+
+            // Typically, only a few of the bytes in the keys vary
+            if (offsets[(src_keys[0] >> shift) & 0xff] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = offsets[i];
+                offsets[i] = offset;
+                offset += c;
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint64_t key = src_keys[i];
+                uint32_t dst = offsets[(key >> shift) & 0xff]++;
+                dst_keys[dst] = key;
+                dst_values[dst] = src_values[i];
+            }
+
+            uint64_t* k = src_keys; src_keys = dst_keys; dst_keys = k;
+            uint32_t* v = src_values; src_values = dst_values; dst_values = v;
+        }
+
+        if (src_keys != keys)
+        {
+            memcpy(keys, src_keys, count * sizeof(uint64_t));
+            memcpy(values, src_values, count * sizeof(uint32_t));
+        }
+    }
+
+    static void EnsureSortScratchCapacity(HRenderContext context, uint32_t count)
+    {
+        if (context->m_RenderListSortKeys.Capacity() < count)
+        {
+            uint32_t capacity = context->m_RenderListSortIndices.Capacity();
+            context->m_RenderListSortKeys.SetCapacity(capacity);
+            context->m_RenderListSortKeysTmp.SetCapacity(capacity);
+            context->m_RenderListSortIndicesTmp.SetCapacity(capacity);
+        }
+        context->m_RenderListSortKeys.SetSize(count);
+        context->m_RenderListSortKeysTmp.SetSize(count);
+        context->m_RenderListSortIndicesTmp.SetSize(count);
+    }
+
     static void SortRenderList(HRenderContext context)
     {
         DM_PROFILE("SortRenderList");
@@ -522,9 +667,16 @@ namespace dmRender
 
         // First sort on the tag masks
         {
-            RenderListEntrySorter sort;
-            sort.m_Base = context->m_RenderList.Begin();
-            std::stable_sort(context->m_RenderListSortIndices.Begin(), context->m_RenderListSortIndices.End(), sort);
+            uint32_t count = context->m_RenderListSortIndices.Size();
+            EnsureSortScratchCapacity(context, count);
+            uint64_t* keys = context->m_RenderListSortKeys.Begin();
+            uint32_t* indices = context->m_RenderListSortIndices.Begin();
+            RenderListEntry* entries = context->m_RenderList.Begin();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                keys[i] = entries[indices[i]].m_TagListKey;
+            }
+            RadixSort64(count, keys, indices, context->m_RenderListSortKeysTmp.Begin(), context->m_RenderListSortIndicesTmp.Begin());
         }
         // Now find the ranges of tag masks
         {
@@ -550,6 +702,31 @@ namespace dmRender
         }
     }
 
+    // Number of render list entries given to a visibility function by each culling job
+    static const uint32_t CULL_JOB_SIZE = 512;
+
+    struct CullJobsContext
+    {
+        HRenderContext                  m_Context;
+        const dmIntersection::Frustum*  m_Frustum;
+    };
+
+    static void CullJob(void* _ctx, uint32_t job_index)
+    {
+        CullJobsContext* ctx = (CullJobsContext*)_ctx;
+        HRenderContext context = ctx->m_Context;
+        const RenderListCullJob& job = context->m_RenderListCullJobs[job_index];
+        const RenderListDispatch* d = &context->m_RenderListDispatch[job.m_Entries->m_Dispatch];
+
+        RenderListVisibilityParams params;
+        params.m_Frustum = ctx->m_Frustum;
+        params.m_UserData = d->m_UserData;
+        params.m_Entries = job.m_Entries;
+        params.m_NumEntries = job.m_Count;
+        d->m_VisibilityFn(params);
+    }
+
+    // The batches with a visibility function are split into jobs, each calling the function for a part of the batch
     static void FrustumCulling(HRenderContext context, const dmIntersection::Frustum& frustum)
     {
         DM_PROFILE("FrustumCulling");
@@ -558,6 +735,9 @@ namespace dmRender
         if (num_entries == 0)
             return;
 
+        dmArray<RenderListCullJob>& jobs = context->m_RenderListCullJobs;
+        jobs.SetSize(0);
+
         BatchIterator<RenderListEntry*> iter(num_entries, context->m_RenderList.Begin(), RenderListEntryEqFn);
         while(iter.Next())
         {
@@ -567,16 +747,82 @@ namespace dmRender
             if (!d->m_VisibilityFn)
             {
                 SetVisibility(iter.Length(), iter.Begin(), dmRender::VISIBILITY_FULL);
+                continue;
             }
-            else {
-                RenderListVisibilityParams params;
-                params.m_Frustum = &frustum;
-                params.m_UserData = d->m_UserData;
-                params.m_Entries = batch_start;
-                params.m_NumEntries = iter.Length();
-                d->m_VisibilityFn(params);
+
+            uint32_t batch_length = iter.Length();
+            for (uint32_t start = 0; start < batch_length; start += CULL_JOB_SIZE)
+            {
+                if (jobs.Full())
+                {
+                    jobs.OffsetCapacity(16);
+                }
+                RenderListCullJob job;
+                job.m_Entries = batch_start + start;
+                job.m_Count = dmMath::Min(CULL_JOB_SIZE, batch_length - start);
+                jobs.Push(job);
             }
         }
+
+        CullJobsContext ctx;
+        ctx.m_Context = context;
+        ctx.m_Frustum = &frustum;
+        dmJobPool::Run(context->m_JobPool, CullJob, &ctx, jobs.Size());
+    }
+
+    static void SortRenderListValues(HRenderContext context, dmArray<uint32_t>& sort_buffer)
+    {
+        DM_PROFILE("DrawRenderList_SORT");
+
+        uint32_t count = sort_buffer.Size();
+        EnsureSortScratchCapacity(context, count);
+        uint64_t* keys = context->m_RenderListSortKeys.Begin();
+        uint32_t* indices = sort_buffer.Begin();
+        const RenderListSortValue* sort_values = context->m_RenderListSortValues.Begin();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            keys[i] = sort_values[indices[i]].m_SortKey;
+        }
+        RadixSort64(count, keys, indices, context->m_RenderListSortKeysTmp.Begin(), context->m_RenderListSortIndicesTmp.Begin());
+    }
+
+    // Returns the sorted render list for the predicate, from the cache if nothing has changed since it was sorted
+    static dmArray<uint32_t>& GetSortedRenderList(HRenderContext context, HPredicate predicate)
+    {
+        uint32_t tag_count = predicate ? predicate->m_TagCount : 0;
+        dmhash_t* tags = predicate ? predicate->m_Tags : 0;
+        uint32_t tags_hash = dmHashBuffer32(tags, tag_count * sizeof(dmhash_t));
+
+        RenderListSortCache* cache = 0;
+        for (uint32_t i = 0; i < MAX_RENDER_LIST_SORT_CACHE_COUNT; ++i)
+        {
+            RenderListSortCache* c = &context->m_RenderListSortCache[i];
+            if (c->m_Version == context->m_RenderListVersion && c->m_TagsHash == tags_hash)
+            {
+                if (c->m_FrustumHash == context->m_FrustumHash && memcmp(&c->m_ViewProj, &context->m_ViewProj, sizeof(Matrix4)) == 0)
+                {
+                    return c->m_SortBuffer;
+                }
+                cache = c;
+                break;
+            }
+        }
+
+        if (!cache)
+        {
+            cache = &context->m_RenderListSortCache[context->m_RenderListSortCacheNext];
+            context->m_RenderListSortCacheNext = (context->m_RenderListSortCacheNext + 1) % MAX_RENDER_LIST_SORT_CACHE_COUNT;
+        }
+
+        MakeSortBuffer(context, tag_count, tags, cache->m_SortBuffer);
+        SortRenderListValues(context, cache->m_SortBuffer);
+        context->m_RenderListSortCount++;
+
+        cache->m_Version = context->m_RenderListVersion;
+        cache->m_TagsHash = tags_hash;
+        cache->m_FrustumHash = context->m_FrustumHash;
+        cache->m_ViewProj = context->m_ViewProj;
+        return cache->m_SortBuffer;
     }
 
     Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer, const dmVMath::Matrix4* frustum_matrix)
@@ -613,18 +859,10 @@ namespace dmRender
             }
         }
 
-        MakeSortBuffer(context, predicate?predicate->m_TagCount:0, predicate?predicate->m_Tags:0);
-
-        if (context->m_RenderListSortBuffer.Empty())
+        dmArray<uint32_t>& sort_buffer = GetSortedRenderList(context, predicate);
+        if (sort_buffer.Empty())
             return RESULT_OK;
 
-        {
-            DM_PROFILE("DrawRenderList_SORT");
-            RenderListSorter sort;
-            sort.values = context->m_RenderListSortValues.Begin();
-            std::stable_sort(context->m_RenderListSortBuffer.Begin(), context->m_RenderListSortBuffer.End(), sort);
-        }
-
         // Construct render objects
         context->m_RenderObjects.SetSize(0);
 
@@ -646,12 +884,12 @@ namespace dmRender
 
         // Make batches for matching dispatch, batch key & minor order
         RenderListEntry *base = context->m_RenderList.Begin();
-        uint32_t *last = context->m_RenderListSortBuffer.Begin();
-        uint32_t count = context->m_RenderListSortBuffer.Size();
+        uint32_t *last = sort_buffer.Begin();
+        uint32_t count = sort_buffer.Size();
 
         for (uint32_t i=1;i<=count;i++)
         {
-            uint32_t *idx = context->m_RenderListSortBuffer.Begin() + i;
+            uint32_t *idx = sort_buffer.Begin() + i;
             const RenderListEntry *last_entry = &base[*last];
             const RenderListEntry *current_entry = &base[*idx];
 
@@ -758,9 +996,17 @@ namespace dmRender
 
             }
 
-            dmGraphics::EnableVertexDeclaration(context, ro->m_VertexDeclaration, ro->m_VertexBuffer, GetMaterialProgram(material));
+            dmGraphics::HProgram program = GetMaterialProgram(material);
+            dmGraphics::EnableVertexDeclaration(context, ro->m_VertexDeclaration, ro->m_VertexBuffer, program);
 
-            if (ro->m_IndexBuffer)
+            if (ro->m_InstanceCount > 0)
+            {
+                assert(ro->m_IndexBuffer);
+                dmGraphics::EnableInstanceVertexDeclaration(context, ro->m_InstanceVertexDeclaration, ro->m_InstanceVertexBuffer, ro->m_InstanceStart, program);
+                dmGraphics::DrawElementsInstanced(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_InstanceCount, ro->m_IndexType, ro->m_IndexBuffer);
+                dmGraphics::DisableInstanceVertexDeclaration(context, ro->m_InstanceVertexDeclaration);
+            }
+            else if (ro->m_IndexBuffer)
                 dmGraphics::DrawElements(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_IndexType, ro->m_IndexBuffer);
             else
                 dmGraphics::Draw(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount);
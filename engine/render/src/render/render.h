@@ -21,6 +21,7 @@
 #include <dmsdk/render/render.h>
 
 #include <dlib/hash.h>
+#include <dlib/job_pool.h>
 #include <script/script.h>
 #include <script/lua_source_ddf.h>
 #include <graphics/graphics.h>
@@ -107,6 +108,8 @@ namespace dmRender
         /// Max debug vertex count
         /// NOTE: This is per debug-type and not the total sum
         uint32_t                        m_MaxDebugVertexCount;
+        /// Pool running the frustum culling and the sort key generation in parallel, may be 0x0
+        dmJobPool::HJobPool             m_JobPool;
     };
 
     static const uint8_t RENDERLIST_INVALID_DISPATCH = 0xff;
@@ -20,6 +20,7 @@
 #include <dlib/array.h>
 #include <dlib/message.h>
 #include <dlib/hashtable.h>
+#include <dlib/job_pool.h>
 
 #include "render.h"
 
@@ -201,10 +202,40 @@ namespace dmRender
     {
         uint32_t m_TagListKey;
         uint32_t m_Start;       // Index into the renderlist
-        uint32_t m_Count:31;
-        uint32_t m_Skip:1;      // During the current draw call
+        uint32_t m_Count;
+    };
+
+    // A part of a render list range matching the predicate, see MakeSortBuffer
+    struct RenderListSortJob
+    {
+        uint32_t m_Start;           // Index into the sorted render list indices
+        uint32_t m_Count;
+        uint32_t m_VisibleCount;
+        uint32_t m_SortBufferOffset;
+        float    m_MinZW;
+        float    m_MaxZW;
+    };
+
+    // A part of a render list batch given to its visibility function, see FrustumCulling
+    struct RenderListCullJob
+    {
+        RenderListEntry*            m_Entries;
+        uint32_t                    m_Count;
+    };
+
+    // The sorted render list for a predicate. Reused by DrawRenderList as long as the render list,
+    // the view projection and the frustum are unchanged.
+    struct RenderListSortCache
+    {
+        dmArray<uint32_t>           m_SortBuffer;   // Sorted indices into the render list
+        Matrix4                     m_ViewProj;
+        dmhash_t                    m_FrustumHash;
+        uint32_t                    m_TagsHash;     // Hash of the predicate tags
+        uint32_t                    m_Version;      // RenderContext::m_RenderListVersion when sorted
     };
 
+    const uint32_t MAX_RENDER_LIST_SORT_CACHE_COUNT = 8;
+
     struct MaterialTagList
     {
         uint32_t m_Count;
@@ -224,9 +255,18 @@ namespace dmRender
         dmArray<RenderListEntry>    m_RenderList;
         dmArray<RenderListDispatch> m_RenderListDispatch;
         dmArray<RenderListSortValue>m_RenderListSortValues;
-        dmArray<uint32_t>           m_RenderListSortBuffer;
         dmArray<uint32_t>           m_RenderListSortIndices;
         dmArray<RenderListRange>    m_RenderListRanges;         // Maps tagmask to a range in the (sorted) render list
+        dmArray<uint64_t>           m_RenderListSortKeys;       // Scratch buffers for the radix sort
+        dmArray<uint64_t>           m_RenderListSortKeysTmp;
+        dmArray<uint32_t>           m_RenderListSortIndicesTmp;
+        dmArray<RenderListSortJob>  m_RenderListSortJobs;
+        dmArray<RenderListCullJob>  m_RenderListCullJobs;
+        dmJobPool::HJobPool         m_JobPool;                  // Runs the culling and sort jobs, may be 0x0
+        RenderListSortCache         m_RenderListSortCache[MAX_RENDER_LIST_SORT_CACHE_COUNT];
+        uint32_t                    m_RenderListSortCacheNext;  // Next cache entry to replace
+        uint32_t                    m_RenderListSortCount;      // Number of times the render list has been sorted, used in unit tests
+        uint32_t                    m_RenderListVersion;        // Incremented whenever entries are added to the render list
         dmhash_t                    m_FrustumHash;
 
         dmHashTable32<MaterialTagList>  m_MaterialTagLists;
@@ -262,18 +302,6 @@ namespace dmRender
     // Gets the list associated with a hash of all the tags (see RegisterMaterialTagList)
     void                            GetMaterialTagList(HRenderContext context, uint32_t list_hash, MaterialTagList* list);
 
-    // Exposed here for unit testing
-    struct RenderListEntrySorter
-    {
-        bool operator()(int a, int b) const
-        {
-            const RenderListEntry& ea = m_Base[a];
-            const RenderListEntry& eb = m_Base[b];
-            return ea.m_TagListKey < eb.m_TagListKey;
-        }
-        RenderListEntry* m_Base;
-    };
-
     struct FindRangeComparator
     {
         RenderListEntry* m_Entries;
@@ -285,6 +313,10 @@ namespace dmRender
 
     typedef void (*RangeCallback)(void* ctx, uint32_t val, size_t start, size_t count);
 
+    // Stable LSD radix sort of the values on their 64 bit keys. The tmp buffers must hold count elements.
+    // Passes where all keys have the same digit are skipped.
+    void RadixSort64(uint32_t count, uint64_t* keys, uint32_t* values, uint64_t* tmp_keys, uint32_t* tmp_values);
+
     // Invokes the callback for each range. Two ranges are not guaranteed to preceed/succeed one another.
     void FindRenderListRanges(uint32_t* first, size_t offset, size_t size, RenderListEntry* entries, FindRangeComparator& comp, void* ctx, RangeCallback callback );
 
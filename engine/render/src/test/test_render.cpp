@@ -20,6 +20,7 @@
 
 #include <dlib/hash.h>
 #include <dlib/math.h>
+#include <dlib/zlib.h>
 
 #include <script/script.h>
 #include <algorithm> // std::stable_sort
@@ -587,6 +588,199 @@ TEST_F(dmRenderTest, TestRenderListOrder)
     ASSERT_EQ(ctx.m_Z, orders[2]);
 }
 
+struct TestRenderListCacheDispatchCtx
+{
+    uint32_t m_Order[8];
+    uint32_t m_Count;
+};
+
+static void TestRenderListCacheDispatch(dmRender::RenderListDispatchParams const & params)
+{
+    TestRenderListCacheDispatchCtx *ctx = (TestRenderListCacheDispatchCtx*) params.m_UserData;
+    if (params.m_Operation == dmRender::RENDER_LIST_OPERATION_BATCH)
+    {
+        for (uint32_t* i = params.m_Begin; i != params.m_End; ++i)
+        {
+            ctx->m_Order[ctx->m_Count++] = *i;
+        }
+    }
+}
+
+TEST_F(dmRenderTest, TestRenderListOrderCached)
+{
+    // The sorted render list is reused as long as nothing changes, but must follow changes to the view projection
+    TestRenderListCacheDispatchCtx ctx;
+    memset(&ctx, 0x00, sizeof(TestRenderListCacheDispatchCtx));
+
+    dmVMath::Matrix4 view = dmVMath::Matrix4::identity();
+    dmVMath::Matrix4 proj = dmVMath::Matrix4::orthographic(0.0f, WIDTH, 0.0f, HEIGHT, -1.0f, 1.0f);
+    dmRender::SetViewMatrix(m_Context, view);
+    dmRender::SetProjectionMatrix(m_Context, proj);
+
+    dmRender::RenderListBegin(m_Context);
+    uint8_t dispatch = dmRender::RenderListMakeDispatch(m_Context, TestRenderListCacheDispatch, 0, &ctx);
+
+    const uint32_t n = 4;
+    dmRender::RenderListEntry* out = dmRender::RenderListAlloc(m_Context, n);
+    for (uint32_t i=0;i!=n;i++)
+    {
+        dmRender::RenderListEntry & entry = out[i];
+        entry.m_WorldPosition = Point3(0, 0, 0.1f * i);
+        entry.m_MajorOrder = dmRender::RENDER_ORDER_WORLD;
+        entry.m_MinorOrder = 0;
+        entry.m_TagListKey = 0;
+        entry.m_Order = 0;
+        entry.m_BatchKey = i;
+        entry.m_Dispatch = dispatch;
+        entry.m_UserData = 0;
+    }
+    dmRender::RenderListSubmit(m_Context, out, out + n);
+    dmRender::RenderListEnd(m_Context);
+
+    uint32_t sort_count = m_Context->m_RenderListSortCount;
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+    ASSERT_EQ(n, ctx.m_Count);
+    ASSERT_EQ(sort_count + 1, m_Context->m_RenderListSortCount);
+    uint32_t first_order[n];
+    memcpy(first_order, ctx.m_Order, sizeof(first_order));
+
+    // Same predicate, nothing changed
+    ctx.m_Count = 0;
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+    ASSERT_EQ(n, ctx.m_Count);
+    ASSERT_EQ(sort_count + 1, m_Context->m_RenderListSortCount);
+    for (uint32_t i=0;i!=n;i++)
+    {
+        ASSERT_EQ(first_order[i], ctx.m_Order[i]);
+    }
+
+    // Another predicate is sorted and cached on its own
+    dmRender::HPredicate predicate = dmRender::NewPredicate();
+    dmRender::AddPredicateTag(predicate, dmHashString64("tile"));
+    dmRender::DrawRenderList(m_Context, predicate, 0, 0);
+    ASSERT_EQ(sort_count + 2, m_Context->m_RenderListSortCount);
+    dmRender::DrawRenderList(m_Context, predicate, 0, 0);
+    ASSERT_EQ(sort_count + 2, m_Context->m_RenderListSortCount);
+    ctx.m_Count = 0;
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+    ASSERT_EQ(n, ctx.m_Count);
+    ASSERT_EQ(sort_count + 2, m_Context->m_RenderListSortCount);
+    dmRender::DeletePredicate(predicate);
+
+    // Flip the z axis, which reverses the draw order
+    dmRender::SetViewMatrix(m_Context, dmVMath::Matrix4::scale(dmVMath::Vector3(1.0f, 1.0f, -1.0f)));
+    ctx.m_Count = 0;
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+    ASSERT_EQ(n, ctx.m_Count);
+    ASSERT_EQ(sort_count + 3, m_Context->m_RenderListSortCount);
+    for (uint32_t i=0;i!=n;i++)
+    {
+        ASSERT_EQ(first_order[n - 1 - i], ctx.m_Order[i]);
+    }
+
+    // A new render list is sorted again, even with the same view projection
+    dmRender::RenderListBegin(m_Context);
+    dispatch = dmRender::RenderListMakeDispatch(m_Context, TestRenderListCacheDispatch, 0, &ctx);
+    out = dmRender::RenderListAlloc(m_Context, n);
+    for (uint32_t i=0;i!=n;i++)
+    {
+        dmRender::RenderListEntry & entry = out[i];
+        entry.m_WorldPosition = Point3(0, 0, 0.1f * i);
+        entry.m_MajorOrder = dmRender::RENDER_ORDER_WORLD;
+        entry.m_MinorOrder = 0;
+        entry.m_TagListKey = 0;
+        entry.m_Order = 0;
+        entry.m_BatchKey = i;
+        entry.m_Dispatch = dispatch;
+        entry.m_UserData = 0;
+    }
+    dmRender::RenderListSubmit(m_Context, out, out + n);
+    dmRender::RenderListEnd(m_Context);
+
+    ctx.m_Count = 0;
+    dmRender::DrawRenderList(m_Context, 0, 0, 0);
+    ASSERT_EQ(n, ctx.m_Count);
+    ASSERT_EQ(sort_count + 4, m_Context->m_RenderListSortCount);
+}
+
+struct TestRenderListJobsDispatchCtx
+{
+    uint32_t m_Order[3000];
+    uint32_t m_Count;
+};
+
+static void TestRenderListJobsDispatch(dmRender::RenderListDispatchParams const & params)
+{
+    TestRenderListJobsDispatchCtx *ctx = (TestRenderListJobsDispatchCtx*) params.m_UserData;
+    if (params.m_Operation == dmRender::RENDER_LIST_OPERATION_BATCH)
+    {
+        for (uint32_t* i = params.m_Begin; i != params.m_End; ++i)
+        {
+            ctx->m_Order[ctx->m_Count++] = *i;
+        }
+    }
+}
+
+TEST_F(dmRenderTest, TestRenderListJobPool)
+{
+    // The culling and the sort values are split into several jobs, which must give the same order as without a pool
+    dmVMath::Matrix4 view = dmVMath::Matrix4::identity();
+    dmVMath::Matrix4 proj = dmVMath::Matrix4::orthographic(0.0f, WIDTH, 0.0f, HEIGHT, -1.0f, 1.0f);
+    dmRender::SetViewMatrix(m_Context, view);
+    dmRender::SetProjectionMatrix(m_Context, proj);
+    dmVMath::Matrix4 view_proj = proj * view;
+
+    const uint32_t n = DM_ARRAY_SIZE(((TestRenderListJobsDispatchCtx*)0)->m_Order);
+    const dmRender::RenderOrder majors[3] = {
+        dmRender::RENDER_ORDER_BEFORE_WORLD,
+        dmRender::RENDER_ORDER_WORLD,
+        dmRender::RENDER_ORDER_AFTER_WORLD
+    };
+
+    dmJobPool::HJobPool pools[2] = { 0x0, dmJobPool::New(3) };
+    TestRenderListJobsDispatchCtx* ctx[2];
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        m_Context->m_JobPool = pools[c];
+        ctx[c] = new TestRenderListJobsDispatchCtx;
+        ctx[c]->m_Count = 0;
+
+        dmRender::RenderListBegin(m_Context);
+        uint8_t dispatch = dmRender::RenderListMakeDispatch(m_Context, TestRenderListJobsDispatch, TestDrawVisibility, ctx[c]);
+
+        dmRender::RenderListEntry* out = dmRender::RenderListAlloc(m_Context, n);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            dmRender::RenderListEntry & entry = out[i];
+            // Every other entry is outside the frustum
+            entry.m_WorldPosition = Point3((i % 2) ? -1.0f : (float)(1 + i % (WIDTH - 2)), (float)(1 + i % (HEIGHT - 2)), ((i * 7919) % n) / (float)n - 0.5f);
+            entry.m_MajorOrder = majors[i % 3];
+            entry.m_MinorOrder = 0;
+            entry.m_TagListKey = 0;
+            entry.m_Order = i;
+            entry.m_BatchKey = 0;
+            entry.m_Dispatch = dispatch;
+            entry.m_UserData = 0;
+            entry.m_Visibility = dmRender::VISIBILITY_NONE;
+        }
+        dmRender::RenderListSubmit(m_Context, out, out + n);
+        dmRender::RenderListEnd(m_Context);
+
+        dmRender::DrawRenderList(m_Context, 0, 0, &view_proj);
+        ASSERT_EQ(n / 2, ctx[c]->m_Count);
+    }
+
+    for (uint32_t i = 0; i < n / 2; ++i)
+    {
+        ASSERT_EQ(ctx[0]->m_Order[i], ctx[1]->m_Order[i]);
+    }
+
+    m_Context->m_JobPool = 0x0;
+    dmJobPool::Delete(pools[1]);
+    delete ctx[0];
+    delete ctx[1];
+}
+
 TEST_F(dmRenderTest, TestRenderListDebug)
 {
     // Test submitting debug drawing when there is no other drawing going on
@@ -717,6 +911,244 @@ static inline float ExpectedHeight(float line_height, float num_lines, float lea
     return num_lines * (line_height * fabsf(leading)) - line_height * (fabsf(leading) - 1.0f);
 }
 
+static void DrawTextFrame(dmRender::HRenderContext context, dmRender::HFontMap font_map, dmRender::HMaterial material, const char* text)
+{
+    dmRender::RenderListBegin(context);
+    dmRender::DrawTextParams params;
+    params.m_Text = text;
+    dmRender::DrawText(context, font_map, material, 0, params);
+    dmRender::FlushTexts(context, dmRender::RENDER_ORDER_WORLD, 0, false);
+    dmRender::RenderListEnd(context);
+    dmRender::DrawRenderList(context, 0, 0, 0);
+    dmRender::ClearRenderObjects(context);
+}
+
+// Checks that the quad of each drawn glyph samples exactly the texels of the glyph in the cache texture.
+// The texels of a glyph are all set to its index + 1, and all glyphs are 4 texels high.
+static void AssertGlyphCacheTexels(dmRender::HRenderContext context, dmRender::HFontMap font_map, const char* text, const uint32_t* widths, uint32_t cache_width, uint32_t cache_height)
+{
+    const dmRender::GlyphVertex* vertices = (const dmRender::GlyphVertex*)context->m_TextContext.m_ClientBuffer;
+    const uint8_t* data = dmRender::GetFontMapCacheData(font_map);
+    for (uint32_t i = 0; text[i]; ++i)
+    {
+        uint32_t glyph_index = text[i] - 'a';
+        // The second vertex of the quad is the top left corner, and the third one the bottom right corner
+        const dmRender::GlyphVertex* quad = &vertices[i * 6];
+        uint32_t x0 = (uint32_t)(quad[1].m_UV[0] * cache_width + 0.5f);
+        uint32_t y0 = (uint32_t)(quad[1].m_UV[1] * cache_height + 0.5f);
+        uint32_t x1 = (uint32_t)(quad[2].m_UV[0] * cache_width + 0.5f);
+        uint32_t y1 = (uint32_t)(quad[2].m_UV[1] * cache_height + 0.5f);
+        ASSERT_EQ(widths[glyph_index], x1 - x0);
+        ASSERT_EQ(4u, y1 - y0);
+        ASSERT_LE(x1, cache_width);
+        ASSERT_LE(y1, cache_height);
+        for (uint32_t y = y0; y < y1; ++y)
+        {
+            for (uint32_t x = x0; x < x1; ++x)
+            {
+                ASSERT_EQ(glyph_index + 1, data[y * cache_width + x]);
+            }
+        }
+    }
+}
+
+TEST_F(dmRenderTest, GlyphCachePacking)
+{
+    // 4x4 glyphs and one 8x4 glyph in an 8x8 cache with 8x8 cells. The glyphs are packed, so four 4x4 glyphs fit.
+    const uint32_t glyph_count = 9;
+    const uint32_t widths[glyph_count] = {4, 4, 4, 4, 4, 4, 4, 4, 8};
+    const uint32_t cache_size = 8;
+    uint32_t glyph_data_size = 0;
+    for (uint32_t i = 0; i < glyph_count; ++i)
+    {
+        glyph_data_size += 1 + widths[i] * 4; // header byte + uncompressed luminance
+    }
+    dmRender::FontMapParams font_map_params;
+    font_map_params.m_CacheWidth = cache_size;
+    font_map_params.m_CacheHeight = cache_size;
+    font_map_params.m_CacheCellWidth = 8;
+    font_map_params.m_CacheCellHeight = 8;
+    font_map_params.m_MaxAscent = 3;
+    font_map_params.m_MaxDescent = 1;
+    font_map_params.m_GlyphData = malloc(glyph_data_size);
+    font_map_params.m_Glyphs.SetCapacity(glyph_count);
+    font_map_params.m_Glyphs.SetSize(glyph_count);
+    memset((void*)&font_map_params.m_Glyphs[0], 0, sizeof(dmRender::Glyph)*glyph_count);
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < glyph_count; ++i)
+    {
+        dmRender::Glyph& g = font_map_params.m_Glyphs[i];
+        g.m_Character = 'a' + i;
+        g.m_Width = widths[i];
+        g.m_Advance = widths[i];
+        g.m_Ascent = 3;
+        g.m_Descent = 1;
+        g.m_GlyphDataOffset = offset;
+        g.m_GlyphDataSize = 1 + widths[i] * 4;
+        uint8_t* glyph_data = (uint8_t*)font_map_params.m_GlyphData + offset;
+        glyph_data[0] = 0; // not compressed
+        memset(glyph_data + 1, i + 1, widths[i] * 4);
+        offset += g.m_GlyphDataSize;
+    }
+    dmRender::HFontMap font_map = dmRender::NewFontMap(m_GraphicsContext, font_map_params);
+
+    dmGraphics::ShaderDesc::Shader shader_ddf;
+    memset(&shader_ddf, 0, sizeof(shader_ddf));
+    shader_ddf.m_Source.m_Data  = (uint8_t*)"foo";
+    shader_ddf.m_Source.m_Count = 3;
+    dmGraphics::HVertexProgram vp = dmGraphics::NewVertexProgram(m_GraphicsContext, &shader_ddf);
+    dmGraphics::HFragmentProgram fp = dmGraphics::NewFragmentProgram(m_GraphicsContext, &shader_ddf);
+    dmRender::HMaterial material = dmRender::NewMaterial(m_Context, vp, fp);
+
+    uint32_t upload_count, upload_size;
+
+    // One rectangle is uploaded for each shelf with new glyphs
+    DrawTextFrame(m_Context, font_map, material, "abcd");
+    ASSERT_EQ(4u, dmRender::GetFontMapCacheGlyphCount(font_map));
+    AssertGlyphCacheTexels(m_Context, font_map, "abcd", widths, cache_size, cache_size);
+    dmRender::GetFontMapCacheUploadStats(font_map, &upload_count, &upload_size);
+    ASSERT_EQ(2u, upload_count);
+    ASSERT_EQ(2u * cache_size * 4, upload_size);
+
+    // The glyphs from the previous frame are evicted
+    DrawTextFrame(m_Context, font_map, material, "efgh");
+    ASSERT_EQ(4u, dmRender::GetFontMapCacheGlyphCount(font_map));
+    AssertGlyphCacheTexels(m_Context, font_map, "efgh", widths, cache_size, cache_size);
+
+    // Glyphs used in the current frame are never evicted, so only four of these are cached
+    DrawTextFrame(m_Context, font_map, material, "abcdefgh");
+    ASSERT_EQ(4u, dmRender::GetFontMapCacheGlyphCount(font_map));
+    AssertGlyphCacheTexels(m_Context, font_map, "abcd", widths, cache_size, cache_size);
+
+    // The wide glyph fits in the room of two adjacent glyphs once they are evicted and their slots merged
+    DrawTextFrame(m_Context, font_map, material, "i");
+    ASSERT_EQ(3u, dmRender::GetFontMapCacheGlyphCount(font_map));
+    AssertGlyphCacheTexels(m_Context, font_map, "i", widths, cache_size, cache_size);
+    dmRender::GetFontMapCacheUploadStats(font_map, &upload_count, &upload_size);
+    ASSERT_EQ(1u, upload_count);
+    ASSERT_EQ(8u * 4, upload_size);
+
+    // Glyphs are evicted in the order they were last used, not in the order they were added
+    DrawTextFrame(m_Context, font_map, material, "cd");
+    ASSERT_EQ(3u, dmRender::GetFontMapCacheGlyphCount(font_map));
+    AssertGlyphCacheTexels(m_Context, font_map, "cd", widths, cache_size, cache_size);
+    // Both glyphs were already in the cache
+    dmRender::GetFontMapCacheUploadStats(font_map, &upload_count, &upload_size);
+    ASSERT_EQ(0u, upload_count);
+
+    // Evicting "i" makes room for both glyphs
+    DrawTextFrame(m_Context, font_map, material, "ab");
+    ASSERT_EQ(4u, dmRender::GetFontMapCacheGlyphCount(font_map));
+    AssertGlyphCacheTexels(m_Context, font_map, "ab", widths, cache_size, cache_size);
+
+    // Only the columns of the new glyph are uploaded
+    DrawTextFrame(m_Context, font_map, material, "e");
+    ASSERT_EQ(4u, dmRender::GetFontMapCacheGlyphCount(font_map));
+    AssertGlyphCacheTexels(m_Context, font_map, "e", widths, cache_size, cache_size);
+    dmRender::GetFontMapCacheUploadStats(font_map, &upload_count, &upload_size);
+    ASSERT_EQ(1u, upload_count);
+    ASSERT_EQ(4u * 4, upload_size);
+
+    dmRender::DeleteMaterial(m_Context, material);
+    dmGraphics::DeleteVertexProgram(vp);
+    dmGraphics::DeleteFragmentProgram(fp);
+    dmRender::DeleteFontMap(font_map);
+}
+
+static bool AppendToArray(void* context, const void* data, uint32_t data_len)
+{
+    dmArray<uint8_t>* array = (dmArray<uint8_t>*)context;
+    if (array->Remaining() < data_len)
+    {
+        array->OffsetCapacity(data_len + 256);
+    }
+    array->PushArray((const uint8_t*)data, data_len);
+    return true;
+}
+
+// Decodes deflated glyphs with and without a job pool, and expects the same cache texture data
+TEST_F(dmRenderTest, GlyphCacheJobPool)
+{
+    const uint32_t glyph_count = 26;
+    const uint32_t width = 6;
+    const uint32_t height = 5;
+    const uint32_t cache_size = 64;
+
+    dmArray<uint8_t> glyph_data;
+    dmRender::FontMapParams font_map_params;
+    font_map_params.m_CacheWidth = cache_size;
+    font_map_params.m_CacheHeight = cache_size;
+    font_map_params.m_CacheCellWidth = 8;
+    font_map_params.m_CacheCellHeight = 8;
+    font_map_params.m_MaxAscent = 4;
+    font_map_params.m_MaxDescent = 1;
+    font_map_params.m_Glyphs.SetCapacity(glyph_count);
+    font_map_params.m_Glyphs.SetSize(glyph_count);
+    memset((void*)&font_map_params.m_Glyphs[0], 0, sizeof(dmRender::Glyph)*glyph_count);
+    for (uint32_t i = 0; i < glyph_count; ++i)
+    {
+        // Delta encoded texels, as expected by the font renderer
+        uint8_t texels[width * height];
+        uint8_t last = 0;
+        for (uint32_t j = 0; j < width * height; ++j)
+        {
+            uint8_t texel = (uint8_t)(1 + i * 7 + j);
+            texels[j] = texel - last;
+            last = texel;
+        }
+
+        dmRender::Glyph& g = font_map_params.m_Glyphs[i];
+        g.m_Character = 'a' + i;
+        g.m_Width = width;
+        g.m_Advance = width;
+        g.m_Ascent = 4;
+        g.m_Descent = 1;
+        g.m_GlyphDataOffset = glyph_data.Size();
+        AppendToArray(&glyph_data, "\x01", 1); // deflated
+        ASSERT_EQ(dmZlib::RESULT_OK, dmZlib::DeflateBuffer(texels, sizeof(texels), 9, &glyph_data, AppendToArray));
+        g.m_GlyphDataSize = glyph_data.Size() - g.m_GlyphDataOffset;
+    }
+
+    dmGraphics::ShaderDesc::Shader shader_ddf;
+    memset(&shader_ddf, 0, sizeof(shader_ddf));
+    shader_ddf.m_Source.m_Data  = (uint8_t*)"foo";
+    shader_ddf.m_Source.m_Count = 3;
+    dmGraphics::HVertexProgram vp = dmGraphics::NewVertexProgram(m_GraphicsContext, &shader_ddf);
+    dmGraphics::HFragmentProgram fp = dmGraphics::NewFragmentProgram(m_GraphicsContext, &shader_ddf);
+    dmRender::HMaterial material = dmRender::NewMaterial(m_Context, vp, fp);
+
+    dmJobPool::HJobPool pools[2] = { 0x0, dmJobPool::New(3) };
+    dmRender::HFontMap font_maps[2];
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        // The font map takes ownership of the glyph data
+        font_map_params.m_GlyphData = malloc(glyph_data.Size());
+        memcpy(font_map_params.m_GlyphData, glyph_data.Begin(), glyph_data.Size());
+        font_maps[c] = dmRender::NewFontMap(m_GraphicsContext, font_map_params);
+
+        m_Context->m_JobPool = pools[c];
+        DrawTextFrame(m_Context, font_maps[c], material, "abcdefghijklmnopqrstuvwxyz");
+        ASSERT_EQ(glyph_count, dmRender::GetFontMapCacheGlyphCount(font_maps[c]));
+    }
+    m_Context->m_JobPool = 0x0;
+
+    const uint8_t* data = dmRender::GetFontMapCacheData(font_maps[0]);
+    uint32_t texel_count = 0;
+    for (uint32_t i = 0; i < cache_size * cache_size; ++i)
+    {
+        texel_count += data[i] != 0;
+    }
+    ASSERT_EQ(glyph_count * width * height, texel_count);
+    ASSERT_EQ(0, memcmp(data, dmRender::GetFontMapCacheData(font_maps[1]), cache_size * cache_size));
+
+    dmJobPool::Delete(pools[1]);
+    dmRender::DeleteFontMap(font_maps[0]);
+    dmRender::DeleteFontMap(font_maps[1]);
+    dmRender::DeleteMaterial(m_Context, material);
+    dmGraphics::DeleteVertexProgram(vp);
+    dmGraphics::DeleteFragmentProgram(fp);
+}
+
 TEST_F(dmRenderTest, GetTextMetrics)
 {
     dmRender::TextMetrics metrics;
@@ -854,19 +1286,21 @@ static void CollectRenderEntryRange(void* _ctx, uint32_t tag_list_key, size_t st
 TEST_F(dmRenderTest, FindRanges)
 {
     // Create unsorted list
-    const uint32_t count = 32; // Large enough to avoid the initial intro sort
+    const uint32_t count = 32;
     dmRender::RenderListEntry entries[count];
     uint32_t indices[count];
+    uint64_t keys[count];
     for( uint32_t i = 0; i < count; ++i) {
         indices[i] = i;
         entries[i].m_Order = i;
         entries[i].m_TagListKey = i % 5;
+        keys[i] = entries[i].m_TagListKey;
     }
 
-    // Sort the entries
-    dmRender::RenderListEntrySorter sort;
-    sort.m_Base = entries;
-    std::stable_sort(indices, indices + count, sort);
+    // Sort the entries on their tag lists, the same way the render list is sorted
+    uint64_t tmp_keys[count];
+    uint32_t tmp_indices[count];
+    dmRender::RadixSort64(count, keys, indices, tmp_keys, tmp_indices);
 
     // Make sure it's sorted
     bool sorted = true;
@@ -1026,6 +1460,47 @@ dmHashEnableReverseHash(true);
     dmRender::DeleteNamedConstantBuffer(buffer);
 }
 
+struct RadixSortTestPair
+{
+    uint64_t m_Key;
+    uint32_t m_Value;
+};
+
+static bool RadixSortTestLess(const RadixSortTestPair& a, const RadixSortTestPair& b)
+{
+    return a.m_Key < b.m_Key;
+}
+
+TEST(Render, RadixSort64)
+{
+    const uint32_t count = 1000;
+    uint64_t keys[count];
+    uint32_t values[count];
+    uint64_t tmp_keys[count];
+    uint32_t tmp_values[count];
+    RadixSortTestPair expected[count];
+
+    // Few distinct keys, to verify that the sort is stable. Bits vary in both the low and high bytes
+    uint32_t seed = 17;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint64_t key = ((uint64_t)((seed >> 16) & 0x7) << 60) | ((seed >> 8) & 0x3);
+        keys[i] = key;
+        values[i] = i;
+        expected[i].m_Key = key;
+        expected[i].m_Value = i;
+    }
+    std::stable_sort(expected, expected + count, RadixSortTestLess);
+
+    dmRender::RadixSort64(count, keys, values, tmp_keys, tmp_values);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(expected[i].m_Key, keys[i]);
+        ASSERT_EQ(expected[i].m_Value, values[i]);
+    }
+}
+
 static bool BatchEntryTestEq(int* a, int* b)
 {
     return *a == *b;
@@ -44,6 +44,8 @@ namespace dmLoadQueue
         dmResource::Result m_LoadResult;
         dmResource::Result m_PreloadResult;
         void* m_PreloadData;
+        // The buffer points into a memory mapped archive, and is valid after FreeLoad
+        bool m_IsBufferView;
     };
 
     HQueue CreateQueue(dmResource::HFactory factory);
@@ -51,7 +53,8 @@ namespace dmLoadQueue
 
     // If the queue does not want to accept any more requests at the moment, it returns 0
     // The name and canonical_path provided must have a lifetime that lasts until EndLoad is called
-    HRequest BeginLoad(HQueue queue, const char* name, const char* canonical_path, PreloadInfo* info);
+    // Requests with a higher priority are loaded before requests with a lower priority
+    HRequest BeginLoad(HQueue queue, const char* name, const char* canonical_path, PreloadInfo* info, uint32_t priority);
 
     // Actual load result will be put in load_result. Ptrs can be handled until FreeLoad has been called.
     Result EndLoad(HQueue queue, HRequest request, void** buf, uint32_t* size, LoadResult* load_result);
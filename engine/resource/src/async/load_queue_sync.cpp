@@ -51,8 +51,9 @@ namespace dmLoadQueue
         delete queue;
     }
 
-    HRequest BeginLoad(HQueue queue, const char* name, const char* canonical_path, PreloadInfo* info)
+    HRequest BeginLoad(HQueue queue, const char* name, const char* canonical_path, PreloadInfo* info, uint32_t priority)
     {
+        (void)priority;
         if (queue->m_ActiveRequest != 0)
         {
             return 0;
@@ -75,6 +76,7 @@ namespace dmLoadQueue
         load_result->m_LoadResult    = dmResource::LoadResource(queue->m_Factory, request->m_CanonicalPath, request->m_Name, buf, size);
         load_result->m_PreloadResult = dmResource::RESULT_PENDING;
         load_result->m_PreloadData   = 0;
+        load_result->m_IsBufferView  = false;
 
         if (load_result->m_LoadResult == dmResource::RESULT_OK && request->m_PreloadInfo.m_Function)
         {
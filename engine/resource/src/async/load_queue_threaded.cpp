@@ -23,27 +23,48 @@
 #include <dlib/mutex.h>
 #include <dlib/time.h>
 #include <dlib/condition_variable.h>
+#include <dlib/math.h>
 
 namespace dmLoadQueue
 {
-    // Implementation of dmLoadQueue with a thread that loads items in the order they are supplied,
+    // Implementation of dmLoadQueue with a pool of threads that load items by priority, then in the order they are supplied.
+    // The file reads are serialized by the factory load mutex, but the decryption and decompression of archive entries
+    // and the preload functions (parsing and decoding of the loaded data) run outside of it, so with more than one thread,
+    // decoding overlaps with the reads of other requests.
 
     // Default to small buffers since a lot of what is loaded are just small objects anyway.
     // That way we can have more in flight, but throttle when max pending data grows too large anyway
     const uint64_t DEFAULT_CAPACITY = 5 * 1024;
 
-    // Once the loader has this amount not picked up, it will stop loading more.
+    // Once the loaders have this amount in flight or not picked up, they will stop loading more.
     // This sets the bandwidth of the loader.
-    const uint64_t MAX_PENDING_DATA = 4 * 1024 * 1024;
-    const uint32_t QUEUE_SLOTS      = 16;
+    const uint64_t MAX_PENDING_DATA   = 4 * 1024 * 1024;
+    const uint32_t QUEUE_SLOTS        = 32;
+    const uint32_t MAX_LOADER_THREADS = 8;
+
+    enum RequestState
+    {
+        REQUEST_STATE_FREE    = 0,
+        REQUEST_STATE_QUEUED  = 1,
+        REQUEST_STATE_LOADING = 2,
+        REQUEST_STATE_DONE    = 3,
+    };
 
     struct Request
     {
         const char* m_Name;
         const char* m_CanonicalPath;
         dmResource::LoadBufferType m_Buffer;
+        // Set instead of m_Buffer when the resource is used in place from a memory mapped archive
+        const void* m_View;
+        uint32_t m_Size;
+        // The buffer capacity counted in Queue::m_BytesWaiting for this request
+        uint32_t m_BytesCounted;
         PreloadInfo m_PreloadInfo;
         LoadResult m_Result;
+        uint32_t m_Priority;
+        uint32_t m_Sequence;
+        RequestState m_State;
     };
 
     struct Queue
@@ -51,23 +72,19 @@ namespace dmLoadQueue
         dmResource::HFactory m_Factory;
         dmMutex::HMutex m_Mutex;
         dmConditionVariable::HConditionVariable m_WakeupCond;
-        dmThread::Thread m_Thread;
+        dmThread::Thread m_Threads[MAX_LOADER_THREADS];
+        uint32_t m_ThreadCount;
         Request m_Request[QUEUE_SLOTS];
-        uint32_t m_Front, m_Back, m_Loaded;
+        uint32_t m_RequestCount;
+        uint32_t m_Sequence;
         uint64_t m_BytesWaiting;
         bool m_Shutdown;
-
-        // Circular queue with indexing as follow (exclusive end)
-        //
-        //          m_Back           m_Loaded   m_Front
-        // [N/A]   [loaded] [loaded] [to-load]  [N/A]
-        //
     };
 
     static Request* GetNextRequest(Queue* queue)
     {
         // Since we can be loading many things at once, track the total Capacity() for buffers
-        // that are waiting to be picked up by the preloader. In the case of the queue being filled
+        // that are in flight or waiting to be picked up by the preloader. In the case of the queue being filled
         // with only large requests (say only 4Mb textures), this throttles a bit so memory consumption
         // does not run away.
         if (queue->m_BytesWaiting >= MAX_PENDING_DATA)
@@ -75,12 +92,22 @@ namespace dmLoadQueue
             return 0x0;
         }
 
-        if (queue->m_Loaded == queue->m_Front)
+        // Highest priority first, and in the order they were requested within the same priority
+        Request* next = 0x0;
+        for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
         {
-            return 0x0;
+            Request* r = &queue->m_Request[i];
+            if (r->m_State != REQUEST_STATE_QUEUED)
+            {
+                continue;
+            }
+            if (next == 0x0 || r->m_Priority > next->m_Priority ||
+                (r->m_Priority == next->m_Priority && (int32_t)(r->m_Sequence - next->m_Sequence) < 0))
+            {
+                next = r;
+            }
         }
-
-        return &queue->m_Request[queue->m_Loaded % QUEUE_SLOTS];
+        return next;
     }
 
     static void LoadThread(void* arg)
@@ -94,25 +121,32 @@ namespace dmLoadQueue
                 dmMutex::ScopedLock lk(queue->m_Mutex);
                 if (current != 0)
                 {
-                    // Just finished one (from previous iteratino)
-                    queue->m_BytesWaiting += current->m_Buffer.Capacity();
-                    queue->m_Loaded++;
+                    // Just finished one (from previous iteration)
+                    queue->m_BytesWaiting = queue->m_BytesWaiting + current->m_Buffer.Capacity() - current->m_BytesCounted;
+                    current->m_BytesCounted = current->m_Buffer.Capacity();
                     current->m_Result = result;
+                    current->m_State  = REQUEST_STATE_DONE;
                     current           = 0;
                 }
-                if (queue->m_Shutdown)
-                {
-                    return;
-                }
 
-                current = GetNextRequest(queue);
-                if (current == 0x0)
+                while (true)
                 {
+                    if (queue->m_Shutdown)
+                    {
+                        return;
+                    }
+
+                    current = GetNextRequest(queue);
+                    if (current != 0x0)
+                    {
+                        break;
+                    }
+
                     // Nothing to do, reset any buffers of inactive requests that are not at default capacity
                     for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
                     {
                         Request* r = &queue->m_Request[i];
-                        if (r->m_Buffer.Size() == 0)
+                        if (r->m_State == REQUEST_STATE_FREE)
                         {
                             if (r->m_Buffer.Capacity() > DEFAULT_CAPACITY)
                             {
@@ -122,42 +156,57 @@ namespace dmLoadQueue
                         }
                     }
                     dmConditionVariable::Wait(queue->m_WakeupCond, queue->m_Mutex);
-                    current = GetNextRequest(queue);
                 }
+
+                // The buffer is reset to the default capacity below
+                current->m_State = REQUEST_STATE_LOADING;
+                current->m_BytesCounted = DEFAULT_CAPACITY;
+                queue->m_BytesWaiting += DEFAULT_CAPACITY;
             }
 
-            if (current)
+            // We use the temporary result object here to fill in the data so it can be written with the mutex held.
+            uint32_t size;
+
+            assert(current->m_Buffer.Size() == 0);
+            if (current->m_Buffer.Capacity() != DEFAULT_CAPACITY)
+            {
+                current->m_Buffer.SetCapacity(DEFAULT_CAPACITY);
+            }
+            const void* view       = 0;
+            result.m_LoadResult    = DoLoadResource(queue->m_Factory, current->m_CanonicalPath, current->m_Name, &size, &current->m_Buffer, &view);
+            result.m_PreloadResult = dmResource::RESULT_PENDING;
+            result.m_PreloadData   = 0;
+            result.m_IsBufferView  = view != 0;
+
+            // Once loaded, the real size of the buffer is counted while it is being preloaded,
+            // so that the other loaders are throttled by the data actually in flight
+            uint32_t capacity = current->m_Buffer.Capacity();
+            if (capacity != current->m_BytesCounted)
             {
-                // We use the temporary result object here to fill in the data so it can be written with the mutex held.
-                uint32_t size;
+                dmMutex::ScopedLock lk(queue->m_Mutex);
+                queue->m_BytesWaiting = queue->m_BytesWaiting + capacity - current->m_BytesCounted;
+                current->m_BytesCounted = capacity;
+            }
 
-                assert(current->m_Buffer.Size() == 0);
-                if (current->m_Buffer.Capacity() != DEFAULT_CAPACITY)
+            if (result.m_LoadResult == dmResource::RESULT_OK)
+            {
+                assert(view != 0 || current->m_Buffer.Size() == size);
+                current->m_View = view;
+                current->m_Size = size;
+                if (current->m_PreloadInfo.m_Function)
                 {
-                    current->m_Buffer.SetCapacity(DEFAULT_CAPACITY);
+                    dmResource::ResourcePreloadParams params;
+                    params.m_Factory       = queue->m_Factory;
+                    params.m_Context       = current->m_PreloadInfo.m_Context;
+                    params.m_Buffer        = view ? view : current->m_Buffer.Begin();
+                    params.m_BufferSize    = size;
+                    params.m_HintInfo      = &current->m_PreloadInfo.m_HintInfo;
+                    params.m_PreloadData   = &result.m_PreloadData;
+                    result.m_PreloadResult = current->m_PreloadInfo.m_Function(params);
                 }
-                result.m_LoadResult    = DoLoadResource(queue->m_Factory, current->m_CanonicalPath, current->m_Name, &size, &current->m_Buffer);
-                result.m_PreloadResult = dmResource::RESULT_PENDING;
-                result.m_PreloadData   = 0;
-
-                if (result.m_LoadResult == dmResource::RESULT_OK)
+                else
                 {
-                    assert(current->m_Buffer.Size() == size);
-                    if (current->m_PreloadInfo.m_Function)
-                    {
-                        dmResource::ResourcePreloadParams params;
-                        params.m_Factory       = queue->m_Factory;
-                        params.m_Context       = current->m_PreloadInfo.m_Context;
-                        params.m_Buffer        = current->m_Buffer.Begin();
-                        params.m_BufferSize    = current->m_Buffer.Size();
-                        params.m_HintInfo      = &current->m_PreloadInfo.m_HintInfo;
-                        params.m_PreloadData   = &result.m_PreloadData;
-                        result.m_PreloadResult = current->m_PreloadInfo.m_Function(params);
-                    }
-                    else
-                    {
-                        result.m_PreloadResult = dmResource::RESULT_OK;
-                    }
+                    result.m_PreloadResult = dmResource::RESULT_OK;
                 }
             }
         }
@@ -167,14 +216,25 @@ namespace dmLoadQueue
     {
         Queue* q          = new Queue();
         q->m_Factory      = factory;
-        q->m_Front        = 0;
-        q->m_Back         = 0;
-        q->m_Loaded       = 0;
+        q->m_RequestCount = 0;
+        q->m_Sequence     = 0;
         q->m_Shutdown     = false;
         q->m_BytesWaiting = 0;
         q->m_Mutex        = dmMutex::New();
         q->m_WakeupCond   = dmConditionVariable::New();
-        q->m_Thread       = dmThread::New(&LoadThread, 65536, q, "AsyncLoad");
+
+        for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
+        {
+            q->m_Request[i].m_State = REQUEST_STATE_FREE;
+        }
+
+        uint32_t thread_count = dmResource::GetLoaderThreadCount(factory);
+        thread_count = dmMath::Clamp(thread_count, 1U, MAX_LOADER_THREADS);
+        q->m_ThreadCount = thread_count;
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            q->m_Threads[i] = dmThread::New(&LoadThread, 65536, q, "AsyncLoad");
+        }
 
         return q;
     }
@@ -184,16 +244,19 @@ namespace dmLoadQueue
         {
             dmMutex::ScopedLock lk(queue->m_Mutex);
             queue->m_Shutdown = true;
-            // Wake up the worker so it can exit and allow us to join
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            // Wake up the workers so they can exit and allow us to join
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
+        }
+        for (uint32_t i = 0; i < queue->m_ThreadCount; ++i)
+        {
+            dmThread::Join(queue->m_Threads[i]);
         }
-        dmThread::Join(queue->m_Thread);
         dmConditionVariable::Delete(queue->m_WakeupCond);
         dmMutex::Delete(queue->m_Mutex);
         delete queue;
     }
 
-    HRequest BeginLoad(HQueue queue, const char* name, const char* canonical_path, PreloadInfo* info)
+    HRequest BeginLoad(HQueue queue, const char* name, const char* canonical_path, PreloadInfo* info, uint32_t priority)
     {
         assert(name != 0);
         assert(name[0] != 0);
@@ -203,33 +266,47 @@ namespace dmLoadQueue
         dmMutex::ScopedLock lk(queue->m_Mutex);
 
         // Refuse more if full.
-        if ((queue->m_Front - queue->m_Back) == QUEUE_SLOTS)
+        if (queue->m_RequestCount == QUEUE_SLOTS)
             return 0;
 
-        if (queue->m_Loaded == queue->m_Front)
+        Request* req = 0x0;
+        for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
         {
-            // The worker is sleeping waiting for request, wake it up
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            if (queue->m_Request[i].m_State == REQUEST_STATE_FREE)
+            {
+                req = &queue->m_Request[i];
+                break;
+            }
         }
+        assert(req != 0x0);
+        queue->m_RequestCount++;
 
-        Request* req         = &queue->m_Request[(queue->m_Front++) % QUEUE_SLOTS];
         req->m_Name          = name;
         req->m_CanonicalPath = canonical_path;
+        req->m_View          = 0;
+        req->m_Size          = 0;
+        req->m_BytesCounted  = 0;
+        req->m_Priority      = priority;
+        req->m_Sequence      = queue->m_Sequence++;
+        req->m_State         = REQUEST_STATE_QUEUED;
 
         req->m_PreloadInfo         = *info;
         req->m_Result.m_LoadResult = dmResource::RESULT_PENDING;
 
+        // Wake up a worker, in case they are all sleeping waiting for requests
+        dmConditionVariable::Signal(queue->m_WakeupCond);
+
         return req;
     }
 
     Result EndLoad(HQueue queue, HRequest request, void** buf, uint32_t* size, LoadResult* load_result)
     {
         dmMutex::ScopedLock lk(queue->m_Mutex);
-        if (request->m_Result.m_LoadResult == dmResource::RESULT_PENDING)
+        if (request->m_State != REQUEST_STATE_DONE)
             return RESULT_PENDING;
 
-        *buf         = request->m_Buffer.Begin();
-        *size        = request->m_Buffer.Size();
+        *buf         = request->m_View ? (void*) request->m_View : request->m_Buffer.Begin();
+        *size        = request->m_Size;
         *load_result = request->m_Result;
 
         return RESULT_OK;
@@ -239,28 +316,33 @@ namespace dmLoadQueue
     {
         dmMutex::ScopedLock lk(queue->m_Mutex);
 
-        uint32_t old_bytes_waiting = queue->m_BytesWaiting;
+        assert(request->m_State == REQUEST_STATE_DONE);
+
+        uint64_t old_bytes_waiting = queue->m_BytesWaiting;
 
         // Make sure we don't copy any data if we reallocate the buffer
         request->m_Buffer.SetSize(0);
 
         uint32_t buffer_capacity = request->m_Buffer.Capacity();
-        queue->m_BytesWaiting -= buffer_capacity;
-        // If we either have blocked further processing by exceeding MAX_PENDING_DATA or
-        // the buffer has a non-default capacity, we want to wake up the worker
-        if (buffer_capacity != DEFAULT_CAPACITY || (old_bytes_waiting >= MAX_PENDING_DATA && queue->m_BytesWaiting < MAX_PENDING_DATA))
+        queue->m_BytesWaiting -= request->m_BytesCounted;
+        request->m_BytesCounted = 0;
+        // If we have blocked further processing by exceeding MAX_PENDING_DATA, all workers may be waiting.
+        // If the buffer has a non-default capacity, we want to wake up a worker to free it
+        if (old_bytes_waiting >= MAX_PENDING_DATA && queue->m_BytesWaiting < MAX_PENDING_DATA)
+        {
+            // Wake up threads, we can now fit new requests
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
+        }
+        else if (buffer_capacity != DEFAULT_CAPACITY)
         {
-            // Wake up thread, we can now fit a new request
             dmConditionVariable::Signal(queue->m_WakeupCond);
         }
 
         // Clean up picked up requests
         request->m_Name          = 0x0;
         request->m_CanonicalPath = 0x0;
-
-        while (queue->m_Back != queue->m_Loaded && queue->m_Request[queue->m_Back % QUEUE_SLOTS].m_Name == 0x0)
-        {
-            queue->m_Back++;
-        }
+        request->m_View          = 0x0;
+        request->m_State         = REQUEST_STATE_FREE;
+        queue->m_RequestCount--;
     }
 } // namespace dmLoadQueue
@@ -80,6 +80,7 @@ const char* BUNDLE_DATA_FILENAME                = "game.arcd";
 
 
 const char* MAX_RESOURCES_KEY = "resource.max_resources";
+const char* LOADER_THREADS_KEY = "resource.loader_threads";
 
 struct ResourceReloadedCallbackPair
 {
@@ -105,6 +106,9 @@ struct SResourceFactory
     // m_BuiltinsManifest, m_Manifest
     dmMutex::HMutex                              m_LoadMutex;
 
+    // Number of threads in each async load queue
+    uint32_t                                     m_LoaderThreadCount;
+
     // dmResource::Get recursion depth
     uint32_t                                     m_RecursionDepth;
     // List of resources currently in dmResource::Get call-stack
@@ -193,6 +197,7 @@ Result CheckSuppliedResourcePath(const char* name)
 void SetDefaultNewFactoryParams(struct NewFactoryParams* params)
 {
     params->m_MaxResources = 1024;
+    params->m_LoaderThreadCount = 2;
     params->m_Flags = RESOURCE_FACTORY_FLAGS_EMPTY;
 
     params->m_ArchiveManifest.m_Data = 0;
@@ -458,6 +463,7 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
     memset(factory, 0, sizeof(*factory));
     factory->m_Socket = socket;
     factory->m_UseLiveUpdate = params->m_Flags & RESOURCE_FACTORY_FLAGS_LIVE_UPDATE ? 1 : 0;
+    factory->m_LoaderThreadCount = params->m_LoaderThreadCount;
 
     dmURI::Result uri_result = dmURI::Parse(uri, &factory->m_UriParts);
     if (uri_result != dmURI::RESULT_OK)
@@ -850,7 +856,14 @@ Result VerifyResourcesBundled(dmResourceArchive::HArchiveIndexContainer base_arc
     return VerifyResourcesBundled(entries, entry_count, hash_len, base_archive);
 }
 
-static Result LoadFromManifest(const Manifest* manifest, const char* path, uint32_t* resource_size, LoadBufferType* buffer)
+// An archive entry that has been read, but not yet decrypted or decompressed, see DoLoadResource
+struct EncodedEntry
+{
+    dmResourceArchive::EntryData    m_Entry;
+    bool                            m_Pending;
+};
+
+static Result LoadFromManifest(const Manifest* manifest, const char* path, uint32_t* resource_size, LoadBufferType* buffer, const void** view, EncodedEntry* encoded)
 {
     dmhash_t path_hash = dmHashString64(path);
 
@@ -869,6 +882,41 @@ static Result LoadFromManifest(const Manifest* manifest, const char* path, uint3
     if (res == dmResourceArchive::RESULT_OK)
     {
         uint32_t file_size = ed.m_ResourceSize;
+        if (view && dmResourceArchive::GetEntryView(archive, &ed, view) == dmResourceArchive::RESULT_OK)
+        {
+            // The data is stored as is in a memory mapped archive, no need to copy it
+            buffer->SetSize(0);
+            *resource_size = file_size;
+            return RESULT_OK;
+        }
+
+        bool needs_decoding = (ed.m_Flags & dmResourceArchive::ENTRY_FLAG_ENCRYPTED) || ed.m_ResourceCompressedSize != 0xFFFFFFFF;
+        if (encoded && needs_decoding)
+        {
+            // Compressed data is read after the space for the decompressed data, since LZ4 can't decompress in place
+            uint32_t encoded_size = dmResourceArchive::GetEncodedEntrySize(&ed);
+            uint32_t encoded_offset = ed.m_ResourceCompressedSize != 0xFFFFFFFF ? file_size : 0;
+            if (buffer->Capacity() < encoded_offset + encoded_size)
+            {
+                buffer->SetCapacity(encoded_offset + encoded_size);
+            }
+
+            buffer->SetSize(0);
+            dmResourceArchive::Result read_result = dmResourceArchive::ReadEncodedEntry(archive, &ed, buffer->Begin() + encoded_offset);
+            if (read_result == dmResourceArchive::RESULT_OK)
+            {
+                encoded->m_Entry = ed;
+                encoded->m_Pending = true;
+                *resource_size = file_size;
+                return RESULT_OK;
+            }
+            else if (read_result != dmResourceArchive::RESULT_NOT_FOUND)
+            {
+                return RESULT_IO_ERROR;
+            }
+            // Not read by the default reader, fall back to reading it all at once
+        }
+
         if (buffer->Capacity() < file_size)
         {
             buffer->SetCapacity(file_size);
@@ -896,12 +944,18 @@ static Result LoadFromManifest(const Manifest* manifest, const char* path, uint3
 }
 
 // Assumes m_LoadMutex is already held
-static Result DoLoadResourceLocked(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer)
+// If encoded is set, archive entries might be returned without being decrypted or decompressed, see DoLoadResource
+static Result DoLoadResourceLocked(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, const void** view, EncodedEntry* encoded)
 {
     DM_PROFILE(__FUNCTION__);
+    if (view)
+    {
+        *view = 0;
+    }
+
     if (factory->m_BuiltinsManifest)
     {
-        if (LoadFromManifest(factory->m_BuiltinsManifest, original_name, resource_size, buffer) == RESULT_OK)
+        if (LoadFromManifest(factory->m_BuiltinsManifest, original_name, resource_size, buffer, view, encoded) == RESULT_OK)
         {
             return RESULT_OK;
         }
@@ -955,7 +1009,7 @@ static Result DoLoadResourceLocked(HFactory factory, const char* path, const cha
     }
     else if (factory->m_Manifest)
     {
-        Result r = LoadFromManifest(factory->m_Manifest, original_name, resource_size, buffer);
+        Result r = LoadFromManifest(factory->m_Manifest, original_name, resource_size, buffer, view, encoded);
         return r;
     }
     else
@@ -1000,11 +1054,29 @@ static Result DoLoadResourceLocked(HFactory factory, const char* path, const cha
 }
 
 // Takes the lock.
-Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer)
+Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, const void** view)
 {
-    // Called from async queue so we wrap around a lock
-    dmMutex::ScopedLock lk(factory->m_LoadMutex);
-    return DoLoadResourceLocked(factory, path, original_name, resource_size, buffer);
+    // Called from async queue so we wrap around a lock. Only the read itself needs it, archive entries
+    // are decrypted and decompressed after it's released so that the loader threads can do it in parallel
+    EncodedEntry encoded;
+    encoded.m_Pending = false;
+    Result r;
+    {
+        dmMutex::ScopedLock lk(factory->m_LoadMutex);
+        r = DoLoadResourceLocked(factory, path, original_name, resource_size, buffer, view, &encoded);
+    }
+
+    if (r == RESULT_OK && encoded.m_Pending)
+    {
+        DM_PROFILE("DecodeEntry");
+        uint32_t encoded_offset = encoded.m_Entry.m_ResourceCompressedSize != 0xFFFFFFFF ? *resource_size : 0;
+        if (dmResourceArchive::DecodeEntry(&encoded.m_Entry, buffer->Begin() + encoded_offset, buffer->Begin()) != dmResourceArchive::RESULT_OK)
+        {
+            return RESULT_IO_ERROR;
+        }
+        buffer->SetSize(*resource_size);
+    }
+    return r;
 }
 
 // Assumes m_LoadMutex is already held
@@ -1014,9 +1086,10 @@ Result LoadResource(HFactory factory, const char* path, const char* original_nam
         factory->m_Buffer.SetCapacity(DEFAULT_BUFFER_SIZE);
     }
     factory->m_Buffer.SetSize(0);
-    Result r = DoLoadResourceLocked(factory, path, original_name, resource_size, &factory->m_Buffer);
+    const void* view;
+    Result r = DoLoadResourceLocked(factory, path, original_name, resource_size, &factory->m_Buffer, &view, 0);
     if (r == RESULT_OK)
-        *buffer = factory->m_Buffer.Begin();
+        *buffer = view ? (void*) view : factory->m_Buffer.Begin();
     else
         *buffer = 0;
     return r;
@@ -1091,8 +1164,6 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
             return result;
         }
 
-        assert(buffer == factory->m_Buffer.Begin());
-
         // TODO: We should *NOT* allocate SResource dynamically...
         SResourceDescriptor tmp_resource;
         memset(&tmp_resource, 0, sizeof(tmp_resource));
@@ -1286,7 +1357,6 @@ Result GetRaw(HFactory factory, const char* name, void** resource, uint32_t* res
     Result result = LoadResource(factory, canonical_path, name, &buffer, &file_size);
     if (result == RESULT_OK) {
         *resource = malloc(file_size);
-        assert(buffer == factory->m_Buffer.Begin());
         memcpy(*resource, buffer, file_size);
         *resource_size = file_size;
     }
@@ -1318,8 +1388,6 @@ static Result DoReloadResource(HFactory factory, const char* name, SResourceDesc
     if (result != RESULT_OK)
         return result;
 
-    assert(buffer == factory->m_Buffer.Begin());
-
     ResourceRecreateParams params;
     params.m_Factory = factory;
     params.m_Context = resource_type->m_Context;
@@ -1724,6 +1792,11 @@ dmMutex::HMutex GetLoadMutex(const dmResource::HFactory factory)
     return factory->m_LoadMutex;
 }
 
+uint32_t GetLoaderThreadCount(HFactory factory)
+{
+    return factory->m_LoaderThreadCount;
+}
+
 void ReleaseBuiltinsManifest(HFactory factory)
 {
     if (factory->m_BuiltinsManifest)
@@ -37,6 +37,11 @@ namespace dmResource
      */
     extern const char* MAX_RESOURCES_KEY;
 
+    /**
+     * Configuration key used to tweak the number of threads loading resources asynchronously.
+     */
+    extern const char* LOADER_THREADS_KEY;
+
     extern const char* BUNDLE_MANIFEST_FILENAME;
     extern const char* BUNDLE_INDEX_FILENAME;
     extern const char* BUNDLE_DATA_FILENAME;
@@ -133,7 +138,10 @@ namespace dmResource
         EmbeddedResource m_ArchiveData;
         EmbeddedResource m_ArchiveManifest;
 
-        uint32_t m_Reserved[5];
+        /// Number of threads used for asynchronous loading, per preloader. Default is 2
+        uint32_t m_LoaderThreadCount;
+
+        uint32_t m_Reserved[4];
 
         NewFactoryParams()
         {
@@ -545,6 +545,79 @@ namespace dmResourceArchive
         return RESULT_OK;
     }
 
+    uint32_t GetEncodedEntrySize(const EntryData* entry)
+    {
+        bool compressed = entry->m_ResourceCompressedSize != 0xFFFFFFFF;
+        return compressed ? entry->m_ResourceCompressedSize : entry->m_ResourceSize;
+    }
+
+    Result ReadEncodedEntry(HArchiveIndexContainer archive, const EntryData* entry, void* buffer)
+    {
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+
+        // Other readers may store the data differently
+        if (archive->m_Loader.m_Read != ReadEntryFromArchive || afi == 0)
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        uint32_t size = GetEncodedEntrySize(entry);
+        if (afi->m_IsMemMapped)
+        {
+            memcpy(buffer, (const void*) (((uintptr_t)afi->m_ResourceData + entry->m_ResourceDataOffset)), size);
+            return RESULT_OK;
+        }
+
+        FILE* resource_file = afi->m_FileResourceData;
+        fseek(resource_file, entry->m_ResourceDataOffset, SEEK_SET);
+        if (fread(buffer, 1, size, resource_file) != size)
+        {
+            return RESULT_IO_ERROR;
+        }
+        return RESULT_OK;
+    }
+
+    Result DecodeEntry(const EntryData* entry, void* encoded, void* buffer)
+    {
+        uint32_t size = GetEncodedEntrySize(entry);
+        if (entry->m_Flags & ENTRY_FLAG_ENCRYPTED)
+        {
+            Result r = DecryptBuffer(encoded, size);
+            if (r != RESULT_OK)
+            {
+                return r;
+            }
+        }
+
+        if (entry->m_ResourceCompressedSize != 0xFFFFFFFF)
+        {
+            return DecompressBuffer(encoded, size, buffer, entry->m_ResourceSize);
+        }
+
+        if (buffer != encoded)
+        {
+            memcpy(buffer, encoded, size);
+        }
+        return RESULT_OK;
+    }
+
+    Result GetEntryView(HArchiveIndexContainer archive, const EntryData* entry, const void** data)
+    {
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+
+        bool encrypted = (entry->m_Flags & ENTRY_FLAG_ENCRYPTED);
+        bool compressed = entry->m_ResourceCompressedSize != 0xFFFFFFFF;
+
+        // Other readers may store the data differently
+        if (archive->m_Loader.m_Read != ReadEntryFromArchive || afi == 0 || !afi->m_IsMemMapped || encrypted || compressed)
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        *data = (const void*) (((uintptr_t)afi->m_ResourceData + entry->m_ResourceDataOffset));
+        return RESULT_OK;
+    }
+
     void RegisterDefaultArchiveLoader()
     {
         dmResourceArchive::ArchiveLoader loader;
@@ -204,6 +204,18 @@ namespace dmResourceArchive
     // Reads an entry from a single archive
     Result ReadEntryFromArchive(HArchiveIndexContainer archive, const uint8_t* hash, uint32_t hash_len, const EntryData* entry, void* buffer);
 
+    // Reads the data of an entry as it is stored in the archive, without decrypting or decompressing it.
+    // Only possible for archives using the default reader, returns RESULT_NOT_FOUND otherwise.
+    // The buffer must fit GetEncodedEntrySize() bytes
+    Result ReadEncodedEntry(HArchiveIndexContainer archive, const EntryData* entry, void* buffer);
+
+    // The size of the data read by ReadEncodedEntry()
+    uint32_t GetEncodedEntrySize(const EntryData* entry);
+
+    // Decrypts (in place) and decompresses the data read by ReadEncodedEntry() into buffer, which must fit m_ResourceSize bytes.
+    // Does not use any archive state, so it's safe to call without holding any locks
+    Result DecodeEntry(const EntryData* entry, void* encoded, void* buffer);
+
     // Calls each loader in sequence
 
     /*# Loads the archives, calling each registered loader in sequence
@@ -250,6 +262,17 @@ namespace dmResourceArchive
      */
     Result Read(HArchiveIndexContainer archive, const uint8_t* hash, uint32_t hash_len, EntryData* entry_data, void* buffer);
 
+    /**
+     * Get a read-only view of the resource data, without copying it.
+     * Only possible for uncompressed and unencrypted entries in memory mapped archives using the default reader.
+     * The data is valid for as long as the archive is mounted.
+     * @param archive archive index handle
+     * @param entry_data entry data
+     * @param data [out] pointer to the resource data
+     * @return RESULT_OK on success, RESULT_NOT_FOUND if the entry has to be read with Read()
+     */
+    Result GetEntryView(HArchiveIndexContainer archive, const EntryData* entry_data, const void** data);
+
     /**
      * Delete archive index. Only required for archives created with LoadArchive function
      * @param archive archive index handle
@@ -102,6 +102,8 @@ namespace dmResource
         // Set for items that are pending and waiting for children to complete
         void* m_Buffer;
         uint32_t m_BufferSize;
+        // The buffer points into a memory mapped archive, rather than being a copy
+        bool m_IsBufferView;
 
         // Set once preload function has run
         void* m_PreloadData;
@@ -545,9 +547,13 @@ namespace dmResource
             params.m_BufferSize               = req->m_BufferSize;
             req->m_LoadResult                 = resource_type->m_CreateFunction(params);
 
-            dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
+            if (!req->m_IsBufferView)
+            {
+                dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
+            }
 
             req->m_Buffer = 0;
+            req->m_IsBufferView = false;
         }
         else
         {
@@ -737,8 +743,17 @@ namespace dmResource
         else
         {
             // Keep the loaded bytes until we have loaded all children
-            req->m_Buffer = dmBlockAllocator::Allocate(preloader->m_BlockAllocator, buffer_size);
-            memcpy(req->m_Buffer, buffer, buffer_size);
+            if (load_result.m_IsBufferView)
+            {
+                // Data in a memory mapped archive outlives the load request, no need to copy it
+                req->m_Buffer = buffer;
+            }
+            else
+            {
+                req->m_Buffer = dmBlockAllocator::Allocate(preloader->m_BlockAllocator, buffer_size);
+                memcpy(req->m_Buffer, buffer, buffer_size);
+            }
+            req->m_IsBufferView = load_result.m_IsBufferView;
             req->m_BufferSize = buffer_size;
             dmLoadQueue::FreeLoad(preloader->m_LoadQueue, req->m_LoadRequest);
             req->m_LoadRequest = 0;
@@ -862,9 +877,16 @@ namespace dmResource
         info.m_Function             = req->m_PathDescriptor.m_ResourceType->m_PreloadFunction;
         info.m_Context              = req->m_PathDescriptor.m_ResourceType->m_Context;
 
+        // Load deeper requests first, they complete their parents (and free up request slots) sooner
+        uint32_t depth = 0;
+        for (TRequestIndex parent = req->m_Parent; parent != -1; parent = preloader->m_Request[parent].m_Parent)
+        {
+            ++depth;
+        }
+
         // If we can't add the request to the load queue it is because the queue is full
         // We will try again once we completed loading of an item via dmLoadQueue::EndLoad
-        if ((req->m_LoadRequest = dmLoadQueue::BeginLoad(preloader->m_LoadQueue, req->m_PathDescriptor.m_InternalizedName, req->m_PathDescriptor.m_InternalizedCanonicalPath, &info)))
+        if ((req->m_LoadRequest = dmLoadQueue::BeginLoad(preloader->m_LoadQueue, req->m_PathDescriptor.m_InternalizedName, req->m_PathDescriptor.m_InternalizedCanonicalPath, &info, depth)))
         {
             MarkPathInProgress(preloader, &req->m_PathDescriptor);
             return true;
@@ -52,8 +52,11 @@ namespace dmResource
 
     // load with default internal buffer and its management, returns buffer ptr in 'buffer'
     Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size);
-    // load with own buffer
-    Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer);
+    // load with own buffer. If the resource can be used in place from a memory mapped archive, the buffer
+    // is left empty and 'view' points to the data instead (which stays valid as long as the archive is mounted)
+    Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, const void** view);
+    // number of threads to use for each async load queue
+    uint32_t GetLoaderThreadCount(HFactory factory);
 
     Result InsertResource(HFactory factory, const char* path, uint64_t canonical_path_hash, SResourceDescriptor* descriptor);
     uint32_t GetCanonicalPath(const char* relative_dir, char* buf);
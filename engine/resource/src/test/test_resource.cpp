@@ -825,6 +825,49 @@ TEST_P(GetResourceTest, PreloadGetParallell)
     }
 }
 
+TEST_P(GetResourceTest, PreloadGetLoaderThreads)
+{
+    const uint32_t thread_counts[] = {1, 4};
+    for (uint32_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); ++t)
+    {
+        dmResource::DeleteFactory(m_Factory);
+
+        dmResource::NewFactoryParams params;
+        params.m_MaxResources = 16;
+        params.m_LoaderThreadCount = thread_counts[t];
+        m_Factory = dmResource::NewFactory(&params, GetParam());
+        ASSERT_NE((void*) 0, m_Factory);
+
+        dmResource::Result e;
+        e = dmResource::RegisterType(m_Factory, "cont", this, &ResourceContainerPreload, &ResourceContainerCreate, 0, &ResourceContainerDestroy, 0);
+        ASSERT_EQ(dmResource::RESULT_OK, e);
+        e = dmResource::RegisterType(m_Factory, "foo", this, 0, &FooResourceCreate, &FooResourcePostCreate, &FooResourceDestroy, 0);
+        ASSERT_EQ(dmResource::RESULT_OK, e);
+
+        const char* resource_names_list[] = { m_ResourceName, "/test_ref.cont" };
+        dmArray<const char*> resource_names(resource_names_list, 2, 2);
+        dmResource::HPreloader pr = dmResource::NewPreloader(m_Factory, resource_names);
+
+        dmResource::Result r;
+        for (uint32_t i=0;i<33;i++)
+        {
+            r = dmResource::UpdatePreloader(pr, 0, 0, 30*1000);
+            if (r == dmResource::RESULT_PENDING)
+                dmTime::Sleep(30000);
+            else
+                break;
+        }
+        ASSERT_EQ(dmResource::RESULT_OK, r);
+
+        dmResource::SResourceDescriptor descriptor;
+        e = dmResource::GetDescriptor(m_Factory, "/test01.foo", &descriptor);
+        ASSERT_EQ(dmResource::RESULT_OK, e);
+        ASSERT_EQ((uint32_t) 2, descriptor.m_ReferenceCount);
+
+        dmResource::DeletePreloader(pr);
+    }
+}
+
 TEST_P(GetResourceTest, PreloadGetManyRefs)
 {
     // this has more references than the preloader can fit into its tree
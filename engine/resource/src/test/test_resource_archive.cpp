@@ -745,6 +745,56 @@ TEST(dmResourceArchive, Wrap)
     dmResourceArchive::Delete(archive);
 }
 
+TEST(dmResourceArchive, EntryView)
+{
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer((void*) RESOURCES_ARCI, RESOURCES_ARCI_SIZE, true, RESOURCES_ARCD, RESOURCES_ARCD_SIZE, true, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    dmResourceArchive::SetDefaultReader(archive);
+
+    dmResourceArchive::HArchiveIndexContainer entryarchive;
+    dmResourceArchive::EntryData entry;
+    for (uint32_t i = 0; i < (sizeof(path_hash) / sizeof(path_hash[0])); ++i)
+    {
+        if (IsLiveUpdateResource(path_hash[i])) continue;
+
+        result = dmResourceArchive::FindEntry(archive, content_hash[i], sizeof(content_hash[i]), &entryarchive, &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+        const void* view = 0;
+        result = dmResourceArchive::GetEntryView(entryarchive, &entry, &view);
+        if (entry.m_Flags & dmResourceArchive::ENTRY_FLAG_ENCRYPTED)
+        {
+            ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, result);
+            continue;
+        }
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+        // The view points directly into the archive data
+        ASSERT_GE((const uint8_t*) view, (const uint8_t*) RESOURCES_ARCD);
+        ASSERT_LE((const uint8_t*) view + entry.m_ResourceSize, (const uint8_t*) RESOURCES_ARCD + RESOURCES_ARCD_SIZE);
+        ASSERT_EQ(strlen(content[i]), entry.m_ResourceSize);
+        ASSERT_EQ(0, memcmp(content[i], view, entry.m_ResourceSize));
+    }
+
+    dmResourceArchive::Delete(archive);
+
+    // Entries in archives read from file must be copied
+    const char* archive_path = MOUNTFS "build/default/src/test/resources.arci";
+    const char* resource_path = MOUNTFS "build/default/src/test/resources.arcd";
+    result = dmResourceArchive::LoadArchiveFromFile(archive_path, resource_path, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+    dmResourceArchive::SetDefaultReader(archive);
+
+    result = dmResourceArchive::FindEntry(archive, content_hash[0], sizeof(content_hash[0]), &entryarchive, &entry);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+    const void* view = 0;
+    ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, dmResourceArchive::GetEntryView(entryarchive, &entry, &view));
+
+    dmResourceArchive::Delete(archive);
+}
+
 TEST(dmResourceArchive, Wrap_Compressed)
 {
     dmResourceArchive::HArchiveIndexContainer archive = 0;
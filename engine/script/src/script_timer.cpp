@@ -42,19 +42,17 @@ namespace dmScript
      */
 
     /*
-        The timers are stored in a flat array with no holes which we scan sequenctially on each update.
-
-        When a timer is removed the last timer in the list may change location (EraseSwap).
+        The timers are stored in slots that never move, and the timer identity is the slot index combined
+        with a per slot generation counter. This makes it possible to reuse a slot without risk of using
+        stale handles - the caller to CancelTimer is allowed to call with a handle of a timer that already
+        has expired.
 
-        This is to keep the array sweep fast and handle cases where multiple short lived timers are
-        created followed by one long-lived timer. If we did not re-shuffle and keep holes we would keep
-        scanning the array to the end where the only live timer exists skipping all the holes.
-        How much of an issue this is guesswork at this point.
+        The scheduled timers are kept in a binary min-heap ordered by the world time when they fire, so an
+        update only visits the timers that are triggered. Timers firing at the same time are triggered in the
+        order they were scheduled.
 
-        The timer identity is an index into an indirection layer combined with a generation counter,
-        this makes it possible to reuse the index for the indirection layer without risk of using
-        stale indexes - the caller to CancelTimer is allowed to call with an handle of a timer that already
-        has expired.
+        The timers of each owner are linked together, with the head of each list in a hash table, so that
+        KillTimers only visits the timers of that owner.
 
         Each script instance needs to call KillTimers for its owner to clean up potential timers
         that has not yet been cancelled or completed (one-shot).
@@ -63,125 +61,299 @@ namespace dmScript
     static const char TIMER_WORLD_VALUE_KEY[] = "__dm_timer_world__";
     static const uint32_t TIMER_WORLD_VALUE_KEY_HASH = dmHashBuffer32(TIMER_WORLD_VALUE_KEY, sizeof(TIMER_WORLD_VALUE_KEY) - 1);
 
+    #define INVALID_TIMER_INDEX         0xffffffffu
+    #define TIMER_INDEX_BITS            22u
+    #define TIMER_INDEX_MASK            ((1u << TIMER_INDEX_BITS) - 1u)
+    #define TIMER_GENERATION_MASK       ((1u << (32u - TIMER_INDEX_BITS)) - 1u)
+    #define INITIAL_TIMER_CAPACITY      8u
+    #define MAX_TIMER_CAPACITY          TIMER_INDEX_MASK  // The last index is reserved, since it would make INVALID_TIMER_HANDLE with the last generation
+    #define TIMER_CAPACITY_GROWTH       16u
+    #define OWNER_TABLE_SIZE            127u
+
     struct Timer
     {
         TimerCallback   m_Callback;
         uintptr_t       m_Owner;
         uintptr_t       m_UserData;
 
+        // The world time when the timer fires next
+        double          m_FireTime;
+
+        // Order of scheduling, to break ties in the schedule
+        uint64_t        m_Sequence;
+
         // Store complete timer handle with generation here to identify stale timer handles
         HTimer          m_Handle;
 
-        // How much time remaining until the timer fires
-        float           m_Remaining;
-
         // The timer delay, we need to keep this for repeating timers
         float           m_Delay;
 
+        // Position in TimerWorld::m_Schedule, INVALID_TIMER_INDEX if not scheduled
+        uint32_t        m_ScheduleIndex;
+
+        // Previous and next timer with the same owner
+        uint32_t        m_PrevOwned;
+        uint32_t        m_NextOwned;
+
+        // Incremented each time the slot is freed
+        uint16_t        m_Generation;
+
         // Flag if the timer should repeat
-        uint32_t        m_Repeat : 1;
+        uint16_t        m_Repeat : 1;
         // Flag if the timer is alive
-        uint32_t        m_IsAlive : 1;
+        uint16_t        m_IsAlive : 1;
     };
 
-    #define INVALID_TIMER_LOOKUP_INDEX  0xffffu
-    #define INITIAL_TIMER_CAPACITY      8u
-    #define MAX_TIMER_CAPACITY          65000u  // Needs to be less that 65535 since 65535 is reserved for invalid index
-    #define TIMER_CAPACITY_GROWTH       16u
-
     struct TimerWorld
     {
-        dmArray<Timer>                      m_Timers;
-        dmArray<uint16_t>                   m_IndexLookup;
-        dmIndexPool<uint16_t>               m_IndexPool;
-        uint16_t                            m_Version;   // Incremented to avoid collisions each time we push timer indexes back to the m_IndexPool
+        dmArray<Timer>                      m_Timers;       // Slots, indexed by the handle
+        dmIndexPool<uint32_t>               m_IndexPool;
+        dmArray<uint32_t>                   m_Schedule;     // Min-heap of the alive timers, ordered by fire time
+        dmHashTable<uintptr_t, uint32_t>    m_OwnerTimers;  // First timer of each owner
+        dmArray<uint32_t>                   m_Triggered;    // Timers triggered in the current update
+        dmArray<uint32_t>                   m_Dead;         // Timers killed during the update, freed when it is done
+        double                              m_Time;
+        uint64_t                            m_Sequence;
+        uint32_t                            m_AliveCount;
         uint16_t                            m_InUpdate : 1;
     };
 
-    static uint16_t GetLookupIndex(HTimer handle)
+    static uint32_t GetTimerIndex(HTimer handle)
     {
-        return (uint16_t)(handle & 0xffffu);
+        return handle & TIMER_INDEX_MASK;
     }
 
-    static HTimer MakeHandle(uint16_t generation, uint16_t lookup_index)
+    static HTimer MakeHandle(uint16_t generation, uint32_t index)
     {
-        return (((uint32_t)generation) << 16) | (lookup_index);
+        return (((uint32_t)generation & TIMER_GENERATION_MASK) << TIMER_INDEX_BITS) | index;
     }
 
-    static Timer* AllocateTimer(HTimerWorld timer_world, uintptr_t owner)
+    template <typename T>
+    static void PushGrow(dmArray<T>& array, T value)
     {
-        assert(timer_world != 0x0);
-        uint32_t timer_count = timer_world->m_Timers.Size();
-        if (timer_count == MAX_TIMER_CAPACITY)
+        if (array.Full())
         {
-            dmLogError("Timer could not be stored since the timer buffer is full (%d).", MAX_TIMER_CAPACITY);
-            return 0x0;
+            array.OffsetCapacity(dmMath::Max(TIMER_CAPACITY_GROWTH, array.Capacity() / 2));
         }
+        array.Push(value);
+    }
 
-        if (timer_world->m_IndexPool.Remaining() == 0)
+    static bool FiresBefore(const Timer& a, const Timer& b)
+    {
+        if (a.m_FireTime != b.m_FireTime)
         {
-            uint32_t old_capacity = timer_world->m_IndexPool.Capacity();
-            uint32_t capacity = dmMath::Min(old_capacity + TIMER_CAPACITY_GROWTH, MAX_TIMER_CAPACITY);
-            timer_world->m_IndexPool.SetCapacity(capacity);
-            timer_world->m_IndexLookup.SetCapacity(capacity);
-            timer_world->m_IndexLookup.SetSize(capacity);
-            memset(&timer_world->m_IndexLookup[old_capacity], 0u, (capacity - old_capacity) * sizeof(uint16_t));
+            return a.m_FireTime < b.m_FireTime;
         }
+        return a.m_Sequence < b.m_Sequence;
+    }
 
-        HTimer handle = MakeHandle(timer_world->m_Version, timer_world->m_IndexPool.Pop());
+    static void SetScheduleEntry(HTimerWorld timer_world, uint32_t schedule_index, uint32_t timer_index)
+    {
+        timer_world->m_Schedule[schedule_index] = timer_index;
+        timer_world->m_Timers[timer_index].m_ScheduleIndex = schedule_index;
+    }
 
-        if (timer_world->m_Timers.Full())
+    static void SiftUp(HTimerWorld timer_world, uint32_t schedule_index)
+    {
+        uint32_t timer_index = timer_world->m_Schedule[schedule_index];
+        const Timer& timer = timer_world->m_Timers[timer_index];
+        while (schedule_index > 0)
         {
-            uint32_t capacity = timer_world->m_Timers.Capacity();
-            capacity = dmMath::Min(capacity + TIMER_CAPACITY_GROWTH, MAX_TIMER_CAPACITY);
-            timer_world->m_Timers.SetCapacity(capacity);
+            uint32_t parent = (schedule_index - 1) / 2;
+            uint32_t parent_timer_index = timer_world->m_Schedule[parent];
+            if (!FiresBefore(timer, timer_world->m_Timers[parent_timer_index]))
+            {
+                break;
+            }
+            SetScheduleEntry(timer_world, schedule_index, parent_timer_index);
+            schedule_index = parent;
         }
+        SetScheduleEntry(timer_world, schedule_index, timer_index);
+    }
 
-        timer_world->m_Timers.SetSize(timer_count + 1);
-        Timer& timer = timer_world->m_Timers[timer_count];
-        timer.m_Handle = handle;
-        timer.m_Owner = owner;
+    static void SiftDown(HTimerWorld timer_world, uint32_t schedule_index)
+    {
+        uint32_t size = timer_world->m_Schedule.Size();
+        uint32_t timer_index = timer_world->m_Schedule[schedule_index];
+        const Timer& timer = timer_world->m_Timers[timer_index];
+        while (true)
+        {
+            uint32_t child = schedule_index * 2 + 1;
+            if (child >= size)
+            {
+                break;
+            }
+            if (child + 1 < size && FiresBefore(timer_world->m_Timers[timer_world->m_Schedule[child + 1]], timer_world->m_Timers[timer_world->m_Schedule[child]]))
+            {
+                ++child;
+            }
+            uint32_t child_timer_index = timer_world->m_Schedule[child];
+            if (!FiresBefore(timer_world->m_Timers[child_timer_index], timer))
+            {
+                break;
+            }
+            SetScheduleEntry(timer_world, schedule_index, child_timer_index);
+            schedule_index = child;
+        }
+        SetScheduleEntry(timer_world, schedule_index, timer_index);
+    }
+
+    static void Schedule(HTimerWorld timer_world, uint32_t timer_index, double fire_time)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        assert(timer.m_ScheduleIndex == INVALID_TIMER_INDEX);
+        timer.m_FireTime = fire_time;
+        timer.m_Sequence = timer_world->m_Sequence++;
+        PushGrow(timer_world->m_Schedule, timer_index);
+        SiftUp(timer_world, timer_world->m_Schedule.Size() - 1);
+    }
+
+    static void Unschedule(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        uint32_t schedule_index = timer.m_ScheduleIndex;
+        if (schedule_index == INVALID_TIMER_INDEX)
+        {
+            return;
+        }
+        timer.m_ScheduleIndex = INVALID_TIMER_INDEX;
+
+        uint32_t last_timer_index = timer_world->m_Schedule.Back();
+        timer_world->m_Schedule.Pop();
+        if (schedule_index == timer_world->m_Schedule.Size())
+        {
+            return;
+        }
 
-        uint16_t lookup_index = GetLookupIndex(handle);
+        SetScheduleEntry(timer_world, schedule_index, last_timer_index);
+        SiftUp(timer_world, schedule_index);
+        SiftDown(timer_world, timer_world->m_Timers[last_timer_index].m_ScheduleIndex);
+    }
 
-        timer_world->m_IndexLookup[lookup_index] = timer_count;
-        return &timer;
+    static uint32_t PopScheduled(HTimerWorld timer_world)
+    {
+        uint32_t timer_index = timer_world->m_Schedule[0];
+        Unschedule(timer_world, timer_index);
+        return timer_index;
     }
 
-    static void EraseTimer(HTimerWorld timer_world, uint32_t timer_index)
+    static Timer* GetTimer(HTimerWorld timer_world, HTimer handle)
+    {
+        uint32_t timer_index = GetTimerIndex(handle);
+        if (timer_index >= timer_world->m_Timers.Size())
+        {
+            return 0x0;
+        }
+
+        Timer* timer = &timer_world->m_Timers[timer_index];
+        if (timer->m_Handle != handle || timer->m_IsAlive == 0)
+        {
+            return 0x0;
+        }
+        return timer;
+    }
+
+    static uint32_t AllocateTimer(HTimerWorld timer_world, uintptr_t owner)
     {
         assert(timer_world != 0x0);
+        if (timer_world->m_IndexPool.Remaining() == 0)
+        {
+            uint32_t old_capacity = timer_world->m_IndexPool.Capacity();
+            if (old_capacity == MAX_TIMER_CAPACITY)
+            {
+                dmLogError("Timer could not be stored since the timer buffer is full (%d).", MAX_TIMER_CAPACITY);
+                return INVALID_TIMER_INDEX;
+            }
 
-        Timer& movedTimer = timer_world->m_Timers.EraseSwap(timer_index);
+            uint32_t capacity = dmMath::Min(old_capacity + dmMath::Max(TIMER_CAPACITY_GROWTH, old_capacity / 2), MAX_TIMER_CAPACITY);
+            timer_world->m_IndexPool.SetCapacity(capacity);
+            timer_world->m_Timers.SetCapacity(capacity);
+            timer_world->m_Timers.SetSize(capacity);
+            memset(&timer_world->m_Timers[old_capacity], 0u, (capacity - old_capacity) * sizeof(Timer));
+        }
 
-        if (timer_index < timer_world->m_Timers.Size())
+        if (timer_world->m_OwnerTimers.Full())
         {
-            uint16_t moved_lookup_index = GetLookupIndex(movedTimer.m_Handle);
-            timer_world->m_IndexLookup[moved_lookup_index] = timer_index;
+            uint32_t capacity = timer_world->m_OwnerTimers.Capacity() + TIMER_CAPACITY_GROWTH;
+            timer_world->m_OwnerTimers.SetCapacity(dmMath::Max(OWNER_TABLE_SIZE, capacity / 2), capacity);
         }
+
+        uint32_t timer_index = timer_world->m_IndexPool.Pop();
+        Timer& timer = timer_world->m_Timers[timer_index];
+        timer.m_Handle = MakeHandle(timer.m_Generation, timer_index);
+        timer.m_Owner = owner;
+        timer.m_ScheduleIndex = INVALID_TIMER_INDEX;
+
+        // Link it first in the list of timers for the owner
+        uint32_t* first = timer_world->m_OwnerTimers.Get(owner);
+        timer.m_PrevOwned = INVALID_TIMER_INDEX;
+        timer.m_NextOwned = first ? *first : INVALID_TIMER_INDEX;
+        if (first)
+        {
+            timer_world->m_Timers[*first].m_PrevOwned = timer_index;
+            *first = timer_index;
+        }
+        else
+        {
+            timer_world->m_OwnerTimers.Put(owner, timer_index);
+        }
+        return timer_index;
     }
 
-    static void FreeTimer(HTimerWorld timer_world, Timer& timer)
+    static void FreeTimer(HTimerWorld timer_world, uint32_t timer_index)
     {
         assert(timer_world != 0x0);
+        Timer& timer = timer_world->m_Timers[timer_index];
         assert(timer.m_IsAlive == 0);
+        assert(timer.m_ScheduleIndex == INVALID_TIMER_INDEX);
 
-        uint16_t lookup_index = GetLookupIndex(timer.m_Handle);
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        timer_world->m_IndexPool.Push(lookup_index);
+        if (timer.m_PrevOwned != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[timer.m_PrevOwned].m_NextOwned = timer.m_NextOwned;
+        }
+        else if (timer.m_NextOwned != INVALID_TIMER_INDEX)
+        {
+            *timer_world->m_OwnerTimers.Get(timer.m_Owner) = timer.m_NextOwned;
+        }
+        else
+        {
+            timer_world->m_OwnerTimers.Erase(timer.m_Owner);
+        }
+        if (timer.m_NextOwned != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[timer.m_NextOwned].m_PrevOwned = timer.m_PrevOwned;
+        }
 
-        EraseTimer(timer_world, timer_index);
+        ++timer.m_Generation;
+        timer_world->m_IndexPool.Push(timer_index);
+    }
+
+    // Marks the timer as dead. It is freed right away, or when the update is done if we are in an update
+    static void KillTimer(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        assert(timer.m_IsAlive == 1);
+        timer.m_IsAlive = 0;
+        --timer_world->m_AliveCount;
+        Unschedule(timer_world, timer_index);
+        if (timer_world->m_InUpdate)
+        {
+            PushGrow(timer_world->m_Dead, timer_index);
+        }
     }
 
     HTimerWorld NewTimerWorld()
     {
         TimerWorld* timer_world = new TimerWorld();
         timer_world->m_Timers.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_IndexLookup.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_IndexLookup.SetSize(INITIAL_TIMER_CAPACITY);
-        memset(&timer_world->m_IndexLookup[0], 0u, INITIAL_TIMER_CAPACITY * sizeof(uint16_t));
+        timer_world->m_Timers.SetSize(INITIAL_TIMER_CAPACITY);
+        memset(&timer_world->m_Timers[0], 0u, INITIAL_TIMER_CAPACITY * sizeof(Timer));
         timer_world->m_IndexPool.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_Version = 0;
+        timer_world->m_Schedule.SetCapacity(INITIAL_TIMER_CAPACITY);
+        timer_world->m_OwnerTimers.SetCapacity(OWNER_TABLE_SIZE, INITIAL_TIMER_CAPACITY);
+        timer_world->m_Time = 0.0;
+        timer_world->m_Sequence = 0;
+        timer_world->m_AliveCount = 0;
         timer_world->m_InUpdate = 0;
         return timer_world;
     }
@@ -197,35 +369,40 @@ namespace dmScript
         assert(timer_world != 0x0);
         DM_PROFILE("Update");
 
-        timer_world->m_InUpdate = 1;
+        DM_PROPERTY_ADD_U32(rmtp_TimerCount, timer_world->m_AliveCount);
 
-        // We only scan timers for trigger if the timer *existed at entry to UpdateTimers*, any timers added
-        // in a trigger callback will always be added at the end of m_Timers and not triggered in this scope.
-        uint32_t size = timer_world->m_Timers.Size();
-        DM_PROPERTY_ADD_U32(rmtp_TimerCount, size);
+        timer_world->m_InUpdate = 1;
+        timer_world->m_Time += dt;
+        double time = timer_world->m_Time;
+
+        // We only trigger timers that are due *at entry to UpdateTimers*. Any timers added or rescheduled
+        // in a trigger callback are scheduled after this and not triggered in this scope.
+        dmArray<uint32_t>& triggered = timer_world->m_Triggered;
+        triggered.SetSize(0);
+        while (!timer_world->m_Schedule.Empty() && timer_world->m_Timers[timer_world->m_Schedule[0]].m_FireTime <= time)
+        {
+            PushGrow(triggered, PopScheduled(timer_world));
+        }
 
-        for (uint32_t i = 0; i < size; ++i)
+        uint32_t triggered_count = triggered.Size();
+        for (uint32_t i = 0; i < triggered_count; ++i)
         {
-            Timer* timer = &timer_world->m_Timers[i];
+            uint32_t timer_index = triggered[i];
+            Timer* timer = &timer_world->m_Timers[timer_index];
             if (timer->m_IsAlive == 0)
             {
                 continue;
             }
 
-            timer->m_Remaining -= dt;
-            if (timer->m_Remaining > 0.0f)
-            {
-                continue;
-            }
-
-            float elapsed_time = timer->m_Delay - timer->m_Remaining;
+            float remaining = (float)(timer->m_FireTime - time);
+            float elapsed_time = timer->m_Delay - remaining;
 
             TimerEventType eventType = timer->m_Repeat == 0 ? TIMER_EVENT_TRIGGER_WILL_DIE : TIMER_EVENT_TRIGGER_WILL_REPEAT;
 
             timer->m_Callback(timer_world, eventType, timer->m_Handle, elapsed_time, timer->m_Owner, timer->m_UserData);
 
             // The array might have been reallocated here! So grab the pointer again...
-            timer = &timer_world->m_Timers[i];
+            timer = &timer_world->m_Timers[timer_index];
 
             if (timer->m_IsAlive == 0)
             {
@@ -234,46 +411,32 @@ namespace dmScript
 
             if (timer->m_Repeat == 0)
             {
-                timer->m_IsAlive = 0;
+                KillTimer(timer_world, timer_index);
                 continue;
             }
 
             if (timer->m_Delay == 0.0f)
             {
-                timer->m_Remaining = 0.0f;
+                Schedule(timer_world, timer_index, time);
                 continue;
             }
 
-            float wrapped_count = ((-timer->m_Remaining) / timer->m_Delay) + 1.f;
+            float wrapped_count = ((-remaining) / timer->m_Delay) + 1.f;
             float offset_to_next_trigger  = floor(wrapped_count) * timer->m_Delay;
-            timer->m_Remaining += offset_to_next_trigger;
-            if (timer->m_Remaining < 0) // If the delay is very small, the floating point precision might produce issues
-                timer->m_Remaining = timer->m_Delay; // reset the timer
+            remaining += offset_to_next_trigger;
+            if (remaining < 0) // If the delay is very small, the floating point precision might produce issues
+                remaining = timer->m_Delay; // reset the timer
+            Schedule(timer_world, timer_index, time + remaining);
         }
 
         timer_world->m_InUpdate = 0;
 
-        size = timer_world->m_Timers.Size();
-        uint32_t original_size = size;
-        uint32_t i = 0;
-        while (i < size)
+        uint32_t dead_count = timer_world->m_Dead.Size();
+        for (uint32_t i = 0; i < dead_count; ++i)
         {
-            Timer& timer = timer_world->m_Timers[i];
-            if (timer.m_IsAlive == 0)
-            {
-                FreeTimer(timer_world, timer);
-                --size;
-            }
-            else
-            {
-                ++i;
-            }
-        }
-
-        if (size != original_size)
-        {
-            ++timer_world->m_Version;
+            FreeTimer(timer_world, timer_world->m_Dead[i]);
         }
+        timer_world->m_Dead.SetSize(0);
     }
 
     HTimer AddTimer(HTimerWorld timer_world,
@@ -286,55 +449,41 @@ namespace dmScript
         assert(timer_world != 0x0);
         assert(delay >= 0.f);
         assert(timer_callback != 0x0);
-        Timer* timer = AllocateTimer(timer_world, owner);
-        if (timer == 0x0)
+        uint32_t timer_index = AllocateTimer(timer_world, owner);
+        if (timer_index == INVALID_TIMER_INDEX)
         {
             return INVALID_TIMER_HANDLE;
         }
 
-        timer->m_Delay = delay;
-        timer->m_Remaining = delay;
-        timer->m_UserData = userdata;
-        timer->m_Callback = timer_callback;
-        timer->m_Repeat = repeat;
-        timer->m_IsAlive = 1;
+        Timer& timer = timer_world->m_Timers[timer_index];
+        timer.m_Delay = delay;
+        timer.m_UserData = userdata;
+        timer.m_Callback = timer_callback;
+        timer.m_Repeat = repeat;
+        timer.m_IsAlive = 1;
+        ++timer_world->m_AliveCount;
 
-        return timer->m_Handle;
+        Schedule(timer_world, timer_index, timer_world->m_Time + delay);
+
+        return timer.m_Handle;
     }
 
     bool CancelTimer(HTimerWorld timer_world, HTimer handle)
     {
         assert(timer_world != 0x0);
-        uint16_t lookup_index = GetLookupIndex(handle);
-        if (lookup_index >= timer_world->m_IndexLookup.Size())
-        {
-            return false;
-        }
-
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        if (timer_index >= timer_world->m_Timers.Size())
-        {
-            return false;
-        }
-
-        Timer& timer = timer_world->m_Timers[timer_index];
-        if (timer.m_Handle != handle)
-        {
-            return false;
-        }
-
-        if (timer.m_IsAlive == 0)
+        Timer* timer = GetTimer(timer_world, handle);
+        if (timer == 0x0)
         {
             return false;
         }
 
-        timer.m_IsAlive = 0;
-        timer.m_Callback(timer_world, TIMER_EVENT_CANCELLED, timer.m_Handle, 0.f, timer.m_Owner, timer.m_UserData);
+        uint32_t timer_index = GetTimerIndex(handle);
+        KillTimer(timer_world, timer_index);
+        timer->m_Callback(timer_world, TIMER_EVENT_CANCELLED, timer->m_Handle, 0.f, timer->m_Owner, timer->m_UserData);
 
         if (timer_world->m_InUpdate == 0)
         {
-            FreeTimer(timer_world, timer);
-            ++timer_world->m_Version;
+            FreeTimer(timer_world, timer_index);
         }
         return true;
     }
@@ -343,38 +492,25 @@ namespace dmScript
     {
         assert(timer_world != 0x0);
 
-        uint32_t size = timer_world->m_Timers.Size();
+        uint32_t* first = timer_world->m_OwnerTimers.Get(owner);
+        uint32_t timer_index = first ? *first : INVALID_TIMER_INDEX;
         uint32_t cancelled_count = 0;
-        uint32_t timer_index = 0;
-        while (timer_index < size)
+        while (timer_index != INVALID_TIMER_INDEX)
         {
-            Timer& timer = timer_world->m_Timers[timer_index];
-            if (timer.m_Owner != owner)
-            {
-                ++timer_index;
-                continue;
-            }
+            uint32_t next_timer_index = timer_world->m_Timers[timer_index].m_NextOwned;
 
-            if (timer.m_IsAlive == 1)
+            if (timer_world->m_Timers[timer_index].m_IsAlive == 1)
             {
-                timer.m_IsAlive = 0;
+                KillTimer(timer_world, timer_index);
                 ++cancelled_count;
             }
 
             if (timer_world->m_InUpdate == 0)
             {
-                FreeTimer(timer_world, timer);
-                --size;
-            }
-            else
-            {
-                ++timer_index;
+                FreeTimer(timer_world, timer_index);
             }
-        }
 
-        if (cancelled_count > 0)
-        {
-            ++timer_world->m_Version;
+            timer_index = next_timer_index;
         }
 
         return cancelled_count;
@@ -383,20 +519,7 @@ namespace dmScript
     uint32_t GetAliveTimers(HTimerWorld timer_world)
     {
         assert(timer_world != 0x0);
-
-        uint32_t alive_timers = 0u;
-        uint32_t size = timer_world->m_Timers.Size();
-        uint32_t i = 0;
-        while (i < size)
-        {
-            Timer& timer = timer_world->m_Timers[i];
-            if(timer.m_IsAlive == 1)
-            {
-                ++alive_timers;
-            }
-            ++i;
-        }
-        return alive_timers;
+        return timer_world->m_AliveCount;
     }
 
     static void SetTimerWorld(HScriptWorld script_world, HTimerWorld timer_world)
@@ -646,30 +769,21 @@ namespace dmScript
             return 1;
         }
 
-        uint16_t lookup_index = GetLookupIndex(timer_handle);
-        if (lookup_index >= timer_world->m_IndexLookup.Size())
-        {
-            lua_pushboolean(L, 0);
-            return 1;
-        }
-
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        if (timer_index >= timer_world->m_Timers.Size())
+        Timer* timer = GetTimer(timer_world, (dmScript::HTimer)timer_handle);
+        if (timer == 0x0)
         {
             lua_pushboolean(L, 0);
             return 1;
         }
 
-        Timer& timer = timer_world->m_Timers[timer_index];
-
-        LuaCallbackInfo* callback = (LuaCallbackInfo*)timer.m_UserData;
+        LuaCallbackInfo* callback = (LuaCallbackInfo*)timer->m_UserData;
         if (!IsCallbackValid(callback))
         {
             lua_pushboolean(L, 0);
             return 1;
         }
 
-        LuaTimerCallbackArgs args = { timer.m_Handle, timer.m_Delay - timer.m_Remaining };
+        LuaTimerCallbackArgs args = { timer->m_Handle, timer->m_Delay - (float)(timer->m_FireTime - timer_world->m_Time) };
         InvokeCallback(callback, LuaTimerCallbackArgsCB, &args);
 
         lua_pushboolean(L, 1);
@@ -22,6 +22,7 @@
 
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
+#include <dlib/profile.h>
 
 extern "C"
 {
@@ -29,6 +30,9 @@ extern "C"
 #include <lua/lualib.h>
 }
 
+DM_PROPERTY_EXTERN(rmtp_Script);
+DM_PROPERTY_U32(rmtp_VmathAllocations, 0, FrameReset, "# vmath values allocated", &rmtp_Script);
+
 namespace dmScript
 {
     using namespace dmVMath;
@@ -43,6 +47,8 @@ namespace dmScript
      * - The matrix type (`vmath.matrix4`) can be multiplied with numbers, other matrices
      *   and `vmath.vector4` values.
      * - All types performs equality comparison by each component value.
+     * - The functions ending in `_to` (e.g. [ref:vmath.add_to]) store their result in an existing
+     *   value instead of creating a new one, which avoids garbage in performance critical code.
      *
      * The following components are available for the various types:
      *
@@ -2300,6 +2306,276 @@ namespace dmScript
         return 1;
     }
 
+    /*# adds two vectors into an existing vector
+     *
+     * Adds two vectors and stores the result in `out`, instead of creating a new vector.
+     * This avoids the garbage created by `v1 + v2` in performance critical code.
+     * `out` may be one of the arguments.
+     *
+     * @name vmath.add_to
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] first vector
+     * @param v2 [type:vector3|vector4] second vector
+     * @return out [type:vector3|vector4] the `out` vector
+     * @examples
+     *
+     * ```lua
+     * function init(self)
+     *     self.pos = vmath.vector3()
+     *     self.velocity = vmath.vector3(10, 0, 0)
+     *     self.step = vmath.vector3()
+     * end
+     *
+     * function update(self, dt)
+     *     vmath.mul_to(self.step, self.velocity, dt)
+     *     vmath.add_to(self.pos, self.pos, self.step)
+     * end
+     * ```
+     */
+    static int AddTo(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+            *out = *CheckVector3(L, 2) + *CheckVector3(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR4], 0);
+            *out = *CheckVector4(L, 2) + *CheckVector4(L, 3);
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s) as first argument.", SCRIPT_LIB_NAME, "add_to", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# subtracts two vectors into an existing vector
+     *
+     * Subtracts `v2` from `v1` and stores the result in `out`, instead of creating a new vector.
+     * `out` may be one of the arguments.
+     *
+     * @name vmath.sub_to
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] vector to subtract from
+     * @param v2 [type:vector3|vector4] vector to subtract
+     * @return out [type:vector3|vector4] the `out` vector
+     * @examples
+     *
+     * ```lua
+     * local dir = vmath.vector3()
+     * vmath.sub_to(dir, target_pos, pos)
+     * ```
+     */
+    static int SubTo(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+            *out = *CheckVector3(L, 2) - *CheckVector3(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR4], 0);
+            *out = *CheckVector4(L, 2) - *CheckVector4(L, 3);
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s) as first argument.", SCRIPT_LIB_NAME, "sub_to", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# multiplies into an existing vector or quaternion
+     *
+     * Scales a vector by a number, or multiplies two quaternions, and stores the
+     * result in `out`, instead of creating a new value. `out` may be one of the arguments.
+     *
+     * @name vmath.mul_to
+     * @param out [type:vector3|vector4|quaternion] value to store the result in
+     * @param v1 [type:vector3|vector4|quaternion] vector to scale, or first quaternion
+     * @param v2 [type:number|quaternion] scale, or second quaternion
+     * @return out [type:vector3|vector4|quaternion] the `out` value
+     * @examples
+     *
+     * ```lua
+     * vmath.mul_to(self.step, self.velocity, dt)
+     * vmath.mul_to(self.rotation, self.rotation, self.spin)
+     * ```
+     */
+    static int MulTo(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+            *out = *CheckVector3(L, 2) * (float) luaL_checknumber(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR4], 0);
+            *out = *CheckVector4(L, 2) * (float) luaL_checknumber(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_QUAT)
+        {
+            Quat* out = (Quat*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_QUAT], 0);
+            *out = *CheckQuat(L, 2) * *CheckQuat(L, 3);
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s|%s) as first argument.", SCRIPT_LIB_NAME, "mul_to", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4, SCRIPT_TYPE_NAME_QUAT);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# normalizes a vector into an existing vector
+     *
+     * Normalizes `v1` and stores the result in `out`, instead of creating a new value.
+     * `out` may be the same as `v1`.
+     *
+     * [icon:attention] The length of the vector must be above 0, otherwise a
+     * division-by-zero will occur.
+     *
+     * @name vmath.normalize_to
+     * @param out [type:vector3|vector4|quaternion] value to store the result in
+     * @param v1 [type:vector3|vector4|quaternion] vector to normalize
+     * @return out [type:vector3|vector4|quaternion] the `out` value
+     * @examples
+     *
+     * ```lua
+     * vmath.normalize_to(self.dir, self.dir)
+     * ```
+     */
+    static int NormalizeTo(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+            *out = Vectormath::Aos::normalize(*CheckVector3(L, 2));
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR4], 0);
+            *out = Vectormath::Aos::normalize(*CheckVector4(L, 2));
+        }
+        else if (type == SCRIPT_TYPE_QUAT)
+        {
+            Quat* out = (Quat*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_QUAT], 0);
+            *out = Vectormath::Aos::normalize(*CheckQuat(L, 2));
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s|%s) as first argument.", SCRIPT_LIB_NAME, "normalize_to", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4, SCRIPT_TYPE_NAME_QUAT);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# lerps between two vectors into an existing vector
+     *
+     * Linearly interpolates between two values, like [ref:vmath.lerp], and stores the
+     * result in `out`, instead of creating a new value. `out` may be one of the arguments.
+     *
+     * [icon:attention] The function does not clamp t between 0 and 1.
+     *
+     * @name vmath.lerp_to
+     * @param out [type:vector3|vector4|quaternion] value to store the result in
+     * @param t [type:number] interpolation parameter, 0-1
+     * @param v1 [type:vector3|vector4|quaternion] value to lerp from
+     * @param v2 [type:vector3|vector4|quaternion] value to lerp to
+     * @return out [type:vector3|vector4|quaternion] the `out` value
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     self.t = math.min(self.t + dt, 1)
+     *     vmath.lerp_to(self.pos, self.t, self.startpos, self.endpos)
+     *     go.set_position(self.pos)
+     * end
+     * ```
+     */
+    static int LerpTo(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        float t = (float) luaL_checknumber(L, 2);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+            *out = Vectormath::Aos::lerp(t, *CheckVector3(L, 3), *CheckVector3(L, 4));
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR4], 0);
+            *out = Vectormath::Aos::lerp(t, *CheckVector4(L, 3), *CheckVector4(L, 4));
+        }
+        else if (type == SCRIPT_TYPE_QUAT)
+        {
+            Quat* out = (Quat*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_QUAT], 0);
+            *out = Vectormath::Aos::lerp(t, *CheckQuat(L, 3), *CheckQuat(L, 4));
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s|%s) as first argument.", SCRIPT_LIB_NAME, "lerp_to", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4, SCRIPT_TYPE_NAME_QUAT);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# calculates the cross-product of two vectors into an existing vector
+     *
+     * Calculates the cross product, like [ref:vmath.cross], and stores the result in `out`,
+     * instead of creating a new vector. `out` may be one of the arguments.
+     *
+     * @name vmath.cross_to
+     * @param out [type:vector3] vector to store the result in
+     * @param v1 [type:vector3] first vector
+     * @param v2 [type:vector3] second vector
+     * @return out [type:vector3] the `out` vector
+     * @examples
+     *
+     * ```lua
+     * vmath.cross_to(self.normal, edge1, edge2)
+     * ```
+     */
+    static int CrossTo(lua_State* L)
+    {
+        Vector3* out = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+        *out = Vectormath::Aos::cross(*CheckVector3(L, 2), *CheckVector3(L, 3));
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# rotates a vector by a quaternion into an existing vector
+     *
+     * Rotates a vector, like [ref:vmath.rotate], and stores the result in `out`,
+     * instead of creating a new vector. `out` may be the same as `v1`.
+     *
+     * @name vmath.rotate_to
+     * @param out [type:vector3] vector to store the result in
+     * @param q [type:quaternion] quaternion
+     * @param v1 [type:vector3] vector to rotate
+     * @return out [type:vector3] the `out` vector
+     * @examples
+     *
+     * ```lua
+     * vmath.rotate_to(self.forward, go.get_rotation(), FORWARD)
+     * ```
+     */
+    static int RotateTo(lua_State* L)
+    {
+        Vector3* out = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+        *out = Vectormath::Aos::rotate(*CheckQuat(L, 2), *CheckVector3(L, 3));
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
     static const luaL_reg methods[] =
     {
         {SCRIPT_TYPE_NAME_VECTOR, Vector_new},
@@ -2336,6 +2612,13 @@ namespace dmScript
         {"inv", Inverse},
         {"ortho_inv", OrthoInverse},
         {"mul_per_elem", MulPerElem},
+        {"add_to", AddTo},
+        {"sub_to", SubTo},
+        {"mul_to", MulTo},
+        {"normalize_to", NormalizeTo},
+        {"lerp_to", LerpTo},
+        {"cross_to", CrossTo},
+        {"rotate_to", RotateTo},
         {0, 0}
     };
 
@@ -2383,6 +2666,7 @@ namespace dmScript
 
     void PushVector3(lua_State* L, const Vector3& v)
     {
+        DM_PROPERTY_ADD_U32(rmtp_VmathAllocations, 1);
         Vector3* vp = (Vector3*)lua_newuserdata(L, sizeof(Vector3));
         *vp = v;
         luaL_getmetatable(L, SCRIPT_TYPE_NAME_VECTOR3);
@@ -2401,6 +2685,7 @@ namespace dmScript
 
     void PushVector4(lua_State* L, const Vector4& v)
     {
+        DM_PROPERTY_ADD_U32(rmtp_VmathAllocations, 1);
         Vector4* vp = (Vector4*)lua_newuserdata(L, sizeof(Vector4));
         *vp = v;
         luaL_getmetatable(L, SCRIPT_TYPE_NAME_VECTOR4);
@@ -2419,6 +2704,7 @@ namespace dmScript
 
     void PushQuat(lua_State* L, const Quat& q)
     {
+        DM_PROPERTY_ADD_U32(rmtp_VmathAllocations, 1);
         Quat* qp = (Quat*)lua_newuserdata(L, sizeof(Quat));
         *qp = q;
         luaL_getmetatable(L, SCRIPT_TYPE_NAME_QUAT);
@@ -2437,6 +2723,7 @@ namespace dmScript
 
     void PushMatrix4(lua_State* L, const Matrix4& m)
     {
+        DM_PROPERTY_ADD_U32(rmtp_VmathAllocations, 1);
         Matrix4* mp = (Matrix4*)lua_newuserdata(L, sizeof(Matrix4));
         *mp = m;
         luaL_getmetatable(L, SCRIPT_TYPE_NAME_MATRIX4);
@@ -114,3 +114,14 @@ assert(("foo " .. tostring(q)) == "foo vmath.quat(1, 2, 3, 4)")
 assert(("foo " .. q) == "foo vmath.quat(1, 2, 3, 4)")
 q = vmath.quat(-10.01, -10.01, -10.01, -10.01)
 assert(tostring(q) == ("" .. q))
+
+-- in place operations
+local out = vmath.quat()
+local q1 = vmath.quat_rotation_z(0.5)
+local q2 = vmath.quat_rotation_z(0.25)
+assert(vmath.mul_to(out, q1, q2) == out, "mul_to returns out")
+assert(out == q1 * q2, "mul_to")
+vmath.lerp_to(out, 0.5, q1, q2)
+assert(out == vmath.lerp(0.5, q1, q2), "lerp_to")
+vmath.normalize_to(out, vmath.quat(1, 2, 3, 4))
+assert(out == vmath.normalize(vmath.quat(1, 2, 3, 4)), "normalize_to")
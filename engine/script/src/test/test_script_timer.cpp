@@ -254,6 +254,45 @@ TEST_F(ScriptTimerTest, TestTimerTriggerCountLimit)
     dmScript::DeleteTimerWorld(timer_world);
 }
 
+TEST_F(ScriptTimerTest, TestManyTimers)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    // More than fits in a 16 bit index
+    const uint32_t timer_count = 100000u;
+    for (uint32_t i = 0; i < timer_count; ++i)
+    {
+        dmScript::HTimer handle = dmScript::AddTimer(timer_world, 1.0f + (i % 100), false, TestCallback, 1u + i / (timer_count / 4), 0x0);
+        ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, handle);
+    }
+    ASSERT_EQ(timer_count, GetAliveTimers(timer_world));
+
+    // Only the timers that are due are triggered
+    dmScript::UpdateTimers(timer_world, 1.f);
+    ASSERT_EQ(timer_count / 100, TimerTestCallback::callback_count);
+    dmScript::UpdateTimers(timer_world, 1.f);
+    ASSERT_EQ(2 * timer_count / 100, TimerTestCallback::callback_count);
+
+    uint32_t alive = GetAliveTimers(timer_world);
+    ASSERT_EQ(timer_count - 2 * timer_count / 100, alive);
+
+    uint32_t killed = dmScript::KillTimers(timer_world, 1u);
+    ASSERT_EQ(alive / 4, killed);
+    ASSERT_EQ(alive - killed, GetAliveTimers(timer_world));
+
+    dmScript::UpdateTimers(timer_world, 1.f);
+    ASSERT_EQ(2 * timer_count / 100 + 3 * timer_count / 400, TimerTestCallback::callback_count);
+
+    for (uint32_t i = 2; i <= 4; ++i)
+    {
+        dmScript::KillTimers(timer_world, i);
+    }
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+    ASSERT_EQ(0u, TimerTestCallback::cancel_count);
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
 TEST_F(ScriptTimerTest, TestOneshotTimerCallback)
 {
     dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
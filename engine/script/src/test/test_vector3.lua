@@ -130,3 +130,20 @@ assert(("foo " .. tostring(v)) == "foo vmath.vector3(1, 2, 3)")
 assert(("foo " .. v) == "foo vmath.vector3(1, 2, 3)")
 v = vmath.vector3(-10.01, -10.01, -10.01)
 assert(tostring(v) == ("" .. v))
+
+-- in place operations
+local out = vmath.vector3()
+assert(vmath.add_to(out, vmath.vector3(1, 2, 3), vmath.vector3(4, 5, 6)) == out, "add_to returns out")
+assert(out.x == 5 and out.y == 7 and out.z == 9, "add_to")
+vmath.sub_to(out, out, vmath.vector3(1, 2, 3))
+assert(out.x == 4 and out.y == 5 and out.z == 6, "sub_to")
+vmath.mul_to(out, out, 2)
+assert(out.x == 8 and out.y == 10 and out.z == 12, "mul_to")
+vmath.lerp_to(out, 0.5, vmath.vector3(1, 0, 0), vmath.vector3(0, -1, 0))
+assert(out.x == 0.5 and out.y == -0.5 and out.z == 0, "lerp_to")
+vmath.cross_to(out, vmath.vector3(1, 0, 0), vmath.vector3(0, 1, 0))
+assert(out.x == 0 and out.y == 0 and out.z == 1, "cross_to")
+vmath.normalize_to(out, vmath.vector3(1.2, 1.6, 0))
+assert(math.abs(out.x - 0.6) < 0.000001 and math.abs(out.y - 0.8) < 0.000001, "normalize_to")
+vmath.rotate_to(out, vmath.quat_rotation_z(math.pi * 0.5), vmath.vector3(1, 0, 0))
+assert(math.abs(out.x) < 0.000001 and math.abs(out.y - 1) < 0.000001, "rotate_to")
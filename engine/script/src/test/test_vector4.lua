@@ -140,3 +140,16 @@ assert(("foo " .. tostring(v)) == "foo vmath.vector4(1, 2, 3, 4)")
 assert(("foo " .. v) == "foo vmath.vector4(1, 2, 3, 4)")
 v = vmath.vector4(-10.01, -10.01, -10.01, -10.01)
 assert(tostring(v) == ("" .. v))
+
+-- in place operations
+local out = vmath.vector4()
+assert(vmath.add_to(out, vmath.vector4(1, 2, 3, 4), vmath.vector4(4, 5, 6, 7)) == out, "add_to returns out")
+assert(out.x == 5 and out.y == 7 and out.z == 9 and out.w == 11, "add_to")
+vmath.sub_to(out, out, vmath.vector4(1, 2, 3, 4))
+assert(out.x == 4 and out.y == 5 and out.z == 6 and out.w == 7, "sub_to")
+vmath.mul_to(out, out, 2)
+assert(out.x == 8 and out.y == 10 and out.z == 12 and out.w == 14, "mul_to")
+vmath.lerp_to(out, 0.5, vmath.vector4(1, 0, 0, 0), vmath.vector4(0, -1, 0, 1))
+assert(out.x == 0.5 and out.y == -0.5 and out.z == 0 and out.w == 0.5, "lerp_to")
+vmath.normalize_to(out, vmath.vector4(1.2, 1.6, 0, 0))
+assert(math.abs(out.x - 0.6) < 0.000001 and math.abs(out.y - 0.8) < 0.000001, "normalize_to")
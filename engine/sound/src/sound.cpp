@@ -14,6 +14,7 @@
 
 #include <stdint.h>
 #include <dlib/array.h>
+#include <dlib/condition_variable.h>
 #include <dlib/hashtable.h>
 #include <dlib/index_pool.h>
 #include <dlib/log.h>
@@ -27,11 +28,17 @@
 
 #include "sound.h"
 #include "sound_codec.h"
+#include "sound_mixer.h"
 #include "sound_private.h"
 
 #include <math.h>
 #include <cfloat>
 
+DM_PROPERTY_GROUP(rmtp_Sound, "Sound");
+DM_PROPERTY_U32(rmtp_SoundDecodeTime, 0, FrameReset, "time spent decoding (us)", &rmtp_Sound);
+DM_PROPERTY_U32(rmtp_SoundVoiceDecodeTimeMax, 0, FrameReset, "max time spent decoding a single voice (us)", &rmtp_Sound);
+DM_PROPERTY_U32(rmtp_SoundDecodeUnderruns, 0, FrameReset, "# voices decoded by the mixer, since the decode jobs weren't done", &rmtp_Sound);
+
 /**
  * Defold simple sound system
  * NOTE: Must units is in frames, i.e a sample in time with N channels
@@ -44,6 +51,8 @@ namespace dmSound
     #define SOUND_MAX_MIX_CHANNELS (2)
     #define SOUND_OUTBUFFER_COUNT (6)
     #define SOUND_MAX_SPEED (5)
+    // Number of frames the mixers resample at a time, before gain and pan is applied
+    #define SOUND_MIX_CHUNK_FRAMES (256)
 
     // TODO: How many bits?
     const uint32_t RESAMPLE_FRACTION_BITS = 31;
@@ -52,6 +61,9 @@ namespace dmSound
     const uint32_t GROUP_MEMORY_BUFFER_COUNT = 64;
 
     static void SoundThread(void* ctx);
+    static void DecodeJob(void* ctx, uint32_t index);
+    static void ResetDecodeAhead(struct SoundSystem* sound, struct SoundInstance* instance);
+    static void CancelDecodeAhead(struct SoundSystem* sound, struct SoundInstance* instance);
 
     /**
      * Value with memory for "ramping" of values. See also struct Ramp below.
@@ -104,28 +116,6 @@ namespace dmSound
         float m_Next;
     };
 
-    /**
-     * Helper for calculating ramps
-     */
-    struct Ramp
-    {
-        float m_From, m_To, m_TotalSamplesRecip;
-
-        Ramp(const Value* value, uint32_t buffer, uint32_t total_buffers, uint32_t total_samples)
-        {
-            float ramp_length = (value->m_Current - value->m_Prev) / total_buffers;
-            m_From = value->m_Prev + ramp_length * buffer;
-            m_To = m_From + ramp_length;
-            m_TotalSamplesRecip = 1.0f / total_samples;
-        }
-
-        inline float GetValue(int i) const
-        {
-            float mix = i * m_TotalSamplesRecip;
-            return m_From + mix * (m_To - m_From);
-        }
-    };
-
     /**
      * Context with data for mixing N buffers, i.e. during update
      */
@@ -142,9 +132,16 @@ namespace dmSound
         uint32_t m_TotalBuffers;
     };
 
+    /**
+     * Ramp of a value over the current buffer, see Ramp in sound_mixer.h
+     */
     Ramp GetRamp(const MixContext* mix_context, const Value* value, uint32_t total_samples)
     {
-        Ramp ramp(value, mix_context->m_CurrentBuffer, mix_context->m_TotalBuffers, total_samples);
+        Ramp ramp;
+        float ramp_length = (value->m_Current - value->m_Prev) / mix_context->m_TotalBuffers;
+        ramp.m_From = value->m_Prev + ramp_length * mix_context->m_CurrentBuffer;
+        ramp.m_To = ramp.m_From + ramp_length;
+        ramp.m_TotalSamplesRecip = 1.0f / total_samples;
         return ramp;
     }
 
@@ -177,6 +174,17 @@ namespace dmSound
         uint8_t     m_Playing : 1;
         uint8_t     : 5;
         int8_t      m_Loopcounter; // if set to 3, there will be 3 loops effectively playing the sound 4 times.
+
+        // Ring buffer of frames decoded ahead of the mixer by the decode jobs. Protected by SoundSystem::m_DecodeMutex.
+        char*       m_DecodeBuffer;
+        uint32_t    m_DecodeRead;       // Offset of the first decoded byte
+        uint32_t    m_DecodeCount;      // Number of decoded bytes
+        uint32_t    m_DecodeTime;       // Time spent decoding since it was last reported (us)
+        dmSoundCodec::Result m_DecodeResult;
+        uint8_t     m_DecodeQueued : 1; // In SoundSystem::m_DecodeQueue
+        uint8_t     m_DecodeBusy : 1;   // Being decoded by a decode job
+        uint8_t     m_DecodeEnd : 1;    // The decoder has reached the end of the stream
+        uint8_t     : 5;
     };
 
     struct SoundGroup
@@ -214,6 +222,16 @@ namespace dmSound
         int16_t*                m_OutBuffers[SOUND_OUTBUFFER_COUNT];
         uint16_t                m_NextOutBuffer;
 
+        // Jobs decoding the playing instances ahead of the mixer, see DecodeJob
+        dmJobPool::HJobPool     m_JobPool;
+        uint32_t                m_DecodeThreadCount;    // Max number of decode jobs
+        uint32_t                m_DecodeJobCount;       // Number of posted decode jobs that haven't finished
+        uint32_t                m_DecodeBufferSize;     // Size of SoundInstance::m_DecodeBuffer
+        dmMutex::HMutex         m_DecodeMutex;
+        dmConditionVariable::HConditionVariable m_DecodeDoneCond;
+        dmArray<uint16_t>       m_DecodeQueue;          // Instance indices, decoded in the order they were queued
+        uint32_t                m_DecodeTimeMax;
+
         bool                    m_IsDeviceStarted;
         bool                    m_IsAudioInterrupted;
         bool                    m_HasWindowFocus;
@@ -252,6 +270,8 @@ namespace dmSound
         params->m_FrameCount = 768;
         params->m_MaxInstances = 256;
         params->m_UseThread = true;
+        params->m_DecodeThreadCount = 0;
+        params->m_DecodeLookahead = 4;
     }
 
     Result RegisterDevice(struct DeviceType* device)
@@ -341,6 +361,8 @@ namespace dmSound
         uint32_t max_buffers = params->m_MaxBuffers;
         uint32_t max_sources = params->m_MaxSources;
         uint32_t max_instances = params->m_MaxInstances;
+        uint32_t decode_thread_count = params->m_DecodeThreadCount;
+        uint32_t decode_lookahead = params->m_DecodeLookahead;
 
         if (config)
         {
@@ -349,8 +371,17 @@ namespace dmSound
             max_buffers = (uint32_t) dmConfigFile::GetInt(config, "sound.max_sound_buffers", (int32_t) max_buffers);
             max_sources = (uint32_t) dmConfigFile::GetInt(config, "sound.max_sound_sources", (int32_t) max_sources);
             max_instances = (uint32_t) dmConfigFile::GetInt(config, "sound.max_sound_instances", (int32_t) max_instances);
+            decode_thread_count = (uint32_t) dmConfigFile::GetInt(config, "sound.decode_thread_count", (int32_t) decode_thread_count);
+            decode_lookahead = (uint32_t) dmConfigFile::GetInt(config, "sound.decode_lookahead", (int32_t) decode_lookahead);
         }
 
+        // More jobs than threads in the pool wouldn't run at the same time
+        decode_thread_count = dmMath::Min(decode_thread_count, dmJobPool::GetThreadCount(params->m_JobPool));
+        decode_lookahead = dmMath::Max(1U, decode_lookahead);
+        // Room for the look-ahead number of mix buffers, at normal speed and the largest frame size
+        sound->m_DecodeThreadCount = decode_thread_count;
+        sound->m_DecodeBufferSize = decode_thread_count > 0 ? decode_lookahead * params->m_FrameCount * sizeof(int16_t) * SOUND_MAX_MIX_CHANNELS : 0;
+
         sound->m_Instances.SetCapacity(max_instances);
         sound->m_Instances.SetSize(max_instances);
         sound->m_InstancesPool.SetCapacity(max_instances);
@@ -365,6 +396,7 @@ namespace dmSound
             instance->m_Frames = malloc((params->m_FrameCount * SOUND_MAX_SPEED + 1) * sizeof(int16_t) * SOUND_MAX_MIX_CHANNELS);
             instance->m_FrameCount = 0;
             instance->m_Speed = 1.0f;
+            instance->m_DecodeBuffer = sound->m_DecodeBufferSize > 0 ? (char*) malloc(sound->m_DecodeBufferSize) : 0;
         }
 
         sound->m_SoundData.SetCapacity(max_sound_data);
@@ -395,6 +427,17 @@ namespace dmSound
         sound->m_IsPaused = false;
         sound->m_Status = RESULT_NOTHING_TO_PLAY;
 
+        sound->m_JobPool = params->m_JobPool;
+        sound->m_DecodeMutex = 0;
+        sound->m_DecodeJobCount = 0;
+        sound->m_DecodeTimeMax = 0;
+        if (decode_thread_count > 0)
+        {
+            sound->m_DecodeMutex = dmMutex::New();
+            sound->m_DecodeDoneCond = dmConditionVariable::New();
+            sound->m_DecodeQueue.SetCapacity(max_instances);
+        }
+
         sound->m_Thread = 0;
         sound->m_Mutex = 0;
         if (params->m_UseThread)
@@ -419,6 +462,25 @@ namespace dmSound
             dmMutex::Delete(sound->m_Mutex);
         }
 
+        if (sound->m_DecodeThreadCount > 0)
+        {
+            {
+                // Drop what hasn't been started, and wait for the running jobs
+                DM_MUTEX_SCOPED_LOCK(sound->m_DecodeMutex);
+                for (uint32_t i = 0; i < sound->m_DecodeQueue.Size(); ++i)
+                {
+                    sound->m_Instances[sound->m_DecodeQueue[i]].m_DecodeQueued = 0;
+                }
+                sound->m_DecodeQueue.SetSize(0);
+                while (sound->m_DecodeJobCount > 0)
+                {
+                    dmConditionVariable::Wait(sound->m_DecodeDoneCond, sound->m_DecodeMutex);
+                }
+            }
+            dmConditionVariable::Delete(sound->m_DecodeDoneCond);
+            dmMutex::Delete(sound->m_DecodeMutex);
+        }
+
         PlatformFinalize();
 
         Result result = RESULT_OK;
@@ -433,6 +495,7 @@ namespace dmSound
                 instance->m_Index = 0xffff;
                 instance->m_SoundDataIndex = 0xffff;
                 free(instance->m_Frames);
+                free(instance->m_DecodeBuffer);
                 memset(instance, 0, sizeof(*instance));
             }
 
@@ -577,6 +640,13 @@ namespace dmSound
         si->m_Playing = 0;
         si->m_Decoder = decoder;
         si->m_Group = MASTER_GROUP_HASH;
+        si->m_DecodeRead = 0;
+        si->m_DecodeCount = 0;
+        si->m_DecodeTime = 0;
+        si->m_DecodeResult = dmSoundCodec::RESULT_OK;
+        si->m_DecodeQueued = 0;
+        si->m_DecodeBusy = 0;
+        si->m_DecodeEnd = 0;
 
         *sound_instance = si;
 
@@ -600,6 +670,7 @@ namespace dmSound
         sound->m_InstancesPool.Push(index);
         sound_instance->m_Index = 0xffff;
         sound_instance->m_SoundDataIndex = 0xffff;
+        ResetDecodeAhead(sound, sound_instance);
         dmSoundCodec::DeleteDecoder(sound->m_CodecContext, sound_instance->m_Decoder);
         sound_instance->m_Decoder = 0;
         sound_instance->m_FrameCount = 0;
@@ -774,6 +845,7 @@ namespace dmSound
     {
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
         sound_instance->m_Playing = 0;
+        ResetDecodeAhead(sound, sound_instance);
         dmSoundCodec::Reset(sound->m_CodecContext, sound_instance->m_Decoder);
     }
 
@@ -809,7 +881,22 @@ namespace dmSound
 
     Result SetLooping(HSoundInstance sound_instance, bool looping, int8_t loopcounter)
     {
-        DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
+        SoundSystem* sound = g_SoundSystem;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(sound->m_Mutex);
+        if (sound->m_DecodeThreadCount > 0)
+        {
+            // The decode jobs read the loop state
+            DM_MUTEX_SCOPED_LOCK(sound->m_DecodeMutex);
+            CancelDecodeAhead(sound, sound_instance);
+            sound_instance->m_Looping = (uint32_t) looping;
+            sound_instance->m_Loopcounter = loopcounter;
+            if (looping)
+            {
+                // Let the decoder wrap around at the end of the stream
+                sound_instance->m_DecodeEnd = 0;
+            }
+            return RESULT_OK;
+        }
         sound_instance->m_Looping = (uint32_t) looping;
         sound_instance->m_Loopcounter = loopcounter;
         return RESULT_OK;
@@ -840,14 +927,6 @@ namespace dmSound
         return RESULT_OK;
     }
 
-    static inline void GetPanScale(float pan, float* left_scale, float* right_scale)
-    {
-        // Constant power panning: https://www.cs.cmu.edu/~music/icm-online/readings/panlaws/index.html
-        const float theta = pan * M_PI_2;
-        *left_scale = cosf(theta);
-        *right_scale = sinf(theta);
-    }
-
     /*
      *
      * Template parameters
@@ -876,29 +955,30 @@ namespace dmSound
 
         Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
         Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        float resampled[2 * SOUND_MIX_CHUNK_FRAMES];
+        for (uint32_t start = 0; start < mix_buffer_count; start += SOUND_MIX_CHUNK_FRAMES)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
-            float mix = frac * range_recip; // determines the bias between two consecutive samples in the sound instance. It ranges from 0-1. A mix of 0, makes only the first sample count while a mix of 0.5 will count equally both samples.
-            T s1 = frames[index];
-            T s2 = frames[index + 1];
-            s1 = (s1 - offset) * scale;
-            s2 = (s2 - offset) * scale;
-
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
+            uint32_t n = dmMath::Min((uint32_t)SOUND_MIX_CHUNK_FRAMES, mix_buffer_count - start);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                float mix = frac * range_recip; // determines the bias between two consecutive samples in the sound instance. It ranges from 0-1. A mix of 0, makes only the first sample count while a mix of 0.5 will count equally both samples.
+                T s1 = frames[index];
+                T s2 = frames[index + 1];
+                s1 = (s1 - offset) * scale;
+                s2 = (s2 - offset) * scale;
 
-            float s = (1.0f - mix) * s1 + mix * s2; // resulting destination sample value is a mix of two source samples since a kind of fractional indexing is used
-            mix_buffer[2 * i] += s * gain * left_scale;
-            mix_buffer[2 * i + 1] += s * gain * right_scale;
+                float s = (1.0f - mix) * s1 + mix * s2; // resulting destination sample value is a mix of two source samples since a kind of fractional indexing is used
+                resampled[2 * i] = s;
+                resampled[2 * i + 1] = s;
 
-            prev_index = index; // keep old index for assertion
-            frac += delta;
+                prev_index = index; // keep old index for assertion
+                frac += delta;
 
-            index += (uint32_t)(frac >> RESAMPLE_FRACTION_BITS);
+                index += (uint32_t)(frac >> RESAMPLE_FRACTION_BITS);
 
-            frac &= ((1U << RESAMPLE_FRACTION_BITS) - 1U); // Keep lower RESAMPLE_FRACTION_BITS bits. Clear higher.
+                frac &= ((1U << RESAMPLE_FRACTION_BITS) - 1U); // Keep lower RESAMPLE_FRACTION_BITS bits. Clear higher.
+            }
+            MixScaledFrames(mix_buffer, resampled, start, n, gain_ramp, pan_ramp);
         }
         instance->m_FrameFraction = frac;
 
@@ -931,34 +1011,33 @@ namespace dmSound
 
         Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
         Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        float resampled[2 * SOUND_MIX_CHUNK_FRAMES];
+        for (uint32_t start = 0; start < mix_buffer_count; start += SOUND_MIX_CHUNK_FRAMES)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
-            float mix = frac * range_recip;
-            T sl1 = frames[2 * index];
-            T sl2 = frames[2 * index + 2];
-            sl1 = (sl1 - offset) * scale;
-            sl2 = (sl2 - offset) * scale;
-
-            T sr1 = frames[2 * index + 1];
-            T sr2 = frames[2 * index + 3];
-            sr1 = (sr1 - offset) * scale;
-            sr2 = (sr2 - offset) * scale;
+            uint32_t n = dmMath::Min((uint32_t)SOUND_MIX_CHUNK_FRAMES, mix_buffer_count - start);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                float mix = frac * range_recip;
+                T sl1 = frames[2 * index];
+                T sl2 = frames[2 * index + 2];
+                sl1 = (sl1 - offset) * scale;
+                sl2 = (sl2 - offset) * scale;
 
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
+                T sr1 = frames[2 * index + 1];
+                T sr2 = frames[2 * index + 3];
+                sr1 = (sr1 - offset) * scale;
+                sr2 = (sr2 - offset) * scale;
 
-            float sl = (1.0f - mix) * sl1 + mix * sl2;
-            float sr = (1.0f - mix) * sr1 + mix * sr2;
-            mix_buffer[2 * i]       += sl * gain * left_scale;
-            mix_buffer[2 * i + 1]   += sr * gain * right_scale;
+                resampled[2 * i]        = (1.0f - mix) * sl1 + mix * sl2;
+                resampled[2 * i + 1]    = (1.0f - mix) * sr1 + mix * sr2;
 
-            prev_index = index;
-            frac += delta;
-            index += (uint32_t)(frac >> RESAMPLE_FRACTION_BITS);
+                prev_index = index;
+                frac += delta;
+                index += (uint32_t)(frac >> RESAMPLE_FRACTION_BITS);
 
-            frac &= ((1U << RESAMPLE_FRACTION_BITS) - 1U);
+                frac &= ((1U << RESAMPLE_FRACTION_BITS) - 1U);
+            }
+            MixScaledFrames(mix_buffer, resampled, start, n, gain_ramp, pan_ramp);
         }
         instance->m_FrameFraction = frac;
 
@@ -968,6 +1047,43 @@ namespace dmSound
         instance->m_FrameCount -= index;
     }
 
+    template <typename T, int offset, int scale>
+    static inline void ConvertMono(float* out, const T* frames, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            float s = frames[i];
+            s = (s - offset) * scale;
+            out[2 * i]      = s;
+            out[2 * i + 1]  = s;
+        }
+    }
+
+    // For 16 bit samples the offset and scale are no-ops, and the conversion is vectorized
+    template <>
+    inline void ConvertMono<int16_t, 0, 1>(float* out, const int16_t* frames, uint32_t count)
+    {
+        ConvertMonoS16(out, frames, count);
+    }
+
+    template <typename T, int offset, int scale>
+    static inline void ConvertStereo(float* out, const T* frames, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            float s1 = frames[2 * i];
+            float s2 = frames[2 * i + 1];
+            out[2 * i]      = (s1 - offset) * scale;
+            out[2 * i + 1]  = (s2 - offset) * scale;
+        }
+    }
+
+    template <>
+    inline void ConvertStereo<int16_t, 0, 1>(float* out, const int16_t* frames, uint32_t count)
+    {
+        ConvertStereoS16(out, frames, count);
+    }
+
     template <typename T, int offset, int scale>
     static void MixResampleIdentityMono(const MixContext* mix_context, SoundInstance* instance, uint32_t rate, uint32_t mix_rate, float* mix_buffer, uint32_t mix_buffer_count)
     {
@@ -978,17 +1094,12 @@ namespace dmSound
         Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
         Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
 
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        float converted[2 * SOUND_MIX_CHUNK_FRAMES];
+        for (uint32_t start = 0; start < mix_buffer_count; start += SOUND_MIX_CHUNK_FRAMES)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
-            float s = frames[i];
-            s = (s - offset) * scale * gain;
-
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
-            mix_buffer[2 * i]       += s * left_scale;
-            mix_buffer[2 * i + 1]   += s * right_scale;
+            uint32_t n = dmMath::Min((uint32_t)SOUND_MIX_CHUNK_FRAMES, mix_buffer_count - start);
+            ConvertMono<T, offset, scale>(converted, frames + start, n);
+            MixScaledFrames(mix_buffer, converted, start, n, gain_ramp, pan_ramp);
         }
         instance->m_FrameCount -= mix_buffer_count;
     }
@@ -1003,19 +1114,12 @@ namespace dmSound
         Ramp gain_ramp = GetRamp(mix_context, &instance->m_Gain, mix_buffer_count);
         Ramp pan_ramp = GetRamp(mix_context, &instance->m_Pan, mix_buffer_count);
 
-        for (uint32_t i = 0; i < mix_buffer_count; i++)
+        float converted[2 * SOUND_MIX_CHUNK_FRAMES];
+        for (uint32_t start = 0; start < mix_buffer_count; start += SOUND_MIX_CHUNK_FRAMES)
         {
-            float gain = gain_ramp.GetValue(i);
-            float pan = pan_ramp.GetValue(i);
-            float s1 = frames[2 * i];
-            float s2 = frames[2 * i + 1];
-            s1 = (s1 - offset) * scale * gain;
-            s2 = (s2 - offset) * scale * gain;
-
-            float left_scale, right_scale;
-            GetPanScale(pan, &left_scale, &right_scale);
-            mix_buffer[2 * i]       += s1 * left_scale;
-            mix_buffer[2 * i + 1]   += s2 * right_scale;
+            uint32_t n = dmMath::Min((uint32_t)SOUND_MIX_CHUNK_FRAMES, mix_buffer_count - start);
+            ConvertStereo<T, offset, scale>(converted, frames + 2 * start, n);
+            MixScaledFrames(mix_buffer, converted, start, n, gain_ramp, pan_ramp);
         }
         instance->m_FrameCount -= mix_buffer_count;
     }
@@ -1131,6 +1235,232 @@ namespace dmSound
         return false;
     }
 
+    /**
+     * Decodes (or skips, if muted) into the buffer. If the stream ends and the instance is looping,
+     * the stream is restarted and the rest of the buffer decoded.
+     */
+    static dmSoundCodec::Result DecodeFrames(SoundSystem* sound, SoundInstance* instance, char* buffer, uint32_t buffer_size, bool skip, uint32_t* decoded, bool* end_of_stream)
+    {
+        dmSoundCodec::Result r;
+        uint32_t n = 0;
+        if (!skip)
+        {
+            r = dmSoundCodec::Decode(sound->m_CodecContext, instance->m_Decoder, buffer, buffer_size, &n);
+        }
+        else
+        {
+            r = dmSoundCodec::Skip(sound->m_CodecContext, instance->m_Decoder, buffer_size, &n);
+            memset(buffer, 0x00, buffer_size);
+        }
+
+        *end_of_stream = false;
+        if (n < buffer_size)
+        {
+            if (instance->m_Looping && instance->m_Loopcounter != 0) {
+                dmSoundCodec::Reset(sound->m_CodecContext, instance->m_Decoder);
+                if ( instance->m_Loopcounter > 0 ) {
+                    instance->m_Loopcounter --;
+                }
+
+                uint32_t looped = 0;
+                if (!skip)
+                {
+                    r = dmSoundCodec::Decode(sound->m_CodecContext, instance->m_Decoder, buffer + n, buffer_size - n, &looped);
+                }
+                else
+                {
+                    r = dmSoundCodec::Skip(sound->m_CodecContext, instance->m_Decoder, buffer_size - n, &looped);
+                }
+                n += looped;
+            } else {
+                *end_of_stream = true;
+            }
+        }
+
+        *decoded = n;
+        return r;
+    }
+
+    // Decodes into the free part of the decode ring buffer. Called without the decode mutex held,
+    // by the decode job that took the instance from the queue.
+    static dmSoundCodec::Result DecodeAhead(SoundSystem* sound, SoundInstance* instance, uint32_t offset, uint32_t size, uint32_t* decoded, bool* end_of_stream)
+    {
+        uint32_t buffer_size = sound->m_DecodeBufferSize;
+        uint32_t first = dmMath::Min(size, buffer_size - offset);
+        dmSoundCodec::Result r = DecodeFrames(sound, instance, instance->m_DecodeBuffer + offset, first, false, decoded, end_of_stream);
+        if (r == dmSoundCodec::RESULT_OK && !*end_of_stream && *decoded == first && first < size)
+        {
+            uint32_t wrapped = 0;
+            r = DecodeFrames(sound, instance, instance->m_DecodeBuffer, size - first, false, &wrapped, end_of_stream);
+            *decoded += wrapped;
+        }
+        return r;
+    }
+
+    // Removes the entry at index from the decode queue, keeping the order of the others. The decode mutex must be held.
+    static SoundInstance* RemoveFromDecodeQueue(SoundSystem* sound, uint32_t index)
+    {
+        dmArray<uint16_t>& queue = sound->m_DecodeQueue;
+        SoundInstance* instance = &sound->m_Instances[queue[index]];
+        memmove(&queue[index], &queue[index] + 1, (queue.Size() - index - 1) * sizeof(uint16_t));
+        queue.Pop();
+        instance->m_DecodeQueued = 0;
+        return instance;
+    }
+
+    // Takes the instance out of the decode queue, and waits for a running decode of it to finish.
+    // The decode mutex must be held.
+    static void CancelDecodeAhead(SoundSystem* sound, SoundInstance* instance)
+    {
+        if (instance->m_DecodeQueued)
+        {
+            uint16_t index = (uint16_t)(instance - sound->m_Instances.Begin());
+            for (uint32_t i = 0; i < sound->m_DecodeQueue.Size(); ++i)
+            {
+                if (sound->m_DecodeQueue[i] == index)
+                {
+                    RemoveFromDecodeQueue(sound, i);
+                    break;
+                }
+            }
+        }
+        while (instance->m_DecodeBusy)
+        {
+            dmConditionVariable::Wait(sound->m_DecodeDoneCond, sound->m_DecodeMutex);
+        }
+    }
+
+    // Decodes the queued instances, oldest first, until the queue is empty. Posted to the job pool by QueueDecoding.
+    static void DecodeJob(void* ctx, uint32_t index)
+    {
+        SoundSystem* sound = (SoundSystem*)ctx;
+        dmMutex::Lock(sound->m_DecodeMutex);
+        while (!sound->m_DecodeQueue.Empty())
+        {
+            SoundInstance* instance = RemoveFromDecodeQueue(sound, 0);
+            instance->m_DecodeBusy = 1;
+            uint32_t offset = (instance->m_DecodeRead + instance->m_DecodeCount) % sound->m_DecodeBufferSize;
+            uint32_t size = sound->m_DecodeBufferSize - instance->m_DecodeCount;
+            dmMutex::Unlock(sound->m_DecodeMutex);
+
+            uint64_t start = dmTime::GetTime();
+            uint32_t decoded = 0;
+            bool end_of_stream = false;
+            dmSoundCodec::Result r = DecodeAhead(sound, instance, offset, size, &decoded, &end_of_stream);
+            uint32_t time = (uint32_t)(dmTime::GetTime() - start);
+
+            dmMutex::Lock(sound->m_DecodeMutex);
+            instance->m_DecodeCount += decoded;
+            instance->m_DecodeEnd = end_of_stream;
+            instance->m_DecodeResult = r;
+            instance->m_DecodeTime += time;
+            instance->m_DecodeBusy = 0;
+            dmConditionVariable::Broadcast(sound->m_DecodeDoneCond);
+        }
+        --sound->m_DecodeJobCount;
+        dmConditionVariable::Broadcast(sound->m_DecodeDoneCond);
+        dmMutex::Unlock(sound->m_DecodeMutex);
+    }
+
+    // Moves decoded bytes from the ring buffer. The decode mutex must be held.
+    static uint32_t TakeDecoded(SoundSystem* sound, SoundInstance* instance, char* buffer, uint32_t buffer_size)
+    {
+        uint32_t n = dmMath::Min(buffer_size, instance->m_DecodeCount);
+        uint32_t first = dmMath::Min(n, sound->m_DecodeBufferSize - instance->m_DecodeRead);
+        memcpy(buffer, instance->m_DecodeBuffer + instance->m_DecodeRead, first);
+        memcpy(buffer + first, instance->m_DecodeBuffer, n - first);
+        instance->m_DecodeRead = (instance->m_DecodeRead + n) % sound->m_DecodeBufferSize;
+        instance->m_DecodeCount -= n;
+        return n;
+    }
+
+    /**
+     * Reads frames decoded ahead by the decode jobs. If they haven't decoded enough, the
+     * rest is decoded on the calling thread. An instance that is still queued is taken out of
+     * the queue instead of waiting for a job to get to it, and only a running decode is waited for.
+     */
+    static dmSoundCodec::Result ReadDecodedFrames(SoundSystem* sound, SoundInstance* instance, char* buffer, uint32_t buffer_size, uint32_t* decoded, bool* end_of_stream)
+    {
+        dmMutex::Lock(sound->m_DecodeMutex);
+
+        DM_PROPERTY_ADD_U32(rmtp_SoundDecodeTime, instance->m_DecodeTime);
+        sound->m_DecodeTimeMax = dmMath::Max(sound->m_DecodeTimeMax, instance->m_DecodeTime);
+        instance->m_DecodeTime = 0;
+
+        uint32_t n = TakeDecoded(sound, instance, buffer, buffer_size);
+        if (n < buffer_size && instance->m_DecodeQueued)
+        {
+            CancelDecodeAhead(sound, instance);
+        }
+        while (n < buffer_size && instance->m_DecodeBusy)
+        {
+            dmConditionVariable::Wait(sound->m_DecodeDoneCond, sound->m_DecodeMutex);
+            n += TakeDecoded(sound, instance, buffer + n, buffer_size - n);
+        }
+
+        if (n < buffer_size && !instance->m_DecodeEnd && instance->m_DecodeResult == dmSoundCodec::RESULT_OK)
+        {
+            // The ring buffer is empty, and no decode job is using the decoder. It can only be queued
+            // again by the mixer, i.e. this thread.
+            dmMutex::Unlock(sound->m_DecodeMutex);
+            uint32_t rest = 0;
+            bool end = false;
+            dmSoundCodec::Result r = DecodeFrames(sound, instance, buffer + n, buffer_size - n, false, &rest, &end);
+            n += rest;
+            dmMutex::Lock(sound->m_DecodeMutex);
+            instance->m_DecodeEnd = end;
+            instance->m_DecodeResult = r;
+            DM_PROPERTY_ADD_U32(rmtp_SoundDecodeUnderruns, 1);
+        }
+
+        *decoded = n;
+        *end_of_stream = n < buffer_size && instance->m_DecodeEnd;
+        dmSoundCodec::Result r = instance->m_DecodeResult;
+        dmMutex::Unlock(sound->m_DecodeMutex);
+        return r;
+    }
+
+    // Queues the playing instances that have room for at least one more mix buffer in their ring buffers
+    static void QueueDecoding(SoundSystem* sound)
+    {
+        DM_MUTEX_SCOPED_LOCK(sound->m_DecodeMutex);
+        uint32_t min_size = sound->m_FrameCount * sizeof(int16_t) * SOUND_MAX_MIX_CHANNELS;
+        uint32_t instances = sound->m_Instances.Size();
+        for (uint32_t i = 0; i < instances; ++i) {
+            SoundInstance* instance = &sound->m_Instances[i];
+            if (!instance->m_Playing || instance->m_DecodeQueued || instance->m_DecodeBusy || instance->m_DecodeEnd || instance->m_DecodeResult != dmSoundCodec::RESULT_OK)
+                continue;
+            if (sound->m_DecodeBufferSize - instance->m_DecodeCount < min_size)
+                continue;
+            instance->m_DecodeQueued = 1;
+            sound->m_DecodeQueue.Push((uint16_t)i);
+        }
+        // A running job takes what is queued before it finishes
+        uint32_t job_count = dmMath::Min(sound->m_DecodeThreadCount, sound->m_DecodeQueue.Size());
+        while (sound->m_DecodeJobCount < job_count)
+        {
+            ++sound->m_DecodeJobCount;
+            dmJobPool::Push(sound->m_JobPool, DecodeJob, sound, 0);
+        }
+
+        DM_PROPERTY_SET_U32(rmtp_SoundVoiceDecodeTimeMax, sound->m_DecodeTimeMax);
+        sound->m_DecodeTimeMax = 0;
+    }
+
+    // Takes the instance out of the decode queue, waits for a running decode job, and discards what
+    // has been decoded. The sound mutex must be held, so that the mixer can't queue it again.
+    static void ResetDecodeAhead(SoundSystem* sound, SoundInstance* instance)
+    {
+        if (sound->m_DecodeThreadCount == 0)
+            return;
+        DM_MUTEX_SCOPED_LOCK(sound->m_DecodeMutex);
+        CancelDecodeAhead(sound, instance);
+        instance->m_DecodeRead = 0;
+        instance->m_DecodeCount = 0;
+        instance->m_DecodeEnd = 0;
+        instance->m_DecodeResult = dmSoundCodec::RESULT_OK;
+    }
+
     static void MixInstance(const MixContext* mix_context, SoundInstance* instance) {
         SoundSystem* sound = g_SoundSystem;
         uint32_t decoded = 0;
@@ -1161,58 +1491,23 @@ namespace dmSound
             const uint32_t stride = info.m_Channels * (info.m_BitsPerSample / 8);
             uint32_t n = mixed_instance_FrameCount - instance->m_FrameCount; // if the result contains a fractional part and we don't ceil(), we'll end up with a smaller number. Later, when deciding the mix_count in Mix(), a smaller value (integer) will be produced. This will result in leaving a small gap in the mix buffer resulting in sound crackling when the chunk changes.
 
-            if (!is_muted)
-            {
-                r = dmSoundCodec::Decode(sound->m_CodecContext,
-                                         instance->m_Decoder,
-                                         ((char*) instance->m_Frames) + instance->m_FrameCount * stride,
-                                         n * stride,
-                                         &decoded);
-            }
+            bool end_of_stream = false;
+            char* frames = ((char*) instance->m_Frames) + instance->m_FrameCount * stride;
+            if (sound->m_DecodeThreadCount > 0)
+                r = ReadDecodedFrames(sound, instance, frames, n * stride, &decoded, &end_of_stream);
             else
-            {
-                r = dmSoundCodec::Skip(sound->m_CodecContext, instance->m_Decoder, n * stride, &decoded);
-                memset(((char*) instance->m_Frames) + instance->m_FrameCount * stride, 0x00, n * stride);
-            }
+                r = DecodeFrames(sound, instance, frames, n * stride, is_muted, &decoded, &end_of_stream);
 
             assert(decoded % stride == 0);
             instance->m_FrameCount += decoded / stride;
 
-            if (instance->m_FrameCount < mixed_instance_FrameCount) {
-
-                if (instance->m_Looping && instance->m_Loopcounter != 0) {
-                    dmSoundCodec::Reset(sound->m_CodecContext, instance->m_Decoder);
-                    if ( instance->m_Loopcounter > 0 ) {
-                        instance->m_Loopcounter --;
-                    }
-
-                    uint32_t n = mixed_instance_FrameCount - instance->m_FrameCount;
-                    if (!is_muted)
-                    {
-                        r = dmSoundCodec::Decode(sound->m_CodecContext,
-                                                 instance->m_Decoder,
-                                                 ((char*) instance->m_Frames) + instance->m_FrameCount * stride,
-                                                 n * stride,
-                                                 &decoded);
-                    }
-                    else
-                    {
-                        r = dmSoundCodec::Skip(sound->m_CodecContext, instance->m_Decoder, n * stride, &decoded);
-                        memset(((char*) instance->m_Frames) + instance->m_FrameCount * stride, 0x00, n * stride);
-                    }
-
-                    assert(decoded % stride == 0);
-                    instance->m_FrameCount += decoded / stride;
-
-                } else {
-
-                    if  (instance->m_FrameCount < instance->m_Speed) {
-                        // since this is the last mix and no more frames will be added, trailing frames will linger on forever
-                        // if they are less than m_Speed. We will truncate them to avoid this.
-                        instance->m_FrameCount = 0;
-                    }
-                    instance->m_EndOfStream = 1;
+            if (end_of_stream) {
+                if  (instance->m_FrameCount < instance->m_Speed) {
+                    // since this is the last mix and no more frames will be added, trailing frames will linger on forever
+                    // if they are less than m_Speed. We will truncate them to avoid this.
+                    instance->m_FrameCount = 0;
                 }
+                instance->m_EndOfStream = 1;
             }
         }
 
@@ -1282,6 +1577,10 @@ namespace dmSound
                 instance->m_Playing = 0;
             }
         }
+
+        if (sound->m_DecodeThreadCount > 0) {
+            QueueDecoding(sound);
+        }
     }
 
     static void Master(const MixContext* mix_context)
@@ -1316,29 +1615,11 @@ namespace dmSound
                 continue;
             }
             Ramp ramp = GetRamp(mix_context, &g->m_Gain, n);
-            for (uint32_t i = 0; i < n; i++) {
-                float gain = ramp.GetValue(i);
-                gain = dmMath::Clamp(gain, 0.0f, 1.0f);
-
-                float s1 = g->m_MixBuffer[2 * i];
-                float s2 = g->m_MixBuffer[2 * i + 1];
-                mix_buffer[2 * i] += s1 * gain;
-                mix_buffer[2 * i + 1] += s2 * gain;
-            }
+            MixGroup(mix_buffer, g->m_MixBuffer, n, ramp);
         }
 
         Ramp ramp = GetRamp(mix_context, &master->m_Gain, n);
-        for (uint32_t i = 0; i < n; i++) {
-            float gain = ramp.GetValue(i);
-            float s1 = mix_buffer[2 * i] * gain;
-            float s2 = mix_buffer[2 * i + 1] * gain;
-            s1 = dmMath::Min(32767.0f, s1);
-            s1 = dmMath::Max(-32768.0f, s1);
-            s2 = dmMath::Min(32767.0f, s2);
-            s2 = dmMath::Max(-32768.0f, s2);
-            out[2 * i] = (int16_t) s1;
-            out[2 * i + 1] = (int16_t) s2;
-        }
+        MixMaster(out, mix_buffer, n, ramp);
     }
 
     static void StepGroupValues()
@@ -17,6 +17,7 @@
 
 #include <dlib/configfile.h>
 #include <dlib/hash.h>
+#include <dlib/job_pool.h>
 
 #include <dmsdk/dlib/vmath.h>
 
@@ -83,6 +84,9 @@ namespace dmSound
         uint32_t m_BufferSize;
         uint32_t m_FrameCount;
         uint32_t m_MaxInstances;
+        dmJobPool::HJobPool m_JobPool; // runs the decode jobs, 0x0 decodes on the mixer thread
+        uint32_t m_DecodeThreadCount; // max number of decode jobs running at the same time, 0 decodes on the mixer thread
+        uint32_t m_DecodeLookahead;   // decode ring buffer size, in mix buffers
         bool     m_UseThread;
 
         InitializeParams()
@@ -0,0 +1,190 @@
+// Copyright 2020-2022 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <dlib/simd.h>
+#include <dmsdk/dlib/math.h>
+
+#include "sound_mixer.h"
+
+namespace dmSound
+{
+#if defined(DM_SIMD)
+    using dmSimd::Float4;
+
+    // The gain ramp of two frames, i.e. (gain(i), gain(i), gain(i+1), gain(i+1)),
+    // with the same operation order as Ramp::GetValue
+    struct RampX2
+    {
+        RampX2(const Ramp& ramp, uint32_t start)
+        : m_Index(dmSimd::Set((float)start, (float)start, (float)(start + 1), (float)(start + 1)))
+        , m_From(dmSimd::Splat(ramp.m_From))
+        , m_Delta(dmSimd::Splat(ramp.m_To - ramp.m_From))
+        , m_Recip(dmSimd::Splat(ramp.m_TotalSamplesRecip))
+        {
+        }
+
+        inline Float4 Next()
+        {
+            Float4 value = dmSimd::Add(m_From, dmSimd::Mul(dmSimd::Mul(m_Index, m_Recip), m_Delta));
+            m_Index = dmSimd::Add(m_Index, dmSimd::Splat(2.0f));
+            return value;
+        }
+
+        Float4 m_Index;
+        Float4 m_From;
+        Float4 m_Delta;
+        Float4 m_Recip;
+    };
+#endif
+
+    void ConvertMonoS16(float* out, const int16_t* frames, uint32_t count)
+    {
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        for (; i + 4 <= count; i += 4)
+        {
+            Float4 s = dmSimd::LoadS16(frames + i);
+            dmSimd::Store(out + 2 * i, dmSimd::ZipLo(s, s));
+            dmSimd::Store(out + 2 * i + 4, dmSimd::ZipHi(s, s));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            float s = frames[i];
+            out[2 * i]      = s;
+            out[2 * i + 1]  = s;
+        }
+    }
+
+    void ConvertStereoS16(float* out, const int16_t* frames, uint32_t count)
+    {
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        for (; i + 2 <= count; i += 2)
+        {
+            dmSimd::Store(out + 2 * i, dmSimd::LoadS16(frames + 2 * i));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            out[2 * i]      = frames[2 * i];
+            out[2 * i + 1]  = frames[2 * i + 1];
+        }
+    }
+
+    void MixScaledFrames(float* mix_buffer, const float* frames, uint32_t start, uint32_t count, const Ramp& gain_ramp, const Ramp& pan_ramp)
+    {
+        uint32_t i = 0;
+        // The pan is usually constant over a buffer, and then there's no need to
+        // evaluate the pan law for every frame. GetValue(0) gives the same value as
+        // any other frame in that case.
+        bool constant_pan = pan_ramp.m_From == pan_ramp.m_To;
+        float const_left_scale, const_right_scale;
+        GetPanScale(pan_ramp.GetValue(0), &const_left_scale, &const_right_scale);
+
+#if defined(DM_SIMD)
+        RampX2 gain(gain_ramp, start);
+        Float4 pan_scale = dmSimd::Set(const_left_scale, const_right_scale, const_left_scale, const_right_scale);
+        for (; i + 2 <= count; i += 2)
+        {
+            uint32_t frame = start + i;
+            if (!constant_pan)
+            {
+                float left0, right0, left1, right1;
+                GetPanScale(pan_ramp.GetValue(frame), &left0, &right0);
+                GetPanScale(pan_ramp.GetValue(frame + 1), &left1, &right1);
+                pan_scale = dmSimd::Set(left0, right0, left1, right1);
+            }
+
+            Float4 s = dmSimd::Mul(dmSimd::Mul(dmSimd::Load(frames + 2 * i), gain.Next()), pan_scale);
+            float* mix = mix_buffer + 2 * frame;
+            dmSimd::Store(mix, dmSimd::Add(dmSimd::Load(mix), s));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            uint32_t frame = start + i;
+            float gain = gain_ramp.GetValue(frame);
+            float left_scale = const_left_scale;
+            float right_scale = const_right_scale;
+            if (!constant_pan)
+            {
+                GetPanScale(pan_ramp.GetValue(frame), &left_scale, &right_scale);
+            }
+
+            mix_buffer[2 * frame]       += frames[2 * i] * gain * left_scale;
+            mix_buffer[2 * frame + 1]   += frames[2 * i + 1] * gain * right_scale;
+        }
+    }
+
+    void MixGroup(float* mix_buffer, const float* group_buffer, uint32_t count, const Ramp& gain_ramp)
+    {
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        RampX2 gain(gain_ramp, 0);
+        const Float4 zero = dmSimd::Splat(0.0f);
+        const Float4 one = dmSimd::Splat(1.0f);
+        for (; i + 2 <= count; i += 2)
+        {
+            // Same as dmMath::Clamp, including for -0
+            Float4 g = dmSimd::Min(one, dmSimd::Max(zero, gain.Next()));
+            Float4 s = dmSimd::Mul(dmSimd::Load(group_buffer + 2 * i), g);
+            dmSimd::Store(mix_buffer + 2 * i, dmSimd::Add(dmSimd::Load(mix_buffer + 2 * i), s));
+        }
+#endif
+
+        for (; i < count; i++) {
+            float gain = gain_ramp.GetValue(i);
+            gain = dmMath::Clamp(gain, 0.0f, 1.0f);
+
+            float s1 = group_buffer[2 * i];
+            float s2 = group_buffer[2 * i + 1];
+            mix_buffer[2 * i] += s1 * gain;
+            mix_buffer[2 * i + 1] += s2 * gain;
+        }
+    }
+
+    void MixMaster(int16_t* out, const float* mix_buffer, uint32_t count, const Ramp& gain_ramp)
+    {
+        uint32_t i = 0;
+#if defined(DM_SIMD)
+        RampX2 gain(gain_ramp, 0);
+        const Float4 max_value = dmSimd::Splat(32767.0f);
+        const Float4 min_value = dmSimd::Splat(-32768.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            Float4 s0 = dmSimd::Mul(dmSimd::Load(mix_buffer + 2 * i), gain.Next());
+            Float4 s1 = dmSimd::Mul(dmSimd::Load(mix_buffer + 2 * i + 4), gain.Next());
+            s0 = dmSimd::Max(min_value, dmSimd::Min(max_value, s0));
+            s1 = dmSimd::Max(min_value, dmSimd::Min(max_value, s1));
+            dmSimd::StoreS16(out + 2 * i, s0, s1);
+        }
+#endif
+
+        for (; i < count; i++) {
+            float gain = gain_ramp.GetValue(i);
+            float s1 = mix_buffer[2 * i] * gain;
+            float s2 = mix_buffer[2 * i + 1] * gain;
+            s1 = dmMath::Min(32767.0f, s1);
+            s1 = dmMath::Max(-32768.0f, s1);
+            s2 = dmMath::Min(32767.0f, s2);
+            s2 = dmMath::Max(-32768.0f, s2);
+            out[2 * i] = (int16_t) s1;
+            out[2 * i + 1] = (int16_t) s2;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright 2020-2022 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_SOUND_MIXER_H
+#define DM_SOUND_MIXER_H
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Mixing kernels used by the sound system. All buffers are interleaved stereo.
+ *
+ * The kernels are vectorized when dmSimd is available, and give the same results,
+ * bit for bit, as the scalar versions.
+ */
+namespace dmSound
+{
+    /**
+     * Linear ramp of a value over a mix buffer
+     */
+    struct Ramp
+    {
+        float m_From, m_To, m_TotalSamplesRecip;
+
+        inline float GetValue(int i) const
+        {
+            float mix = i * m_TotalSamplesRecip;
+            return m_From + mix * (m_To - m_From);
+        }
+    };
+
+    static inline void GetPanScale(float pan, float* left_scale, float* right_scale)
+    {
+        // M_PI_2 isn't defined by default on MSVC
+        const float half_pi = 1.57079632679489661923f;
+        // Constant power panning: https://www.cs.cmu.edu/~music/icm-online/readings/panlaws/index.html
+        const float theta = pan * half_pi;
+        *left_scale = cosf(theta);
+        *right_scale = sinf(theta);
+    }
+
+    /**
+     * Converts mono 16 bit frames to float, with the sample in both channels
+     * @param out [type: float*] interleaved stereo output
+     * @param frames [type: const int16_t*] mono frames
+     * @param count [type: uint32_t] number of frames
+     */
+    void ConvertMonoS16(float* out, const int16_t* frames, uint32_t count);
+
+    /**
+     * Converts stereo 16 bit frames to float
+     * @param out [type: float*] interleaved stereo output
+     * @param frames [type: const int16_t*] interleaved stereo frames
+     * @param count [type: uint32_t] number of frames
+     */
+    void ConvertStereoS16(float* out, const int16_t* frames, uint32_t count);
+
+    /**
+     * Adds frames, scaled by a gain and pan ramp, to the mix buffer:
+     * mix_buffer[2*i+c] += (frames[2*(i-start)+c] * gain(i)) * pan_scale(pan(i), c)
+     * @param mix_buffer [type: float*] mix buffer
+     * @param frames [type: const float*] the frames start to start+count
+     * @param start [type: uint32_t] first frame in the mix buffer
+     * @param count [type: uint32_t] number of frames
+     * @param gain_ramp [type: const Ramp&] gain
+     * @param pan_ramp [type: const Ramp&] pan
+     */
+    void MixScaledFrames(float* mix_buffer, const float* frames, uint32_t start, uint32_t count, const Ramp& gain_ramp, const Ramp& pan_ramp);
+
+    /**
+     * Adds a group mix buffer to the master mix buffer, with the group gain clamped to [0, 1]
+     * @param mix_buffer [type: float*] master mix buffer
+     * @param group_buffer [type: const float*] group mix buffer
+     * @param count [type: uint32_t] number of frames
+     * @param gain_ramp [type: const Ramp&] group gain
+     */
+    void MixGroup(float* mix_buffer, const float* group_buffer, uint32_t count, const Ramp& gain_ramp);
+
+    /**
+     * Applies the master gain to the mix buffer and converts it to clipped 16 bit samples
+     * @param out [type: int16_t*] output buffer
+     * @param mix_buffer [type: const float*] master mix buffer
+     * @param count [type: uint32_t] number of frames
+     * @param gain_ramp [type: const Ramp&] master gain
+     */
+    void MixMaster(int16_t* out, const float* mix_buffer, uint32_t count, const Ramp& gain_ramp);
+}
+
+#endif // #ifndef DM_SOUND_MIXER_H
@@ -26,6 +26,7 @@
 #include <dlib/math.h>
 #include "../sound.h"
 #include "../sound_codec.h"
+#include "../sound_mixer.h"
 #include "../stb_vorbis/stb_vorbis.h"
 
 #include "test/mono_tone_440_22050_44100.wav.embed.h"
@@ -90,11 +91,14 @@ struct TestParams
     float       m_Pan;
     float       m_Speed;
     uint8_t     m_Loopcount;
+    uint32_t    m_DecodeThreadCount;
 
-    TestParams(const char* device_name, void* sound, uint32_t sound_size, SoundDataType type, uint32_t tone_rate, uint32_t mix_rate, uint32_t frame_count, uint32_t buffer_frame_count)
+    TestParams(const char* device_name, void* sound, uint32_t sound_size, SoundDataType type, uint32_t tone_rate, uint32_t mix_rate, uint32_t frame_count, uint32_t buffer_frame_count,
+                uint32_t decode_thread_count = 0)
     : m_Pan(0.0f)
     , m_Speed(1.0f)
     , m_Loopcount(0)
+    , m_DecodeThreadCount(decode_thread_count)
     {
         m_DeviceName = device_name;
         m_Sound = sound;
@@ -110,6 +114,8 @@ struct TestParams
                 uint32_t frame_count, uint32_t buffer_frame_count, float pan, float speed)
     : m_Pan(pan)
     , m_Speed(speed)
+    , m_Loopcount(0)
+    , m_DecodeThreadCount(0)
     {
         m_DeviceName = device_name;
         m_Sound = sound;
@@ -122,10 +128,11 @@ struct TestParams
     }
     
     TestParams(const char* device_name, void* sound, uint32_t sound_size, SoundDataType type, uint32_t tone_rate, uint32_t mix_rate,
-                uint32_t frame_count, uint32_t buffer_frame_count, float pan, float speed, uint32_t loopcount)
+                uint32_t frame_count, uint32_t buffer_frame_count, float pan, float speed, uint32_t loopcount, uint32_t decode_thread_count = 0)
     : m_Pan(pan)
     , m_Speed(speed)
     , m_Loopcount(loopcount)
+    , m_DecodeThreadCount(decode_thread_count)
     {
         m_DeviceName = device_name;
         m_Sound = sound;
@@ -165,11 +172,12 @@ struct TestParams2
 
     uint32_t    m_BufferFrameCount;
     bool        m_UseThread;
+    uint32_t    m_DecodeThreadCount;
 
     TestParams2(const char* device_name,
                 void* sound1, uint32_t sound_size1, SoundDataType type1, uint32_t tone_rate1, uint32_t mix_rate1, uint32_t frame_count1, float gain1, bool ramp1,
                 void* sound2, uint32_t sound_size2, SoundDataType type2, uint32_t tone_rate2, uint32_t mix_rate2, uint32_t frame_count2, float gain2, bool ramp2,
-                uint32_t buffer_frame_count, bool use_thread)
+                uint32_t buffer_frame_count, bool use_thread, uint32_t decode_thread_count = 0)
     {
         m_DeviceName = device_name;
 
@@ -193,6 +201,7 @@ struct TestParams2
 
         m_BufferFrameCount = buffer_frame_count;
         m_UseThread = use_thread;
+        m_DecodeThreadCount = decode_thread_count;
     }
 };
 
@@ -204,6 +213,7 @@ class dmSoundTest : public jc_test_params_class<TestParams>
 {
 public:
     const char* m_DeviceName;
+    dmJobPool::HJobPool m_JobPool;
 
     dmSoundTest() {
         m_DeviceName = GetParam().m_DeviceName;
@@ -217,6 +227,9 @@ public:
         params.m_OutputDevice = m_DeviceName;
         params.m_FrameCount = GetParam().m_BufferFrameCount;
         params.m_UseThread = false;
+        params.m_DecodeThreadCount = GetParam().m_DecodeThreadCount;
+        m_JobPool = dmJobPool::New(GetParam().m_DecodeThreadCount);
+        params.m_JobPool = m_JobPool;
 
         dmSound::Result r = dmSound::Initialize(0, &params);
         ASSERT_EQ(dmSound::RESULT_OK, r);
@@ -226,6 +239,7 @@ public:
     {
         dmSound::Result r = dmSound::Finalize();
         ASSERT_EQ(dmSound::RESULT_OK, r);
+        dmJobPool::Delete(m_JobPool);
     }
 };
 
@@ -233,6 +247,7 @@ class dmSoundTest2 : public jc_test_params_class<TestParams2>
 {
 public:
     const char* m_DeviceName;
+    dmJobPool::HJobPool m_JobPool;
 
     dmSoundTest2() {
         m_DeviceName = GetParam().m_DeviceName;
@@ -246,6 +261,9 @@ public:
         params.m_OutputDevice = m_DeviceName;
         params.m_FrameCount = GetParam().m_BufferFrameCount;
         params.m_UseThread = GetParam().m_UseThread;
+        params.m_DecodeThreadCount = GetParam().m_DecodeThreadCount;
+        m_JobPool = dmJobPool::New(GetParam().m_DecodeThreadCount);
+        params.m_JobPool = m_JobPool;
 
         dmSound::Result r = dmSound::Initialize(0, &params);
         ASSERT_EQ(dmSound::RESULT_OK, r);
@@ -255,6 +273,7 @@ public:
     {
         dmSound::Result r = dmSound::Finalize();
         ASSERT_EQ(dmSound::RESULT_OK, r);
+        dmJobPool::Delete(m_JobPool);
     }
 };
 
@@ -470,7 +489,20 @@ const TestParams params_looping_test[] = {
             88200,
             2048,
             0.0f,
-            2.0f)
+            2.0f),
+    // Decoded ahead on the job pool
+    TestParams("loopback",
+            MONO_TONE_440_44100_88200_WAV,
+            MONO_TONE_440_44100_88200_WAV_SIZE,
+            dmSound::SOUND_DATA_TYPE_WAV,
+            440,
+            44100,
+            88200,
+            2048,
+            0.0f,
+            2.0f,
+            0,
+            2)
 };
 INSTANTIATE_TEST_CASE_P(dmSoundTestLoopingTest, dmSoundTestLoopingTest, jc_test_values_in(params_looping_test));
 #endif
@@ -989,7 +1021,17 @@ const TestParams params_verify_ogg_test[] = {TestParams("loopback",
                                             2000,
                                             44100,
                                             35200,
-                                            2048)};
+                                            2048),
+                                            // Decoded ahead on the job pool
+                                            TestParams("loopback",
+                                            MONO_RESAMPLE_FRAMECOUNT_16000_OGG,
+                                            MONO_RESAMPLE_FRAMECOUNT_16000_OGG_SIZE,
+                                            dmSound::SOUND_DATA_TYPE_OGG_VORBIS,
+                                            2000,
+                                            44100,
+                                            35200,
+                                            2048,
+                                            2)};
 INSTANTIATE_TEST_CASE_P(dmSoundVerifyOggTest, dmSoundVerifyOggTest, jc_test_values_in(params_verify_ogg_test));
 #endif
 
@@ -1482,10 +1524,349 @@ const TestParams2 params_mixer_test[] = {
 
                 2048,
                 true),
+
+    // Decode threads
+    TestParams2("loopback",
+                MONO_TONE_440_22050_44100_WAV,
+                MONO_TONE_440_22050_44100_WAV_SIZE,
+                dmSound::SOUND_DATA_TYPE_WAV,
+                440,
+                22050,
+                44100,
+                0.6f,
+                false,
+
+                MONO_TONE_440_32000_64000_WAV,
+                MONO_TONE_440_32000_64000_WAV_SIZE,
+                dmSound::SOUND_DATA_TYPE_WAV,
+                440,
+                32000,
+                64000,
+                0.4f,
+                false,
+
+                2048,
+                false,
+                2),
+
+    TestParams2("loopback",
+                MONO_TONERAMP_440_32000_64000_WAV,
+                MONO_TONERAMP_440_32000_64000_WAV_SIZE,
+                dmSound::SOUND_DATA_TYPE_WAV,
+                440,
+                32000,
+                64000,
+                0.6f,
+                true,
+
+                MONO_TONERAMP_440_32000_64000_WAV,
+                MONO_TONERAMP_440_32000_64000_WAV_SIZE,
+                dmSound::SOUND_DATA_TYPE_WAV,
+                440,
+                32000,
+                64000,
+                0.6f,
+                true,
+
+                2048,
+                true,
+                2),
 };
 INSTANTIATE_TEST_CASE_P(dmSoundMixerTest, dmSoundMixerTest, jc_test_values_in(params_mixer_test));
 #endif
 
+// The mixing loops as they were before the kernels in sound_mixer.cpp, used as reference
+static void RefMixScaledFrames(float* mix_buffer, const float* frames, uint32_t start, uint32_t count, const dmSound::Ramp& gain_ramp, const dmSound::Ramp& pan_ramp)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t frame = start + i;
+        float gain = gain_ramp.GetValue(frame);
+        float pan = pan_ramp.GetValue(frame);
+
+        float left_scale, right_scale;
+        dmSound::GetPanScale(pan, &left_scale, &right_scale);
+        mix_buffer[2 * frame]       += frames[2 * i] * gain * left_scale;
+        mix_buffer[2 * frame + 1]   += frames[2 * i + 1] * gain * right_scale;
+    }
+}
+
+static void RefMixGroup(float* mix_buffer, const float* group_buffer, uint32_t count, const dmSound::Ramp& ramp)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        float gain = ramp.GetValue(i);
+        gain = dmMath::Clamp(gain, 0.0f, 1.0f);
+
+        float s1 = group_buffer[2 * i];
+        float s2 = group_buffer[2 * i + 1];
+        mix_buffer[2 * i] += s1 * gain;
+        mix_buffer[2 * i + 1] += s2 * gain;
+    }
+}
+
+static void RefMixMaster(int16_t* out, const float* mix_buffer, uint32_t count, const dmSound::Ramp& ramp)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        float gain = ramp.GetValue(i);
+        float s1 = mix_buffer[2 * i] * gain;
+        float s2 = mix_buffer[2 * i + 1] * gain;
+        s1 = dmMath::Min(32767.0f, s1);
+        s1 = dmMath::Max(-32768.0f, s1);
+        s2 = dmMath::Min(32767.0f, s2);
+        s2 = dmMath::Max(-32768.0f, s2);
+        out[2 * i] = (int16_t) s1;
+        out[2 * i + 1] = (int16_t) s2;
+    }
+}
+
+static dmSound::Ramp MakeRamp(float from, float to, uint32_t total_samples)
+{
+    dmSound::Ramp ramp;
+    ramp.m_From = from;
+    ramp.m_To = to;
+    ramp.m_TotalSamplesRecip = 1.0f / total_samples;
+    return ramp;
+}
+
+static void RandomSamples(float* samples, uint32_t count, float range)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        samples[i] = range * (2.0f * rand() / (float) RAND_MAX - 1.0f);
+    }
+}
+
+TEST(dmSoundMixerKernels, BitExact)
+{
+    srand(2938);
+
+    const uint32_t counts[] = {1, 2, 3, 5, 8, 63, 256, 1023};
+    // from, to: constant, ramping and out of range (the group gain is clamped)
+    const float ramps[][2] = {{1.0f, 1.0f}, {0.0f, 1.0f}, {0.8f, 0.3f}, {-0.5f, 1.5f}};
+    const uint32_t ramp_count = sizeof(ramps) / sizeof(ramps[0]);
+
+    const uint32_t max_count = 1023;
+    std::vector<float> frames(2 * max_count);
+    std::vector<float> initial(2 * max_count);
+    std::vector<float> expected(2 * max_count);
+    std::vector<float> actual(2 * max_count);
+    std::vector<int16_t> expected_out(2 * max_count);
+    std::vector<int16_t> actual_out(2 * max_count);
+
+    for (uint32_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        const uint32_t count = counts[c];
+        for (uint32_t g = 0; g < ramp_count; ++g)
+        {
+            dmSound::Ramp gain_ramp = MakeRamp(ramps[g][0], ramps[g][1], count);
+            for (uint32_t p = 0; p < ramp_count; ++p)
+            {
+                dmSound::Ramp pan_ramp = MakeRamp(ramps[p][0], ramps[p][1], count);
+
+                RandomSamples(&frames[0], 2 * count, 32768.0f);
+                RandomSamples(&initial[0], 2 * count, 32768.0f);
+
+                // Mix the second half of the frames, to test a start offset
+                uint32_t start = count / 2;
+                expected = initial;
+                actual = initial;
+                RefMixScaledFrames(&expected[0], &frames[0], start, count - start, gain_ramp, pan_ramp);
+                dmSound::MixScaledFrames(&actual[0], &frames[0], start, count - start, gain_ramp, pan_ramp);
+                ASSERT_EQ(0, memcmp(&expected[0], &actual[0], 2 * count * sizeof(float)));
+            }
+
+            expected = initial;
+            actual = initial;
+            RefMixGroup(&expected[0], &frames[0], count, gain_ramp);
+            dmSound::MixGroup(&actual[0], &frames[0], count, gain_ramp);
+            ASSERT_EQ(0, memcmp(&expected[0], &actual[0], 2 * count * sizeof(float)));
+
+            // Twice the range, to test the clipping
+            RandomSamples(&frames[0], 2 * count, 65536.0f);
+            RefMixMaster(&expected_out[0], &frames[0], count, gain_ramp);
+            dmSound::MixMaster(&actual_out[0], &frames[0], count, gain_ramp);
+            ASSERT_EQ(0, memcmp(&expected_out[0], &actual_out[0], 2 * count * sizeof(int16_t)));
+        }
+
+        // The 16 bit conversions of the identity mixers, i.e. float(s)
+        const std::vector<int16_t>& samples = expected_out;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            expected[2 * i] = samples[i];
+            expected[2 * i + 1] = samples[i];
+        }
+        dmSound::ConvertMonoS16(&actual[0], &samples[0], count);
+        ASSERT_EQ(0, memcmp(&expected[0], &actual[0], 2 * count * sizeof(float)));
+
+        for (uint32_t i = 0; i < 2 * count; ++i)
+        {
+            expected[i] = samples[i];
+        }
+        dmSound::ConvertStereoS16(&actual[0], &samples[0], count);
+        ASSERT_EQ(0, memcmp(&expected[0], &actual[0], 2 * count * sizeof(float)));
+    }
+}
+
+// Builds a 16 bit PCM wav file
+static void MakeWav(std::vector<uint8_t>& wav, uint32_t rate, uint16_t channels, const std::vector<int16_t>& samples)
+{
+    uint32_t data_size = samples.size() * sizeof(int16_t);
+    uint16_t block_align = channels * sizeof(int16_t);
+    uint32_t byte_rate = rate * block_align;
+    uint32_t riff_size = 4 + (8 + 16) + (8 + data_size);
+    uint16_t format = 1;
+    uint16_t bits_per_sample = 16;
+    uint32_t fmt_size = 16;
+
+    wav.clear();
+    wav.insert(wav.end(), (const uint8_t*)"RIFF", (const uint8_t*)"RIFF" + 4);
+    wav.insert(wav.end(), (const uint8_t*)&riff_size, (const uint8_t*)&riff_size + 4);
+    wav.insert(wav.end(), (const uint8_t*)"WAVEfmt ", (const uint8_t*)"WAVEfmt " + 8);
+    wav.insert(wav.end(), (const uint8_t*)&fmt_size, (const uint8_t*)&fmt_size + 4);
+    wav.insert(wav.end(), (const uint8_t*)&format, (const uint8_t*)&format + 2);
+    wav.insert(wav.end(), (const uint8_t*)&channels, (const uint8_t*)&channels + 2);
+    wav.insert(wav.end(), (const uint8_t*)&rate, (const uint8_t*)&rate + 4);
+    wav.insert(wav.end(), (const uint8_t*)&byte_rate, (const uint8_t*)&byte_rate + 4);
+    wav.insert(wav.end(), (const uint8_t*)&block_align, (const uint8_t*)&block_align + 2);
+    wav.insert(wav.end(), (const uint8_t*)&bits_per_sample, (const uint8_t*)&bits_per_sample + 2);
+    wav.insert(wav.end(), (const uint8_t*)"data", (const uint8_t*)"data" + 4);
+    wav.insert(wav.end(), (const uint8_t*)&data_size, (const uint8_t*)&data_size + 4);
+    wav.insert(wav.end(), (const uint8_t*)&samples[0], (const uint8_t*)&samples[0] + data_size);
+}
+
+static void RandomSamples(std::vector<int16_t>& samples)
+{
+    for (uint32_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = (int16_t)(rand() % 65536 - 32768);
+    }
+}
+
+// The mono resampler as it was before the kernels in sound_mixer.cpp, over the whole sound
+static void RefResampleUpMono(std::vector<float>& out, const std::vector<int16_t>& frames, uint32_t rate, uint32_t mix_rate, uint32_t count)
+{
+    const uint32_t fraction_bits = 31; // RESAMPLE_FRACTION_BITS
+    const uint32_t mask = (1U << fraction_bits) - 1U;
+    const float range_recip = 1.0f / mask;
+
+    uint64_t frac = 0;
+    uint32_t index = 0;
+    uint64_t delta = (((uint64_t) rate) << fraction_bits) / mix_rate;
+    delta *= 1.0f; // speed
+
+    out.resize(2 * count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float mix = frac * range_recip;
+        int16_t s1 = frames[index];
+        int16_t s2 = frames[index + 1];
+        float s = (1.0f - mix) * s1 + mix * s2;
+        out[2 * i] = s;
+        out[2 * i + 1] = s;
+
+        frac += delta;
+        index += (uint32_t)(frac >> fraction_bits);
+        frac &= mask;
+    }
+}
+
+/*
+ * Mixes a mono 22050 Hz sound (resampled) in a group and a stereo 44100 Hz sound (identity) in the
+ * master group through dmSound::Update, and compares the output with the old scalar loops
+ */
+TEST(dmSoundMixPath, BitExact)
+{
+    const uint32_t buffer_frame_count = 2048;
+    const uint32_t mix_rate = 44100;
+    const uint32_t mono_rate = 22050;
+    const uint32_t mono_frame_count = 11025;
+    const uint32_t stereo_frame_count = 20000;
+    const float mono_gain = 0.8f;
+    const float mono_pan = -0.4f;
+    const float stereo_pan = 0.6f;
+    const float group_gain = 0.5f;
+    const float master_gain = 0.75f;
+
+    dmSound::InitializeParams params;
+    params.m_MaxBuffers = MAX_BUFFERS;
+    params.m_MaxSources = MAX_SOURCES;
+    params.m_OutputDevice = "loopback";
+    params.m_FrameCount = buffer_frame_count;
+    params.m_UseThread = false;
+    params.m_DecodeThreadCount = 0;
+    params.m_JobPool = 0;
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::Initialize(0, &params));
+
+    srand(2938);
+    std::vector<int16_t> mono(mono_frame_count);
+    std::vector<int16_t> stereo(2 * stereo_frame_count);
+    RandomSamples(mono);
+    RandomSamples(stereo);
+
+    std::vector<uint8_t> mono_wav;
+    std::vector<uint8_t> stereo_wav;
+    MakeWav(mono_wav, mono_rate, 1, mono);
+    MakeWav(stereo_wav, mix_rate, 2, stereo);
+
+    dmSound::HSoundData mono_data = 0;
+    dmSound::HSoundData stereo_data = 0;
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::NewSoundData(&mono_wav[0], mono_wav.size(), dmSound::SOUND_DATA_TYPE_WAV, &mono_data, 1));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::NewSoundData(&stereo_wav[0], stereo_wav.size(), dmSound::SOUND_DATA_TYPE_WAV, &stereo_data, 2));
+
+    // Values set before playing aren't ramped
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::AddGroup("g1"));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::SetGroupGain(dmHashString64("g1"), group_gain));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::SetGroupGain(dmHashString64("master"), master_gain));
+
+    dmSound::HSoundInstance mono_instance = 0;
+    dmSound::HSoundInstance stereo_instance = 0;
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::NewSoundInstance(mono_data, &mono_instance));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::NewSoundInstance(stereo_data, &stereo_instance));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::SetInstanceGroup(mono_instance, "g1"));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::SetParameter(mono_instance, dmSound::PARAMETER_GAIN, dmVMath::Vector4(mono_gain, 0, 0, 0)));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::SetParameter(mono_instance, dmSound::PARAMETER_PAN, dmVMath::Vector4(mono_pan, 0, 0, 0)));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::SetParameter(stereo_instance, dmSound::PARAMETER_PAN, dmVMath::Vector4(stereo_pan, 0, 0, 0)));
+
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::Play(mono_instance));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::Play(stereo_instance));
+    do {
+        ASSERT_EQ(dmSound::RESULT_OK, dmSound::Update());
+    } while (dmSound::IsPlaying(mono_instance) || dmSound::IsPlaying(stereo_instance));
+
+    // The frames both sounds cover, with room for the last mono frame being interpolated
+    const uint32_t count = dmMath::Min(2 * (mono_frame_count - 1), stereo_frame_count);
+    ASSERT_LE(2 * count, g_LoopbackDevice->m_AllOutput.Size());
+
+    std::vector<float> resampled;
+    RefResampleUpMono(resampled, mono, mono_rate, mix_rate, count);
+    std::vector<float> converted(2 * count);
+    for (uint32_t i = 0; i < 2 * count; ++i)
+    {
+        converted[i] = stereo[i];
+    }
+
+    const dmSound::Ramp mono_gain_ramp = MakeRamp(mono_gain, mono_gain, count);
+    const dmSound::Ramp mono_pan_ramp = MakeRamp((mono_pan + 1.0f) * 0.5f, (mono_pan + 1.0f) * 0.5f, count);
+    const dmSound::Ramp stereo_gain_ramp = MakeRamp(1.0f, 1.0f, count);
+    const dmSound::Ramp stereo_pan_ramp = MakeRamp((stereo_pan + 1.0f) * 0.5f, (stereo_pan + 1.0f) * 0.5f, count);
+
+    std::vector<float> group_buffer(2 * count, 0.0f);
+    std::vector<float> master_buffer(2 * count, 0.0f);
+    std::vector<int16_t> expected(2 * count);
+    RefMixScaledFrames(&group_buffer[0], &resampled[0], 0, count, mono_gain_ramp, mono_pan_ramp);
+    RefMixScaledFrames(&master_buffer[0], &converted[0], 0, count, stereo_gain_ramp, stereo_pan_ramp);
+    RefMixGroup(&master_buffer[0], &group_buffer[0], count, MakeRamp(group_gain, group_gain, count));
+    RefMixMaster(&expected[0], &master_buffer[0], count, MakeRamp(master_gain, master_gain, count));
+
+    ASSERT_EQ(0, memcmp(&expected[0], &g_LoopbackDevice->m_AllOutput[0], 2 * count * sizeof(int16_t)));
+
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::DeleteSoundInstance(mono_instance));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::DeleteSoundInstance(stereo_instance));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::DeleteSoundData(mono_data));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::DeleteSoundData(stereo_data));
+    ASSERT_EQ(dmSound::RESULT_OK, dmSound::Finalize());
+}
+
 DM_DECLARE_SOUND_DEVICE(LoopBackDevice, "loopback", DeviceLoopbackOpen, DeviceLoopbackClose, DeviceLoopbackQueue, DeviceLoopbackFreeBufferSlots, DeviceLoopbackDeviceInfo, DeviceLoopbackRestart, DeviceLoopbackStop);
 
 int main(int argc, char **argv)